@@ -0,0 +1,82 @@
+#pragma once
+
+#include "loaders/GltfLoader.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+// ============================================================================
+// Data Structures
+// ============================================================================
+
+// Per-bone local TRS pose in structure-of-arrays form, so sampling and
+// blending run as flat loops over all bones instead of per-bone glm calls.
+struct PoseSoA {
+    std::vector<float> tx, ty, tz;
+    std::vector<float> rx, ry, rz, rw;
+    std::vector<float> sx, sy, sz;
+
+    size_t size() const { return tx.size(); }
+    void resize(size_t n);
+};
+
+struct AnimationLayer {
+    int   clip = -1;        // index into the animation list, -1 = inactive
+    float time = 0.0f;      // seconds, wraps at clip duration
+    float speed = 1.0f;
+    float weight = 1.0f;
+    bool  additive = false; // applied relative to the clip's first frame
+};
+
+// ============================================================================
+// Blender
+// ============================================================================
+
+class AnimationBlender {
+public:
+    // Capture rest pose and hierarchy order; call after extractAnimations
+    void init(const Skeleton& skeleton, const std::vector<Animation>& animations);
+    void clear();
+    bool isInitialized() const { return restPose.size() > 0; }
+
+    // Base layer: fade from the current clip to `clip` over `duration` seconds.
+    // Interrupting a fade starts the new one from the pose the old one had
+    // reached. Returns false (no-op) when `clip` is already the active clip.
+    bool crossfadeTo(int clip, float duration);
+
+    // Additive layer on top of the blended base; returns its index in additiveLayers
+    int addAdditiveLayer(int clip, float weight);
+
+    // Advance layer clocks (scaled by each layer's speed) and crossfade progress
+    void update(float deltaTime);
+
+    // Sample all active layers, blend, and produce final skinning matrices
+    // (global * inverseBind, conjugated by the OBJ alignment like computeBoneMatrices)
+    void evaluate(const Skeleton& skeleton, const std::vector<Animation>& animations,
+                  std::vector<glm::mat4>& boneMatrices);
+
+    // True when the output is exactly one clip at full weight (bake-friendly)
+    bool isSingleClip() const;
+
+    float fadeProgress() const;
+
+    AnimationLayer current;                    // base clip being faded in
+    AnimationLayer previous;                   // base clip being faded out (or, after an
+                                               // interrupted fade, the one it was fading in)
+    std::vector<AnimationLayer> additiveLayers;
+
+private:
+    void sampleClip(const Animation& animation, float time, PoseSoA& out) const;
+
+    PoseSoA restPose;
+    PoseSoA basePose;
+    PoseSoA scratchPose;
+    PoseSoA blendedPose;                       // last faded base pose, before additive layers
+    PoseSoA fadeSourcePose;                    // frozen source of a fade that interrupted another
+    bool blendedPoseValid = false;             // evaluated since the last crossfadeTo
+    bool fadeFromSnapshot = false;             // fade out of fadeSourcePose, not previous.clip
+    std::vector<PoseSoA> additiveRefPoses;     // first frame per clip, for additive deltas
+    std::vector<int> evalOrder;                // parents before children
+    std::vector<glm::mat4> globalTransforms;
+    float fadeDuration = 0.0f;
+    float fadeElapsed = 0.0f;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+// Correctness checks run by `gravel_bench --check`. Each compares a CPU stage
+// against a reference (an analytic value, a second code path, a write/read
+// round trip) on small generated inputs, so a change that keeps the timings
+// but breaks the output is caught before the numbers are looked at. Checks
+// that need a shipped asset are skipped when it is missing.
+class BenchChecks {
+public:
+    // Runs the checks whose name contains filter (all when empty), one line
+    // each. Returns how many failed.
+    static int run(const std::string& filter, const std::string& assetsDir);
+};
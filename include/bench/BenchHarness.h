@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Minimal timing harness for gravel_bench. Each case runs a few untimed
+// warmup iterations, then a fixed number of timed ones, each preceded by an
+// untimed setup (e.g. copying the input a destructive stage works on).
+// Results are reported per element of the fixture so meshes of different
+// sizes compare, and can be written as JSON for regression tracking.
+//
+// Host memory is the MemoryTracker total: hostPeakBytes is how far the body
+// raised it above what was live when the body started, so only tracked
+// containers count.
+//
+// The pipeline stages log heavily to std::cout; the harness silences it
+// while a case runs so the log does not end up in the timings.
+class BenchHarness {
+public:
+    struct Options {
+        uint32_t    warmup     = 1;
+        uint32_t    iterations = 5;
+        std::string filter;          // run only cases whose name contains this
+    };
+
+    struct Result {
+        std::string name;            // stage, e.g. "halfedge_build"
+        std::string fixture;         // mesh, e.g. "bunny" or "grid_512"
+        std::string unit;            // what an element is, e.g. "face"
+        uint64_t    elements   = 0;
+        uint32_t    iterations = 0;
+        double      minNs      = 0.0;
+        double      medianNs   = 0.0;
+        double      meanNs     = 0.0;
+        uint64_t    hostPeakBytes = 0;  // largest over the timed iterations
+
+        double nsPerElement() const { return elements ? medianNs / double(elements) : 0.0; }
+    };
+
+    explicit BenchHarness(const Options& options);
+
+    bool enabled(const std::string& name) const;
+
+    // setup may be empty. Exceptions from either propagate after the log
+    // is restored.
+    void run(const std::string& name, const std::string& fixture,
+             const std::string& unit, uint64_t elements,
+             const std::function<void()>& setup,
+             const std::function<void()>& body);
+
+    const std::vector<Result>& results() const { return resultList; }
+
+    void printTable(std::ostream& out) const;
+    // Throws std::runtime_error if the file cannot be written
+    void writeJson(const std::string& path) const;
+
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+    };
+
+    Options options;
+    std::vector<Result> resultList;
+    NullBuffer nullBuffer;
+};
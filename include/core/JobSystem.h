@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Shared work-stealing scheduler for the CPU stages. Each worker owns a
+// deque it pushes to and pops from at the back; idle workers steal from the
+// front of the others'. Threads outside the pool (the render thread, the
+// GRWM job thread) submit through a shared injection queue, and a thread
+// waiting on a Counter runs queued tasks instead of blocking, so nested
+// parallelFor calls and a zero-worker pool both make progress.
+//
+// Vulkan calls must stay on the main thread: tasks only prepare data, and
+// the render loop polls their Counter and does the upload itself (see
+// Renderer::pollMeshLoad). Tasks must not wait on main-thread work.
+//
+// Long-running work that must not hold up a frame (mesh loads) goes through
+// submitBackground(): only idle workers pick it up, never a thread helping
+// in wait(), so the render thread's own parallelFor calls stay short. Tasks
+// a background task submits (its parallelFor chunks, task graph nodes) are
+// queued as background work as well.
+//
+// Scheduler activity shows up in the CPU trace as "job" zones on the
+// worker rows and as the "jobs queued" and "job steals" counters.
+class JobSystem {
+public:
+    using Task = std::function<void()>;
+
+    // Tasks submitted against a counter; wait() returns once all have run
+    // and rethrows the first exception any of them threw
+    class Counter {
+    public:
+        bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+        std::atomic<uint32_t> pending{0};
+        std::mutex            errorMutex;
+        std::exception_ptr    error;
+    };
+
+    struct Stats {
+        uint32_t workers = 0;
+        uint64_t tasksRun = 0;      // including ones run by waiting threads
+        uint64_t steals = 0;
+    };
+
+    // Worker count of the shared scheduler, before its first use. Without a
+    // call the GRAVEL_THREADS environment variable applies (total threads,
+    // caller included), else one worker per hardware thread but the caller's.
+    static void configure(uint32_t workerThreads);
+    static JobSystem& get();
+
+    explicit JobSystem(uint32_t workerThreads);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    uint32_t workerCount() const { return static_cast<uint32_t>(workers.size()); }
+    // Threads that run a parallelFor: the workers plus the caller
+    uint32_t threadCount() const { return workerCount() + 1; }
+
+    void submit(Task task, Counter& counter);
+    void wait(Counter& counter);
+    // Without workers the task runs inline before this returns
+    void submitBackground(Task task, Counter& counter);
+
+    // fn(begin, end) over [0, count) in contiguous chunks of at least
+    // minChunk, a few per thread so stealing can even out the load. The
+    // caller runs the last chunk itself, then helps until all are done.
+    template <typename Fn>
+    void parallelFor(size_t count, size_t minChunk, Fn&& fn);
+
+    Stats stats() const;
+
+private:
+    struct Job {
+        Task     fn;
+        Counter* counter = nullptr;
+        bool     background = false;
+    };
+
+    struct Queue {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+    };
+
+    void workerLoop(uint32_t index);
+    bool tryRunOne(int self);
+    bool tryRunBackground();
+    void pushBackground(Job job);
+    bool popJob(int self, Job& job);
+    void execute(Job& job);
+
+    std::vector<std::thread>            workers;
+    std::vector<std::unique_ptr<Queue>> queues;  // one per worker, then the injection queue
+    std::atomic<int64_t>                queued{0};
+    Queue                               background;
+    std::atomic<int64_t>                backgroundQueued{0};
+    std::atomic<bool>                   stopping{false};
+    std::mutex                          sleepMutex;
+    std::condition_variable             wake;
+
+    std::atomic<uint64_t> tasksRun{0};
+    std::atomic<uint64_t> steals{0};
+};
+
+// Tasks with dependencies. Nodes are submitted as soon as everything they
+// depend on has finished; after a failed node the remaining ones are skipped
+// and wait() rethrows. Build the graph, then run it once. A started graph
+// that is destroyed without wait() (an exception on the caller's side)
+// still waits for its nodes, discarding their errors.
+class TaskGraph {
+public:
+    using Node = uint32_t;
+
+    TaskGraph() = default;
+    ~TaskGraph();
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // name must be a string literal (it becomes the node's trace zone)
+    Node add(const char* name, JobSystem::Task fn, std::initializer_list<Node> dependsOn = {});
+
+    // start() submits the nodes without dependencies and returns, so the
+    // caller can do main-thread work while the graph runs
+    void start(JobSystem& jobs);
+    void wait(JobSystem& jobs);
+    void run(JobSystem& jobs) { start(jobs); wait(jobs); }
+
+private:
+    struct NodeData {
+        const char*           name;
+        JobSystem::Task       fn;
+        std::vector<Node>     successors;
+        uint32_t              dependencies = 0;
+        std::atomic<uint32_t> remaining{0};
+    };
+
+    void submitNode(JobSystem& jobs, Node node);
+
+    std::deque<NodeData> nodes;  // deque: stable addresses for the atomics
+    JobSystem*           system = nullptr;  // set by start()
+    JobSystem::Counter   counter;
+    std::atomic<bool>    failed{false};
+};
+
+template <typename Fn>
+void JobSystem::parallelFor(size_t count, size_t minChunk, Fn&& fn) {
+    size_t chunks = std::min<size_t>(4 * threadCount(), count / std::max<size_t>(1, minChunk));
+    if (chunks <= 1 || workers.empty()) {
+        if (count > 0) fn(size_t(0), count);
+        return;
+    }
+
+    Counter counter;
+    size_t chunk = (count + chunks - 1) / chunks;
+    size_t last = 0;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        size_t end = std::min(count, begin + chunk);
+        if (end == count) { last = begin; break; }
+        submit([&fn, begin, end]() { fn(begin, end); }, counter);
+    }
+    try {
+        fn(last, count);
+    } catch (...) {
+        wait(counter);
+        throw;
+    }
+    wait(counter);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Per-subsystem accounting of host memory held by the CPU-side mesh copies
+// the renderer keeps next to its GPU buffers. Containers opt in by using
+// TrackedVector<T, Tag>; data whose type belongs to another module (loaded
+// NGonMesh, skeleton and animation structs) is charged by footprint through
+// a Charge that lives as long as the data does.
+//
+// Counters are process-wide atomics, so charging from worker threads is
+// safe. Peaks are high-water marks since the last resetPeaks().
+enum class MemTag : uint32_t {
+    MeshLoad,   // transient loader output (NGonMesh) while a mesh is built
+    HalfEdge,   // HalfEdgeMesh SoA arrays
+    CpuMesh,    // renderer's CPU mesh copies for stats, culling and export
+    Culling,    // visible element lists
+    Skinning,   // joint data, skeleton and (baked) animations
+    Mask,       // mask texture pixels kept on the CPU
+    Count
+};
+
+class MemoryTracker {
+public:
+    struct Stats {
+        uint64_t current = 0;
+        uint64_t peak = 0;
+        uint64_t allocations = 0;  // lifetime count
+    };
+
+    static void onAlloc(MemTag tag, size_t bytes);
+    static void onFree(MemTag tag, size_t bytes);
+
+    static Stats stats(MemTag tag);
+    static uint64_t totalCurrent();
+    // Largest sum of per-tag current bytes seen since the last resetPeaks()
+    static uint64_t totalPeak();
+    // Sets every peak (and the total's) back to the current usage
+    static void resetPeaks();
+
+    static const char* tagName(MemTag tag);  // "mesh load", "half-edge", ...
+
+    // Footprint charge: holds `bytes` against a tag until reset or destroyed
+    class Charge {
+    public:
+        explicit Charge(MemTag tag, size_t bytes = 0) : tag(tag), bytes(bytes) { if (bytes) onAlloc(tag, bytes); }
+        ~Charge() { if (bytes) onFree(tag, bytes); }
+        Charge(Charge&& other) noexcept : tag(other.tag), bytes(other.bytes) { other.bytes = 0; }
+        Charge& operator=(Charge&& other) noexcept;
+        Charge(const Charge&) = delete;
+        Charge& operator=(const Charge&) = delete;
+
+        void reset(size_t newBytes = 0);
+        size_t size() const { return bytes; }
+
+    private:
+        MemTag tag;
+        size_t bytes;
+    };
+
+    // Heap bytes owned by a vector, for charging untracked containers
+    template<typename T, typename A>
+    static size_t capacityBytes(const std::vector<T, A>& v) { return v.capacity() * sizeof(T); }
+};
+
+// std::allocator with its traffic charged to Tag. Stateless, so tracked
+// vectors swap and move like plain ones; copying into a vector with a
+// different allocator needs assign(begin, end).
+template<typename T, MemTag Tag>
+struct TrackedAllocator {
+    using value_type = T;
+
+    TrackedAllocator() noexcept = default;
+    template<typename U>
+    TrackedAllocator(const TrackedAllocator<U, Tag>&) noexcept {}
+
+    template<typename U>
+    struct rebind { using other = TrackedAllocator<U, Tag>; };
+
+    T* allocate(size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        MemoryTracker::onAlloc(Tag, n * sizeof(T));
+        return p;
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        MemoryTracker::onFree(Tag, n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const TrackedAllocator<U, Tag>&) const noexcept { return true; }
+};
+
+template<typename T, MemTag Tag>
+using TrackedVector = std::vector<T, TrackedAllocator<T, Tag>>;
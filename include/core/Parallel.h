@@ -0,0 +1,18 @@
+#pragma once
+
+#include "core/JobSystem.h"
+
+#include <cstddef>
+#include <utility>
+
+// Run fn(begin, end) over [0, count) on the shared job system (see
+// JobSystem::parallelFor). Ranges smaller than two minChunk run inline.
+template <typename Fn>
+void parallelFor(size_t count, size_t minChunk, Fn&& fn) {
+    JobSystem::get().parallelFor(count, minChunk, std::forward<Fn>(fn));
+}
+
+// Threads a parallelFor spreads over, for callers that split work by hand
+inline size_t parallelThreadCount() {
+    return JobSystem::get().threadCount();
+}
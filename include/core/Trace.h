@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Scoped-zone CPU tracer. TRACE_ZONE("name") records the enclosing scope
+// as one complete event into a ring buffer owned by the calling thread, so
+// recording takes no shared lock; the oldest events are overwritten once a
+// thread has logged kRingCapacity of them. Dumps are Chrome trace-event
+// JSON (chrome://tracing, ui.perfetto.dev).
+//
+// TRACE_COUNTER("name", value) samples a value over time (a counter track
+// in the viewer), e.g. a queue depth.
+//
+// With GRAVEL_TRACING off the macros expand to nothing. Zone and counter
+// names are stored by pointer and must be string literals.
+class Trace {
+public:
+    static constexpr size_t kRingCapacity = 1 << 16;  // events per thread
+
+    class Zone {
+    public:
+        explicit Zone(const char* name) : name(name), startNs(isEnabled() ? nowNs() : 0) {}
+        ~Zone() { if (startNs) record(name, startNs, nowNs()); }
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name;
+        uint64_t    startNs;
+    };
+
+    // Nanoseconds since the first call, on the steady clock (never 0)
+    static uint64_t nowNs();
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+    static void counter(const char* name, int64_t value);
+    // Labels the calling thread's row in the trace; threads that exit hand
+    // their buffer and row to the next new thread
+    static void setThreadName(const char* name);
+
+    // Runtime switch on top of the compile-time one (on by default)
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    static void clear();
+    static size_t eventCount();
+    // Throws std::runtime_error if the file cannot be written
+    static void writeChromeJson(const std::string& path);
+};
+
+#if GRAVEL_TRACING
+#define GRAVEL_TRACE_CONCAT_(a, b) a##b
+#define GRAVEL_TRACE_CONCAT(a, b) GRAVEL_TRACE_CONCAT_(a, b)
+#define TRACE_ZONE(name) Trace::Zone GRAVEL_TRACE_CONCAT(traceZone_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) Trace::setThreadName(name)
+#define TRACE_COUNTER(name, value) (Trace::isEnabled() ? Trace::counter(name, value) : (void)0)
+#else
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/MemoryTracker.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+// CPU pre-cull of resurfacing elements: the mask, frustum and backface tests
+// the task shader would otherwise make per element, run once per camera or
+// settings change so only visible elements are dispatched. Faces are element
+// ids [0, nbFaces), vertices follow at nbFaces + i; in slot mode each visible
+// face contributes slotK consecutive ids and vertices are skipped.
+class ElementCull {
+public:
+    using VisibleList = TrackedVector<uint32_t, MemTag::Culling>;
+
+    // Base mesh elements as uploadHalfEdgeMesh keeps them; not owned
+    struct Elements {
+        const glm::vec3* faceCenters      = nullptr;
+        const glm::vec3* faceNormals      = nullptr;
+        const float*     faceAreas        = nullptr;
+        const glm::vec2* faceUVs          = nullptr;
+        uint32_t         nbFaces          = 0;
+        const glm::vec3* vertexPositions  = nullptr;
+        const glm::vec3* vertexNormals    = nullptr;
+        const float*     vertexFaceAreas  = nullptr;
+        const glm::vec2* vertexUVs        = nullptr;
+        uint32_t         nbVertices       = 0;
+    };
+
+    struct Settings {
+        glm::mat4 mvp   = glm::mat4(1.0f);
+        glm::mat4 model = glm::mat4(1.0f);
+        glm::vec3 cameraPosition = glm::vec3(0.0f);
+        bool      frustumCulling  = false;
+        bool      backfaceCulling = false;
+        float     cullingThreshold = 0.0f;
+        float     userScaling = 1.0f;
+        uint32_t  slotK = 0;               // > 0: slot placement mode
+        bool      faceElementsOnly = false;  // chainmail: no vertex elements
+
+        const uint8_t* maskPixels = nullptr;  // R channel; null = no mask
+        uint32_t       maskWidth  = 0;
+        uint32_t       maskHeight = 0;
+
+        uint32_t maxVisible = UINT32_MAX;  // ids past this are dropped
+    };
+
+    // Replaces visible with the ids that pass, in element order. Returns the
+    // number of unmasked element ids, visible or not. Large meshes are culled
+    // in parallel blocks on the job system.
+    static uint32_t run(const Elements& elements, const Settings& settings,
+                        VisibleList& visible);
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+// Weld template for a parametric element's (M+1)x(N+1) vertex grid. The
+// seams and poles are known from the surface type, so coincident vertices
+// are merged by index: a whole v = 0 / v = 1 row onto its first vertex at a
+// pole and, when seams are welded too, u = 1 onto u = 0 for surfaces closed
+// in u and v = 1 onto v = 0 for the torus. Triangles that collapse are
+// dropped. Every element of a type welds the same way, so one template
+// serves a whole export.
+//
+// Seam vertices share position and normal but not UV (u = 1 against u = 0),
+// so by default they stay split and textures map as exported unwelded. A
+// welded seam keeps the u = 0 (or v = 0) vertex's UV, which stretches the
+// last quad column's texture back across the whole atlas. A pole keeps its
+// first vertex's UV and normal.
+class GridWeld {
+public:
+    struct Topology {
+        bool periodicU = false;
+        bool periodicV = false;
+        bool poleV0 = false;   // v = 0 row is a single point
+        bool poleV1 = false;   // v = 1 row is a single point
+    };
+
+    // Seams and poles of the surfaces in parametricSurfaces.glsl
+    static Topology topologyFor(uint32_t elementType);
+
+    // weldSeams also merges the periodic seams, for consumers that need a
+    // closed manifold more than correct UVs along the seam
+    void build(uint32_t M, uint32_t N, const Topology& topology, bool weldSeams);
+
+    uint32_t gridVertexCount() const { return gridVertices; }
+    uint32_t vertexCount() const { return static_cast<uint32_t>(keptVertices.size()); }
+    uint32_t triangleCount() const { return static_cast<uint32_t>(indices.size() / 3); }
+
+    // Weld elementCount grids laid out back to back (as the export shader
+    // writes them) into compact outputs, one element per task in parallel.
+    // Output indices are batch-local like the input's.
+    void apply(const glm::vec4* positions, const glm::vec4* normals, const glm::vec2* uvs,
+               uint32_t elementCount,
+               std::vector<glm::vec4>& outPositions, std::vector<glm::vec4>& outNormals,
+               std::vector<glm::vec2>& outUVs, std::vector<uint32_t>& outIndices) const;
+
+private:
+    uint32_t gridVertices = 0;
+    std::vector<uint32_t> keptVertices;  // grid index of each welded vertex
+    std::vector<uint32_t> indices;       // welded triangles, element-local
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Static 3D k-d tree over a point set, stored implicitly: each range
+// [lo, hi) is split at its median on the widest axis, so the tree is the
+// permuted point array plus one split axis per node. O(N log N) build,
+// O(log N) expected nearest-neighbour query; queries are const and can
+// run concurrently from many threads.
+class KdTree {
+public:
+    void build(const std::vector<glm::vec3>& points);
+    void clear();
+
+    size_t size() const { return points.size(); }
+    bool empty() const { return points.empty(); }
+
+    // Index (into the build array) of the nearest point, or SIZE_MAX if empty
+    // or no point is at a finite distance (NaN or infinite coordinates).
+    // outDistSq receives the squared distance when non-null and found.
+    size_t nearest(const glm::vec3& query, float* outDistSq = nullptr) const;
+
+private:
+    void buildRange(const std::vector<glm::vec3>& input, size_t lo, size_t hi);
+    void nearestRange(size_t lo, size_t hi, const glm::vec3& query,
+                      size_t& bestSlot, float& bestDistSq) const;
+
+    std::vector<glm::vec3> points;   // permuted into tree order
+    std::vector<uint32_t>  indices;  // tree slot -> original point index
+    std::vector<uint8_t>   axes;     // split axis of the node at each median slot
+};
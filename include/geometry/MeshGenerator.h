@@ -0,0 +1,56 @@
+#pragma once
+
+#include "geometry/HalfEdge.h"
+#include "loaders/ObjLoader.h"
+
+#include <string>
+#include <cstdint>
+
+// Procedural base meshes at arbitrary resolution, for stress tests and
+// benchmarks well past the size of the shipped assets. Shapes are built as
+// indexed polygons with shared vertices and linked straight into the
+// half-edge SoA (twins found through per-vertex outgoing lists, no edge
+// map), so multi-million-face meshes take a fraction of an OBJ round trip.
+//
+// All shapes are manifold with faces counter-clockwise seen from outside;
+// grids and tilings lie in the XZ plane facing +Y. UVs are not split at
+// seams, so closed shapes keep one vertex per position.
+class MeshGenerator {
+public:
+    enum class Shape {
+        Grid,            // resolution^2 quads
+        Icosphere,       // geodesic, 20 * resolution^2 triangles
+        QuadSphere,      // spherified cube, 6 * resolution^2 quads
+        Torus,           // resolution (at least 3) segments around the tube and
+                         // about size / minorRadius times as many around the
+                         // ring (at least 3), so the quads stay near square:
+                         // 4 * resolution^2 quads at the default radii
+        PentagonTiling,  // the ground plane's pentagon pairs, resolution^2
+                         // faces; an odd resolution ends in a column of quads
+        MixedTiling,     // cell pairs randomly left as quads, split into
+                         // triangles or turned into pentagons
+    };
+
+    struct Settings {
+        Shape    shape       = Shape::Grid;
+        uint32_t resolution  = 64;
+        float    size        = 1.0f;    // radius, torus major radius or plane side
+        float    minorRadius = 0.25f;   // torus tube radius
+        // Displacement along the normal by fractal value noise, as a
+        // fraction of size; 0 keeps the exact shape
+        float    noiseAmplitude = 0.0f;
+        float    noiseFrequency = 4.0f;  // base octave cycles per size
+        uint32_t seed        = 1;        // noise and MixedTiling choices
+    };
+
+    // Face normals are Newell normals, vertex normals area-weighted; face
+    // colors (faceNormals w) are left for computeFace2Coloring.
+    static HalfEdgeMesh generate(const Settings& settings);
+
+    // Same mesh as a loaded NGonMesh, for the stages that take one
+    // (triangulate, subdivide, HalfEdgeBuilder)
+    static NGonMesh generateNGon(const Settings& settings);
+
+    static const char* shapeName(Shape shape);  // "grid", "icosphere", ...
+    static bool parseShape(const std::string& name, Shape& shape);
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+// Partitions indexed triangles into meshlets for mesh-shader consumers.
+// A meshlet grows by the adjacent triangle that adds the fewest new
+// vertices (ties go to the one nearest the meshlet's centroid), so grids
+// come out as compact tiles rather than strips, and closes at the vertex or
+// triangle limit.
+//
+// Export batches are runs of independent pieces (elements, pebble patches)
+// with disjoint vertex ranges. The input is split at piece boundaries into
+// chunks built in parallel; meshlets may gather several small neighbouring
+// pieces but never span chunks.
+class MeshletBuilder {
+public:
+    static constexpr uint32_t MAX_VERTICES  = 64;
+    static constexpr uint32_t MAX_TRIANGLES = 124;
+
+    struct Meshlet {
+        glm::vec3 center;        // bounding sphere
+        float     radius;
+        glm::vec3 coneApex;      // normal cone: the meshlet is backfacing from
+        float     coneCutoff;    // camera c when dot(normalize(coneApex - c), coneAxis) >= coneCutoff
+        glm::vec3 coneAxis;
+        uint32_t  vertexOffset;  // into Result::vertices
+        uint32_t  triangleOffset;  // into Result::triangles, in triangles
+        uint32_t  vertexCount;
+        uint32_t  triangleCount;
+    };
+
+    struct Result {
+        std::vector<Meshlet>  meshlets;
+        std::vector<uint32_t> vertices;   // meshlet-local slot -> input vertex index
+        std::vector<uint8_t>  triangles;  // 3 local slots per triangle
+
+        void clear();
+    };
+
+    // Output vertex indices are the input's; meshlets follow the input
+    // triangle order.
+    static void build(const glm::vec4* positions, const uint32_t* indices,
+                      uint32_t triangleCount, Result& out);
+
+private:
+    static void buildChunk(const glm::vec4* positions, const uint32_t* indices,
+                           uint32_t firstTriangle, uint32_t triangleCount, Result& out);
+    static void computeBounds(const glm::vec4* positions, const Result& result, Meshlet& meshlet);
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "geometry/ParametricSurface.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+// CPU port of getLodMN in lods.glsl, for exporting what one view shows:
+// every element gets the square grid resolution the task shader would draw
+// it at under a given MVP, optionally scaled down to fit a triangle budget.
+//
+// Elements are returned grouped by resolution (ascending element id within
+// a group), so an export can process each group with fixed-size batches.
+class ParametricLod {
+public:
+    struct Settings {
+        glm::mat4 mvp            = glm::mat4(1.0f);  // view the export should match
+        uint32_t  baseResolution = 8;     // push.resolutionM
+        float     lodFactor      = 1.0f;
+        uint32_t  minResolution  = 2;     // as parametric.task passes to getLodMN
+        uint32_t  maxResolution  = 64;
+        uint64_t  triangleBudget = 0;     // 0 = no budget
+    };
+
+    // Elements drawn at one resolution (M = N)
+    struct Run {
+        uint32_t resolution;
+        uint32_t first;   // into Result::elements
+        uint32_t count;
+    };
+
+    struct Result {
+        std::vector<uint32_t> elements;  // element ids, grouped by run
+        std::vector<Run>      runs;      // ascending resolution
+        uint64_t triangles   = 0;
+        float    budgetScale = 1.0f;     // lodFactor multiplier the budget needed
+    };
+
+    // surface supplies the element shape (its 3x3 sample grid gives the
+    // bounding box parametricBoundingBox takes); resolutions are independent
+    // of its own M and N. Throws like ParametricSurface for a missing LUT.
+    static Result compute(const ParametricSurface::Params& surface,
+                          const ParametricSurface::ElementFrames& frames,
+                          const Settings& settings);
+
+    // computeScreenSpaceSize: largest NDC extent of the element's local box
+    static float screenSpaceSize(const glm::vec3& boxMin, const glm::vec3& boxMax,
+                                 const ParametricSurface::ElementFrame& frame,
+                                 float userScaling, const glm::mat4& mvp);
+
+    // computeLodResolution
+    static uint32_t resolution(float screenSize, const Settings& settings, float factorScale = 1.0f);
+};
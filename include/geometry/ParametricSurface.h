@@ -0,0 +1,120 @@
+#pragma once
+
+#include "core/MemoryTracker.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+struct HalfEdgeMesh;
+
+// CPU reference for the parametric elements: evaluateParametricSurface in
+// parametricSurfaces.glsl for every element type, and the offsetVertex /
+// offsetVertexChainmail transforms in common.glsl. Output matches what
+// parametric_export.comp writes (up to float rounding), so export works
+// without a GPU and the compute path can be checked against it.
+//
+// The (M+1)x(N+1) grid is evaluated a row at a time from per-column trig
+// tables, in separate x/y/z arrays so the inner loops vectorize. Surfaces
+// whose shape does not depend on the element (everything except randomised
+// straws and studs) are evaluated once and only transformed per element.
+class ParametricSurface {
+public:
+    struct Params {
+        uint32_t elementType  = 0;
+        uint32_t resolutionM  = 8;
+        uint32_t resolutionN  = 8;
+        float    userScaling  = 1.0f;
+        float    torusMajorR  = 1.0f;
+        float    torusMinorR  = 0.3f;
+        float    sphereRadius = 0.5f;
+
+        bool  chainmailMode          = false;
+        float chainmailTiltAngle     = 0.0f;
+        float chainmailSurfaceOffset = 0.0f;
+
+        // Dragon scale control grid: lutNx * lutNy points, row-major in v
+        const glm::vec4* lutPoints = nullptr;
+        uint32_t  lutNx = 0;
+        uint32_t  lutNy = 0;
+        glm::vec3 lutMinExtent = glm::vec3(0.0f);
+        glm::vec3 lutMaxExtent = glm::vec3(1.0f);
+
+        float strawTaperPower     = 2.0f;
+        float strawBendAmount     = 0.3f;
+        float strawBaseRadius     = 0.05f;
+        float strawBendDirection  = 0.0f;
+        float strawBendRandomness = 0.0f;
+
+        float studElongation         = 3.0f;
+        float studHeight             = 0.15f;
+        float studPower              = 2.0f;
+        float studRotation           = 0.0f;
+        float studRotationRandomness = 0.0f;
+        bool  studTreadPlate         = false;
+    };
+
+    // Per-element inputs as parametric_export.comp fetches them
+    struct ElementFrame {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec3 edgeTangent;
+        float     area      = 0.0f;
+        float     faceColor = 0.0f;  // already flipped for vertex elements
+    };
+
+    // Frames for every element of the mesh, faces first then vertices (the
+    // element ids the task and export shaders use)
+    using ElementFrames = TrackedVector<ElementFrame, MemTag::CpuMesh>;
+    static ElementFrames buildFrames(const HalfEdgeMesh& mesh);
+
+    // Throws std::runtime_error for a dragon scale without a usable LUT
+    explicit ParametricSurface(const Params& params);
+
+    uint32_t vertsPerElement() const { return (M + 1) * (N + 1); }
+    uint32_t trisPerElement() const { return M * N * 2; }
+
+    // Local-space surface for one element, before scaling and orientation.
+    // Point (u, v) of the grid is at index v * (M + 1) + u.
+    void evaluateLocal(uint32_t elementId, float faceColor,
+                       glm::vec3* positions, glm::vec3* normals) const;
+
+    // Export layout for elements [firstElement, firstElement + count) of
+    // frames: vertsPerElement() vertices and trisPerElement() triangles per
+    // element, back to back, with indices relative to this range. Elements
+    // run in parallel.
+    void evaluateElementRange(const ElementFrames& frames,
+                              uint32_t firstElement, uint32_t count,
+                              glm::vec4* positions, glm::vec4* normals,
+                              glm::vec2* uvs, uint32_t* indices) const;
+
+    // Same for the listed elements (e.g. one LOD run), in list order
+    void evaluateElementList(const ElementFrames& frames,
+                             const uint32_t* elementIds, uint32_t count,
+                             glm::vec4* positions, glm::vec4* normals,
+                             glm::vec2* uvs, uint32_t* indices) const;
+
+private:
+    // Grid in separate component arrays
+    struct Grid {
+        std::vector<float> px, py, pz, nx, ny, nz;
+        void resize(size_t n);
+    };
+
+    bool shapeVariesPerElement() const;
+    void evaluateElements(const ElementFrames& frames,
+                          const uint32_t* elementIds, uint32_t firstElement, uint32_t count,
+                          glm::vec4* positions, glm::vec4* normals,
+                          glm::vec2* uvs, uint32_t* indices) const;
+    void evaluateGrid(uint32_t elementId, float faceColor, Grid& grid) const;
+    void evaluateDragonScale(Grid& grid) const;
+    void transformElement(const Grid& grid, const ElementFrame& frame,
+                          glm::vec4* positions, glm::vec4* normals) const;
+
+    Params   params;
+    uint32_t M = 0, N = 0;
+    std::vector<float> gridU, gridV;   // uv coordinates of the grid columns/rows
+    std::vector<float> cosU, sinU;     // of gridU * 2pi, shared by the revolved surfaces
+    Grid sharedGrid;                   // when the shape is the same for every element
+    std::vector<uint32_t> gridIndices; // element-local triangles, export quad split
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+// CPU port of the pebble task/mesh shaders (pebble.task, pebble.mesh), for
+// export without a mesh-shader GPU. Per face: a plain extrusion at
+// subdivision level 0, otherwise 3 rings x 2 patches per edge of cubic
+// B-spline patches over the ring control cage (with adjustedVertexPos
+// compensation and the subdivOffset edge stitching), plus the inner fill
+// fans; then the pathway fade and Perlin noise of emitVertex.
+//
+// Each patch is emitted as one (2^(N-1) + 1)^2 grid, so sub-patches the GPU
+// splits across workgroups share their boundary vertices here. There is no
+// LOD, culling or skinning; export captures the rest pose.
+class PebbleGenerator {
+public:
+    static constexpr uint32_t MAX_SUBDIVISION_LEVEL = 9;  // pebble.glsl
+
+    // The PebbleUBO fields that shape the geometry
+    struct Params {
+        uint32_t subdivisionLevel        = 3;
+        uint32_t subdivOffset            = 0;
+        float    extrusionAmount         = 0.1f;
+        float    extrusionVariation      = 0.5f;
+        float    roundness               = 2.0f;
+        uint32_t normalCalculationMethod = 1;     // 0 = cage cross products, 1 = explicit
+        float    fillradius              = 0.0f;
+        float    ringoffset              = 0.3f;
+
+        bool  doNoise        = false;
+        float noiseAmplitude = 0.01f;
+        float noiseFrequency = 5.0f;
+        float normalOffset   = 0.2f;
+
+        bool      usePathway       = false;
+        float     pathwayRadius    = 4.0f;
+        float     pathwayBackScale = 0.35f;
+        float     pathwayFalloff   = 2.0f;
+        glm::vec3 playerWorldPos   = glm::vec3(0.0f);
+        glm::vec3 playerForward    = glm::vec3(0.0f, 0.0f, -1.0f);
+    };
+
+    // Base mesh faces as the shaders read them; not owned
+    struct Faces {
+        const glm::vec3* vertexPositions = nullptr;
+        const glm::vec3* faceCenters     = nullptr;
+        const glm::vec3* faceNormals     = nullptr;
+        const uint32_t*  faceVertOffsets = nullptr;  // nbFaces + 1
+        const uint32_t*  faceVertIndices = nullptr;  // corners in half-edge order
+        uint32_t         nbFaces         = 0;
+    };
+
+    // One thread's output: whole faces in order, indices local to the arena
+    struct Arena {
+        std::vector<glm::vec4> positions;  // w = 1
+        std::vector<glm::vec4> normals;    // w = 0
+        std::vector<glm::vec2> uvs;        // patch uv; fills and extrusions use 0
+        std::vector<uint32_t>  indices;
+
+        void clear();
+        uint32_t vertexCount() const { return static_cast<uint32_t>(positions.size()); }
+        uint32_t triangleCount() const { return static_cast<uint32_t>(indices.size() / 3); }
+    };
+
+    PebbleGenerator(const Params& params, const Faces& faces);
+
+    uint32_t faceCount() const { return faces.nbFaces; }
+
+    // Exact output of one face (zero if it has < 3 corners or the pathway
+    // fades it out), for sizing files and batches up front
+    uint64_t faceVertexCount(uint32_t face) const;
+    uint64_t faceTriangleCount(uint32_t face) const;
+
+    // Faces [firstFace, firstFace + count), split into contiguous runs
+    // generated in parallel. arenas is resized to the number of runs and
+    // run i goes to arenas[i], so appending them in order keeps face order.
+    void generate(uint32_t firstFace, uint32_t count, std::vector<Arena>& arenas) const;
+
+private:
+    struct FaceFrame {
+        glm::vec3 center;
+        glm::vec3 normal;
+        float     extrusion;  // randomised per face
+        float     scale;      // pathway fade; 0 when the face is dropped
+    };
+
+    FaceFrame faceFrame(uint32_t face) const;
+    uint32_t cornerCount(uint32_t face) const;
+    glm::vec3 corner(uint32_t face, uint32_t i) const;
+
+    void generateFace(uint32_t face, Arena& out) const;
+    void generateExtrusion(uint32_t face, const FaceFrame& frame, Arena& out) const;
+    void generateEdgePatch(uint32_t face, const FaceFrame& frame, uint32_t ring, uint32_t patch,
+                           Arena& out) const;
+    void generateFillPatch(uint32_t face, const FaceFrame& frame, uint32_t patch, Arena& out) const;
+    void emitVertex(const FaceFrame& frame, glm::vec3 pos, glm::vec3 normal, glm::vec2 uv,
+                    Arena& out) const;
+
+    Params   params;
+    Faces    faces;
+    uint32_t level = 0;           // subdivisionLevel, clamped
+    uint32_t patchResolution = 0; // edge patch grid side, 2^(level-1) + 1
+    uint32_t fillResolution = 0;  // fill curve vertices per half edge
+    std::vector<float> bsplineWeights;  // 4 per patch grid column, shared by rows
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Indexed triangle mesh, as the export writers produce it
+struct TriangleMesh {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;    // empty if the file has none
+    std::vector<glm::vec2> uvs;        // empty if the file has none
+    std::vector<uint32_t>  indices;    // 3 per triangle
+};
+
+// Reads .glb, binary little-endian .ply and .gmlt meshes straight from a
+// memory map: attribute data is copied out of the file without any text
+// parsing. GLB primitives (triangle lists, float attributes) are concatenated
+// without node transforms; PLY faces with more than three corners are
+// fan-split; GMLT meshlets are flattened back into one index list.
+class BinaryMeshLoader {
+public:
+    static bool canLoad(const std::string& filepath);  // by extension
+
+    // Throws std::runtime_error on malformed or unsupported files
+    static TriangleMesh load(const std::string& filepath);
+    static TriangleMesh loadGlb(const std::string& filepath);
+    static TriangleMesh loadPly(const std::string& filepath);
+    static TriangleMesh loadGmlt(const std::string& filepath);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "loaders/MeshStreamWriter.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Binary glTF 2.0 export: one mesh with POSITION, NORMAL, TEXCOORD_0 and
+// uint32 indices, each a tightly packed section of a single BIN chunk.
+// Section offsets follow from the totals given to open(), so every batch
+// is written in place with no text formatting. The JSON chunk is reserved
+// up front and rewritten on close() with the final POSITION bounds.
+class GlbWriter {
+public:
+    class Stream : public MeshStreamWriter {
+    public:
+        void open(const std::string& filepath, uint64_t totalVertices, uint64_t totalTriangles) override;
+        void appendBatch(const glm::vec4* positions,
+                         const glm::vec4* normals,
+                         const glm::vec2* uvs,
+                         const uint32_t* indices,
+                         uint32_t numVertices,
+                         uint32_t numTriangles) override;
+        void close() override;
+
+        bool isOpen() const override { return file.is_open(); }
+        uint64_t verticesWritten() const override { return vertexBase; }
+
+    private:
+        std::string buildJson() const;
+        void writeAt(uint64_t offset, const void* data, size_t size);
+
+        std::ofstream file;
+        std::string path;
+        uint64_t totalVertices = 0;
+        uint64_t totalTriangles = 0;
+        uint64_t vertexBase = 0;
+        uint64_t triangleBase = 0;
+        uint32_t jsonChunkLength = 0;  // reserved, padded with spaces
+        uint64_t binStart = 0;         // file offset of the BIN chunk data
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+        double writeSeconds = 0.0;
+        std::vector<uint8_t> scratch;  // vec4 -> vec3 packing, rebased indices
+    };
+};
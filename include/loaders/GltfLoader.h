@@ -2,6 +2,9 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include "loaders/ObjLoader.h"
+#include "core/MemoryTracker.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -28,6 +31,8 @@ struct Skeleton {
     glm::mat4 skinNodeGlobalInverse = glm::mat4(1.0f); // inverse(mesh node global transform)
     glm::mat4 objAlignTransform = glm::mat4(1.0f);     // glTF mesh-local → OBJ space
     glm::mat4 objAlignInverse = glm::mat4(1.0f);       // OBJ → glTF mesh-local space
+
+    size_t sizeBytes() const;  // heap footprint
 };
 
 struct KeyFrame {
@@ -51,6 +56,35 @@ struct Animation {
     std::string name;
     float duration = 0.0f;
     std::vector<AnimationChannel> channels;
+
+    size_t sizeBytes() const;  // heap footprint
+};
+
+// Animation pre-sampled at a fixed rate into final bone matrices.
+// Frame-major layout: frames[frame * boneCount + bone]. Empty (frameCount == 0)
+// when the clip did not fit the bake budget and must be evaluated live.
+struct BakedAnimation {
+    float sampleRate = 30.0f;
+    float duration = 0.0f;
+    uint32_t frameCount = 0;
+    uint32_t boneCount = 0;
+    TrackedVector<glm::mat4, MemTag::Skinning> frames;
+
+    bool valid() const { return frameCount > 0; }
+    size_t sizeBytes() const { return frames.size() * sizeof(glm::mat4); }
+};
+
+// Per-vertex JOINTS_0 / WEIGHTS_0, charged to MemTag::Skinning
+using JointData = TrackedVector<glm::vec4, MemTag::Skinning>;
+
+// Nearest-vertex correspondence from OBJ vertices to flattened glTF vertices.
+// Built once by buildVertexMatch and shared by the bone and UV matchers.
+struct GltfVertexMatch {
+    struct PrimitiveRef { int mesh; int primitive; };
+    std::vector<PrimitiveRef> primitives;  // primitives with POSITION, in flatten order
+    std::vector<uint32_t> gltfPrim;        // per glTF vertex: slot in primitives
+    std::vector<uint32_t> gltfVert;        // per glTF vertex: index within its primitive
+    std::vector<size_t> objToGltf;         // per OBJ vertex: glTF vertex (SIZE_MAX = none)
 };
 
 // ============================================================================
@@ -59,9 +93,18 @@ struct Animation {
 
 class GltfLoader {
 public:
-    // Load a .gltf file and return the tinygltf model
+    // Load a .gltf or .glb file and return the tinygltf model
+    // (.glb is parsed straight from a memory map of the file)
     static tinygltf::Model loadModel(const std::string& filepath);
 
+    // Build a base mesh directly from the model's triangle primitives:
+    // POSITION, NORMAL, TEXCOORD_0 and indices, plus JOINTS_0 / WEIGHTS_0 per
+    // vertex (zero for unskinned primitives). Skinned primitives stay in
+    // mesh-local bind space; static ones get their node's global transform.
+    static NGonMesh loadMesh(const tinygltf::Model& model,
+                             JointData& jointIndices,
+                             JointData& jointWeights);
+
     // Extract skeleton hierarchy from the first skin
     static void extractSkeleton(const tinygltf::Model& model, Skeleton& skeleton);
 
@@ -78,15 +121,54 @@ public:
     static void computeBoneMatrices(const Skeleton& skeleton,
                                     std::vector<glm::mat4>& boneMatrices);
 
-    // Match glTF vertex positions to OBJ vertex positions (O(n^2))
-    // and transfer joint indices + weights
+    // Sample an animation at sampleRate (frames/s) into final bone matrices.
+    // Returns false and leaves baked empty if it would exceed maxBytes.
+    // Clips bake independently and may run in parallel.
+    static bool bakeAnimation(const Animation& animation, const Skeleton& skeleton,
+                              float sampleRate, size_t maxBytes,
+                              BakedAnimation& baked);
+    // Size bakeAnimation needs for the clip, for budgeting ahead of a bake
+    static size_t bakedSizeBytes(const Animation& animation, const Skeleton& skeleton,
+                                 float sampleRate);
+
+    // Bake every clip that fits budgetBytes, in clip order; the rest stay
+    // empty and fall back to live evaluation. baked ends up parallel to animations.
+    static void bakeAnimations(const std::vector<Animation>& animations, const Skeleton& skeleton,
+                               float sampleRate, size_t budgetBytes,
+                               std::vector<BakedAnimation>& baked);
+
+    // Fetch bone matrices from a bake: blend the two nearest frames, or pick
+    // the nearest one when interpolate is false
+    static void sampleBakedAnimation(const BakedAnimation& baked, float time,
+                                     bool interpolate,
+                                     std::vector<glm::mat4>& boneMatrices);
+
+    // Align glTF positions onto the OBJ (AABB fit, stored in the skeleton unless
+    // already set), index them in a k-d tree and find each OBJ vertex's nearest
+    // glTF vertex in parallel. O(N log N) regardless of how well the meshes agree.
+    static void buildVertexMatch(const tinygltf::Model& model,
+                                 const std::vector<glm::vec3>& objPositions,
+                                 Skeleton& skeleton,
+                                 GltfVertexMatch& match);
+
+    // Transfer JOINTS_0 / WEIGHTS_0 through a prebuilt match
+    static void matchBoneDataToObjMesh(const tinygltf::Model& model,
+                                       const GltfVertexMatch& match,
+                                       JointData& jointIndices,
+                                       JointData& jointWeights);
+
+    // Transfer TEXCOORD_0 through a prebuilt match
+    static void matchUVsToObjMesh(const tinygltf::Model& model,
+                                  const GltfVertexMatch& match,
+                                  std::vector<glm::vec2>& outUVs);
+
+    // Convenience overloads that build their own match
     static void matchBoneDataToObjMesh(const tinygltf::Model& model,
                                        const std::vector<glm::vec3>& objPositions,
                                        Skeleton& skeleton,
-                                       std::vector<glm::vec4>& jointIndices,
-                                       std::vector<glm::vec4>& jointWeights);
+                                       JointData& jointIndices,
+                                       JointData& jointWeights);
 
-    // Extract TEXCOORD_0 from glTF and match to OBJ vertex positions
     static void matchUVsToObjMesh(const tinygltf::Model& model,
                                    const std::vector<glm::vec3>& objPositions,
                                    const Skeleton& skeleton,
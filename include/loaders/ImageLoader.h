@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -13,4 +14,6 @@ struct ImageData {
 class ImageLoader {
 public:
     static ImageData load(const std::string& filepath);
+    // Decode an encoded image already in memory; name is only for messages
+    static ImageData loadFromMemory(const uint8_t* data, size_t size, const std::string& name);
 };
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+enum class MeshFileFormat { Obj = 0, Glb = 1, Ply = 2, Meshlet = 3 };
+
+// Export file writer fed one batch of triangles at a time. Batches arrive in
+// order with 0-based indices into their own vertices; the writer rebases
+// them. Vertex and triangle totals are fixed up front so binary formats can
+// lay the file out before any data arrives.
+class MeshStreamWriter {
+public:
+    virtual ~MeshStreamWriter() = default;
+
+    virtual void open(const std::string& filepath, uint64_t totalVertices, uint64_t totalTriangles) = 0;
+    virtual void appendBatch(const glm::vec4* positions,
+                             const glm::vec4* normals,
+                             const glm::vec2* uvs,
+                             const uint32_t* indices,
+                             uint32_t numVertices,
+                             uint32_t numTriangles) = 0;
+    virtual void close() = 0;
+
+    virtual bool isOpen() const = 0;
+    virtual uint64_t verticesWritten() const = 0;
+
+    static std::unique_ptr<MeshStreamWriter> create(MeshFileFormat format);
+    static const char* extension(MeshFileFormat format);  // ".obj", ".glb", ".ply", ".gmlt"
+};
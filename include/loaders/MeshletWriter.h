@@ -0,0 +1,114 @@
+#pragma once
+
+#include "loaders/MeshStreamWriter.h"
+#include "geometry/MeshletBuilder.h"
+
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Meshlet-partitioned binary export (.gmlt) for mesh-shader consumers: the
+// triangles arrive already split into meshlets of at most 64 vertices and
+// 124 triangles, with culling bounds, so they can be uploaded as-is.
+//
+// Little-endian layout:
+//   FileHeader
+//   Vertex[vertexCount]            position, octahedral snorm16 normal, uv
+//   uint32 data[dataSize / 4]      per meshlet: vertexCount global vertex
+//                                  indices, then 3 uint8 local indices per
+//                                  triangle, padded to 4 bytes
+//   Meshlet[meshletCount]          bounds and word offsets into data
+//
+// The vertex section is sized from open()'s total and written in place.
+// Meshlet data is appended behind it as batches arrive, and the meshlet
+// table is staged in a side file and appended on close().
+class MeshletWriter {
+public:
+    static constexpr uint32_t MAGIC   = 0x544C4D47;  // "GMLT"
+    static constexpr uint32_t VERSION = 1;
+
+#pragma pack(push, 1)
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t maxVertices;    // MeshletBuilder::MAX_VERTICES
+        uint32_t maxTriangles;   // MeshletBuilder::MAX_TRIANGLES
+        uint64_t vertexCount;
+        uint64_t meshletCount;
+        uint64_t vertexOffset;   // file offsets of the sections
+        uint64_t dataOffset;
+        uint64_t dataSize;       // bytes
+        uint64_t meshletOffset;
+    };
+
+    struct Vertex {
+        float   position[3];
+        int16_t normal[2];       // octahedral, snorm16
+        float   uv[2];
+    };
+
+    struct Meshlet {
+        float    center[3];
+        float    radius;
+        float    coneApex[3];
+        float    coneCutoff;     // backfacing from c if dot(normalize(apex - c), axis) >= cutoff
+        float    coneAxis[3];
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+        uint32_t vertexOffset;   // in 4-byte words into data
+        uint32_t triangleOffset; // in 4-byte words into data
+        uint32_t reserved;
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(FileHeader) == 64, "meshlet file header must be packed");
+    static_assert(sizeof(Vertex) == 24, "meshlet vertex record must be packed");
+    static_assert(sizeof(Meshlet) == 64, "meshlet record must be packed");
+
+    // Meshlet records address the data in uint32 words, so it stays under
+    // 16 GiB; appendBatch throws before a batch would cross that
+    static constexpr bool dataFits(uint64_t wordsWritten, uint64_t batchWords) {
+        return wordsWritten + batchWords <= std::numeric_limits<uint32_t>::max();
+    }
+
+    static void encodeNormal(const glm::vec3& n, int16_t out[2]);
+    static glm::vec3 decodeNormal(const int16_t in[2]);
+
+    class Stream : public MeshStreamWriter {
+    public:
+        void open(const std::string& filepath, uint64_t totalVertices, uint64_t totalTriangles) override;
+        void appendBatch(const glm::vec4* positions,
+                         const glm::vec4* normals,
+                         const glm::vec2* uvs,
+                         const uint32_t* indices,
+                         uint32_t numVertices,
+                         uint32_t numTriangles) override;
+        void close() override;
+
+        bool isOpen() const override { return file.is_open(); }
+        uint64_t verticesWritten() const override { return vertexBase; }
+
+    private:
+        void writeAt(uint64_t offset, const void* data, size_t size);
+
+        std::ofstream file;
+        std::ofstream meshletFile;  // staged meshlet table
+        std::string path;
+        std::string meshletPath;
+        uint64_t totalVertices = 0;
+        uint64_t totalTriangles = 0;
+        uint64_t vertexBase = 0;
+        uint64_t triangleBase = 0;
+        uint64_t meshletCount = 0;
+        uint64_t vertexStart = 0;   // file offset of the vertex section
+        uint64_t dataStart = 0;     // file offset of the meshlet data
+        uint64_t dataWords = 0;     // meshlet data written so far
+        double buildSeconds = 0.0;
+        double writeSeconds = 0.0;
+        MeshletBuilder::Result meshlets;   // one batch
+        std::vector<uint8_t>  scratch;     // packed vertices, then data words
+        std::vector<Meshlet>  records;
+    };
+};
@@ -32,6 +32,9 @@ struct NGonMesh {
 
     uint32_t nbVertices = 0;
     uint32_t nbFaces = 0;
+
+    // Heap footprint (vector capacities, including each face's index lists)
+    size_t sizeBytes() const;
 };
 
 class ObjLoader {
@@ -41,7 +44,7 @@ public:
     static void subdivide(NGonMesh& mesh, int levels = 1);
     static void subdivideFlat(NGonMesh& mesh, int levels = 1);
 
-private:
+    // Face metrics (also used by loaders that build NGonMesh directly)
     static glm::vec3 computeFaceNormal(
         const std::vector<glm::vec3>& positions,
         const std::vector<uint32_t>& indices);
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "loaders/MeshStreamWriter.h"
+
 #include <glm/glm.hpp>
+#include <fstream>
 #include <string>
+#include <vector>
 #include <cstdint>
 
 struct NGonMesh;
@@ -21,4 +25,33 @@ public:
     static void appendMesh(const std::string& filepath,
                            const NGonMesh& mesh,
                            uint32_t vertexOffset);
+
+    // Writes an OBJ a batch at a time, so the whole mesh never has to be in
+    // memory. Each batch is a v/vn/vt/f block whose 0-based indices refer to
+    // its own vertices; they are rebased past everything written before.
+    // Records are formatted with std::to_chars on all cores into per-block
+    // buffers and written in order; the text matches ostream's defaults.
+    class Stream : public MeshStreamWriter {
+    public:
+        void open(const std::string& filepath, uint64_t totalVertices, uint64_t totalTriangles) override;
+        void appendBatch(const glm::vec4* positions,
+                         const glm::vec4* normals,
+                         const glm::vec2* uvs,
+                         const uint32_t* indices,
+                         uint32_t numVertices,
+                         uint32_t numTriangles) override;
+        void close() override;
+
+        bool isOpen() const override { return file.is_open(); }
+        uint64_t verticesWritten() const override { return vertexBase; }
+        uint64_t trianglesWritten() const { return triangleCount; }
+
+    private:
+        std::ofstream file;
+        std::string path;
+        uint64_t vertexBase = 0;
+        uint64_t triangleCount = 0;
+        double   writeSeconds = 0.0;   // time spent formatting and writing
+        std::vector<std::string> blocks;  // reused formatting buffers
+    };
 };
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "loaders/MeshStreamWriter.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Binary little-endian PLY export: an interleaved vertex element
+// (x y z nx ny nz s t, all float) and a face element of uchar-counted uint
+// index lists. Both element sizes follow from the totals given to open(),
+// so each batch's vertices and faces are written in place.
+class PlyWriter {
+public:
+    class Stream : public MeshStreamWriter {
+    public:
+        void open(const std::string& filepath, uint64_t totalVertices, uint64_t totalTriangles) override;
+        void appendBatch(const glm::vec4* positions,
+                         const glm::vec4* normals,
+                         const glm::vec2* uvs,
+                         const uint32_t* indices,
+                         uint32_t numVertices,
+                         uint32_t numTriangles) override;
+        void close() override;
+
+        bool isOpen() const override { return file.is_open(); }
+        uint64_t verticesWritten() const override { return vertexBase; }
+
+    private:
+        void writeAt(uint64_t offset, const void* data, size_t size);
+
+        std::ofstream file;
+        std::string path;
+        uint64_t totalVertices = 0;
+        uint64_t totalTriangles = 0;
+        uint64_t vertexBase = 0;
+        uint64_t triangleBase = 0;
+        uint64_t vertexStart = 0;  // file offset of the vertex element
+        uint64_t faceStart = 0;    // file offset of the face element
+        double writeSeconds = 0.0;
+        std::vector<uint8_t> scratch;  // interleaved records for one batch
+    };
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "loaders/ImageLoader.h"
+
+#include <string>
+
+// Decoded RGBA8 images on disk, keyed by a content hash of the source file,
+// so reloading a mesh or switching presets skips PNG/JPEG decoding. Entries
+// are raw (small header, then the pixels) and are read back through a memory
+// map; a truncated or mismatched entry counts as a miss and is rewritten.
+// Safe to call from several job system tasks at once.
+class TextureCache {
+public:
+    // Pixels for the image at path, from the cache when an entry for the
+    // same file contents exists, else decoded and stored. An empty cacheDir
+    // only decodes. Throws like ImageLoader::load.
+    static ImageData load(const std::string& path, const std::string& cacheDir);
+};
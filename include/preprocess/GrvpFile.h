@@ -0,0 +1,62 @@
+#pragma once
+
+#include "preprocess/GrwmFormat.h"
+#include "loaders/MappedFile.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Read access to a mesh's GRWM preprocess data, v1 or v2. A v2 container
+// is mmapped and the accessors point straight into the mapping; v1 files
+// are read once each and their 16-byte slots packed into owned arrays.
+// Pointers stay valid until the GrvpFile is closed or destroyed.
+class GrvpFile {
+public:
+    static constexpr const char* V2_FILENAME = "grwm.grvp";
+
+    // Load from a preprocess directory, preferring grwm.grvp over the v1
+    // trio. Returns false if neither is present; throws std::runtime_error
+    // if the files exist but are malformed or inconsistent.
+    bool open(const std::string& preprocessDir, bool preferV2 = true);
+    void close();
+
+    bool isOpen() const { return version != 0; }
+
+    uint32_t version      = 0;
+    uint32_t vertexCount  = 0;
+    uint32_t faceCount    = 0;  // triangles as seen by GRWM
+    uint32_t edgeCount    = 0;
+    uint32_t slotsPerFace = 0;
+
+    const float*      curvature() const { return curvaturePtr; }        // vertexCount
+    const uint32_t*   features() const { return featuresPtr; }          // faceCount
+    const PackedSlot* slots() const { return slotsPtr; }                // faceCount * slotsPerFace
+    const uint16_t*   slotPriorities() const { return prioritiesPtr; }  // half floats, same layout
+
+    // Write a v2 container. Throws std::runtime_error on I/O failure.
+    static void writeV2(const std::string& path, uint32_t vertexCount, uint32_t faceCount,
+                        uint32_t edgeCount, uint32_t slotsPerFace,
+                        const float* curvature, const uint32_t* features,
+                        const PackedSlot* slots, const uint16_t* slotPriorities);
+
+    // Read the v1 files in preprocessDir and write preprocessDir/grwm.grvp.
+    // Throws std::runtime_error if the v1 data is missing or invalid.
+    static void convertV1ToV2(const std::string& preprocessDir);
+
+private:
+    bool openV1(const std::string& preprocessDir);
+    void openV2(const std::string& path);
+    void packSlots(const SlotEntry* entries, size_t count);
+
+    MappedFile mapped;
+    std::vector<float>      v1Curvature;
+    std::vector<uint32_t>   v1Features;
+    std::vector<PackedSlot> ownedSlots;
+    std::vector<uint16_t>   ownedPriorities;
+
+    const float*      curvaturePtr  = nullptr;
+    const uint32_t*   featuresPtr   = nullptr;
+    const PackedSlot* slotsPtr      = nullptr;
+    const uint16_t*   prioritiesPtr = nullptr;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+// GRWM preprocess file format (GRVP). Version 1 is three files in
+// <meshdir>/preprocess/: curvature.bin (float per vertex), features.bin
+// (uint8 per triangle) and slots.bin (SlotEntry per triangle slot), each
+// starting with the same 32-byte header.
+//
+// Version 2 is a single file, <meshdir>/preprocess/grwm.grvp: a 64-byte
+// header, a section table, then each section's payload at a 64-byte
+// aligned offset so it can be mmapped and uploaded without copying.
+// Feature flags are widened to uint32 to match the GPU buffer layout.
+// Slots are stored packed (see PackedSlot) with priorities in a separate
+// half-float section that is only read when slots must be re-merged.
+
+constexpr uint32_t GRVP_MAGIC     = 0x47525650;  // "GRVP"
+constexpr uint32_t GRVP_VERSION_1 = 1;
+constexpr uint32_t GRVP_VERSION_2 = 2;
+constexpr uint64_t GRVP_V2_ALIGNMENT = 64;
+
+struct PreprocessHeader {
+    uint32_t magic;          // 0x47525650 ("GRVP")
+    uint32_t version;        // 1
+    uint32_t vertex_count;
+    uint32_t face_count;
+    uint32_t edge_count;
+    uint32_t slots_per_face;
+    uint32_t padding[2];
+};
+static_assert(sizeof(PreprocessHeader) == 32, "GRVP header must be 32 bytes");
+
+struct SlotEntry {
+    float    u;
+    float    v;
+    float    priority;
+    uint32_t slot_index;
+};
+static_assert(sizeof(SlotEntry) == 16, "SlotEntry must be 16 bytes");
+
+// Slot as stored on the GPU and in v2 files: u, v as unorm16 (u in the low
+// half), 4 bytes instead of 16. Array position already encodes slot order
+// within a face, so slot_index is dropped; priority lives beside it.
+using PackedSlot = uint32_t;
+
+inline PackedSlot packSlotUV(float u, float v) {
+    return glm::packUnorm2x16(glm::vec2(u, v));
+}
+
+inline glm::vec2 unpackSlotUV(PackedSlot slot) {
+    return glm::unpackUnorm2x16(slot);
+}
+
+// Priority as IEEE half; clamped so the face-centre sentinel stays finite
+inline uint16_t packSlotPriority(float priority) {
+    return glm::packHalf1x16(glm::clamp(priority, -65504.0f, 65504.0f));
+}
+
+inline float unpackSlotPriority(uint16_t priority) {
+    return glm::unpackHalf1x16(priority);
+}
+
+enum class GrvpSectionType : uint32_t {
+    Curvature      = 1,  // float per vertex
+    Features       = 2,  // uint32 per triangle
+    Slots          = 3,  // SlotEntry per triangle slot (early v2 files)
+    PackedSlots    = 4,  // PackedSlot per triangle slot
+    SlotPriorities = 5,  // half-float priority per triangle slot
+};
+
+struct GrvpHeaderV2 {
+    uint32_t magic;          // 0x47525650 ("GRVP")
+    uint32_t version;        // 2
+    uint32_t vertex_count;
+    uint32_t face_count;     // triangles
+    uint32_t edge_count;
+    uint32_t slots_per_face;
+    uint32_t section_count;  // entries in the section table that follows
+    uint32_t reserved[9];
+};
+static_assert(sizeof(GrvpHeaderV2) == 64, "GRVP v2 header must be 64 bytes");
+
+struct GrvpSection {
+    uint32_t type;           // GrvpSectionType
+    uint32_t element_size;   // bytes per element
+    uint64_t offset;         // from file start, GRVP_V2_ALIGNMENT aligned
+    uint64_t count;          // number of elements
+    uint64_t reserved;
+};
+static_assert(sizeof(GrvpSection) == 32, "GRVP section entry must be 32 bytes");
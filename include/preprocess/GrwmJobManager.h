@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+// Runs one GRWM preprocess job at a time on a worker thread, either the
+// external cuda_preprocess binary or the in-process CPU implementation.
+// Output lines and progress are streamed to the UI, jobs can be cancelled,
+// and results are cached under <cacheRoot>/<key>/ where the key hashes the
+// mesh file contents, slots per face, feature threshold and backend (for the
+// external binary, its path, size and mtime), plus a version bumped with the
+// preprocess output, so a repeated run only copies the cached files into place.
+//
+// All public methods are safe to call from the UI thread while a job runs.
+class GrwmJobManager {
+public:
+    struct Request {
+        std::string meshPath;
+        std::string outputDir;    // where loadGrwmPreprocess looks (<meshdir>/preprocess/)
+        std::string cacheRoot;    // empty disables caching
+        std::string binaryPath;   // empty -> in-process CPU preprocessor
+        int         slotsPerFace = 64;
+        float       featureThreshold = 30.0f;
+    };
+
+    enum class State { Idle, Running, Succeeded, Failed, Cancelled };
+
+    GrwmJobManager() = default;
+    ~GrwmJobManager();
+
+    GrwmJobManager(const GrwmJobManager&) = delete;
+    GrwmJobManager& operator=(const GrwmJobManager&) = delete;
+
+    // Start a job; returns false if one is already running
+    bool start(const Request& request);
+    // Request cancellation; the worker kills the child process or stops the
+    // CPU preprocessor at its next stage boundary
+    void cancel();
+
+    bool isRunning() const { return state.load() == State::Running; }
+    State getState() const { return state.load(); }
+    float getProgress() const { return progress.load(); }  // [0,1], or < 0 if unknown
+
+    std::string getStatus() const;
+    std::vector<std::string> getLog() const;
+
+    // True exactly once after a job succeeds (fresh or from cache)
+    bool consumeCompleted() { return completed.exchange(false); }
+
+    // Content hash of the file at path (FNV-1a 64 over the mapped bytes)
+    static uint64_t hashFile(const std::string& path);
+    // "v<version>-<mesh hash>-s<slots>-t<threshold float bits>-<backend>",
+    // backend "cpu" or "cuda<binary stamp>"; hashes the whole mesh file, so
+    // a job computes it once
+    static std::string cacheKey(const Request& request);
+
+private:
+    static constexpr size_t MAX_LOG_LINES = 200;
+
+    void run(Request request);
+    bool runProcess(const Request& request, const std::string& outputDir);
+    bool runInProcess(const Request& request, const std::string& outputDir);
+    void installOutputs(const std::string& fromDir, const std::string& toDir);
+
+    void setStatus(const std::string& text);
+    void appendLog(const std::string& line);
+    void finish(State finalState, const std::string& text);
+
+    std::thread worker;
+    std::atomic<State> state{State::Idle};
+    std::atomic<bool>  cancelRequested{false};
+    std::atomic<bool>  completed{false};
+    std::atomic<float> progress{-1.0f};
+
+    mutable std::mutex textMutex;
+    std::string status;
+    std::deque<std::string> log;
+};
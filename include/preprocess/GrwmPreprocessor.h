@@ -0,0 +1,55 @@
+#pragma once
+
+#include "preprocess/GrwmFormat.h"
+#include "loaders/ObjLoader.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+
+struct GrwmSettings {
+    uint32_t slotsPerFace        = 64;
+    float    featureThresholdDeg = 30.0f;  // dihedral angle above which an edge is a feature
+};
+
+// Preprocess output in GRWM's view of the mesh: vertices are the original
+// (unsplit) positions and every N-gon is fan-triangulated into N-2
+// consecutive triangles, which is what loadGrwmPreprocess remaps from.
+struct GrwmResult {
+    uint32_t vertexCount   = 0;
+    uint32_t triangleCount = 0;
+    uint32_t edgeCount     = 0;
+    uint32_t slotsPerFace  = 0;
+
+    std::vector<float>     curvature;     // |mean curvature| per vertex
+    std::vector<uint8_t>   featureFlags;  // 1 if the triangle borders a feature edge
+    std::vector<SlotEntry> slots;         // triangleCount * slotsPerFace, priority-descending
+};
+
+// Optional hooks for long runs: report is called between stages with the
+// overall fraction done; a set cancel flag aborts with GrwmCancelled.
+struct GrwmProgress {
+    std::function<void(float fraction, const std::string& stage)> report;
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+class GrwmCancelled : public std::runtime_error {
+public:
+    GrwmCancelled() : std::runtime_error("GRWM preprocess cancelled") {}
+};
+
+// CPU implementation of the GRWM preprocess pass (replaces the CUDA
+// cuda_preprocess binary). Per-vertex work and slot generation are split
+// across threads; results are deterministic regardless of thread count.
+class GrwmPreprocessor {
+public:
+    static GrwmResult run(const NGonMesh& mesh, const GrwmSettings& settings,
+                          const GrwmProgress* progress = nullptr);
+
+    // Write curvature.bin, features.bin and slots.bin (GRVP v1) into outputDir.
+    // Throws std::runtime_error if a file cannot be written.
+    static void writeGrvp(const std::string& outputDir, const GrwmResult& result);
+};
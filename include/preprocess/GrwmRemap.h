@@ -0,0 +1,33 @@
+#pragma once
+
+#include "preprocess/GrwmFormat.h"
+
+#include <vector>
+#include <cstdint>
+
+// Maps GRWM preprocess data onto the loaded mesh. GRWM triangulates its
+// input, so per-triangle data is folded back onto the original n-gons (a
+// face of N corners owns N-2 consecutive triangles), and per-vertex data
+// is spread over vertices the loader split at UV/normal seams.
+class GrwmRemap {
+public:
+    // face -> first GRWM triangle, nbFaces + 1 entries (exclusive prefix
+    // sum of N-2); the last entry is the triangle count GRWM should have
+    static std::vector<uint32_t> faceTriangleOffsets(const int* faceVertCounts, uint32_t nbFaces);
+
+    // out[v] = curvature[originalVertexIndices[v]]
+    static void curvature(const float* curvature, const uint32_t* originalVertexIndices,
+                          uint32_t nbVertices, std::vector<float>& out);
+
+    // Per face: OR of its triangles' feature flags
+    static void features(const uint32_t* triFlags, const std::vector<uint32_t>& faceTriOffset,
+                         std::vector<uint32_t>& out);
+
+    // Per face: the top slotsPerFace slots of its triangles by priority.
+    // GRWM writes each triangle's slots priority-sorted, so this is a k-way
+    // merge of the child lists (k = N-2, usually 2). A face with a child out
+    // of order is partial-sorted instead, with a warning.
+    static void slots(const PackedSlot* triSlots, const uint16_t* triPriorities,
+                      uint32_t slotsPerFace, const std::vector<uint32_t>& faceTriOffset,
+                      std::vector<PackedSlot>& out);
+};
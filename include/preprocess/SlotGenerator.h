@@ -0,0 +1,39 @@
+#pragma once
+
+#include "preprocess/GrwmFormat.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+// Built-in per-face slot placement, for meshes without GRWM data. Each
+// face gets a progressive blue-noise point set: slot 0 is the face centre,
+// and every following slot is the best of a candidate pool by distance (in
+// 3D, so stretched faces are sampled by area) to the slots already placed
+// and to the face boundary, optionally weighted towards where the vertex
+// normals bend away from the face normal. Any prefix of the slots is
+// therefore evenly spread, which is what the active-slot count relies on.
+//
+// Output uses the heSlotsBuffer layout: slotsPerFace PackedSlot per face,
+// u,v as the task shader interprets them: barycentric for triangles, folded
+// so u + v <= 1; bilinear over the whole unit square of the first four
+// corners otherwise.
+class SlotGenerator {
+public:
+    struct Settings {
+        uint32_t slotsPerFace      = 64;
+        uint32_t candidatesPerSlot = 3;     // pool size = slotsPerFace * this
+        float    curvatureBias     = 0.0f;  // 0 = pure blue noise
+    };
+
+    // Base mesh faces as the renderer keeps them; not owned
+    struct Faces {
+        const glm::vec3* vertexPositions = nullptr;
+        const glm::vec3* vertexNormals   = nullptr;  // null: no curvature bias
+        const uint32_t*  faceVertOffsets = nullptr;  // nbFaces + 1
+        const uint32_t*  faceVertIndices = nullptr;  // corners in half-edge order
+        uint32_t         nbFaces         = 0;
+    };
+
+    static std::vector<PackedSlot> generate(const Faces& faces, const Settings& settings);
+};
@@ -15,18 +15,33 @@ struct ExportElementOffset {
     uint32_t isVertex;
 };
 
+// Output of one export dispatch. Sized for a batch of elements rather than
+// the whole mesh; offsets are rewritten per batch and are batch-local.
 struct MeshExportBuffers {
     StorageBuffer positions;   // vec4[totalVertices]
     StorageBuffer normals;     // vec4[totalVertices]
     StorageBuffer uvs;         // vec2[totalVertices]
     StorageBuffer indices;     // uint[totalTriangles * 3]
-    StorageBuffer offsets;     // ExportElementOffset[numElements]
+    StorageBuffer offsets;     // ExportElementOffset[maxElements]
 
     uint32_t totalVertices = 0;
     uint32_t totalTriangles = 0;
+    uint32_t maxElements = 0;
 
     void allocate(VkDevice device, VkPhysicalDevice physDevice,
-                  uint32_t numVerts, uint32_t numTris,
-                  const std::vector<ExportElementOffset>& elementOffsets);
+                  uint32_t numVerts, uint32_t numTris, uint32_t numElements);
+    void setOffsets(const std::vector<ExportElementOffset>& elementOffsets);
     void destroy();
 };
+
+// One in-flight export batch. Export keeps two, so the GPU fills one while
+// the CPU writes the other to disk.
+struct MeshExportBatch {
+    MeshExportBuffers buffers;
+    VkDescriptorSet   descriptorSet = VK_NULL_HANDLE;
+    VkCommandBuffer   commandBuffer = VK_NULL_HANDLE;
+    VkFence           fence = VK_NULL_HANDLE;
+    uint32_t          firstElement = 0;
+    uint32_t          elementCount = 0;  // 0 when idle
+    uint32_t          run = 0;           // ExportRun of its elements
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "core/MemoryTracker.h"
+#include "geometry/HalfEdge.h"
+#include "geometry/ParametricSurface.h"
+#include "loaders/GltfLoader.h"
+#include "loaders/ImageLoader.h"
+#include "preprocess/GrvpFile.h"
+#include "preprocess/SlotGenerator.h"
+
+class TaskGraph;
+
+// CPU-side copies of a half-edge mesh for stats, culling and export
+struct CpuMeshCopies {
+    TrackedVector<glm::vec3, MemTag::CpuMesh> faceCenters;
+    TrackedVector<glm::vec3, MemTag::CpuMesh> faceNormals;
+    TrackedVector<float, MemTag::CpuMesh>     faceAreas;
+    TrackedVector<glm::vec3, MemTag::CpuMesh> vertexPositions;
+    TrackedVector<glm::vec3, MemTag::CpuMesh> vertexNormals;
+    TrackedVector<float, MemTag::CpuMesh>     vertexFaceAreas;
+    TrackedVector<glm::vec2, MemTag::CpuMesh> faceUVs;
+    TrackedVector<int, MemTag::CpuMesh>       faceVertCounts;
+    TrackedVector<uint32_t, MemTag::CpuMesh>  faceVertOffsets;
+    TrackedVector<uint32_t, MemTag::CpuMesh>  faceVertIndices;
+    TrackedVector<glm::vec2, MemTag::CpuMesh> vertexUVs;
+    ParametricSurface::ElementFrames          elementFrames;
+
+    // Adds the nodes that fill the copies from mesh; both must outlive the run
+    void addBuildNodes(TaskGraph& graph, const HalfEdgeMesh& mesh);
+};
+
+// GRWM preprocess output (<mesh dir>/preprocess/) remapped onto the loaded mesh
+struct GrwmPreprocessData {
+    bool     loaded = false;
+    uint32_t version = 0;
+    uint32_t slotsPerFace = 0;
+    float    curvatureScale = 1.0f;  // 1 / median curvature
+    std::span<const float>      curvature;  // per vertex
+    std::span<const uint32_t>   features;   // per face
+    std::span<const PackedSlot> slots;      // nbFaces * slotsPerFace
+
+    // What the spans point into: the GRVP data itself when it already
+    // matches the mesh, so uploads read straight from the mapping; the
+    // remapped copies otherwise
+    GrvpFile                source;
+    std::vector<float>      remappedCurvature;
+    std::vector<uint32_t>   remappedFeatures;
+    std::vector<PackedSlot> remappedSlots;
+
+    // Leaves loaded false, with a warning, when the files are missing or do
+    // not match the mesh. originalVertexIndices maps split vertices back to
+    // the OBJ positions GRWM saw (may be empty).
+    static GrwmPreprocessData read(const std::string& meshPath,
+                                   uint32_t nbVertices, uint32_t nbFaces,
+                                   const int* faceVertCounts,
+                                   const uint32_t* originalVertexIndices,
+                                   size_t originalVertexIndexCount,
+                                   uint32_t originalVertexCount);
+};
+
+// Everything a mesh load reads, decodes and computes, prepared off the render
+// thread. The renderer only uploads it and swaps descriptors
+// (Renderer::commitMeshPackage).
+struct MeshPackage {
+    // Renderer settings, captured when the load is requested
+    struct Settings {
+        bool  triangulate = false;
+        int   subdivideLevel = 0;
+        int   subdivideFlatLevel = 0;
+        bool  generateSlots = true;  // built-in slots when there is no GRWM data
+        SlotGenerator::Settings slotSettings;
+        float bakeRate = 30.0f;
+        int   bakeBudgetMB = 32;
+        std::string textureCacheDir;  // decoded texture cache; empty = always decode
+    };
+
+    enum TextureSlot { Ao, ElementType, Mask, Skin, Diffuse, Normal, Orm, TextureCount };
+
+    struct Texture {
+        std::string path;
+        ImageData   image;  // RGBA8; empty when the file is absent or failed to decode
+
+        bool loaded() const { return !image.pixels.empty(); }
+    };
+
+    std::string path;
+    bool        gltfNative = false;
+
+    HalfEdgeMesh  mesh;
+    CpuMeshCopies copies;
+    TrackedVector<uint32_t, MemTag::CpuMesh> originalVertexIndices;
+    uint32_t originalVertexCount = 0;
+
+    GrwmPreprocessData      preprocess;
+    std::vector<PackedSlot> generatedSlots;  // when preprocess is not loaded
+    uint32_t                generatedSlotsPerFace = 0;
+
+    std::array<Texture, TextureCount> textures;
+    TrackedVector<uint8_t, MemTag::Mask> maskPixels;  // mask R channel
+    uint32_t maskWidth = 0, maskHeight = 0;
+
+    bool                        hasSkeleton = false;  // a glTF skeleton was extracted
+    Skeleton                    skeleton;
+    std::vector<Animation>      animations;
+    std::vector<BakedAnimation> bakedAnimations;
+    size_t                      skinningBytes = 0;  // skeleton + animations footprint
+    JointData                   jointIndices;
+    JointData                   jointWeights;
+
+    std::string coatPath;  // dragon_coat.obj next to the mesh, when present
+
+    // Runs on a job system worker and touches no renderer state. Throws when
+    // the mesh itself cannot be loaded; textures and skeleton are optional and
+    // only warn. Returns false if cancel was raised between stages.
+    bool prepare(const std::string& meshPath, const Settings& settings,
+                 const std::atomic<bool>& cancel);
+};
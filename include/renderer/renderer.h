@@ -9,13 +9,26 @@
 #include <optional>
 #include <limits>
 #include <array>
+#include <memory>
 
 #include "vulkan/vkHelper.h"
 #include "renderer/MeshExport.h"
+#include "renderer/MeshPackage.h"
+#include "loaders/MeshStreamWriter.h"
+#include "core/JobSystem.h"
+#include "core/MemoryTracker.h"
+#include "geometry/GridWeld.h"
+#include "geometry/ElementCull.h"
+#include "geometry/ParametricSurface.h"
+#include "geometry/ParametricLod.h"
+#include "geometry/PebbleGenerator.h"
+#include "preprocess/GrwmFormat.h"
+#include "preprocess/GrwmJobManager.h"
 #include "camera/FreeFlyCamera.h"
 #include "camera/OrbitCamera.h"
 #include "renderer/renderer_init.h"
 #include "loaders/GltfLoader.h"
+#include "animation/AnimationBlender.h"
 #include "player/PlayerController.h"
 #include "level/LevelPreset.h"
 #include "ui/ResurfacingPanel.h"
@@ -210,6 +223,84 @@ struct PushConstants {
     uint32_t slotUniformSizeFlag; // 1 = don't shrink elements with slot count
 };
 
+// Batched procedural export in progress. Spans frames so the loading overlay
+// can show progress; peak memory is the two batch buffer sets.
+// Elements exported at one grid resolution, in export order. A plain
+// export is a single run; LOD exports have one per resolution, so every
+// batch (a dispatch, a CPU evaluation, a weld) has a fixed element size.
+struct ExportRun {
+    uint32_t first = 0;            // position in the export order
+    uint32_t count = 0;
+    uint32_t M = 0, N = 0;
+    uint32_t batchElements = 0;    // elements per batch
+    uint32_t vertsPerElement = 0;
+    uint32_t trisPerElement = 0;
+    GridWeld gridWeld;             // built when welding
+    std::unique_ptr<ParametricSurface> cpuSurface;  // CPU backend
+};
+
+struct ProceduralExportJob {
+    bool active = false;
+    std::string filepath;
+    std::unique_ptr<MeshStreamWriter> writer;
+    bool appendBaseMesh = false;   // OBJ only
+    std::array<MeshExportBatch, 2> batches;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    PushConstants pushConstants{};
+    // Set 2 for the dispatches: a copy of the ResurfacingUBO (and scale LUT)
+    // taken at begin, since the frame loop rewrites the live ones
+    VkBuffer configUBO = VK_NULL_HANDLE;
+    VkDeviceMemory configUBOMemory = VK_NULL_HANDLE;
+    StorageBuffer scaleLut;
+    VkDescriptorSet configDescriptorSet = VK_NULL_HANDLE;
+    uint32_t numElements = 0;
+    std::vector<ExportRun> runs;
+    std::vector<uint32_t> elementOrder;  // LOD exports: element ids by run; empty = in order
+    uint32_t currentRun = 0;       // run holding nextElement
+    bool weld = false;             // weld poles before writing
+    bool weldSeams = false;        // and seams
+    std::vector<glm::vec4> weldPositions, weldNormals;  // one welded batch
+    std::vector<glm::vec2> weldUVs;
+    std::vector<uint32_t>  weldIndices;
+    bool cpuBackend = false;       // evaluate with ParametricSurface
+    std::vector<glm::vec4> cpuPositions, cpuNormals;    // one CPU-evaluated batch
+    std::vector<glm::vec2> cpuUVs;
+    std::vector<uint32_t>  cpuIndices;
+    std::unique_ptr<PebbleGenerator> pebbles;            // set for pebble exports (elements are faces)
+    std::vector<PebbleGenerator::Arena> pebbleArenas;    // one batch, per generating thread
+    uint32_t nextElement = 0;      // first position in the export order not yet submitted
+    uint32_t elementsWritten = 0;
+    uint32_t submitSlot = 0;       // batches are submitted and written in turn
+    uint32_t writeSlot = 0;
+    double startTime = 0.0;
+
+    uint32_t elementAt(uint32_t position) const {
+        return elementOrder.empty() ? position : elementOrder[position];
+    }
+    // Size of the batch starting at nextElement; moves currentRun past
+    // finished runs. 0 when everything is submitted.
+    uint32_t nextBatchSize() {
+        while (currentRun < runs.size() &&
+               nextElement >= runs[currentRun].first + runs[currentRun].count) {
+            currentRun++;
+        }
+        if (currentRun >= runs.size()) return 0;
+        const ExportRun& run = runs[currentRun];
+        return std::min(run.batchElements, run.first + run.count - nextElement);
+    }
+};
+
+// A mesh load being prepared on the job system (see Renderer::loadMesh)
+struct MeshLoadJob {
+    JobSystem::Counter done;
+    std::atomic<bool>  cancel{false};  // superseded by a newer load
+    MeshPackage        package;
+    bool               prepared = false;
+    std::string        error;
+    const LevelPreset* preset = nullptr;  // post-load state, applied after the commit
+    float              startTime = 0.0f;
+};
+
 struct BenchmarkPushConstants {
     glm::mat4 model;
     glm::mat4 view;
@@ -226,25 +317,6 @@ struct ElementProxyParams {
     float coverageFraction;   // fraction of face area covered by element [0,1]
 };
 
-struct PreprocessHeader {
-    uint32_t magic;          // 0x47525650 ("GRVP")
-    uint32_t version;        // 1
-    uint32_t vertex_count;
-    uint32_t face_count;
-    uint32_t edge_count;
-    uint32_t slots_per_face;
-    uint32_t padding[2];
-};
-static_assert(sizeof(PreprocessHeader) == 32, "GRVP header must be 32 bytes");
-
-struct SlotEntry {
-    float    u;
-    float    v;
-    float    priority;
-    uint32_t slot_index;
-};
-static_assert(sizeof(SlotEntry) == 16, "SlotEntry must be 16 bytes");
-
 class Renderer {
 public:
     Renderer(Window& window);
@@ -262,7 +334,10 @@ public:
     bool isFrameStarted() const { return frameStarted; }
     Window& getWindow() { return window; }
 
+    // Starts preparing the mesh on a background task; the current mesh keeps
+    // rendering until beginFrame commits the new one. Supersedes any load in flight.
     void loadMesh(const std::string& path);
+    bool meshLoadInFlight() const { return meshLoad != nullptr; }
     void processInput(Window& window, float deltaTime);
 
     void applyPreset(const LevelPreset& preset);
@@ -314,6 +389,7 @@ public:
     bool triangulateMesh = false;
     int subdivideLevel = 0;  // 0=none, 1=4x, 2=16x, 3=64x faces
     int subdivideFlatLevel = 0;  // 0=none, flat subdivision (no smoothing)
+    bool useTextureCache = true;  // keep decoded mesh textures under texture_cache/
     bool useElementTypeTexture = false;
     bool useAOTexture = false;
     bool useMaskTexture = false;
@@ -342,20 +418,47 @@ public:
     int      activeSlotCount       = 8;      // 1-64, how many top-priority slots per face
     bool     slotUniformSize       = true;   // keep element size constant regardless of slot count
     uint32_t slotsPerFace      = 0;
+    bool     enableSlotGenerator  = true;   // built-in blue-noise slots when no GRWM data
+    bool     slotsGenerated       = false;  // heSlotsBuffer holds generated slots
+    bool     slotGenPending       = false;  // regenerate at the next safe point
+    int      slotGenCount         = 64;
+    float    slotGenCurvatureBias = 0.0f;   // >0 densifies where normals bend within a face
+    void generateFaceSlots();
+    bool slotPlacementActive() const {
+        return enableSlotPlacement && slotsPerFace > 0
+            && ((preprocessLoaded && enablePreprocess) || slotsGenerated);
+    }
+    uint32_t preprocessVersion = 0;      // GRVP version of the loaded data (1 or 2)
     float    preprocessCurvatureScale = 1.0f;  // computed: 1/median curvature
     float    preprocessCurvatureBoost = 1.0f;  // UI: strength of curvature effect
 
     // GRWM pipeline execution
     std::string grwmBinaryPath;  // path to cuda_preprocess binary (auto-detected)
+    bool        grwmUseNative = false;  // in-process CPU preprocessor (also used when no binary)
     int         grwmSlotsPerFace = 64;
     float       grwmFeatureThreshold = 30.0f;
-    bool        grwmRunning = false;
-    bool        grwmPendingLoad = false;  // reload preprocess data after pipeline finishes
-    std::string grwmStatus;               // status message for UI
+    bool        grwmUseCache = true;      // reuse outputs for identical mesh + settings
+    bool        grwmPendingLoad = false;  // reload preprocess data at the next safe point
+    std::string grwmStatus;               // status message for UI (render thread only)
+    GrwmJobManager grwmJobs;
     void runGrwmPreprocess();
+    void convertGrwmPreprocessToV2();
     bool doSkinning = false;
     bool animationPlaying = false;
 
+    // Animation pose bake (per-frame bone-matrix cache, live evaluation fallback)
+    bool  useAnimationBake         = true;
+    bool  animationBakeInterpolate = true;
+    float animationBakeRate        = 30.0f;  // frames per second
+    int   animationBakeBudgetMB    = 32;     // total across all clips
+    void  bakeAnimations();
+
+    // Animation blending (layers, AnimState-driven crossfades, additive layers)
+    bool  useAnimationBlending = true;
+    float animCrossfadeTime    = 0.25f;          // seconds
+    int   animStateClips[3]    = { 0, 0, 0 };    // clip per PlayerController::AnimState
+    AnimationBlender animBlender;
+
     // Dragon coat toggle
     bool     dragonCoatAvailable   = false;
     bool     dragonCoatEnabled     = false;
@@ -401,6 +504,7 @@ public:
     float loadingDoneTime = 0.0f;
     float loadingDuration = 0.0f;
     bool loadingDone = false;  // show "done" message briefly
+    float loadingProgress = -1.0f;  // [0,1], or < 0 for an indeterminate bar
 
     // Pebble config
     bool renderPebbles = false;
@@ -420,11 +524,20 @@ public:
     int       groundMeshType         = 0;   // 0=quads, 1=pentagons
     bool      pendingGroundRegenerate = false;
     PebbleUBO groundPebbleUBO;
+    bool hasGroundMesh() const { return groundMeshActive; }
 
     // Export state
     bool pendingExport = false;
     std::string exportFilePath = "export.obj";
-    int exportMode = 0;  // 0=parametric, 1=pebble
+    int exportMode = 0;  // 0=parametric, 1=pebble, 2=ground pathway pebbles
+    int exportFormat = 0;  // MeshFileFormat: 0=OBJ, 1=GLB, 2=PLY, 3=GMLT
+    bool exportWeld = false;  // merge pole vertices, drop collapsed triangles
+    bool exportWeldSeams = false;  // with exportWeld: merge u/v seams too (UVs take the u = 0 side)
+    int exportBatchMB = 128;  // output per batch; the GPU backend keeps two in flight
+    int exportBackend = 0;    // 0=GPU compute, 1=CPU (ParametricSurface)
+    bool exportLod = false;   // per-element resolution as the current view draws it (getLodMN)
+    int exportLodTargetHeight = 0;     // screen height (px) the LOD targets; 0 = window
+    float exportTriangleBudgetM = 0.0f; // LOD triangle budget in millions; 0 = none
     std::string lastExportStatus;
 
     // Benchmark mesh state (static OBJ loaded for A/B performance comparison)
@@ -505,22 +618,27 @@ public:
     // Skeleton & animation data (CPU-side)
     Skeleton skeleton;
     std::vector<Animation> animations;
-    std::vector<glm::vec4> jointIndicesData;
-    std::vector<glm::vec4> jointWeightsData;
+    std::vector<BakedAnimation> bakedAnimations;  // parallel to animations
+    MemoryTracker::Charge skeletonCharge{MemTag::Skinning};  // skeleton + animations footprint
+    JointData jointIndicesData;
+    JointData jointWeightsData;
 
     // CPU-side mesh data for stats computation
-    std::vector<glm::vec3> cpuFaceCenters;
-    std::vector<glm::vec3> cpuFaceNormals;
-    std::vector<float>     cpuFaceAreas;
-    std::vector<glm::vec3> cpuVertexPositions;
-    std::vector<glm::vec3> cpuVertexNormals;
-    std::vector<float>     cpuVertexFaceAreas;  // area of adjacent face, for bounding radius
-    std::vector<glm::vec2> cpuFaceUVs;          // base UV per face element (first vertex texcoord)
-    std::vector<int>       cpuFaceVertCounts;   // polygon vertex count per face (for pebble export)
-    std::vector<uint32_t>  cpuOriginalVertexIndices; // maps split vertex -> original OBJ position index
-    uint32_t               cpuOriginalVertexCount = 0;
-    std::vector<glm::vec2> cpuVertexUVs;        // base UV per vertex element (vertex texcoord)
-    std::vector<uint8_t>   cpuMaskPixels;       // mask texture R channel on CPU
+    TrackedVector<glm::vec3, MemTag::CpuMesh> cpuFaceCenters;
+    TrackedVector<glm::vec3, MemTag::CpuMesh> cpuFaceNormals;
+    TrackedVector<float, MemTag::CpuMesh>     cpuFaceAreas;
+    TrackedVector<glm::vec3, MemTag::CpuMesh> cpuVertexPositions;
+    TrackedVector<glm::vec3, MemTag::CpuMesh> cpuVertexNormals;
+    TrackedVector<float, MemTag::CpuMesh>     cpuVertexFaceAreas;          // area of adjacent face, for bounding radius
+    TrackedVector<glm::vec2, MemTag::CpuMesh> cpuFaceUVs;                  // base UV per face element (first vertex texcoord)
+    TrackedVector<int, MemTag::CpuMesh>       cpuFaceVertCounts;           // polygon vertex count per face (for pebble export)
+    TrackedVector<uint32_t, MemTag::CpuMesh>  cpuFaceVertOffsets;          // nbFaces + 1 offsets into cpuFaceVertIndices
+    TrackedVector<uint32_t, MemTag::CpuMesh>  cpuFaceVertIndices;          // face corners in half-edge order
+    TrackedVector<uint32_t, MemTag::CpuMesh>  cpuOriginalVertexIndices;    // maps split vertex -> original OBJ position index
+    uint32_t                                  cpuOriginalVertexCount = 0;
+    TrackedVector<glm::vec2, MemTag::CpuMesh> cpuVertexUVs;                // base UV per vertex element (vertex texcoord)
+    ParametricSurface::ElementFrames          cpuElementFrames;            // export shader's element inputs
+    TrackedVector<uint8_t, MemTag::Mask>      cpuMaskPixels;               // mask texture R channel on CPU
     uint32_t cpuMaskWidth = 0, cpuMaskHeight = 0;
 
     // Swap chain extent (needed by stats panel)
@@ -536,7 +654,7 @@ public:
     std::vector<void*> elementStatsMapped;
 
     // CPU pre-cull cache — rebuilt only when camera/settings change
-    std::vector<uint32_t> cachedVisibleIndices;
+    ElementCull::VisibleList cachedVisibleIndices;
     uint32_t cachedTotalElements   = 0;
     uint32_t cachedEstMeshShaders  = 0;  // CPU-estimated mesh shader workgroups (LOD off only)
     uint32_t frameDrawCalls        = 0;  // draw/dispatch calls this frame
@@ -554,6 +672,7 @@ public:
     uint32_t  lastSlotK                 = 0;
     bool      lastChainmailMode        = false;
     bool     showGPUInvocStats     = false;  // enables task/mesh invoc query (has GPU perf cost)
+    bool     traceOnExit           = false;  // main writes the CPU trace on close (GRAVEL_TRACING builds)
 
 private:
     VkQueryPool statsQueryPool  = VK_NULL_HANDLE;
@@ -608,6 +727,13 @@ private:
     void writeSkeletonDescriptors();
     void cleanupMeshTextures();
     void cleanupMeshSkeleton();
+    MeshPackage::Settings meshLoadSettings() const;
+    void pollMeshLoad();
+    void commitMeshPackage(MeshPackage& package);
+    void cancelMeshLoads();
+    void uploadHalfEdgeMesh(const HalfEdgeMesh& mesh, CpuMeshCopies&& copies);
+    void adoptHalfEdgeMesh(const HalfEdgeMesh& mesh, CpuMeshCopies&& copies);
+    void setupAnimationBlending();
     void loadSecondaryMesh(const std::string& path);
     void cleanupSecondaryMesh();
     void loadBenchmarkMesh(const std::string& path);
@@ -616,10 +742,21 @@ private:
     void cleanupGroundMesh();
     glm::vec3 playerForwardDir() const;
     void exportProceduralMesh(const std::string& filepath, int mode);
+    void beginProceduralExport(const std::string& filepath, int mode);
+    bool stepProceduralExport(double budgetMs);  // true once the file is complete
+    void submitExportBatch(MeshExportBatch& batch);
+    void beginPebbleExport(const std::string& filepath, int mode);
+    void evaluateExportBatchCpu(uint32_t elementCount);
+    void generatePebbleBatch(uint32_t faceCount);
+    void writeExportBatch(const glm::vec4* positions, const glm::vec4* normals,
+                          const glm::vec2* uvs, const uint32_t* indices, uint32_t elementCount,
+                          const ExportRun& run);
+    void destroyProceduralExport();
+    void finishLoadingOverlay();
     void createExportComputePipelines();
     void cleanupExportPipelines();
-    void loadAndUploadTexture(const std::string& path, VulkanTexture& texture,
-                               VkFormat format, bool& loadedFlag);
+    void uploadTexture(const MeshPackage::Texture& texture, VulkanTexture& target,
+                       VkFormat format, bool& loadedFlag);
     void loadScaleLut();
     void scanSkyboxes();
     void loadSkybox(const std::string& path);
@@ -628,8 +765,11 @@ private:
     void precomputeProxyParams();
     void cleanupScaleLut();
     void loadGrwmPreprocess(const std::string& meshPath);
+    void uploadGrwmPreprocess(const GrwmPreprocessData& data);
+    void uploadGeneratedSlots(const std::vector<PackedSlot>& slots, uint32_t perFace);
     void cleanupGrwmPreprocess();
     void writeGrwmDescriptors(VkDescriptorSet dstSet);
+    void updateMeshInfoSlots();
     size_t calculateVRAM() const;
 
     void initImGui();
@@ -717,6 +857,12 @@ private:
     VkPipelineLayout      computePipelineLayout = VK_NULL_HANDLE;
     VkPipeline            parametricExportPipeline = VK_NULL_HANDLE;
     bool                  exportPipelinesCreated = false;
+    ProceduralExportJob   exportJob;
+    static constexpr double EXPORT_FRAME_BUDGET_MS = 50.0;  // file writing per frame while exporting
+
+    // Background mesh loads; superseded ones are kept until their task ends
+    std::unique_ptr<MeshLoadJob>              meshLoad;
+    std::vector<std::unique_ptr<MeshLoadJob>> retiredMeshLoads;
 
     // ImGui
     VkDescriptorPool imguiDescriptorPool = VK_NULL_HANDLE;
@@ -825,6 +971,7 @@ private:
     StorageBuffer scaleLutBuffer;
     glm::vec4     scaleLutMinExtent = glm::vec4(0.0f);
     glm::vec4     scaleLutMaxExtent = glm::vec4(1.0f);
+    std::vector<glm::vec4> cpuScaleLutPoints;  // same Nx * Ny points as scaleLutBuffer
 
     // Ground plane mesh (pathway pebbles)
     std::vector<StorageBuffer> groundHeVec4Buffers;
@@ -839,6 +986,12 @@ private:
     VkDeviceMemory groundPebbleUBOMemory = VK_NULL_HANDLE;
     void* groundPebbleUBOMapped = nullptr;
     uint32_t groundNbFaces = 0;
+    // CPU copies of the ground faces, for pathway pebble export
+    TrackedVector<glm::vec3, MemTag::CpuMesh> groundCpuVertexPositions;
+    TrackedVector<glm::vec3, MemTag::CpuMesh> groundCpuFaceCenters;
+    TrackedVector<glm::vec3, MemTag::CpuMesh> groundCpuFaceNormals;
+    TrackedVector<uint32_t, MemTag::CpuMesh>  groundCpuFaceVertOffsets;
+    TrackedVector<uint32_t, MemTag::CpuMesh>  groundCpuFaceVertIndices;
     bool groundMeshActive = false;
 
     // Benchmark mesh (traditional vertex pipeline for performance comparison)
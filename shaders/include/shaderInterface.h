@@ -197,15 +197,15 @@ LAYOUT_STD430(SET_HALF_EDGE, BINDING_HE_FEATURES) readonly buffer HEFeaturesBuff
     uint data[];
 } heFeaturesBuffer[1];
 
+// Slots are packed on upload: u, v as unorm16 (u in the low half), already
+// sorted by priority within each face
 struct SlotEntry {
     float u;
     float v;
-    float priority;
-    uint slot_index;
 };
 
 LAYOUT_STD430(SET_HALF_EDGE, BINDING_HE_SLOTS) readonly buffer HESlotsBuffer {
-    SlotEntry data[];
+    uint data[];
 } heSlotsBuffer[1];
 
 // --- Vertex data access ---
@@ -297,7 +297,8 @@ uint getFaceFeatureFlag(uint faceId) {
 }
 
 SlotEntry getSlotEntry(uint faceId, uint slotIdx, uint slotsPerFace) {
-    return heSlotsBuffer[0].data[faceId * slotsPerFace + slotIdx];
+    vec2 uv = unpackUnorm2x16(heSlotsBuffer[0].data[faceId * slotsPerFace + slotIdx]);
+    return SlotEntry(uv.x, uv.y);
 }
 
 // --- Proxy face data (binding 7, per-face proxy flags written by task shader) ---
@@ -0,0 +1,298 @@
+#include "animation/AnimationBlender.h"
+#include <algorithm>
+#include <cmath>
+
+// ============================================================================
+// PoseSoA
+// ============================================================================
+
+void PoseSoA::resize(size_t n) {
+    tx.resize(n); ty.resize(n); tz.resize(n);
+    rx.resize(n); ry.resize(n); rz.resize(n); rw.resize(n);
+    sx.resize(n); sy.resize(n); sz.resize(n);
+}
+
+// ============================================================================
+// Pose kernels (flat loops over all bones)
+// ============================================================================
+
+// dst = mix(dst, src, w), quaternions via normalized lerp on the near hemisphere
+static void blendPose(PoseSoA& dst, const PoseSoA& src, float w) {
+    const size_t n = dst.size();
+    for (size_t i = 0; i < n; ++i) {
+        dst.tx[i] += (src.tx[i] - dst.tx[i]) * w;
+        dst.ty[i] += (src.ty[i] - dst.ty[i]) * w;
+        dst.tz[i] += (src.tz[i] - dst.tz[i]) * w;
+        dst.sx[i] += (src.sx[i] - dst.sx[i]) * w;
+        dst.sy[i] += (src.sy[i] - dst.sy[i]) * w;
+        dst.sz[i] += (src.sz[i] - dst.sz[i]) * w;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        float d = dst.rx[i] * src.rx[i] + dst.ry[i] * src.ry[i] +
+                  dst.rz[i] * src.rz[i] + dst.rw[i] * src.rw[i];
+        float ws = (d < 0.0f) ? -w : w;
+        float x = dst.rx[i] * (1.0f - w) + src.rx[i] * ws;
+        float y = dst.ry[i] * (1.0f - w) + src.ry[i] * ws;
+        float z = dst.rz[i] * (1.0f - w) + src.rz[i] * ws;
+        float q = dst.rw[i] * (1.0f - w) + src.rw[i] * ws;
+        float inv = 1.0f / std::sqrt(x * x + y * y + z * z + q * q);
+        dst.rx[i] = x * inv; dst.ry[i] = y * inv; dst.rz[i] = z * inv; dst.rw[i] = q * inv;
+    }
+}
+
+// dst = dst + w * (src - ref): translation offset, rotation dst * (inv(ref) * src)^w,
+// scale dst * mix(1, src / ref, w)
+static void addPose(PoseSoA& dst, const PoseSoA& src, const PoseSoA& ref, float w) {
+    const size_t n = dst.size();
+    for (size_t i = 0; i < n; ++i) {
+        dst.tx[i] += (src.tx[i] - ref.tx[i]) * w;
+        dst.ty[i] += (src.ty[i] - ref.ty[i]) * w;
+        dst.tz[i] += (src.tz[i] - ref.tz[i]) * w;
+        dst.sx[i] *= 1.0f + (src.sx[i] / ref.sx[i] - 1.0f) * w;
+        dst.sy[i] *= 1.0f + (src.sy[i] / ref.sy[i] - 1.0f) * w;
+        dst.sz[i] *= 1.0f + (src.sz[i] / ref.sz[i] - 1.0f) * w;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        // delta = conjugate(ref) * src (unit quaternions)
+        float ax = -ref.rx[i], ay = -ref.ry[i], az = -ref.rz[i], aw = ref.rw[i];
+        float bx = src.rx[i], by = src.ry[i], bz = src.rz[i], bw = src.rw[i];
+        float dw = aw * bw - ax * bx - ay * by - az * bz;
+        float dx = aw * bx + ax * bw + ay * bz - az * by;
+        float dy = aw * by - ax * bz + ay * bw + az * bx;
+        float dz = aw * bz + ax * by - ay * bx + az * bw;
+        if (dw < 0.0f) { dw = -dw; dx = -dx; dy = -dy; dz = -dz; }
+
+        // Scale delta by weight: nlerp(identity, delta, w)
+        dw = 1.0f + (dw - 1.0f) * w;
+        dx *= w; dy *= w; dz *= w;
+        float inv = 1.0f / std::sqrt(dw * dw + dx * dx + dy * dy + dz * dz);
+        dw *= inv; dx *= inv; dy *= inv; dz *= inv;
+
+        // dst = dst * delta
+        float cx = dst.rx[i], cy = dst.ry[i], cz = dst.rz[i], cw = dst.rw[i];
+        dst.rw[i] = cw * dw - cx * dx - cy * dy - cz * dz;
+        dst.rx[i] = cw * dx + cx * dw + cy * dz - cz * dy;
+        dst.ry[i] = cw * dy - cx * dz + cy * dw + cz * dx;
+        dst.rz[i] = cw * dz + cx * dy - cy * dx + cz * dw;
+    }
+}
+
+// ============================================================================
+// AnimationBlender
+// ============================================================================
+
+void AnimationBlender::init(const Skeleton& skeleton, const std::vector<Animation>& animations) {
+    clear();
+    const size_t n = skeleton.bones.size();
+    if (n == 0) return;
+
+    restPose.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Skeleton::Bone& bone = skeleton.bones[i];
+        restPose.tx[i] = bone.animTranslation.x;
+        restPose.ty[i] = bone.animTranslation.y;
+        restPose.tz[i] = bone.animTranslation.z;
+        restPose.rx[i] = bone.animRotation.x;
+        restPose.ry[i] = bone.animRotation.y;
+        restPose.rz[i] = bone.animRotation.z;
+        restPose.rw[i] = bone.animRotation.w;
+        restPose.sx[i] = bone.animScale.x;
+        restPose.sy[i] = bone.animScale.y;
+        restPose.sz[i] = bone.animScale.z;
+    }
+
+    // Hierarchy order: parents before children, so globals resolve in one pass
+    evalOrder.reserve(n);
+    std::vector<int> stack;
+    for (size_t i = 0; i < n; ++i) {
+        if (skeleton.bones[i].parentIndex == -1) stack.push_back(static_cast<int>(i));
+    }
+    while (!stack.empty()) {
+        int b = stack.back();
+        stack.pop_back();
+        evalOrder.push_back(b);
+        for (int c : skeleton.bones[b].childrenIndices) stack.push_back(c);
+    }
+
+    additiveRefPoses.resize(animations.size());
+    for (size_t a = 0; a < animations.size(); ++a) {
+        sampleClip(animations[a], 0.0f, additiveRefPoses[a]);
+    }
+
+    basePose.resize(n);
+    scratchPose.resize(n);
+    globalTransforms.resize(n);
+}
+
+void AnimationBlender::clear() {
+    current = AnimationLayer{};
+    previous = AnimationLayer{};
+    additiveLayers.clear();
+    restPose = PoseSoA{};
+    basePose = PoseSoA{};
+    scratchPose = PoseSoA{};
+    blendedPose = PoseSoA{};
+    fadeSourcePose = PoseSoA{};
+    blendedPoseValid = false;
+    fadeFromSnapshot = false;
+    additiveRefPoses.clear();
+    evalOrder.clear();
+    globalTransforms.clear();
+    fadeDuration = 0.0f;
+    fadeElapsed = 0.0f;
+}
+
+bool AnimationBlender::crossfadeTo(int clip, float duration) {
+    if (clip == current.clip) return false;
+    // A fade still running is frozen where it stands and faded out from
+    // there; restarting from its outgoing clip alone would pop the pose.
+    // Without an evaluate() since the last call the previous source stays.
+    if (previous.clip < 0) {
+        fadeFromSnapshot = false;
+    } else if (blendedPoseValid) {
+        fadeSourcePose = blendedPose;
+        fadeFromSnapshot = true;
+    }
+    blendedPoseValid = false;
+    previous = current;
+    current = AnimationLayer{};
+    current.clip = clip;
+    current.speed = previous.speed;
+    fadeDuration = (previous.clip >= 0) ? std::max(duration, 0.0f) : 0.0f;
+    fadeElapsed = 0.0f;
+    return true;
+}
+
+int AnimationBlender::addAdditiveLayer(int clip, float weight) {
+    AnimationLayer layer;
+    layer.clip = clip;
+    layer.weight = weight;
+    layer.additive = true;
+    additiveLayers.push_back(layer);
+    return static_cast<int>(additiveLayers.size()) - 1;
+}
+
+void AnimationBlender::update(float deltaTime) {
+    current.time += deltaTime * current.speed;
+    if (previous.clip >= 0) {
+        previous.time += deltaTime * previous.speed;
+        fadeElapsed += deltaTime;
+        if (fadeElapsed >= fadeDuration) {
+            previous = AnimationLayer{};
+            fadeFromSnapshot = false;
+        }
+    }
+    for (auto& layer : additiveLayers) layer.time += deltaTime * layer.speed;
+}
+
+float AnimationBlender::fadeProgress() const {
+    if (previous.clip < 0 || fadeDuration <= 0.0f) return 1.0f;
+    return std::clamp(fadeElapsed / fadeDuration, 0.0f, 1.0f);
+}
+
+bool AnimationBlender::isSingleClip() const {
+    if (current.clip < 0 || previous.clip >= 0) return false;
+    for (const auto& layer : additiveLayers) {
+        if (layer.clip >= 0 && layer.weight > 0.0f) return false;
+    }
+    return true;
+}
+
+void AnimationBlender::sampleClip(const Animation& animation, float time, PoseSoA& out) const {
+    out = restPose;
+
+    for (const auto& channel : animation.channels) {
+        const auto& keyframes = channel.keyframes;
+        if (keyframes.empty()) continue;
+
+        // Same time wrapping as GltfLoader::updateSkeleton
+        float t = time;
+        if (t < keyframes.front().time) {
+            t = keyframes.front().time;
+        } else if (t > keyframes.back().time && animation.duration > 0.0f) {
+            t = std::fmod(t, animation.duration);
+        }
+
+        // Binary search for the surrounding keyframe pair
+        auto it = std::upper_bound(keyframes.begin(), keyframes.end(), t,
+            [](float v, const KeyFrame& kf) { return v < kf.time; });
+        size_t k1 = static_cast<size_t>(it - keyframes.begin());
+        size_t k0 = (k1 == 0) ? 0 : k1 - 1;
+        k1 = std::min(k1, keyframes.size() - 1);
+
+        const KeyFrame& kf0 = keyframes[k0];
+        const KeyFrame& kf1 = keyframes[k1];
+        float a = 0.0f;
+        if (channel.interpolation == AnimInterp::Linear && kf1.time > kf0.time) {
+            a = std::clamp((t - kf0.time) / (kf1.time - kf0.time), 0.0f, 1.0f);
+        }
+
+        const size_t b = static_cast<size_t>(channel.boneIndex);
+        if (channel.path == AnimPath::Translation) {
+            glm::vec3 v = glm::mix(kf0.translation, kf1.translation, a);
+            out.tx[b] = v.x; out.ty[b] = v.y; out.tz[b] = v.z;
+        } else if (channel.path == AnimPath::Rotation) {
+            glm::quat q = glm::slerp(kf0.rotation, kf1.rotation, a);
+            out.rx[b] = q.x; out.ry[b] = q.y; out.rz[b] = q.z; out.rw[b] = q.w;
+        } else if (channel.path == AnimPath::Scale) {
+            glm::vec3 v = glm::mix(kf0.scale, kf1.scale, a);
+            out.sx[b] = v.x; out.sy[b] = v.y; out.sz[b] = v.z;
+        }
+    }
+}
+
+void AnimationBlender::evaluate(const Skeleton& skeleton, const std::vector<Animation>& animations,
+                                std::vector<glm::mat4>& boneMatrices) {
+    const size_t n = skeleton.bones.size();
+    boneMatrices.resize(n);
+    if (n == 0 || restPose.size() != n) return;
+
+    auto validClip = [&](int clip) {
+        return clip >= 0 && clip < static_cast<int>(animations.size());
+    };
+
+    // Base: current clip, cross-faded over the outgoing one
+    if (validClip(previous.clip)) {
+        if (fadeFromSnapshot) basePose = fadeSourcePose;
+        else sampleClip(animations[previous.clip], previous.time, basePose);
+        if (validClip(current.clip)) {
+            sampleClip(animations[current.clip], current.time, scratchPose);
+            blendPose(basePose, scratchPose, fadeProgress());
+        }
+        blendedPose = basePose;
+        blendedPoseValid = true;
+    } else if (validClip(current.clip)) {
+        sampleClip(animations[current.clip], current.time, basePose);
+    } else {
+        basePose = restPose;
+    }
+
+    // Additive layers on top
+    for (const auto& layer : additiveLayers) {
+        if (!validClip(layer.clip) || layer.weight <= 0.0f) continue;
+        sampleClip(animations[layer.clip], layer.time, scratchPose);
+        addPose(basePose, scratchPose, additiveRefPoses[layer.clip], layer.weight);
+    }
+
+    // Local TRS -> global, one pass in hierarchy order
+    for (int b : evalOrder) {
+        glm::quat q(basePose.rw[b], basePose.rx[b], basePose.ry[b], basePose.rz[b]);
+        glm::mat4 local = glm::mat4_cast(q);
+        local[0] *= basePose.sx[b];
+        local[1] *= basePose.sy[b];
+        local[2] *= basePose.sz[b];
+        local[3] = glm::vec4(basePose.tx[b], basePose.ty[b], basePose.tz[b], 1.0f);
+
+        int parent = skeleton.bones[b].parentIndex;
+        globalTransforms[b] = (parent != -1)
+            ? globalTransforms[parent] * local
+            : skeleton.armatureTransform * local;
+        boneMatrices[b] = globalTransforms[b] * skeleton.bones[b].inverseBindMatrix;
+    }
+
+    if (skeleton.objAlignTransform != glm::mat4(1.0f)) {
+        for (size_t i = 0; i < n; ++i) {
+            boneMatrices[i] = skeleton.objAlignTransform * boneMatrices[i] * skeleton.objAlignInverse;
+        }
+    }
+}
@@ -0,0 +1,1280 @@
+#include "bench/BenchChecks.h"
+#include "animation/AnimationBlender.h"
+#include "core/JobSystem.h"
+#include "geometry/GridWeld.h"
+#include "geometry/KdTree.h"
+#include "geometry/MeshGenerator.h"
+#include "geometry/MeshletBuilder.h"
+#include "geometry/ParametricLod.h"
+#include "geometry/ParametricSurface.h"
+#include "geometry/PebbleGenerator.h"
+#include "preprocess/GrvpFile.h"
+#include "preprocess/GrwmFormat.h"
+#include "preprocess/GrwmJobManager.h"
+#include "preprocess/GrwmRemap.h"
+#include "preprocess/SlotGenerator.h"
+#include "loaders/BinaryMeshLoader.h"
+#include "loaders/GltfLoader.h"
+#include "loaders/MeshletWriter.h"
+#include "renderer/MeshPackage.h"
+#include "json.hpp"
+
+#include <tiny_gltf.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Thrown when a check cannot run here (e.g. a shipped asset is missing)
+struct Skipped : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+void require(bool condition, const std::string& what) {
+    if (!condition) throw std::runtime_error(what);
+}
+
+std::string format(const char* fmt, double a, double b = 0.0, double c = 0.0) {
+    char text[256];
+    std::snprintf(text, sizeof(text), fmt, a, b, c);
+    return text;
+}
+
+float maxDifference(const glm::mat4* a, const glm::mat4* b, size_t count) {
+    float diff = 0.0f;
+    for (size_t i = 0; i < count; i++)
+        for (int c = 0; c < 4; c++)
+            for (int r = 0; r < 4; r++) diff = std::max(diff, std::abs(a[i][c][r] - b[i][c][r]));
+    return diff;
+}
+
+// Live evaluation of a clip at t, as the renderer does without a bake
+std::vector<glm::mat4> liveBoneMatrices(const Animation& animation, const Skeleton& skeleton, float t) {
+    Skeleton pose = skeleton;
+    GltfLoader::updateSkeleton(animation, t, pose);
+    std::vector<glm::mat4> matrices;
+    GltfLoader::computeBoneMatrices(pose, matrices);
+    return matrices;
+}
+
+// ---------------------------------------------------------------------------
+// Animation bake
+// ---------------------------------------------------------------------------
+
+// Three-bone chain with an OBJ alignment, and a clip whose duration is not a
+// whole number of frames at 30 Hz so the closing interval is short
+void syntheticClip(Skeleton& skeleton, Animation& animation) {
+    skeleton = Skeleton{};
+    for (int i = 0; i < 3; i++) {
+        Skeleton::Bone bone;
+        bone.nodeIndex = i;
+        bone.name = "bone" + std::to_string(i);
+        bone.parentIndex = i - 1;
+        bone.localTransform = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, i ? 1.0f : 0.0f, 0.0f));
+        bone.animTranslation = glm::vec3(bone.localTransform[3]);
+        bone.inverseBindMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -float(i), 0.0f));
+        if (i > 0) skeleton.bones[i - 1].childrenIndices.push_back(i);
+        skeleton.bones.push_back(bone);
+    }
+    skeleton.objAlignTransform = glm::translate(glm::mat4(1.0f), glm::vec3(0.2f, -0.1f, 0.05f)) *
+                                 glm::scale(glm::mat4(1.0f), glm::vec3(2.5f));
+    skeleton.objAlignInverse = glm::inverse(skeleton.objAlignTransform);
+
+    animation = Animation{};
+    animation.name = "synthetic";
+    animation.duration = 1.05f;
+    AnimationChannel move{0, AnimPath::Translation, AnimInterp::Linear, {}};
+    move.keyframes.push_back({0.0f, glm::vec3(0.0f)});
+    move.keyframes.push_back({1.05f, glm::vec3(3.0f, 0.0f, 0.0f)});
+    AnimationChannel bend{1, AnimPath::Rotation, AnimInterp::Linear, {}};
+    for (int k = 0; k < 3; k++) {
+        KeyFrame keyframe{k * 0.525f};
+        keyframe.rotation = glm::angleAxis(glm::radians(30.0f * k), glm::vec3(0.0f, 0.0f, 1.0f));
+        bend.keyframes.push_back(keyframe);
+    }
+    animation.channels = {move, bend};
+}
+
+// Frame 0 is the t = 0 pose in OBJ space, and sampling inside the short
+// closing interval blends by real frame times
+void checkAnimationBake(const std::string&) {
+    Skeleton skeleton;
+    Animation animation;
+    syntheticClip(skeleton, animation);
+    BakedAnimation baked;
+    require(GltfLoader::bakeAnimation(animation, skeleton, 30.0f, size_t(1) << 20, baked), "bake failed");
+    require(baked.frameCount == 33, format("frameCount %.0f, expected 33", baked.frameCount));
+
+    std::vector<glm::mat4> live = liveBoneMatrices(animation, skeleton, 0.0f);
+    float diff = maxDifference(baked.frames.data(), live.data(), live.size());
+    require(diff <= 1e-5f, format("frame 0 differs from computeBoneMatrices at t=0 by %g", diff));
+
+    std::vector<glm::mat4> sampled;
+    for (float t : {0.25f, 0.51f, 1.036f, 1.04f, 1.045f, 1.049f}) {
+        GltfLoader::sampleBakedAnimation(baked, t, true, sampled);
+        live = liveBoneMatrices(animation, skeleton, t);
+        diff = maxDifference(sampled.data(), live.data(), live.size());
+        require(diff <= 2e-3f, format("sample at t=%g differs from live by %g", t, diff));
+    }
+}
+
+// A crossfade that interrupts another starts from the pose the first one
+// had reached: evaluating right before and right after the switch agrees
+void checkCrossfade(const std::string&) {
+    Skeleton skeleton;
+    Animation clip;
+    syntheticClip(skeleton, clip);
+    std::vector<Animation> clips(3, clip);
+    for (size_t c = 0; c < clips.size(); c++) {
+        for (KeyFrame& keyframe : clips[c].channels[1].keyframes)
+            keyframe.rotation = glm::angleAxis(glm::radians(40.0f * float(c) - 30.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    }
+
+    AnimationBlender blender;
+    blender.init(skeleton, clips);
+    blender.crossfadeTo(0, 0.0f);
+    blender.update(0.1f);
+    blender.crossfadeTo(1, 0.4f);
+    blender.update(0.2f);  // halfway from clip 0 to clip 1
+    std::vector<glm::mat4> before, after;
+    blender.evaluate(skeleton, clips, before);
+    require(blender.crossfadeTo(2, 0.4f), "crossfade to clip 2 refused");
+    blender.evaluate(skeleton, clips, after);
+    float diff = maxDifference(before.data(), after.data(), before.size());
+    require(diff <= 1e-5f, format("pose jumps by %g when a fade is interrupted", diff));
+
+    // Completes onto the new clip alone
+    blender.update(0.5f);
+    require(blender.isSingleClip(), "fade did not complete");
+}
+
+// The bake MeshPackage keeps for an OBJ + glTF pair carries the alignment
+// the spatial match computed. The shipped pair already lines up, so the OBJ
+// is rewritten scaled and offset next to a copy of the glTF; frames from the
+// start and the middle of each clip (a bind pose at t = 0 conjugates to
+// itself) must match live evaluation with that alignment.
+void checkPackageBake(const std::string& assetsDir) {
+    namespace fs = std::filesystem;
+    fs::path source = fs::path(assetsDir) / "base_mesh" / "man";
+    if (!fs::exists(source / "man.obj") || !fs::exists(source / "man.gltf"))
+        throw Skipped((source / "man.obj").string() + " or man.gltf not found");
+
+    fs::path dir = fs::temp_directory_path() / "gravel_check_package";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    for (const char* name : {"man.gltf", "man.bin"})
+        fs::copy_file(source / name, dir / name, fs::copy_options::overwrite_existing);
+    {
+        std::ifstream in(source / "man.obj");
+        std::ofstream out(dir / "man.obj");
+        std::string line;
+        while (std::getline(in, line)) {
+            float x, y, z;
+            if (line.rfind("v ", 0) == 0 && std::sscanf(line.c_str() + 2, "%f %f %f", &x, &y, &z) == 3) {
+                out << "v " << 2.0f * x + 0.5f << " " << 2.0f * y - 1.0f << " " << 2.0f * z << "\n";
+            } else {
+                out << line << "\n";
+            }
+        }
+        require(bool(out), "cannot write " + (dir / "man.obj").string());
+    }
+
+    MeshPackage package;
+    std::atomic<bool> cancel{false};
+    bool prepared = package.prepare((dir / "man.obj").string(), MeshPackage::Settings{}, cancel);
+    fs::remove_all(dir);
+    require(prepared, "prepare failed");
+    require(package.hasSkeleton, "no skeleton extracted");
+    float scale = package.skeleton.objAlignTransform[0][0];
+    require(std::abs(scale - 2.0f) < 0.05f, format("alignment scale %g, expected 2", scale));
+
+    size_t checked = 0;
+    for (size_t i = 0; i < package.animations.size(); i++) {
+        const BakedAnimation& baked = package.bakedAnimations[i];
+        if (!baked.valid()) continue;
+        for (uint32_t frame : {0u, baked.frameCount / 2}) {
+            float t = std::min(float(frame) / baked.sampleRate, baked.duration);
+            std::vector<glm::mat4> live = liveBoneMatrices(package.animations[i], package.skeleton, t);
+            float diff = maxDifference(&baked.frames[size_t(frame) * baked.boneCount], live.data(), live.size());
+            require(diff <= 1e-4f, "\"" + package.animations[i].name + "\" frame " + std::to_string(frame) +
+                                   " differs from computeBoneMatrices by " + format("%g", diff));
+        }
+        checked++;
+    }
+    require(checked > 0, "no clip was baked");
+}
+
+// ---------------------------------------------------------------------------
+// Parametric elements
+// ---------------------------------------------------------------------------
+
+// Distance of a world-space point from the analytic surface of the element
+// type, and that surface's outward normal there, in the element's frame
+// (origin o, normal n, scale s). hasNormal is false where the surface has
+// none (the cone apex).
+struct AnalyticPoint {
+    float     error;
+    glm::vec3 normal;
+    bool      hasNormal = true;
+};
+
+AnalyticPoint analyticSurface(uint32_t type, const ParametricSurface::Params& params,
+                              glm::vec3 o, glm::vec3 n, float s, glm::vec3 p) {
+    glm::vec3 d = p - o;
+    float z = glm::dot(d, n);
+    glm::vec3 planar = d - z * n;
+    float radial = glm::length(planar);
+    glm::vec3 out = radial > 1e-6f ? planar / radial : glm::vec3(0.0f);
+    switch (type) {
+    case 0: {  // torus about n
+        float R = params.torusMajorR * s, r = params.torusMinorR * s;
+        glm::vec3 tube = d - R * out;
+        return {std::abs(glm::length(tube) - r), glm::normalize(tube)};
+    }
+    case 2: {  // cone: radius 0.5 s at z = 0 down to the apex at z = s
+        float error = std::max(std::abs(radial - 0.5f * (s - z)),
+                               std::max(-z, z - s));
+        return {error, glm::normalize(out + 0.5f * n), radial > 1e-4f * s};
+    }
+    case 3: {  // cylinder: radius 0.5 s, z in [-s/2, s/2]
+        float error = std::max(std::abs(radial - 0.5f * s), std::abs(z) - 0.5f * s);
+        return {std::max(error, 0.0f), out};
+    }
+    default: {  // 1 sphere, 4 hemisphere (z >= 0)
+        float error = std::abs(glm::length(d) - params.sphereRadius * s);
+        if (type == 4) error = std::max(error, -z);
+        return {error, glm::normalize(d)};
+    }
+    }
+}
+
+// evaluateElementRange against the closed-form torus, sphere, cone,
+// cylinder and hemisphere, and evaluateElementList against the range
+void checkParametricElements(const std::string&) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    ParametricSurface::ElementFrames frames(6);
+    for (ParametricSurface::ElementFrame& frame : frames) {
+        frame.position = glm::vec3(unit(rng), unit(rng), unit(rng)) * 5.0f;
+        frame.normal = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)));
+        glm::vec3 helper = std::abs(frame.normal.x) < 0.9f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+        frame.edgeTangent = glm::normalize(glm::cross(frame.normal, helper));
+        frame.area = 0.5f + 4.0f * std::abs(unit(rng));
+    }
+    const uint32_t count = static_cast<uint32_t>(frames.size());
+
+    for (uint32_t type : {0u, 1u, 2u, 3u, 4u}) {
+        ParametricSurface::Params params;
+        params.elementType = type;
+        params.resolutionM = 12;
+        params.resolutionN = 9;
+        params.userScaling = 0.8f;
+        ParametricSurface surface(params);
+        const uint32_t vpe = surface.vertsPerElement();
+        const size_t ipe = size_t(surface.trisPerElement()) * 3;
+
+        std::vector<glm::vec4> positions(size_t(count) * vpe), normals(positions.size());
+        std::vector<glm::vec2> uvs(positions.size());
+        std::vector<uint32_t> indices(count * ipe);
+        surface.evaluateElementRange(frames, 0, count, positions.data(), normals.data(),
+                                     uvs.data(), indices.data());
+
+        const std::string name = "type " + std::to_string(type);
+        for (uint32_t e = 0; e < count; e++) {
+            const ParametricSurface::ElementFrame& frame = frames[e];
+            float s = std::sqrt(frame.area) * params.userScaling;
+            for (uint32_t k = 0; k < vpe; k++) {
+                size_t v = size_t(e) * vpe + k;
+                AnalyticPoint ref = analyticSurface(type, params, frame.position, frame.normal, s,
+                                                    glm::vec3(positions[v]));
+                require(ref.error <= 1e-4f * s, name + format(": vertex %.0f is %g off the surface",
+                                                              double(v), ref.error));
+                if (ref.hasNormal) {
+                    float angle = glm::length(glm::vec3(normals[v]) - ref.normal);
+                    require(angle <= 1e-3f, name + format(": normal %.0f off by %g", double(v), angle));
+                }
+                glm::vec2 uv(float(k % (params.resolutionM + 1)) / params.resolutionM,
+                             float(k / (params.resolutionM + 1)) / params.resolutionN);
+                require(uvs[v] == uv, name + format(": uv %.0f", double(v)));
+            }
+            for (size_t i = 0; i < ipe; i++) {
+                uint32_t index = indices[e * ipe + i];
+                require(index >= e * vpe && index < (e + 1) * vpe,
+                        name + format(": index %.0f outside its element", double(e * ipe + i)));
+            }
+        }
+
+        // Listed elements, reversed, land in list order with list-relative indices
+        std::vector<uint32_t> ids(count);
+        for (uint32_t e = 0; e < count; e++) ids[e] = count - 1 - e;
+        std::vector<glm::vec4> listPositions(positions.size()), listNormals(positions.size());
+        std::vector<glm::vec2> listUVs(positions.size());
+        std::vector<uint32_t> listIndices(indices.size());
+        surface.evaluateElementList(frames, ids.data(), count, listPositions.data(), listNormals.data(),
+                                    listUVs.data(), listIndices.data());
+        for (uint32_t e = 0; e < count; e++) {
+            size_t from = size_t(ids[e]) * vpe, to = size_t(e) * vpe;
+            // Bitwise: the cone apex normal is NaN on both paths, as in the shader
+            require(std::memcmp(&listPositions[to], &positions[from], vpe * sizeof(glm::vec4)) == 0 &&
+                    std::memcmp(&listNormals[to], &normals[from], vpe * sizeof(glm::vec4)) == 0,
+                    name + format(": listed element %.0f differs from the range", e));
+            for (size_t i = 0; i < ipe; i++) {
+                require(listIndices[e * ipe + i] - to == indices[ids[e] * ipe + i] - from,
+                        name + format(": listed element %.0f indices", e));
+            }
+        }
+    }
+}
+
+// Welded export grids keep their texture coordinates across u/v seams
+// unless seam welding is asked for, and only then close the surface
+void checkGridWeld(const std::string&) {
+    const uint32_t M = 8, N = 6, W = M + 1;
+    std::vector<glm::vec4> positions(W * (N + 1)), normals(positions.size(), glm::vec4(0, 0, 1, 0));
+    std::vector<glm::vec2> uvs(positions.size());
+    for (uint32_t v = 0; v <= N; v++) {
+        for (uint32_t u = 0; u <= M; u++) {
+            uvs[v * W + u] = glm::vec2(float(u) / M, float(v) / N);
+            positions[v * W + u] = glm::vec4(float(u) / M, float(v) / N, 0.0f, 1.0f);
+        }
+    }
+    for (uint32_t type = 0; type < 8; type++) {
+        GridWeld::Topology topology = GridWeld::topologyFor(type);
+        uint32_t poles = (topology.poleV0 ? 1 : 0) + (topology.poleV1 ? 1 : 0);
+        for (bool weldSeams : {false, true}) {
+            GridWeld weld;
+            weld.build(M, N, topology, weldSeams);
+            std::vector<glm::vec4> outPositions, outNormals;
+            std::vector<glm::vec2> outUVs;
+            std::vector<uint32_t> outIndices;
+            weld.apply(positions.data(), normals.data(), uvs.data(), 1,
+                       outPositions, outNormals, outUVs, outIndices);
+            std::string name = format("type %.0f", type) + (weldSeams ? " welded seams" : "");
+
+            uint32_t columns = weldSeams && topology.periodicU ? M : W;
+            uint32_t rows = (weldSeams && topology.periodicV ? N : N + 1) - poles;
+            require(weld.vertexCount() == columns * rows + poles,
+                    name + format(": %.0f vertices, want %.0f", weld.vertexCount(), columns * rows + poles));
+            if (weldSeams) continue;
+
+            // Away from the poles a triangle spans one grid step in u and v
+            for (size_t t = 0; t + 2 < outIndices.size(); t += 3) {
+                glm::vec2 lo(1.0f), hi(0.0f);
+                bool atPole = false;
+                for (int k = 0; k < 3; k++) {
+                    glm::vec2 uv = outUVs[outIndices[t + k]];
+                    lo = glm::min(lo, uv);
+                    hi = glm::max(hi, uv);
+                    atPole |= (topology.poleV0 && uv.y == 0.0f) || (topology.poleV1 && uv.y == 1.0f);
+                }
+                if (atPole) continue;
+                require(hi.x - lo.x <= 1.0f / M + 1e-6f && hi.y - lo.y <= 1.0f / N + 1e-6f,
+                        name + format(": a triangle spans uv (%g, %g)", hi.x - lo.x, hi.y - lo.y));
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// View-dependent LOD
+// ---------------------------------------------------------------------------
+
+// Runs partition the elements, ascending in resolution and element id, each
+// resolution within [min, max], and the triangle total is what they add to
+void checkLodResult(const ParametricLod::Result& lod, const ParametricLod::Settings& settings,
+                    size_t elementCount, const std::string& name) {
+    require(lod.elements.size() == elementCount, name + ": element count changed");
+    std::vector<bool> seen(elementCount, false);
+    uint64_t triangles = 0;
+    uint32_t next = 0, lastResolution = 0;
+    for (const ParametricLod::Run& run : lod.runs) {
+        require(run.first == next && run.count > 0, name + ": runs do not tile the element list");
+        require(run.resolution >= settings.minResolution && run.resolution <= settings.maxResolution,
+                name + format(": resolution %.0f outside [%.0f, %.0f]", run.resolution,
+                              settings.minResolution, settings.maxResolution));
+        require(run.resolution > lastResolution || run.first == 0, name + ": runs not ascending");
+        lastResolution = run.resolution;
+        for (uint32_t i = run.first; i < run.first + run.count; i++) {
+            uint32_t element = lod.elements[i];
+            require(element < elementCount && !seen[element], name + ": element listed twice");
+            require(i == run.first || element > lod.elements[i - 1], name + ": run not in element order");
+            seen[element] = true;
+        }
+        triangles += uint64_t(run.count) * 2 * run.resolution * run.resolution;
+        next += run.count;
+    }
+    require(next == elementCount, name + ": runs do not cover every element");
+    require(triangles == lod.triangles, name + format(": runs add up to %.0f triangles, result says %.0f",
+                                                      double(triangles), double(lod.triangles)));
+}
+
+// Resolutions stay clamped to [min, max] with and without a triangle budget;
+// a reachable budget is met by the finest LOD that fits, and one below the
+// all-minimum floor leaves every element at the minimum
+void checkLodBudget(const std::string&) {
+    MeshGenerator::Settings grid;
+    grid.resolution = 48;
+    grid.size = 10.0f;
+    HalfEdgeMesh mesh = MeshGenerator::generate(grid);
+    ParametricSurface::ElementFrames frames = ParametricSurface::buildFrames(mesh);
+    const size_t count = frames.size();
+
+    ParametricSurface::Params surface;  // torus
+    ParametricLod::Settings settings;
+    settings.baseResolution = 16;
+    settings.minResolution = 3;
+    settings.maxResolution = 24;
+    settings.mvp = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.05f, 100.0f) *
+                   glm::lookAt(glm::vec3(0.0f, 0.6f, 4.5f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    ParametricLod::Result unbudgeted = ParametricLod::compute(surface, frames, settings);
+    checkLodResult(unbudgeted, settings, count, "no budget");
+    require(unbudgeted.budgetScale == 1.0f, "budgetScale changed without a budget");
+    require(unbudgeted.runs.size() > 2,
+            format("only %.0f resolutions in a perspective view", unbudgeted.runs.size()));
+
+    // Camera inside the grid: near elements hit the maximum
+    ParametricLod::Settings inside = settings;
+    inside.mvp = glm::perspective(glm::radians(60.0f), 1.0f, 0.001f, 100.0f) *
+                 glm::lookAt(glm::vec3(0.0f, 0.01f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    ParametricLod::Result closeLod = ParametricLod::compute(surface, frames, inside);
+    checkLodResult(closeLod, inside, count, "close view");
+    require(closeLod.runs.back().resolution == inside.maxResolution, "nothing reached maxResolution");
+
+    const uint64_t minimumTriangles = uint64_t(count) * 2 * settings.minResolution * settings.minResolution;
+    ParametricLod::Settings budgeted = settings;
+    budgeted.triangleBudget = minimumTriangles + (unbudgeted.triangles - minimumTriangles) / 3;
+    ParametricLod::Result fit = ParametricLod::compute(surface, frames, budgeted);
+    checkLodResult(fit, budgeted, count, "budget");
+    require(fit.triangles <= budgeted.triangleBudget,
+            format("%.0f triangles over a budget of %.0f", double(fit.triangles), double(budgeted.triangleBudget)));
+    require(fit.budgetScale < 1.0f, "budget did not scale the LOD down");
+    ParametricLod::Settings finer = settings;
+    finer.lodFactor *= fit.budgetScale * 1.001f;
+    require(ParametricLod::compute(surface, frames, finer).triangles > budgeted.triangleBudget,
+            "a finer LOD than the budget scale would also have fit");
+
+    budgeted.triangleBudget = minimumTriangles / 2;
+    ParametricLod::Result starved = ParametricLod::compute(surface, frames, budgeted);
+    checkLodResult(starved, budgeted, count, "budget below the floor");
+    require(starved.runs.size() == 1 && starved.runs[0].resolution == settings.minResolution &&
+            starved.triangles == minimumTriangles,
+            "an unreachable budget must leave every element at minResolution");
+}
+
+// ---------------------------------------------------------------------------
+// Procedural meshes
+// ---------------------------------------------------------------------------
+
+template <typename Vector>
+void requireSame(const Vector& direct, const Vector& built, const std::string& what) {
+    require(direct.size() == built.size() && std::equal(direct.begin(), direct.end(), built.begin()),
+            what + " differs from HalfEdgeBuilder");
+}
+
+// The direct half-edge link of every shape matches HalfEdgeBuilder on the
+// same polygons: same half-edge order, the same twins, and boundaries only
+// where the shape has one; and small resolutions give the documented counts
+void checkMeshGenerator(const std::string&) {
+    using Shape = MeshGenerator::Shape;
+    for (Shape shape : {Shape::Grid, Shape::Icosphere, Shape::QuadSphere, Shape::Torus,
+                        Shape::PentagonTiling, Shape::MixedTiling}) {
+        for (uint32_t resolution : {7u, 12u}) {
+            MeshGenerator::Settings settings;
+            settings.shape = shape;
+            settings.resolution = resolution;
+            HalfEdgeMesh direct = MeshGenerator::generate(settings);
+            HalfEdgeMesh built = HalfEdgeBuilder::build(MeshGenerator::generateNGon(settings));
+            std::string name = std::string(MeshGenerator::shapeName(shape)) + format(" %.0f", resolution);
+
+            require(direct.nbVertices == built.nbVertices && direct.nbFaces == built.nbFaces
+                    && direct.nbHalfEdges == built.nbHalfEdges, name + ": element counts differ");
+            requireSame(direct.vertexFaceIndices, built.vertexFaceIndices, name + ": face list");
+            requireSame(direct.faceOffsets, built.faceOffsets, name + ": faceOffsets");
+            requireSame(direct.faceEdges, built.faceEdges, name + ": faceEdges");
+            requireSame(direct.vertexEdges, built.vertexEdges, name + ": vertexEdges");
+            requireSame(direct.heVertex, built.heVertex, name + ": heVertex");
+            requireSame(direct.heFace, built.heFace, name + ": heFace");
+            requireSame(direct.heNext, built.heNext, name + ": heNext");
+            requireSame(direct.hePrev, built.hePrev, name + ": hePrev");
+            requireSame(direct.heTwin, built.heTwin, name + ": heTwin");
+
+            uint32_t boundary = 0;
+            for (uint32_t he = 0; he < direct.nbHalfEdges; he++) {
+                int twin = direct.heTwin[he];
+                if (twin < 0) { boundary++; continue; }
+                require(direct.heTwin[twin] == int(he)
+                        && direct.heVertex[twin] == direct.heVertex[direct.heNext[he]],
+                        name + format(": half-edge %.0f and its twin do not pair up", he));
+            }
+            bool open = shape == Shape::Grid || shape == Shape::PentagonTiling || shape == Shape::MixedTiling;
+            require(open ? boundary > 0 : boundary == 0,
+                    name + format(": %.0f boundary half-edges", boundary));
+            if (shape == Shape::Grid) {
+                require(boundary == 4 * resolution,
+                        name + format(": %.0f boundary half-edges, want %.0f", boundary, 4 * resolution));
+            }
+        }
+    }
+
+    // Face counts as the shape comments give them, odd and tiny resolutions
+    // included: pentagons resolution^2, the torus 4 * max(resolution, 3)^2
+    // at the default radii
+    for (uint32_t resolution = 1; resolution <= 6; resolution++) {
+        MeshGenerator::Settings settings;
+        settings.resolution = resolution;
+        settings.shape = Shape::PentagonTiling;
+        NGonMesh pentagons = MeshGenerator::generateNGon(settings);
+        require(pentagons.nbFaces == resolution * resolution,
+                format("pentagons %.0f: %.0f faces", resolution, pentagons.nbFaces));
+        settings.shape = Shape::Torus;
+        uint32_t tube = std::max(resolution, 3u);
+        NGonMesh torus = MeshGenerator::generateNGon(settings);
+        require(torus.nbFaces == 4 * tube * tube, format("torus %.0f: %.0f faces", resolution, torus.nbFaces));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Pebbles
+// ---------------------------------------------------------------------------
+
+// The face arrays the renderer hands the pebble generator, from a generated mesh
+struct PebbleInput {
+    HalfEdgeMesh  mesh;
+    CpuMeshCopies copies;
+
+    PebbleInput(MeshGenerator::Shape shape, uint32_t resolution) {
+        MeshGenerator::Settings settings;
+        settings.shape = shape;
+        settings.resolution = resolution;
+        mesh = MeshGenerator::generate(settings);
+        TaskGraph graph;
+        copies.addBuildNodes(graph, mesh);
+        graph.run(JobSystem::get());
+    }
+
+    PebbleGenerator::Faces faces() const {
+        PebbleGenerator::Faces f;
+        f.vertexPositions = copies.vertexPositions.data();
+        f.faceCenters = copies.faceCenters.data();
+        f.faceNormals = copies.faceNormals.data();
+        f.faceVertOffsets = copies.faceVertOffsets.data();
+        f.faceVertIndices = copies.faceVertIndices.data();
+        f.nbFaces = mesh.nbFaces;
+        return f;
+    }
+};
+
+// Generates every face and checks the output against the per-face counts
+// the export sizes its files with; returns the totals
+void generatePebbles(const PebbleGenerator& pebbles, const std::string& name,
+                     uint64_t& vertices, uint64_t& triangles, uint32_t& emptyFaces) {
+    uint64_t expectedVerts = 0, expectedTris = 0;
+    emptyFaces = 0;
+    for (uint32_t f = 0; f < pebbles.faceCount(); f++) {
+        expectedVerts += pebbles.faceVertexCount(f);
+        expectedTris += pebbles.faceTriangleCount(f);
+        if (pebbles.faceVertexCount(f) == 0) emptyFaces++;
+    }
+    std::vector<PebbleGenerator::Arena> arenas;
+    pebbles.generate(0, pebbles.faceCount(), arenas);
+    vertices = triangles = 0;
+    for (const PebbleGenerator::Arena& arena : arenas) {
+        for (uint32_t index : arena.indices)
+            require(index < arena.vertexCount(), name + ": index past its arena");
+        require(arena.normals.size() == arena.positions.size() && arena.uvs.size() == arena.positions.size(),
+                name + ": attribute arrays differ in length");
+        vertices += arena.vertexCount();
+        triangles += arena.triangleCount();
+    }
+    require(vertices == expectedVerts, name + format(": %.0f vertices, faceVertexCount sums to %.0f",
+                                                     double(vertices), double(expectedVerts)));
+    require(triangles == expectedTris, name + format(": %.0f triangles, faceTriangleCount sums to %.0f",
+                                                     double(triangles), double(expectedTris)));
+}
+
+// Pebble output matches the exact counts export opens its writers with, for
+// the loaded-mesh mode at every subdivision path and for the ground pathway
+// mode, and a quad comes out at the sizes pebble.mesh emits
+void checkPebbleCounts(const std::string&) {
+    uint64_t vertices, triangles;
+    uint32_t emptyFaces;
+
+    // Mode 1: loaded mesh, mixed triangles/quads/pentagons
+    PebbleInput mixed(MeshGenerator::Shape::MixedTiling, 12);
+    struct Level { uint32_t level, offset; bool noise; };
+    for (Level l : {Level{0, 0, false}, Level{1, 0, false}, Level{3, 0, true},
+                    Level{5, 2, false}, Level{4, 7, false}}) {
+        PebbleGenerator::Params params;
+        params.subdivisionLevel = l.level;
+        params.subdivOffset = l.offset;
+        params.doNoise = l.noise;
+        PebbleGenerator pebbles(params, mixed.faces());
+        std::string name = format("level %.0f offset %.0f", l.level, l.offset);
+        generatePebbles(pebbles, name, vertices, triangles, emptyFaces);
+        require(emptyFaces == 0, name + ": faces dropped without a pathway");
+    }
+
+    // One quad: level 0 is a capped prism; level 3 is 6 x 4 patches of 5^2
+    // vertices and 8 fill fans of 2 * 5 + 1; level 9 (257^2 patches, the
+    // cap) only on this one face
+    PebbleInput quad(MeshGenerator::Shape::Grid, 1);
+    for (uint32_t level : {0u, 3u, 9u}) {
+        PebbleGenerator::Params params;
+        params.subdivisionLevel = level;
+        PebbleGenerator pebbles(params, quad.faces());
+        generatePebbles(pebbles, format("quad level %.0f", level), vertices, triangles, emptyFaces);
+        if (level == 9) continue;
+        uint64_t wantVerts = level ? 688 : 8, wantTris = level ? 864 : 10;
+        require(vertices == wantVerts && triangles == wantTris,
+                format("quad level %.0f: %.0f vertices, %.0f triangles", level,
+                       double(vertices), double(triangles)));
+    }
+
+    // Mode 2: ground pathway around a player in the middle of the grid
+    PebbleInput ground(MeshGenerator::Shape::Grid, 32);
+    PebbleGenerator::Params params;
+    params.usePathway = true;
+    params.pathwayRadius = 0.2f;
+    params.playerForward = glm::vec3(1.0f, 0.0f, 0.0f);
+    PebbleGenerator pathway(params, ground.faces());
+    generatePebbles(pathway, "pathway", vertices, triangles, emptyFaces);
+    require(emptyFaces > 0 && emptyFaces < ground.mesh.nbFaces,
+            format("pathway kept %.0f of %.0f faces", double(ground.mesh.nbFaces - emptyFaces),
+                   double(ground.mesh.nbFaces)));
+}
+
+// ---------------------------------------------------------------------------
+// Meshlet export
+// ---------------------------------------------------------------------------
+
+// Triangles with the corners rotated so the smallest index leads; winding is
+// kept, and meshlets may reorder triangles and rotate their corners
+std::vector<std::array<uint32_t, 3>> canonicalTriangles(const std::vector<uint32_t>& indices) {
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        std::array<uint32_t, 3> tri = {indices[t], indices[t + 1], indices[t + 2]};
+        std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+        triangles.push_back(tri);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+// Two bumpy grids written as separate batches come back from loadGmlt with
+// the same vertices and triangles; and the 16 GiB data guard sits where the
+// uint32 word offsets run out
+void checkMeshletRoundTrip(const std::string&) {
+    const uint32_t n = 24;  // quads per side, several meshlets per batch
+    const uint32_t verts = (n + 1) * (n + 1), tris = n * n * 2;
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> uvs;
+    std::vector<uint32_t> indices;
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gravel_check_meshlets";
+    std::filesystem::create_directories(dir);
+    std::string path = (dir / "grids.gmlt").string();
+    {
+        MeshletWriter::Stream stream;
+        stream.open(path, 2 * verts, 2 * tris);
+        for (uint32_t batch = 0; batch < 2; batch++) {
+            std::vector<glm::vec4> p, nrm;
+            std::vector<glm::vec2> uv;
+            std::vector<uint32_t> idx;
+            for (uint32_t j = 0; j <= n; j++) {
+                for (uint32_t i = 0; i <= n; i++) {
+                    float u = float(i) / n, v = float(j) / n;
+                    float h = 0.2f * std::sin(6.0f * u + batch) * std::cos(5.0f * v);
+                    glm::vec3 normal = glm::normalize(glm::vec3(
+                        -1.2f * std::cos(6.0f * u + batch) * std::cos(5.0f * v),
+                        1.0f, std::sin(6.0f * u + batch) * std::sin(5.0f * v)));
+                    p.push_back(glm::vec4(u + 2.0f * batch, h, v, 1.0f));
+                    nrm.push_back(glm::vec4(normal, 0.0f));
+                    uv.push_back(glm::vec2(u, v));
+                }
+            }
+            for (uint32_t j = 0; j < n; j++) {
+                for (uint32_t i = 0; i < n; i++) {
+                    uint32_t a = j * (n + 1) + i, b = a + 1, c = a + n + 1, d = c + 1;
+                    for (uint32_t k : {a, c, b, b, c, d}) idx.push_back(k);
+                }
+            }
+            stream.appendBatch(p.data(), nrm.data(), uv.data(), idx.data(), verts, tris);
+            for (uint32_t k = 0; k < verts; k++) {
+                positions.push_back(glm::vec3(p[k]));
+                normals.push_back(glm::vec3(nrm[k]));
+                uvs.push_back(uv[k]);
+            }
+            for (uint32_t k : idx) indices.push_back(k + batch * verts);
+        }
+        stream.close();
+    }
+    TriangleMesh mesh = BinaryMeshLoader::loadGmlt(path);
+    std::filesystem::remove_all(dir);
+
+    require(mesh.positions.size() == positions.size() && mesh.normals.size() == normals.size()
+            && mesh.uvs.size() == uvs.size(),
+            format("%.0f vertices read back, %.0f written", double(mesh.positions.size()),
+                   double(positions.size())));
+    float normalError = 0.0f;
+    for (size_t k = 0; k < positions.size(); k++) {
+        require(mesh.positions[k] == positions[k] && mesh.uvs[k] == uvs[k],
+                format("vertex %.0f changed in the round trip", double(k)));
+        normalError = std::max(normalError, glm::length(mesh.normals[k] - normals[k]));
+    }
+    // Octahedral snorm16 keeps normals to a few 1e-5
+    require(normalError < 1e-4f, format("normal error %g", normalError));
+    require(canonicalTriangles(mesh.indices) == canonicalTriangles(indices),
+            format("triangles differ (%.0f read back, %.0f written)", double(mesh.indices.size() / 3),
+                   double(indices.size() / 3)));
+
+    // Offsets reach uint32 max words: one more word would wrap a record
+    const uint64_t lastWord = std::numeric_limits<uint32_t>::max();
+    const uint64_t worstBatch = MeshletBuilder::MAX_VERTICES + MeshletBuilder::MAX_TRIANGLES * 3 / 4;
+    require(MeshletWriter::dataFits(lastWord - worstBatch, worstBatch)
+            && !MeshletWriter::dataFits(lastWord - worstBatch, worstBatch + 1)
+            && !MeshletWriter::dataFits(lastWord, lastWord),
+            "data guard does not stop at 16 GiB");
+}
+
+// ---------------------------------------------------------------------------
+// Mesh loading
+// ---------------------------------------------------------------------------
+
+// A one-quad GLB whose NORMAL and TEXCOORD_0 accessors claim the given
+// entry counts (the buffer holds five of each, POSITION four)
+void writeQuadGlb(const std::string& path, size_t normalCount, size_t uvCount) {
+    const float positions[4][3] = {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}};
+    const float normals[5][3] = {{0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 1, 0}};
+    const float uvs[5][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}, {0, 0}};
+    const uint32_t indices[6] = {0, 2, 1, 0, 3, 2};
+    std::vector<uint8_t> bin;
+    auto append = [&](const void* data, size_t size) {
+        size_t offset = bin.size();
+        bin.insert(bin.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+        return nlohmann::json{{"buffer", 0}, {"byteOffset", offset}, {"byteLength", size}};
+    };
+    nlohmann::json json;
+    json["asset"] = {{"version", "2.0"}};
+    json["bufferViews"] = {append(positions, sizeof(positions)), append(normals, sizeof(normals)),
+                           append(uvs, sizeof(uvs)), append(indices, sizeof(indices))};
+    json["buffers"] = {{{"byteLength", bin.size()}}};
+    json["accessors"] = {
+        {{"bufferView", 0}, {"componentType", 5126}, {"count", 4}, {"type", "VEC3"}},
+        {{"bufferView", 1}, {"componentType", 5126}, {"count", normalCount}, {"type", "VEC3"}},
+        {{"bufferView", 2}, {"componentType", 5126}, {"count", uvCount}, {"type", "VEC2"}},
+        {{"bufferView", 3}, {"componentType", 5125}, {"count", 6}, {"type", "SCALAR"}}};
+    json["meshes"] = {{{"primitives", {{{"attributes", {{"POSITION", 0}, {"NORMAL", 1}, {"TEXCOORD_0", 2}}},
+                                        {"indices", 3}}}}}};
+    std::string text = json.dump();
+    text.resize((text.size() + 3) & ~size_t(3), ' ');
+
+    const uint32_t header[3] = {0x46546C67, 2, uint32_t(12 + 8 + text.size() + 8 + bin.size())};
+    const uint32_t jsonChunk[2] = {uint32_t(text.size()), 0x4E4F534A};
+    const uint32_t binChunk[2] = {uint32_t(bin.size()), 0x004E4942};
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(jsonChunk), sizeof(jsonChunk));
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    out.write(reinterpret_cast<const char*>(binChunk), sizeof(binChunk));
+    out.write(reinterpret_cast<const char*>(bin.data()), static_cast<std::streamsize>(bin.size()));
+}
+
+// NORMAL / TEXCOORD_0 accessors with another count than POSITION are
+// dropped instead of leaving per-vertex arrays of the wrong length
+void checkGlbAttributes(const std::string&) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gravel_check_glb";
+    std::filesystem::create_directories(dir);
+    std::string path = (dir / "quad.glb").string();
+    struct Case { size_t normals, uvs; };
+    for (Case c : {Case{4, 4}, Case{3, 4}, Case{4, 5}, Case{5, 3}}) {
+        writeQuadGlb(path, c.normals, c.uvs);
+        TriangleMesh mesh = BinaryMeshLoader::loadGlb(path);
+        std::string name = format("%.0f normals, %.0f uvs", double(c.normals), double(c.uvs));
+        require(mesh.positions.size() == 4 && mesh.indices.size() == 6, name + ": quad not loaded");
+        require(mesh.normals.size() == (c.normals == 4 ? 4u : 0u),
+                name + format(": %.0f normals loaded", double(mesh.normals.size())));
+        require(mesh.uvs.size() == (c.uvs == 4 ? 4u : 0u),
+                name + format(": %.0f uvs loaded", double(mesh.uvs.size())));
+    }
+    std::filesystem::remove_all(dir);
+}
+
+// In-memory glTF model: one buffer, one view per accessor
+struct GltfBuilder {
+    tinygltf::Model model;
+
+    GltfBuilder() { model.buffers.resize(1); }
+
+    int add(const void* data, size_t size, size_t count, int componentType, int type,
+            bool normalized = false, int byteStride = 0) {
+        std::vector<unsigned char>& bytes = model.buffers[0].data;
+        tinygltf::BufferView view;
+        view.buffer = 0;
+        view.byteOffset = bytes.size();
+        view.byteLength = size;
+        view.byteStride = byteStride;
+        bytes.insert(bytes.end(), static_cast<const unsigned char*>(data),
+                     static_cast<const unsigned char*>(data) + size);
+        bytes.resize((bytes.size() + 3) & ~size_t(3));
+        model.bufferViews.push_back(view);
+        tinygltf::Accessor accessor;
+        accessor.bufferView = static_cast<int>(model.bufferViews.size() - 1);
+        accessor.componentType = componentType;
+        accessor.type = type;
+        accessor.normalized = normalized;
+        accessor.count = count;
+        model.accessors.push_back(accessor);
+        return static_cast<int>(model.accessors.size() - 1);
+    }
+
+    void addPrimitive(int position, int normal, int uv) {
+        if (model.meshes.empty()) model.meshes.emplace_back();
+        tinygltf::Primitive primitive;
+        primitive.attributes["POSITION"] = position;
+        if (normal >= 0) primitive.attributes["NORMAL"] = normal;
+        if (uv >= 0) primitive.attributes["TEXCOORD_0"] = uv;
+        model.meshes[0].primitives.push_back(primitive);
+    }
+
+    NGonMesh load() const {
+        JointData jointIndices, jointWeights;
+        return GltfLoader::loadMesh(model, jointIndices, jointWeights);
+    }
+};
+
+const float kTrianglePositions[9] = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+
+// One triangle per primitive whose NORMAL (and TEXCOORD_0) are stored as
+// normalized signed integers, as KHR_mesh_quantization allows
+void checkGltfQuantized(const std::string&) {
+    GltfBuilder gltf;
+    // Padded to 4-byte elements (the spec's vertex attribute alignment);
+    // -32768 / -128 clamp to -1
+    const int16_t shortNormals[12] = {32767, 0, 0, 0, 0, -32768, 0, 0, 0, 0, -32767, 0};
+    const int8_t byteNormals[12] = {0, 127, 0, 0, 0, -128, 0, 0, 0, 0, -127, 0};
+    const int8_t byteUVs[12] = {127, -64, 0, 0, -128, 0, 0, 0, 0, 127, 0, 0};
+    int position = gltf.add(kTrianglePositions, sizeof(kTrianglePositions), 3,
+                            TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+    int shortNormal = gltf.add(shortNormals, sizeof(shortNormals), 3,
+                               TINYGLTF_COMPONENT_TYPE_SHORT, TINYGLTF_TYPE_VEC3, true, 8);
+    int byteNormal = gltf.add(byteNormals, sizeof(byteNormals), 3,
+                              TINYGLTF_COMPONENT_TYPE_BYTE, TINYGLTF_TYPE_VEC3, true, 4);
+    int byteUV = gltf.add(byteUVs, sizeof(byteUVs), 3, TINYGLTF_COMPONENT_TYPE_BYTE, TINYGLTF_TYPE_VEC2, true, 4);
+    gltf.addPrimitive(position, shortNormal, byteUV);
+    gltf.addPrimitive(position, byteNormal, byteUV);
+
+    NGonMesh loaded = gltf.load();
+    const glm::vec3 wantNormals[6] = {{1, 0, 0}, {0, -1, 0}, {0, 0, -1}, {0, 1, 0}, {0, -1, 0}, {0, 0, -1}};
+    const glm::vec2 wantUVs[3] = {{1.0f, -64.0f / 127.0f}, {-1.0f, 0.0f}, {0.0f, 1.0f}};
+    require(loaded.normals.size() == 6 && loaded.texCoords.size() == 6, "attributes not loaded");
+    for (size_t i = 0; i < 6; i++) {
+        require(glm::length(loaded.normals[i] - wantNormals[i]) < 1e-6f,
+                format("normal %.0f is off by %g", double(i), glm::length(loaded.normals[i] - wantNormals[i])));
+        require(glm::length(loaded.texCoords[i] - wantUVs[i % 3]) < 1e-6f,
+                format("uv %.0f is (%g, %g)", double(i), loaded.texCoords[i].x, loaded.texCoords[i].y));
+    }
+}
+
+// Malformed .gltf input fails cleanly: attributes shorter than POSITION are
+// dropped, and accessors or views past their data throw
+void checkGltfMalformed(const std::string&) {
+    const float normals[6] = {0, 0, 1, 0, 0, 1};
+    const float uvs[4] = {0.5f, 0.5f, 0.5f, 0.5f};
+    {
+        GltfBuilder gltf;
+        int position = gltf.add(kTrianglePositions, sizeof(kTrianglePositions), 3,
+                                TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+        // Two entries for three positions: dropped, so normals come from the
+        // face and UVs default to 0
+        int normal = gltf.add(normals, sizeof(normals), 2, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+        int uv = gltf.add(uvs, sizeof(uvs), 2, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC2);
+        gltf.addPrimitive(position, normal, uv);
+        NGonMesh loaded = gltf.load();
+        require(loaded.normals.size() == 3 && loaded.texCoords.size() == 3, "short attributes: wrong vertex count");
+        for (size_t i = 0; i < 3; i++) {
+            require(loaded.normals[i] == glm::vec3(0, 0, 1) && loaded.texCoords[i] == glm::vec2(0.0f),
+                    format("short attributes: vertex %.0f kept data past the accessor", double(i)));
+        }
+    }
+
+    auto requireThrows = [](const GltfBuilder& gltf, const std::string& what) {
+        bool threw = false;
+        try {
+            gltf.load();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        require(threw, what + " was read instead of rejected");
+    };
+    {
+        GltfBuilder gltf;
+        int position = gltf.add(kTrianglePositions, sizeof(kTrianglePositions), 3,
+                                TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+        gltf.model.accessors[position].count = 4;
+        gltf.addPrimitive(position, -1, -1);
+        requireThrows(gltf, "an accessor longer than its view");
+    }
+    {
+        GltfBuilder gltf;
+        int position = gltf.add(kTrianglePositions, sizeof(kTrianglePositions), 3,
+                                TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+        gltf.model.bufferViews[0].byteLength = 1 << 20;
+        gltf.model.accessors[position].byteOffset = 1 << 19;
+        gltf.addPrimitive(position, -1, -1);
+        requireThrows(gltf, "a view past the end of its buffer");
+    }
+}
+
+// Vertices with no finite nearest neighbour (NaN or infinite coordinates)
+// stay unmatched instead of indexing past the k-d tree
+void checkVertexMatch(const std::string&) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    KdTree tree;
+    tree.build({glm::vec3(nan), glm::vec3(inf, 0, 0)});
+    require(tree.nearest(glm::vec3(0.0f)) == SIZE_MAX, "matched a point at no finite distance");
+    tree.build({glm::vec3(0.0f), glm::vec3(1.0f)});
+    require(tree.nearest(glm::vec3(nan, 0, 0)) == SIZE_MAX, "matched a NaN query");
+    require(tree.nearest(glm::vec3(0.9f)) == 1, "wrong nearest point");
+
+    GltfBuilder gltf;
+    const float uvs[6] = {0.25f, 0.25f, 0.5f, 0.5f, 0.75f, 0.75f};
+    int position = gltf.add(kTrianglePositions, sizeof(kTrianglePositions), 3,
+                            TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+    int uv = gltf.add(uvs, sizeof(uvs), 3, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC2);
+    gltf.addPrimitive(position, -1, uv);
+    // Fixed alignment (glTF scaled by 2), so the NaN vertex cannot skew the fit
+    Skeleton skeleton;
+    skeleton.objAlignTransform = glm::scale(glm::mat4(1.0f), glm::vec3(2.0f));
+    std::vector<glm::vec3> objPositions = {{0, 0, 0}, {2, 0, 0}, glm::vec3(nan), {0, 2, 0}};
+    std::vector<glm::vec2> outUVs;
+    GltfLoader::matchUVsToObjMesh(gltf.model, objPositions, skeleton, outUVs);
+    require(outUVs.size() == 4, "wrong UV count");
+    require(outUVs[0] == glm::vec2(0.25f) && outUVs[1] == glm::vec2(0.5f) && outUVs[3] == glm::vec2(0.75f),
+            "finite vertices matched wrongly");
+    require(outUVs[2] == glm::vec2(0.0f), "NaN vertex was given a UV");
+}
+
+// ---------------------------------------------------------------------------
+// GRWM slot packing
+// ---------------------------------------------------------------------------
+
+// unorm16 slot uvs come back within one quantisation step anywhere in
+// [0, 1]^2, the edges included, and the edges exactly
+void checkSlotPacking(const std::string&) {
+    const uint32_t steps = 2048;
+    float worst = 0.0f;
+    glm::vec2 worstUV(0.0f);
+    for (uint32_t j = 0; j <= steps; j++) {
+        for (uint32_t i = 0; i <= steps; i++) {
+            // Off the 1/65535 lattice on purpose, except at 0 and 1
+            glm::vec2 uv(float(i) / steps, float(j) / steps);
+            glm::vec2 back = unpackSlotUV(packSlotUV(uv.x, uv.y));
+            float error = std::max(std::abs(back.x - uv.x), std::abs(back.y - uv.y));
+            if (error > worst) { worst = error; worstUV = uv; }
+        }
+    }
+    require(worst <= 1.0f / 65535.0f, format("worst round trip error %g at (%g, %g)",
+                                             worst, worstUV.x, worstUV.y));
+    for (float u : {0.0f, 1.0f}) {
+        for (float v : {0.0f, 1.0f}) {
+            require(unpackSlotUV(packSlotUV(u, v)) == glm::vec2(u, v),
+                    format("corner (%g, %g) does not round trip exactly", u, v));
+        }
+    }
+}
+
+// Slot position as parametric.task computes it from a packed slot
+glm::vec3 placeSlot(const glm::vec3* p, uint32_t count, PackedSlot slot) {
+    glm::vec2 uv = unpackSlotUV(slot);
+    float su = uv.x, sv = uv.y;
+    if (count != 3) {
+        return (1 - su) * (1 - sv) * p[0] + su * (1 - sv) * p[1] + su * sv * p[2] + (1 - su) * sv * p[3];
+    }
+    if (su + sv > 1) { su = 1 - su; sv = 1 - sv; }
+    return (1 - su - sv) * p[0] + su * p[1] + sv * p[2];
+}
+
+// Generated slots, placed the way the task shader places them, land inside
+// the face and cover all of it: a quad's slots must not fold onto one half
+void checkSlotPlacement(const std::string&) {
+    const glm::vec3 positions[7] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0},
+                                    {2, 0, 0}, {3, 0, 0}, {3, 1, 0}, {2, 1, 0}};
+    const uint32_t offsets[3] = {0, 3, 7};
+    const uint32_t indices[7] = {0, 1, 2, 3, 4, 5, 6};
+    SlotGenerator::Faces faces;
+    faces.vertexPositions = positions;
+    faces.faceVertOffsets = offsets;
+    faces.faceVertIndices = indices;
+    faces.nbFaces = 2;
+    SlotGenerator::Settings settings;
+    std::vector<PackedSlot> slots = SlotGenerator::generate(faces, settings);
+    const uint32_t S = settings.slotsPerFace;
+    require(slots.size() == 2 * S, "wrong slot count");
+
+    for (uint32_t s = 0; s < S; s++) {
+        glm::vec3 q = placeSlot(positions, 3, slots[s]);
+        require(q.x >= -1e-6f && q.y >= -1e-6f && q.x + q.y <= 1 + 1e-4f,
+                format("triangle slot %.0f placed outside at (%g, %g)", double(s), q.x, q.y));
+    }
+    // Quad slot 0 is the centre; count the rest per diagonal half
+    uint32_t upper = 0;
+    for (uint32_t s = 1; s < S; s++) {
+        glm::vec3 q = placeSlot(positions + 3, 4, slots[S + s]) - positions[3];
+        require(q.x >= 0 && q.x <= 1 && q.y >= 0 && q.y <= 1,
+                format("quad slot %.0f placed outside at (%g, %g)", double(s), q.x, q.y));
+        if (q.x + q.y > 1) upper++;
+    }
+    double fraction = double(upper) / (S - 1);
+    require(fraction > 0.35 && fraction < 0.65,
+            format("%.0f%% of the quad's slots are in its upper half", fraction * 100));
+}
+
+// GRWM data that already matches the mesh is used in place (the spans point
+// into the open container); data that needs a remap is copied and remapped
+void checkGrvpRead(const std::string&) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gravel_check_grvp";
+    std::filesystem::create_directories(dir / "preprocess");
+    const std::string meshPath = (dir / "mesh.obj").string();
+
+    // Two triangles, two slots each, priorities descending per triangle
+    const float curvature[4] = {0.5f, 1.0f, 2.0f, 4.0f};
+    const uint32_t features[2] = {1, 2};
+    const PackedSlot slots[4] = {packSlotUV(0.1f, 0.1f), packSlotUV(0.2f, 0.2f),
+                                 packSlotUV(0.3f, 0.3f), packSlotUV(0.4f, 0.4f)};
+    const uint16_t priorities[4] = {packSlotPriority(4), packSlotPriority(1),
+                                    packSlotPriority(3), packSlotPriority(2)};
+    GrvpFile::writeV2((dir / "preprocess" / GrvpFile::V2_FILENAME).string(), 4, 2, 5, 2,
+                      curvature, features, slots, priorities);
+
+    const int triangles[2] = {3, 3};
+    GrwmPreprocessData direct = GrwmPreprocessData::read(meshPath, 4, 2, triangles, nullptr, 0, 0);
+    require(direct.loaded, "matching data was not loaded");
+    require(direct.source.isOpen() && direct.remappedCurvature.empty() &&
+            direct.remappedFeatures.empty() && direct.remappedSlots.empty(),
+            "matching data was copied");
+    require(direct.curvature.data() == direct.source.curvature() &&
+            direct.features.data() == direct.source.features() &&
+            direct.slots.data() == direct.source.slots(), "spans do not point into the container");
+    require(direct.slots.size() == 4 && direct.slots[3] == slots[3], "wrong slots");
+
+    // The same two triangles as one quad: features OR, slots merged by priority
+    const int quad[1] = {4};
+    GrwmPreprocessData merged = GrwmPreprocessData::read(meshPath, 4, 1, quad, nullptr, 0, 0);
+    std::filesystem::remove_all(dir);
+    require(merged.loaded, "remapped data was not loaded");
+    require(merged.features.size() == 1 && merged.features[0] == 3, "features not merged");
+    require(merged.slots.data() == merged.remappedSlots.data() && merged.slots.size() == 2 &&
+            merged.slots[0] == slots[0] && merged.slots[1] == slots[2], "slots not merged by priority");
+}
+
+// v1 preprocess files whose size disagrees with their header are rejected
+// before any pointer into them is handed out
+void checkGrvpV1Sizes(const std::string&) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gravel_check_grvp_v1";
+    std::filesystem::create_directories(dir);
+    auto writeV1 = [&](const char* name, uint32_t vertices, uint32_t faces, uint32_t slotsPerFace,
+                       size_t payloadBytes) {
+        PreprocessHeader hdr{};
+        hdr.magic = GRVP_MAGIC;
+        hdr.version = GRVP_VERSION_1;
+        hdr.vertex_count = vertices;
+        hdr.face_count = faces;
+        hdr.slots_per_face = slotsPerFace;
+        std::ofstream f(dir / name, std::ios::binary | std::ios::trunc);
+        f.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        std::vector<char> payload(payloadBytes, 0);
+        f.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    };
+    auto opens = [&] {
+        GrvpFile grvp;
+        try {
+            return grvp.open(dir.string(), false);
+        } catch (const std::runtime_error&) {
+            return false;
+        }
+    };
+
+    writeV1("curvature.bin", 3, 1, 2, 3 * sizeof(float));
+    writeV1("features.bin", 3, 1, 2, 1);
+    writeV1("slots.bin", 3, 1, 2, 2 * sizeof(SlotEntry));
+    require(opens(), "consistent v1 files were rejected");
+
+    writeV1("curvature.bin", 3, 1, 2, 4 * sizeof(float));
+    require(!opens(), "curvature with trailing data was accepted");
+    writeV1("curvature.bin", 3, 1, 2, 3 * sizeof(float));
+    writeV1("slots.bin", 3, 1, 0xFFFFFFFFu, 2 * sizeof(SlotEntry));
+    require(!opens(), "slots claiming more entries than the file holds were accepted");
+    std::filesystem::remove_all(dir);
+}
+
+// Slot merge onto n-gons keeps the top priorities whether or not GRWM wrote
+// each triangle's slots in priority order
+void checkSlotMerge(const std::string&) {
+    const std::vector<uint32_t> quad = {0, 2};
+    PackedSlot slots[6];
+    for (uint32_t i = 0; i < 6; i++) slots[i] = packSlotUV(0.1f * (i + 1), 0.0f);
+    auto merge = [&](std::initializer_list<float> priorities) {
+        std::vector<uint16_t> packed;
+        for (float p : priorities) packed.push_back(packSlotPriority(p));
+        std::vector<PackedSlot> out;
+        GrwmRemap::slots(slots, packed.data(), 3, quad, out);
+        require(out.size() == 3, "wrong slot count");
+        return out;
+    };
+
+    std::vector<PackedSlot> sorted = merge({9, 5, 1, 8, 4, 2});
+    require(sorted[0] == slots[0] && sorted[1] == slots[3] && sorted[2] == slots[1],
+            "sorted children merged out of priority order");
+    // Second triangle's best slot last, first triangle's in the middle
+    std::vector<PackedSlot> unsorted = merge({1, 9, 5, 4, 2, 8});
+    require(unsorted[0] == slots[1] && unsorted[1] == slots[5] && unsorted[2] == slots[2],
+            "unsorted children lost their top slots");
+}
+
+// Preprocess cache keys tell apart every input that changes the output:
+// mesh contents, slots per face, backend (down to which build of the
+// external binary), and thresholds closer than any printed rounding
+void checkGrwmCacheKey(const std::string&) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gravel_check_grwm";
+    std::filesystem::create_directories(dir);
+    GrwmJobManager::Request request;
+    request.meshPath = (dir / "mesh.obj").string();
+    std::ofstream(request.meshPath) << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+
+    std::vector<std::string> keys;
+    auto addKey = [&](const GrwmJobManager::Request& r) { keys.push_back(GrwmJobManager::cacheKey(r)); };
+    addKey(request);
+    require(GrwmJobManager::cacheKey(request) == keys[0], "key is not deterministic");
+    for (float threshold : {30.001f, 29.999f, std::nextafter(30.0f, 31.0f), 45.0f}) {
+        GrwmJobManager::Request r = request;
+        r.featureThreshold = threshold;
+        addKey(r);
+    }
+    GrwmJobManager::Request slots = request;
+    slots.slotsPerFace = 32;
+    addKey(slots);
+    // External binaries by path, and the same path once rebuilt
+    GrwmJobManager::Request cuda = request;
+    cuda.binaryPath = (dir / "cuda_preprocess").string();
+    std::ofstream(cuda.binaryPath) << "build 1";
+    addKey(cuda);
+    GrwmJobManager::Request otherCuda = request;
+    otherCuda.binaryPath = (dir / "cuda_preprocess_old").string();
+    std::ofstream(otherCuda.binaryPath) << "build 1";
+    addKey(otherCuda);
+    std::ofstream(cuda.binaryPath) << "build 22";
+    addKey(cuda);
+    std::ofstream(request.meshPath, std::ios::app) << "f 3 2 1\n";
+    addKey(request);
+    std::filesystem::remove_all(dir);
+
+    for (size_t i = 0; i < keys.size(); i++)
+        for (size_t j = i + 1; j < keys.size(); j++)
+            require(keys[i] != keys[j], "two requests share the key " + keys[i]);
+}
+
+// ---------------------------------------------------------------------------
+// Job system
+// ---------------------------------------------------------------------------
+
+// Chunks a background task splits off stay background work: a thread
+// helping in wait() for its own parallelFor must never pick one up
+void checkBackgroundJobs(const std::string&) {
+    JobSystem jobs(2);
+    const std::thread::id caller = std::this_thread::get_id();
+    std::atomic<uint32_t> chunks{0}, onCaller{0};
+    JobSystem::Counter loading;
+    jobs.submitBackground([&] {
+        jobs.parallelFor(64, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                chunks++;
+                if (std::this_thread::get_id() == caller) onCaller++;
+            }
+        });
+    }, loading);
+    while (!loading.done()) {
+        jobs.parallelFor(16, 1, [](size_t, size_t) { std::this_thread::sleep_for(std::chrono::microseconds(200)); });
+    }
+    jobs.wait(loading);
+    require(chunks == 64, format("%.0f of 64 background chunks ran", chunks.load()));
+    require(onCaller == 0, format("%.0f background chunks ran on the waiting thread", onCaller.load()));
+}
+
+struct Check {
+    const char* name;
+    void (*fn)(const std::string& assetsDir);
+};
+
+const Check kChecks[] = {
+    {"anim_bake",      checkAnimationBake},
+    {"anim_crossfade", checkCrossfade},
+    {"package_bake",   checkPackageBake},
+    {"parametric",     checkParametricElements},
+    {"grid_weld",      checkGridWeld},
+    {"lod_budget",     checkLodBudget},
+    {"mesh_generator", checkMeshGenerator},
+    {"pebble_counts",  checkPebbleCounts},
+    {"meshlet_export", checkMeshletRoundTrip},
+    {"glb_attributes", checkGlbAttributes},
+    {"gltf_quantized", checkGltfQuantized},
+    {"gltf_malformed", checkGltfMalformed},
+    {"vertex_match",   checkVertexMatch},
+    {"slot_packing",   checkSlotPacking},
+    {"slot_placement", checkSlotPlacement},
+    {"grvp_read",      checkGrvpRead},
+    {"grvp_v1_sizes",  checkGrvpV1Sizes},
+    {"slot_merge",     checkSlotMerge},
+    {"grwm_cache_key", checkGrwmCacheKey},
+    {"job_background", checkBackgroundJobs},
+};
+
+} // namespace
+
+int BenchChecks::run(const std::string& filter, const std::string& assetsDir) {
+    int failed = 0;
+    for (const Check& check : kChecks) {
+        std::string name = check.name;
+        if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+
+        std::string status = "PASS", detail;
+        // The stages log every step, and the loaders warn about missing textures
+        std::streambuf* savedOut = std::cout.rdbuf(nullptr);
+        std::streambuf* savedErr = std::cerr.rdbuf(nullptr);
+        try {
+            check.fn(assetsDir);
+        } catch (const Skipped& e) {
+            status = "SKIP";
+            detail = e.what();
+        } catch (const std::exception& e) {
+            status = "FAIL";
+            detail = e.what();
+            failed++;
+        }
+        std::cout.rdbuf(savedOut);  // also clears the badbit the null buffer set
+        std::cerr.rdbuf(savedErr);
+
+        char line[64];
+        std::snprintf(line, sizeof(line), "  %-18s %s", name.c_str(), status.c_str());
+        std::cout << line << (detail.empty() ? "" : ": " + detail) << std::endl;
+    }
+    return failed;
+}
@@ -0,0 +1,125 @@
+#include "bench/BenchHarness.h"
+#include "core/JobSystem.h"
+#include "core/MemoryTracker.h"
+#include "json.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Restores std::cout even if a case throws
+struct SilenceCout {
+    std::streambuf* saved;
+    explicit SilenceCout(std::streambuf* sink) : saved(std::cout.rdbuf(sink)) {}
+    ~SilenceCout() { std::cout.rdbuf(saved); }
+};
+
+} // namespace
+
+BenchHarness::BenchHarness(const Options& options) : options(options) {}
+
+bool BenchHarness::enabled(const std::string& name) const {
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+void BenchHarness::run(const std::string& name, const std::string& fixture,
+                       const std::string& unit, uint64_t elements,
+                       const std::function<void()>& setup,
+                       const std::function<void()>& body) {
+    if (!enabled(name)) return;
+
+    std::vector<double> samples;
+    samples.reserve(options.iterations);
+    uint64_t hostPeak = 0;
+    {
+        SilenceCout silence(&nullBuffer);
+        for (uint32_t i = 0; i < options.warmup + options.iterations; i++) {
+            if (setup) setup();
+            MemoryTracker::resetPeaks();
+            uint64_t hostBase = MemoryTracker::totalCurrent();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto stop = std::chrono::steady_clock::now();
+            if (i >= options.warmup) {
+                samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+                hostPeak = std::max(hostPeak, MemoryTracker::totalPeak() - hostBase);
+            }
+        }
+    }
+
+    Result result;
+    result.name = name;
+    result.fixture = fixture;
+    result.unit = unit;
+    result.elements = elements;
+    result.iterations = static_cast<uint32_t>(samples.size());
+    result.hostPeakBytes = hostPeak;
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+        result.minNs = samples.front();
+        size_t mid = samples.size() / 2;
+        result.medianNs = (samples.size() % 2) ? samples[mid] : 0.5 * (samples[mid - 1] + samples[mid]);
+        result.meanNs = std::accumulate(samples.begin(), samples.end(), 0.0) / double(samples.size());
+    }
+    resultList.push_back(result);
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "  %-18s %-14s %12.3f ms  %10.2f ns/%s",
+                  name.c_str(), fixture.c_str(), result.medianNs * 1e-6,
+                  result.nsPerElement(), unit.c_str());
+    std::cout << line << std::endl;
+}
+
+void BenchHarness::printTable(std::ostream& out) const {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-18s %-14s %12s %12s %12s %14s %12s",
+                  "case", "fixture", "elements", "min ms", "median ms", "ns/element", "host peak MB");
+    out << line << "\n";
+    for (const Result& r : resultList) {
+        std::snprintf(line, sizeof(line), "%-18s %-14s %12llu %12.3f %12.3f %14.2f %12.2f",
+                      r.name.c_str(), r.fixture.c_str(),
+                      static_cast<unsigned long long>(r.elements),
+                      r.minNs * 1e-6, r.medianNs * 1e-6, r.nsPerElement(),
+                      r.hostPeakBytes / (1024.0 * 1024.0));
+        out << line << "\n";
+    }
+    out.flush();
+}
+
+void BenchHarness::writeJson(const std::string& path) const {
+    nlohmann::json json;
+    json["suite"] = "gravel_bench";
+    json["version"] = 1;
+    json["hardware_threads"] = std::thread::hardware_concurrency();
+    json["threads"] = JobSystem::get().threadCount();
+    json["warmup"] = options.warmup;
+    json["iterations"] = options.iterations;
+    nlohmann::json results = nlohmann::json::array();
+    for (const Result& r : resultList) {
+        results.push_back({
+            {"name", r.name},
+            {"fixture", r.fixture},
+            {"unit", r.unit},
+            {"elements", r.elements},
+            {"iterations", r.iterations},
+            {"min_ns", r.minNs},
+            {"median_ns", r.medianNs},
+            {"mean_ns", r.meanNs},
+            {"ns_per_element", r.nsPerElement()},
+            {"host_peak_bytes", r.hostPeakBytes},
+        });
+    }
+    json["results"] = results;
+
+    std::ofstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Cannot open file for writing: " + path);
+    file << json.dump(2) << "\n";
+    if (!file) throw std::runtime_error("Write failed: " + path);
+}
@@ -0,0 +1,410 @@
+// gravel_bench: headless timings of the CPU mesh pipeline, from OBJ parsing
+// to export, on the shipped assets and on generated meshes. Links no Vulkan
+// or windowing code, so it runs on any machine that builds the CPU modules.
+//
+//   gravel_bench [--mesh NAME|PATH.obj]... [--synthetic SHAPE:RES[:NOISE]]...
+//                [--grid N]... [--iterations N] [--warmup N]
+//                [--filter CASE] [--json FILE] [--trace FILE] [--threads N]
+//                [--assets DIR] [--check]
+
+#include "bench/BenchHarness.h"
+#include "bench/BenchChecks.h"
+#include "loaders/ObjLoader.h"
+#include "loaders/ObjWriter.h"
+#include "loaders/GltfLoader.h"
+#include "geometry/HalfEdge.h"
+#include "geometry/ElementCull.h"
+#include "geometry/MeshGenerator.h"
+#include "preprocess/GrwmRemap.h"
+#include "core/JobSystem.h"
+#include "core/MemoryTracker.h"
+#include "core/Trace.h"
+
+#include <tiny_gltf.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Runs fn with std::cout silenced, for fixture preparation outside the
+// timed cases (the loaders log every stage)
+template <typename Fn>
+void quietly(Fn&& fn) {
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    try {
+        fn();
+    } catch (...) {
+        std::cout.rdbuf(saved);
+        throw;
+    }
+    std::cout.rdbuf(saved);  // also clears the badbit the null buffer set
+}
+
+struct Fixture {
+    std::string name;
+    std::string objPath;   // empty for synthetic meshes
+    std::string gltfPath;  // glTF counterpart for spatial matching, may be empty
+    NGonMesh    ngon;
+    bool        synthetic = false;
+    MeshGenerator::Settings generator;  // when synthetic
+};
+
+// "SHAPE:RES[:NOISE]", e.g. "icosphere:64" or "grid:256:0.05"
+MeshGenerator::Settings parseSynthetic(const std::string& spec) {
+    MeshGenerator::Settings settings;
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos || !MeshGenerator::parseShape(spec.substr(0, colon), settings.shape))
+        throw std::runtime_error("Bad synthetic mesh: " + spec);
+    std::string rest = spec.substr(colon + 1);
+    size_t noise = rest.find(':');
+    settings.resolution = static_cast<uint32_t>(std::stoul(rest.substr(0, noise)));
+    if (noise != std::string::npos) settings.noiseAmplitude = std::stof(rest.substr(noise + 1));
+    return settings;
+}
+
+// Stand-in for an exported glTF: the OBJ positions in reverse order, scaled
+// and offset, as one POSITION-only primitive
+tinygltf::Model makeMatchModel(const std::vector<glm::vec3>& positions) {
+    tinygltf::Model model;
+    tinygltf::Buffer buffer;
+    buffer.data.resize(positions.size() * sizeof(glm::vec3));
+    float* dst = reinterpret_cast<float*>(buffer.data.data());
+    for (size_t i = 0; i < positions.size(); i++) {
+        glm::vec3 p = positions[positions.size() - 1 - i] * 0.01f + glm::vec3(0.2f, -0.1f, 0.05f);
+        std::memcpy(dst + i * 3, &p, sizeof(p));
+    }
+    model.buffers.push_back(std::move(buffer));
+
+    tinygltf::BufferView view;
+    view.buffer = 0;
+    view.byteLength = positions.size() * sizeof(glm::vec3);
+    model.bufferViews.push_back(view);
+
+    tinygltf::Accessor accessor;
+    accessor.bufferView = 0;
+    accessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+    accessor.type = TINYGLTF_TYPE_VEC3;
+    accessor.count = positions.size();
+    model.accessors.push_back(accessor);
+
+    tinygltf::Primitive primitive;
+    primitive.attributes["POSITION"] = 0;
+    tinygltf::Mesh mesh;
+    mesh.primitives.push_back(primitive);
+    model.meshes.push_back(mesh);
+    return model;
+}
+
+// The per-element arrays uploadHalfEdgeMesh keeps for the pre-cull
+struct CullInput {
+    TrackedVector<glm::vec3, MemTag::CpuMesh> faceCenters, faceNormals, vertexPositions, vertexNormals;
+    TrackedVector<float, MemTag::CpuMesh>     faceAreas, vertexFaceAreas;
+    TrackedVector<glm::vec2, MemTag::CpuMesh> faceUVs, vertexUVs;
+
+    explicit CullInput(const HalfEdgeMesh& mesh) {
+        faceAreas.assign(mesh.faceAreas.begin(), mesh.faceAreas.end());
+        for (uint32_t i = 0; i < mesh.nbFaces; i++) {
+            faceCenters.push_back(glm::vec3(mesh.faceCenters[i]));
+            faceNormals.push_back(glm::vec3(mesh.faceNormals[i]));
+            faceUVs.push_back(mesh.vertexTexCoords[mesh.heVertex[mesh.faceEdges[i]]]);
+        }
+        for (uint32_t i = 0; i < mesh.nbVertices; i++) {
+            vertexPositions.push_back(glm::vec3(mesh.vertexPositions[i]));
+            vertexNormals.push_back(glm::vec3(mesh.vertexNormals[i]));
+            int edge = mesh.vertexEdges[i];
+            vertexFaceAreas.push_back(edge >= 0 ? mesh.faceAreas[mesh.heFace[edge]] : 0.0f);
+            vertexUVs.push_back(mesh.vertexTexCoords[i]);
+        }
+    }
+
+    ElementCull::Elements elements() const {
+        ElementCull::Elements e;
+        e.faceCenters = faceCenters.data();
+        e.faceNormals = faceNormals.data();
+        e.faceAreas = faceAreas.data();
+        e.faceUVs = faceUVs.data();
+        e.nbFaces = static_cast<uint32_t>(faceCenters.size());
+        e.vertexPositions = vertexPositions.data();
+        e.vertexNormals = vertexNormals.data();
+        e.vertexFaceAreas = vertexFaceAreas.data();
+        e.vertexUVs = vertexUVs.data();
+        e.nbVertices = static_cast<uint32_t>(vertexPositions.size());
+        return e;
+    }
+};
+
+void runFixture(BenchHarness& bench, const Fixture& fx) {
+    const NGonMesh& ngon = fx.ngon;
+    const std::string& name = fx.name;
+    std::cout << name << ": " << ngon.nbVertices << " vertices, " << ngon.nbFaces << " faces" << std::endl;
+
+    // NGonMesh and the other stage outputs below are plain std::vectors, so
+    // each body charges what it produced (as MeshPackage::prepare does) for
+    // host_peak_bytes to see it
+    NGonMesh work;
+    auto chargeWork = [&] { return MemoryTracker::Charge(MemTag::MeshLoad, work.sizeBytes()); };
+    if (!fx.objPath.empty()) {
+        bench.run("obj_load", name, "face", ngon.nbFaces, {},
+                  [&] { work = ObjLoader::load(fx.objPath); auto charge = chargeWork(); });
+    }
+    if (fx.synthetic) {
+        HalfEdgeMesh generated;
+        bench.run("generate", name, "face", ngon.nbFaces,
+                  [&] { generated = HalfEdgeMesh{}; }, [&] { generated = MeshGenerator::generate(fx.generator); });
+    }
+    bench.run("triangulate", name, "face", ngon.nbFaces,
+              [&] { work = ngon; }, [&] { ObjLoader::triangulate(work); auto charge = chargeWork(); });
+    bench.run("subdivide", name, "face", ngon.nbFaces,
+              [&] { work = ngon; }, [&] { ObjLoader::subdivide(work, 1); auto charge = chargeWork(); });
+    bench.run("subdivide_flat", name, "face", ngon.nbFaces,
+              [&] { work = ngon; }, [&] { ObjLoader::subdivideFlat(work, 1); auto charge = chargeWork(); });
+
+    HalfEdgeMesh he;
+    bench.run("halfedge_build", name, "face", ngon.nbFaces,
+              [&] { he = HalfEdgeMesh{}; }, [&] { he = HalfEdgeBuilder::build(ngon); });
+    if (he.nbFaces == 0) quietly([&] { he = HalfEdgeBuilder::build(ngon); });  // filtered out
+    HalfEdgeMesh colored;
+    bench.run("face2coloring", name, "face", he.nbFaces,
+              [&] { colored = he; }, [&] { computeFace2Coloring(colored); });
+
+    // Pre-cull from a three-quarter view that frames the mesh
+    if (bench.enabled("precull")) {
+        CullInput input(he);
+        glm::vec3 lo(1e30f), hi(-1e30f);
+        for (const glm::vec3& p : ngon.positions) { lo = glm::min(lo, p); hi = glm::max(hi, p); }
+        glm::vec3 center = (lo + hi) * 0.5f;
+        float radius = std::max(glm::length(hi - lo) * 0.5f, 1e-3f);
+        glm::vec3 eye = center + glm::normalize(glm::vec3(0.6f, 0.5f, 1.0f)) * radius * 2.2f;
+        ElementCull::Settings settings;
+        settings.mvp = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, radius * 0.01f, radius * 10.0f) *
+                       glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+        settings.cameraPosition = eye;
+        settings.frustumCulling = true;
+        settings.backfaceCulling = true;
+        ElementCull::VisibleList visible;
+        bench.run("precull", name, "element", uint64_t(he.nbFaces) + he.nbVertices, {},
+                  [&] { ElementCull::run(input.elements(), settings, visible); });
+    }
+
+    // GRWM remap of triangle data shaped like this mesh's triangulation
+    if (bench.enabled("grwm_remap")) {
+        const uint32_t slotsPerFace = 64;
+        std::vector<uint32_t> offsets = GrwmRemap::faceTriangleOffsets(he.faceVertCounts.data(), he.nbFaces);
+        const uint32_t triCount = offsets.back();
+        std::mt19937 rng(1234);
+        std::vector<uint32_t> triFlags(triCount);
+        for (uint32_t& f : triFlags) f = (rng() % 8 == 0) ? 1u : 0u;
+        std::vector<PackedSlot> triSlots(size_t(triCount) * slotsPerFace);
+        std::vector<uint16_t> triPriorities(triSlots.size());
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (uint32_t t = 0; t < triCount; t++) {
+            float priority = 1.0f;
+            for (uint32_t s = 0; s < slotsPerFace; s++) {
+                size_t k = size_t(t) * slotsPerFace + s;
+                priority *= 0.5f + 0.5f * unit(rng);  // descending, as GRWM sorts them
+                triSlots[k] = packSlotUV(unit(rng), unit(rng));
+                triPriorities[k] = packSlotPriority(priority);
+            }
+        }
+        std::vector<float> curvature(ngon.originalVertexCount);
+        for (float& c : curvature) c = unit(rng);
+        bool splitVertices = ngon.originalVertexIndices.size() == ngon.nbVertices;
+
+        std::vector<uint32_t> features;
+        std::vector<PackedSlot> slots;
+        std::vector<float> remapped;
+        bench.run("grwm_remap", name, "face", he.nbFaces, {}, [&] {
+            std::vector<uint32_t> faceTriOffset =
+                GrwmRemap::faceTriangleOffsets(he.faceVertCounts.data(), he.nbFaces);
+            if (splitVertices)
+                GrwmRemap::curvature(curvature.data(), ngon.originalVertexIndices.data(), ngon.nbVertices, remapped);
+            GrwmRemap::features(triFlags.data(), faceTriOffset, features);
+            GrwmRemap::slots(triSlots.data(), triPriorities.data(), slotsPerFace, faceTriOffset, slots);
+            MemoryTracker::Charge charge(MemTag::MeshLoad,
+                MemoryTracker::capacityBytes(faceTriOffset) + MemoryTracker::capacityBytes(remapped)
+                + MemoryTracker::capacityBytes(features) + MemoryTracker::capacityBytes(slots));
+        });
+    }
+
+    // OBJ -> glTF nearest-vertex matching, against the real glTF when shipped
+    if (bench.enabled("spatial_match")) {
+        tinygltf::Model model;
+        if (!fx.gltfPath.empty()) {
+            quietly([&] { model = GltfLoader::loadModel(fx.gltfPath); });
+        } else {
+            model = makeMatchModel(ngon.positions);
+        }
+        Skeleton skeleton;
+        GltfVertexMatch match;
+        bench.run("spatial_match", name, "vertex", ngon.positions.size(),
+                  [&] { skeleton = Skeleton{}; },
+                  [&] {
+                      GltfLoader::buildVertexMatch(model, ngon.positions, skeleton, match);
+                      MemoryTracker::Charge matchCharge(MemTag::MeshLoad,
+                          MemoryTracker::capacityBytes(match.primitives) + MemoryTracker::capacityBytes(match.gltfPrim)
+                          + MemoryTracker::capacityBytes(match.gltfVert) + MemoryTracker::capacityBytes(match.objToGltf));
+                      MemoryTracker::Charge skeletonCharge(MemTag::Skinning, skeleton.sizeBytes());
+                  });
+    }
+
+    // ObjWriter on the triangulated mesh
+    if (bench.enabled("obj_write")) {
+        NGonMesh tri = ngon;
+        quietly([&] { ObjLoader::triangulate(tri); });
+        std::vector<glm::vec4> positions, normals;
+        std::vector<glm::vec2> uvs(tri.texCoords.begin(), tri.texCoords.end());
+        uvs.resize(tri.positions.size(), glm::vec2(0.0f));
+        for (size_t v = 0; v < tri.positions.size(); v++) {
+            positions.push_back(glm::vec4(tri.positions[v], 1.0f));
+            normals.push_back(glm::vec4(v < tri.normals.size() ? tri.normals[v] : glm::vec3(0.0f), 0.0f));
+        }
+        const std::vector<uint32_t>& indices = tri.faceVertexIndices;
+        const uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+        std::string path = (std::filesystem::temp_directory_path() / "gravel_bench_write.obj").string();
+        // The triangulated copy and the staged arrays are held for the write
+        const size_t heldBytes = tri.sizeBytes() + MemoryTracker::capacityBytes(positions)
+                               + MemoryTracker::capacityBytes(normals) + MemoryTracker::capacityBytes(uvs);
+        bench.run("obj_write", name, "triangle", numTriangles, {}, [&] {
+            MemoryTracker::Charge charge(MemTag::MeshLoad, heldBytes);
+            ObjWriter::write(path, positions.data(), normals.data(), uvs.data(), indices.data(),
+                             static_cast<uint32_t>(positions.size()), numTriangles);
+        });
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+}
+
+void printUsage() {
+    std::cout << "Usage: gravel_bench [options]\n"
+                 "  --mesh NAME|PATH   asset mesh (assets/base_mesh/NAME/NAME.obj) or an OBJ file;\n"
+                 "                     repeatable, default bunny and dragon\n"
+                 "  --synthetic SPEC   generated mesh SHAPE:RES[:NOISE]; SHAPE is grid, icosphere,\n"
+                 "                     quadsphere, torus, pentagons or mixed, NOISE the\n"
+                 "                     displacement amplitude; repeatable, default\n"
+                 "                     grid:256:0.05 and mixed:256\n"
+                 "  --grid N           same as --synthetic grid:N\n"
+                 "  --iterations N     timed iterations per case (default 5)\n"
+                 "  --warmup N         untimed iterations per case (default 1)\n"
+                 "  --filter CASE      only cases whose name contains CASE\n"
+                 "  --json FILE        write the results as JSON\n"
+                 "  --trace FILE       write a Chrome trace of the run (GRAVEL_TRACING builds)\n"
+                 "  --threads N        job system threads, caller included (default GRAVEL_THREADS\n"
+                 "                     or one per hardware thread)\n"
+                 "  --assets DIR       assets directory (default " ASSETS_DIR ")\n"
+                 "  --check            run the correctness checks instead of timing (--filter\n"
+                 "                     selects checks by name); exits 1 if any fails\n"
+                 "Cases: obj_load generate triangulate subdivide subdivide_flat halfedge_build face2coloring\n"
+                 "       precull grwm_remap spatial_match obj_write" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    TRACE_THREAD_NAME("main");
+    BenchHarness::Options options;
+    std::vector<std::string> meshes;
+    std::vector<MeshGenerator::Settings> synthetics;
+    std::string jsonPath;
+    std::string tracePath;
+    std::string assetsDir = ASSETS_DIR;
+    bool check = false;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+                return argv[++i];
+            };
+            if (arg == "--mesh") meshes.push_back(value());
+            else if (arg == "--synthetic") synthetics.push_back(parseSynthetic(value()));
+            else if (arg == "--grid") synthetics.push_back(parseSynthetic("grid:" + value()));
+            else if (arg == "--iterations") options.iterations = static_cast<uint32_t>(std::stoul(value()));
+            else if (arg == "--warmup") options.warmup = static_cast<uint32_t>(std::stoul(value()));
+            else if (arg == "--filter") options.filter = value();
+            else if (arg == "--json") jsonPath = value();
+            else if (arg == "--trace") tracePath = value();
+            else if (arg == "--threads") JobSystem::configure(std::max(1u, static_cast<uint32_t>(std::stoul(value()))) - 1);
+            else if (arg == "--assets") assetsDir = value();
+            else if (arg == "--check") check = true;
+            else if (arg == "--help" || arg == "-h") { printUsage(); return 0; }
+            else throw std::runtime_error("Unknown option: " + arg);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        printUsage();
+        return 2;
+    }
+    if (check) {
+        std::cout << "Checks:" << std::endl;
+        return BenchChecks::run(options.filter, assetsDir) == 0 ? 0 : 1;
+    }
+    if (meshes.empty() && synthetics.empty()) {
+        meshes = {"bunny", "dragon"};
+        synthetics = {parseSynthetic("grid:256:0.05"), parseSynthetic("mixed:256")};
+    }
+    options.iterations = std::max(options.iterations, 1u);
+
+    BenchHarness bench(options);
+    try {
+        for (const std::string& mesh : meshes) {
+            Fixture fx;
+            std::filesystem::path path(mesh);
+            if (path.extension() != ".obj")
+                path = std::filesystem::path(assetsDir) / "base_mesh" / mesh / (mesh + ".obj");
+            if (!std::filesystem::exists(path)) {
+                std::cerr << "Skipping " << mesh << ": " << path.string() << " not found" << std::endl;
+                continue;
+            }
+            fx.name = path.stem().string();
+            fx.objPath = path.string();
+            std::filesystem::path gltf = std::filesystem::path(path).replace_extension(".gltf");
+            if (std::filesystem::exists(gltf)) fx.gltfPath = gltf.string();
+            quietly([&] { fx.ngon = ObjLoader::load(fx.objPath); });
+            runFixture(bench, fx);
+        }
+        for (const MeshGenerator::Settings& settings : synthetics) {
+            Fixture fx;
+            fx.synthetic = true;
+            fx.generator = settings;
+            fx.name = std::string(MeshGenerator::shapeName(fx.generator.shape)) + "_" +
+                      std::to_string(fx.generator.resolution) +
+                      (fx.generator.noiseAmplitude != 0.0f ? "n" : "");
+            quietly([&] { fx.ngon = MeshGenerator::generateNGon(fx.generator); });
+            runFixture(bench, fx);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << std::endl;
+    bench.printTable(std::cout);
+    if (!jsonPath.empty()) {
+        try {
+            bench.writeJson(jsonPath);
+            std::cout << "Wrote " << jsonPath << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (!tracePath.empty()) {
+        try {
+            Trace::writeChromeJson(tracePath);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
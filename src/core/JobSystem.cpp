@@ -0,0 +1,272 @@
+#include "core/JobSystem.h"
+#include "core/Trace.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace {
+
+// Worker index of the calling thread in the scheduler that owns it
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local int currentWorker = -1;
+// Set while the calling thread runs a background job of that scheduler
+thread_local const JobSystem* backgroundSystem = nullptr;
+
+std::atomic<int64_t> configuredWorkers{-1};
+
+uint32_t defaultWorkerCount() {
+    if (const char* env = std::getenv("GRAVEL_THREADS")) {
+        long threads = std::strtol(env, nullptr, 10);
+        if (threads > 0) return static_cast<uint32_t>(threads - 1);
+    }
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+} // namespace
+
+void JobSystem::configure(uint32_t workerThreads) {
+    configuredWorkers.store(workerThreads, std::memory_order_relaxed);
+}
+
+JobSystem& JobSystem::get() {
+    static JobSystem instance([] {
+        int64_t configured = configuredWorkers.load(std::memory_order_relaxed);
+        return configured >= 0 ? static_cast<uint32_t>(configured) : defaultWorkerCount();
+    }());
+    return instance;
+}
+
+JobSystem::JobSystem(uint32_t workerThreads) {
+    for (uint32_t i = 0; i <= workerThreads; i++)
+        queues.push_back(std::make_unique<Queue>());
+    workers.reserve(workerThreads);
+    for (uint32_t i = 0; i < workerThreads; i++)
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    std::cout << "Job system: " << workerThreads << " worker threads" << std::endl;
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void JobSystem::submit(Task task, Counter& counter) {
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    // Work split off a background job is background work too, or a thread
+    // helping in wait() would pick it up
+    if (backgroundSystem == this) {
+        pushBackground(Job{std::move(task), &counter, true});
+        return;
+    }
+    int self = (currentSystem == this) ? currentWorker : -1;
+    Queue& queue = *queues[self >= 0 ? size_t(self) : queues.size() - 1];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(Job{std::move(task), &counter, false});
+    }
+    [[maybe_unused]] int64_t depth = queued.fetch_add(1, std::memory_order_release) + 1;
+    TRACE_COUNTER("jobs queued", depth);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+void JobSystem::wait(Counter& counter) {
+    int self = (currentSystem == this) ? currentWorker : -1;
+    while (!counter.done()) {
+        // A background job waits for its sub-tasks in the background queue
+        if (tryRunOne(self)) continue;
+        if (backgroundSystem == this && tryRunBackground()) continue;
+        std::this_thread::yield();
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(counter.errorMutex);
+        error = std::exchange(counter.error, nullptr);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+void JobSystem::submitBackground(Task task, Counter& counter) {
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    Job job{std::move(task), &counter, true};
+    if (workers.empty()) {
+        execute(job);
+        return;
+    }
+    pushBackground(std::move(job));
+}
+
+void JobSystem::pushBackground(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(background.mutex);
+        background.jobs.push_back(std::move(job));
+    }
+    backgroundQueued.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+JobSystem::Stats JobSystem::stats() const {
+    Stats s;
+    s.workers = workerCount();
+    s.tasksRun = tasksRun.load(std::memory_order_relaxed);
+    s.steals = steals.load(std::memory_order_relaxed);
+    return s;
+}
+
+void JobSystem::workerLoop(uint32_t index) {
+    currentSystem = this;
+    currentWorker = static_cast<int>(index);
+    TRACE_THREAD_NAME(("worker " + std::to_string(index)).c_str());
+
+    while (true) {
+        if (tryRunOne(currentWorker) || tryRunBackground()) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] {
+            return stopping || queued.load(std::memory_order_acquire) > 0
+                            || backgroundQueued.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping) return;
+    }
+}
+
+bool JobSystem::tryRunOne(int self) {
+    Job job;
+    if (!popJob(self, job)) return false;
+    [[maybe_unused]] int64_t depth = queued.fetch_sub(1, std::memory_order_relaxed) - 1;
+    TRACE_COUNTER("jobs queued", depth);
+    execute(job);
+    return true;
+}
+
+bool JobSystem::tryRunBackground() {
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(background.mutex);
+        if (background.jobs.empty()) return false;
+        job = std::move(background.jobs.front());
+        background.jobs.pop_front();
+    }
+    backgroundQueued.fetch_sub(1, std::memory_order_relaxed);
+    execute(job);
+    return true;
+}
+
+bool JobSystem::popJob(int self, Job& job) {
+    // Own queue newest first, for cache locality with what was just split
+    if (self >= 0) {
+        Queue& own = *queues[size_t(self)];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+    // Then the injection queue and the other workers, oldest first
+    const size_t count = queues.size();
+    const size_t start = self >= 0 ? size_t(self) + 1 : count - 1;
+    for (size_t i = 0; i < count; i++) {
+        size_t index = (start + i) % count;
+        if (int(index) == self) continue;
+        Queue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        if (index != count - 1) {
+            [[maybe_unused]] uint64_t stolen = steals.fetch_add(1, std::memory_order_relaxed) + 1;
+            TRACE_COUNTER("job steals", static_cast<int64_t>(stolen));
+        }
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(Job& job) {
+    // Restored afterwards: a background job waiting on its sub-tasks may run
+    // foreground jobs in between, and those split off foreground work
+    const JobSystem* outer = std::exchange(backgroundSystem, job.background ? this : nullptr);
+    {
+        TRACE_ZONE("job");
+        try {
+            job.fn();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.counter->errorMutex);
+            if (!job.counter->error) job.counter->error = std::current_exception();
+        }
+    }
+    backgroundSystem = outer;
+    tasksRun.fetch_add(1, std::memory_order_relaxed);
+    job.counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+TaskGraph::Node TaskGraph::add(const char* name, JobSystem::Task fn, std::initializer_list<Node> dependsOn) {
+    Node node = static_cast<Node>(nodes.size());
+    NodeData& data = nodes.emplace_back();
+    data.name = name;
+    data.fn = std::move(fn);
+    for (Node dependency : dependsOn) {
+        nodes[dependency].successors.push_back(node);
+        data.dependencies++;
+    }
+    return node;
+}
+
+TaskGraph::~TaskGraph() {
+    if (!system || counter.done()) return;
+    try {
+        system->wait(counter);
+    } catch (...) {
+    }
+}
+
+void TaskGraph::start(JobSystem& jobs) {
+    system = &jobs;
+    for (NodeData& data : nodes) data.remaining.store(data.dependencies, std::memory_order_relaxed);
+    for (Node node = 0; node < nodes.size(); node++) {
+        if (nodes[node].dependencies == 0) submitNode(jobs, node);
+    }
+}
+
+void TaskGraph::wait(JobSystem& jobs) {
+    jobs.wait(counter);
+}
+
+void TaskGraph::submitNode(JobSystem& jobs, Node node) {
+    jobs.submit([this, &jobs, node]() {
+        NodeData& data = nodes[node];
+        auto release = [&] {
+            for (Node successor : data.successors) {
+                if (nodes[successor].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    submitNode(jobs, successor);
+            }
+        };
+        if (failed.load(std::memory_order_acquire)) {
+            release();
+            return;
+        }
+        try {
+#if GRAVEL_TRACING
+            Trace::Zone zone(data.name);
+#endif
+            data.fn();
+        } catch (...) {
+            failed = true;
+            release();
+            throw;
+        }
+        release();
+    }, counter);
+}
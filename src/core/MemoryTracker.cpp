@@ -0,0 +1,80 @@
+#include "core/MemoryTracker.h"
+
+namespace {
+
+constexpr size_t kTagCount = static_cast<size_t>(MemTag::Count);
+
+struct Counter {
+    std::atomic<uint64_t> current{0};
+    std::atomic<uint64_t> peak{0};
+    std::atomic<uint64_t> allocations{0};
+};
+
+Counter counters[kTagCount];
+Counter total;
+
+void raisePeak(std::atomic<uint64_t>& peak, uint64_t value) {
+    uint64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+Counter& counter(MemTag tag) { return counters[static_cast<size_t>(tag)]; }
+
+} // namespace
+
+void MemoryTracker::onAlloc(MemTag tag, size_t bytes) {
+    Counter& c = counter(tag);
+    raisePeak(c.peak, c.current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    raisePeak(total.peak, total.current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void MemoryTracker::onFree(MemTag tag, size_t bytes) {
+    counter(tag).current.fetch_sub(bytes, std::memory_order_relaxed);
+    total.current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryTracker::Stats MemoryTracker::stats(MemTag tag) {
+    const Counter& c = counter(tag);
+    return {c.current.load(std::memory_order_relaxed),
+            c.peak.load(std::memory_order_relaxed),
+            c.allocations.load(std::memory_order_relaxed)};
+}
+
+uint64_t MemoryTracker::totalCurrent() { return total.current.load(std::memory_order_relaxed); }
+uint64_t MemoryTracker::totalPeak() { return total.peak.load(std::memory_order_relaxed); }
+
+void MemoryTracker::resetPeaks() {
+    for (Counter& c : counters)
+        c.peak.store(c.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    total.peak.store(total.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+const char* MemoryTracker::tagName(MemTag tag) {
+    switch (tag) {
+        case MemTag::MeshLoad: return "mesh load";
+        case MemTag::HalfEdge: return "half-edge";
+        case MemTag::CpuMesh:  return "CPU mesh";
+        case MemTag::Culling:  return "culling";
+        case MemTag::Skinning: return "skinning";
+        case MemTag::Mask:     return "mask";
+        case MemTag::Count:    break;
+    }
+    return "?";
+}
+
+MemoryTracker::Charge& MemoryTracker::Charge::operator=(Charge&& other) noexcept {
+    if (this != &other) {
+        if (bytes) onFree(tag, bytes);
+        tag = other.tag;
+        bytes = other.bytes;
+        other.bytes = 0;
+    }
+    return *this;
+}
+
+void MemoryTracker::Charge::reset(size_t newBytes) {
+    if (newBytes > bytes) onAlloc(tag, newBytes - bytes);
+    else if (newBytes < bytes) onFree(tag, bytes - newBytes);
+    bytes = newBytes;
+}
@@ -0,0 +1,198 @@
+#include "core/Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint64_t    startNs;
+    uint64_t    endNs;
+    int64_t     value;    // counter sample
+    bool        counter;  // else a complete zone
+};
+
+// One per trace row. Only the owning thread writes; the mutex is there for
+// dumps and clears from other threads and is otherwise uncontended.
+struct Ring {
+    std::mutex         mutex;
+    std::vector<Event> events;
+    uint64_t           written = 0;  // total, the ring keeps the last kRingCapacity
+    uint32_t           tid = 0;
+    std::string        threadName;
+};
+
+struct Registry {
+    std::mutex                         mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::vector<Ring*>                 freeRings;  // released by exited threads
+};
+
+// Leaked so threads exiting during static destruction can still release
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+std::atomic<bool> tracingEnabled{true};
+
+struct ThreadRing {
+    Ring* ring = nullptr;
+
+    Ring& get() {
+        if (ring) return *ring;
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if (!reg.freeRings.empty()) {
+            ring = reg.freeRings.back();
+            reg.freeRings.pop_back();
+        } else {
+            reg.rings.push_back(std::make_unique<Ring>());
+            ring = reg.rings.back().get();
+            ring->tid = static_cast<uint32_t>(reg.rings.size());
+            ring->events.resize(Trace::kRingCapacity);
+        }
+        return *ring;
+    }
+
+    ~ThreadRing() {
+        if (!ring) return;
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.freeRings.push_back(ring);
+    }
+};
+
+thread_local ThreadRing threadRing;
+
+void writeEscaped(std::ostream& out, const char* s) {
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out << '\\' << *s;
+        else if (static_cast<unsigned char>(*s) < 0x20) out << ' ';
+        else out << *s;
+    }
+}
+
+} // namespace
+
+uint64_t Trace::nowNs() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::now() - epoch;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) + 1;
+}
+
+void Trace::record(const char* name, uint64_t startNs, uint64_t endNs) {
+    Ring& ring = threadRing.get();
+    std::lock_guard<std::mutex> lock(ring.mutex);
+    ring.events[ring.written % kRingCapacity] = Event{name, startNs, endNs, 0, false};
+    ring.written++;
+}
+
+void Trace::counter(const char* name, int64_t value) {
+    uint64_t now = nowNs();
+    Ring& ring = threadRing.get();
+    std::lock_guard<std::mutex> lock(ring.mutex);
+    ring.events[ring.written % kRingCapacity] = Event{name, now, now, value, true};
+    ring.written++;
+}
+
+void Trace::setThreadName(const char* name) {
+    Ring& ring = threadRing.get();
+    std::lock_guard<std::mutex> lock(ring.mutex);
+    ring.threadName = name;
+}
+
+void Trace::setEnabled(bool enabled) { tracingEnabled.store(enabled, std::memory_order_relaxed); }
+bool Trace::isEnabled() { return tracingEnabled.load(std::memory_order_relaxed); }
+
+void Trace::clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& ring : reg.rings) {
+        std::lock_guard<std::mutex> ringLock(ring->mutex);
+        ring->written = 0;
+    }
+}
+
+size_t Trace::eventCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t count = 0;
+    for (auto& ring : reg.rings) {
+        std::lock_guard<std::mutex> ringLock(ring->mutex);
+        count += static_cast<size_t>(std::min<uint64_t>(ring->written, kRingCapacity));
+    }
+    return count;
+}
+
+void Trace::writeChromeJson(const std::string& path) {
+    struct Row {
+        uint32_t           tid;
+        std::string        name;
+        std::vector<Event> events;
+    };
+    std::vector<Row> rows;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (auto& ring : reg.rings) {
+            std::lock_guard<std::mutex> ringLock(ring->mutex);
+            Row row;
+            row.tid = ring->tid;
+            row.name = ring->threadName.empty() ? "thread " + std::to_string(ring->tid) : ring->threadName;
+            uint64_t count = std::min<uint64_t>(ring->written, kRingCapacity);
+            row.events.reserve(static_cast<size_t>(count));
+            for (uint64_t i = ring->written - count; i < ring->written; ++i)
+                row.events.push_back(ring->events[i % kRingCapacity]);
+            rows.push_back(std::move(row));
+        }
+    }
+
+    std::ofstream out(path);
+    if (!out.is_open()) throw std::runtime_error("Cannot open file for writing: " + path);
+
+    // Timestamps in microseconds with nanosecond decimals
+    char number[64];
+    auto micros = [&](uint64_t ns) {
+        std::snprintf(number, sizeof(number), "%llu.%03llu",
+                      static_cast<unsigned long long>(ns / 1000),
+                      static_cast<unsigned long long>(ns % 1000));
+        return number;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    size_t total = 0;
+    for (const Row& row : rows) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << row.tid << ",\"args\":{\"name\":\"";
+        writeEscaped(out, row.name.c_str());
+        out << "\"}}";
+        first = false;
+        for (const Event& e : row.events) {
+            out << ",\n{\"name\":\"";
+            writeEscaped(out, e.name);
+            if (e.counter) {
+                // Counters are process-wide tracks; the value goes in args
+                out << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << row.tid << ",\"ts\":" << micros(e.startNs);
+                out << ",\"args\":{\"value\":" << e.value << "}}";
+                continue;
+            }
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << row.tid << ",\"ts\":" << micros(e.startNs);
+            out << ",\"dur\":" << micros(e.endNs - e.startNs) << "}";
+        }
+        total += row.events.size();
+    }
+    out << "\n]}\n";
+    if (!out) throw std::runtime_error("Write failed: " + path);
+    std::cout << "Wrote CPU trace: " << path << " (" << total << " events)" << std::endl;
+}
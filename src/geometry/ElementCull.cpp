@@ -0,0 +1,104 @@
+#include "geometry/ElementCull.h"
+#include "core/Parallel.h"
+#include "core/Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+uint32_t ElementCull::run(const Elements& elements, const Settings& settings,
+                          VisibleList& visible) {
+    TRACE_ZONE("ElementCull::run");
+    visible.clear();
+    const bool doMaskCull = settings.maskPixels && settings.maskWidth > 0 && settings.maskHeight > 0;
+    const bool doCulling = settings.frustumCulling || settings.backfaceCulling;
+    const glm::mat3 modelNormalMat = glm::mat3(settings.model);  // for transforming normals
+
+    auto isMasked = [&](glm::vec2 uv) -> bool {
+        if (!doMaskCull) return false;
+        uint32_t x = static_cast<uint32_t>(uv.x * settings.maskWidth)  % settings.maskWidth;
+        uint32_t y = static_cast<uint32_t>(uv.y * settings.maskHeight) % settings.maskHeight;
+        return settings.maskPixels[y * settings.maskWidth + x] < 128;
+    };
+
+    auto isVisible = [&](glm::vec3 pos, glm::vec3 normal, float area) -> bool {
+        if (!doCulling) return true;
+        float radius = std::sqrt(area) * settings.userScaling * 2.0f;
+        if (settings.frustumCulling) {
+            glm::vec4 clip = settings.mvp * glm::vec4(pos, 1.0f);
+            if (clip.w <= 0.0f) return false;
+            float cr = radius / clip.w * 2.0f * 1.1f;
+            glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            if (ndc.x + cr < -1.0f || ndc.x - cr > 1.0f) return false;
+            if (ndc.y + cr < -1.0f || ndc.y - cr > 1.0f) return false;
+            if (ndc.z + cr <  0.0f || ndc.z - cr > 1.0f) return false;
+        }
+        if (settings.backfaceCulling) {
+            glm::vec3 worldPos = glm::vec3(settings.model * glm::vec4(pos, 1.0f));
+            glm::vec3 worldNormal = glm::normalize(modelNormalMat * normal);
+            glm::vec3 viewDir = glm::normalize(settings.cameraPosition - worldPos);
+            if (glm::dot(viewDir, worldNormal) <= settings.cullingThreshold) return false;
+        }
+        return true;
+    };
+
+    // Blocks of element ids culled in parallel, each into its own list, then
+    // concatenated in element order. Slot mode has no vertex elements.
+    const uint32_t nbFaces = elements.nbFaces;
+    const bool withVertices = settings.slotK == 0 && !settings.faceElementsOnly;
+    const size_t idCount = size_t(nbFaces) + (withVertices ? elements.nbVertices : 0);
+    constexpr size_t kBlock = 16384;
+    const size_t blockCount = (idCount + kBlock - 1) / kBlock;
+
+    struct Block {
+        VisibleList visible;
+        uint32_t    total = 0;
+    };
+    std::vector<Block> blocks(blockCount);
+
+    parallelFor(blockCount, 1, [&](size_t blockBegin, size_t blockEnd) {
+        for (size_t b = blockBegin; b < blockEnd; b++) {
+            Block& block = blocks[b];
+            const uint32_t first = static_cast<uint32_t>(b * kBlock);
+            const uint32_t last = static_cast<uint32_t>(std::min(idCount, (b + 1) * kBlock));
+            for (uint32_t id = first; id < last; id++) {
+                if (id < nbFaces) {
+                    if (isMasked(elements.faceUVs[id])) continue;
+                    if (settings.slotK > 0) {
+                        // Slot mode: K indices per visible face
+                        block.total += settings.slotK;
+                        if (isVisible(elements.faceCenters[id], elements.faceNormals[id], elements.faceAreas[id])) {
+                            for (uint32_t s = 0; s < settings.slotK; s++)
+                                block.visible.push_back(id * settings.slotK + s);
+                        }
+                        continue;
+                    }
+                    block.total++;
+                    if (isVisible(elements.faceCenters[id], elements.faceNormals[id], elements.faceAreas[id]))
+                        block.visible.push_back(id);
+                } else {
+                    uint32_t v = id - nbFaces;
+                    if (isMasked(elements.vertexUVs[v])) continue;
+                    block.total++;
+                    if (isVisible(elements.vertexPositions[v], elements.vertexNormals[v], elements.vertexFaceAreas[v]))
+                        block.visible.push_back(id);
+                }
+            }
+        }
+    });
+
+    uint32_t totalElements = 0;
+    size_t visibleCount = 0;
+    for (const Block& block : blocks) {
+        totalElements += block.total;
+        visibleCount += block.visible.size();
+    }
+    visible.reserve(std::min<size_t>(visibleCount, settings.maxVisible));
+    for (const Block& block : blocks) {
+        size_t room = settings.maxVisible - visible.size();
+        if (room == 0) break;
+        visible.insert(visible.end(), block.visible.begin(),
+                       block.visible.begin() + std::min(room, block.visible.size()));
+    }
+    return totalElements;
+}
@@ -0,0 +1,93 @@
+#include "geometry/GridWeld.h"
+#include "core/Parallel.h"
+
+GridWeld::Topology GridWeld::topologyFor(uint32_t elementType) {
+    Topology t;
+    switch (elementType) {
+        case 0: t.periodicU = true; t.periodicV = true; break;   // torus
+        case 1: t.periodicU = true; t.poleV0 = true; t.poleV1 = true; break;  // sphere
+        case 2: t.periodicU = true; t.poleV1 = true; break;      // cone apex
+        case 3: t.periodicU = true; break;                       // cylinder
+        case 4: t.periodicU = true; t.poleV0 = true; break;      // hemisphere top
+        case 5: break;                                           // dragon scale patch
+        case 6: t.periodicU = true; t.poleV1 = true; break;      // straw tip
+        case 7: t.periodicU = true; t.poleV0 = true; break;      // stud centre
+        default: t.periodicU = true; t.poleV0 = true; t.poleV1 = true; break;  // sphere
+    }
+    return t;
+}
+
+void GridWeld::build(uint32_t M, uint32_t N, const Topology& topology, bool weldSeams) {
+    const uint32_t W = M + 1;
+    gridVertices = W * (N + 1);
+
+    // Canonical grid vertex for each grid vertex
+    std::vector<uint32_t> canonical(gridVertices);
+    for (uint32_t v = 0; v <= N; v++) {
+        for (uint32_t u = 0; u <= M; u++) {
+            uint32_t cu = u, cv = v;
+            if (weldSeams && topology.periodicV && cv == N) cv = 0;
+            if ((topology.poleV0 && cv == 0) || (topology.poleV1 && cv == N)) cu = 0;
+            if (weldSeams && topology.periodicU && cu == M) cu = 0;
+            canonical[v * W + u] = cv * W + cu;
+        }
+    }
+
+    // Surviving vertices keep grid order
+    std::vector<uint32_t> welded(gridVertices);
+    keptVertices.clear();
+    for (uint32_t i = 0; i < gridVertices; i++) {
+        if (canonical[i] == i) {
+            welded[i] = static_cast<uint32_t>(keptVertices.size());
+            keptVertices.push_back(i);
+        }
+    }
+    for (uint32_t i = 0; i < gridVertices; i++) welded[i] = welded[canonical[i]];
+
+    // Same quad split as parametric_export.comp, minus collapsed triangles
+    indices.clear();
+    auto emit = [&](uint32_t a, uint32_t b, uint32_t c) {
+        a = welded[a]; b = welded[b]; c = welded[c];
+        if (a == b || b == c || a == c) return;
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+    };
+    for (uint32_t qv = 0; qv < N; qv++) {
+        for (uint32_t qu = 0; qu < M; qu++) {
+            uint32_t v00 = qv * W + qu;
+            uint32_t v10 = v00 + 1;
+            uint32_t v01 = v00 + W;
+            uint32_t v11 = v01 + 1;
+            emit(v00, v10, v11);
+            emit(v00, v11, v01);
+        }
+    }
+}
+
+void GridWeld::apply(const glm::vec4* positions, const glm::vec4* normals, const glm::vec2* uvs,
+                     uint32_t elementCount,
+                     std::vector<glm::vec4>& outPositions, std::vector<glm::vec4>& outNormals,
+                     std::vector<glm::vec2>& outUVs, std::vector<uint32_t>& outIndices) const {
+    const size_t V = keptVertices.size();
+    const size_t I = indices.size();
+    outPositions.resize(elementCount * V);
+    outNormals.resize(elementCount * V);
+    outUVs.resize(elementCount * V);
+    outIndices.resize(elementCount * I);
+
+    parallelFor(elementCount, 64, [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; e++) {
+            const size_t src = e * gridVertices;
+            const size_t dst = e * V;
+            for (size_t k = 0; k < V; k++) {
+                outPositions[dst + k] = positions[src + keptVertices[k]];
+                outNormals[dst + k] = normals[src + keptVertices[k]];
+                outUVs[dst + k] = uvs[src + keptVertices[k]];
+            }
+            const uint32_t base = static_cast<uint32_t>(dst);
+            uint32_t* out = &outIndices[e * I];
+            for (size_t j = 0; j < I; j++) out[j] = indices[j] + base;
+        }
+    });
+}
@@ -1,4 +1,5 @@
 #include "geometry/HalfEdge.h"
+#include "core/Trace.h"
 #include "loaders/ObjLoader.h"
 #include <map>
 #include <queue>
@@ -6,6 +7,7 @@
 #include <stdexcept>
 
 HalfEdgeMesh HalfEdgeBuilder::build(const NGonMesh& ngonMesh) {
+    TRACE_ZONE("HalfEdgeBuilder::build");
     HalfEdgeMesh mesh;
 
     std::cout << "Building half-edge structure..." << std::endl;
@@ -126,6 +128,7 @@ HalfEdgeMesh HalfEdgeBuilder::build(const NGonMesh& ngonMesh) {
 }
 
 void computeFace2Coloring(HalfEdgeMesh& mesh) {
+    TRACE_ZONE("computeFace2Coloring");
     std::vector<int> color(mesh.nbFaces, -1);
     int conflicts = 0;
 
@@ -167,6 +170,7 @@ void computeFace2Coloring(HalfEdgeMesh& mesh) {
 }
 
 void HalfEdgeBuilder::validateTopology(const HalfEdgeMesh& mesh) {
+    TRACE_ZONE("HalfEdgeBuilder::validateTopology");
     std::cout << "  Validating topology..." << std::endl;
 
     // Test 1: Next/prev loops close correctly
@@ -0,0 +1,92 @@
+#include "geometry/KdTree.h"
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+static constexpr size_t KD_LEAF_SIZE = 8;
+
+void KdTree::build(const std::vector<glm::vec3>& input) {
+    // Partition an index permutation in place, then gather points into tree order
+    indices.resize(input.size());
+    std::iota(indices.begin(), indices.end(), 0u);
+    axes.assign(input.size(), 0);
+    buildRange(input, 0, input.size());
+
+    points.resize(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        points[i] = input[indices[i]];
+    }
+}
+
+void KdTree::clear() {
+    points.clear();
+    indices.clear();
+    axes.clear();
+}
+
+void KdTree::buildRange(const std::vector<glm::vec3>& input, size_t lo, size_t hi) {
+    if (hi - lo <= KD_LEAF_SIZE) return;
+
+    // Split on the widest axis of this range's bounding box
+    glm::vec3 bmin(std::numeric_limits<float>::max());
+    glm::vec3 bmax(std::numeric_limits<float>::lowest());
+    for (size_t i = lo; i < hi; ++i) {
+        bmin = glm::min(bmin, input[indices[i]]);
+        bmax = glm::max(bmax, input[indices[i]]);
+    }
+    glm::vec3 extent = bmax - bmin;
+    uint8_t axis = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    size_t mid = lo + (hi - lo) / 2;
+    std::nth_element(indices.begin() + lo, indices.begin() + mid, indices.begin() + hi,
+        [&](uint32_t a, uint32_t b) { return input[a][axis] < input[b][axis]; });
+
+    axes[mid] = axis;
+    buildRange(input, lo, mid);
+    buildRange(input, mid + 1, hi);
+}
+
+size_t KdTree::nearest(const glm::vec3& query, float* outDistSq) const {
+    if (points.empty()) return SIZE_MAX;
+
+    size_t bestSlot = SIZE_MAX;
+    float bestDistSq = std::numeric_limits<float>::max();
+    nearestRange(0, points.size(), query, bestSlot, bestDistSq);
+
+    // Nothing closer than FLT_MAX: NaN in the query or every point, or
+    // infinite distances
+    if (bestSlot == SIZE_MAX) return SIZE_MAX;
+    if (outDistSq) *outDistSq = bestDistSq;
+    return indices[bestSlot];
+}
+
+void KdTree::nearestRange(size_t lo, size_t hi, const glm::vec3& query,
+                          size_t& bestSlot, float& bestDistSq) const {
+    if (hi - lo <= KD_LEAF_SIZE) {
+        for (size_t i = lo; i < hi; ++i) {
+            glm::vec3 d = points[i] - query;
+            float distSq = glm::dot(d, d);
+            if (distSq < bestDistSq) { bestDistSq = distSq; bestSlot = i; }
+        }
+        return;
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    glm::vec3 d = points[mid] - query;
+    float distSq = glm::dot(d, d);
+    if (distSq < bestDistSq) { bestDistSq = distSq; bestSlot = mid; }
+
+    // Descend the query's side first, visit the far side only if the
+    // splitting plane is closer than the current best
+    float planeDist = query[axes[mid]] - points[mid][axes[mid]];
+    bool goLeft = planeDist < 0.0f;
+    if (goLeft) nearestRange(lo, mid, query, bestSlot, bestDistSq);
+    else        nearestRange(mid + 1, hi, query, bestSlot, bestDistSq);
+
+    if (planeDist * planeDist < bestDistSq) {
+        if (goLeft) nearestRange(mid + 1, hi, query, bestSlot, bestDistSq);
+        else        nearestRange(lo, mid, query, bestSlot, bestDistSq);
+    }
+}
@@ -0,0 +1,555 @@
+#include "geometry/MeshGenerator.h"
+#include "core/Parallel.h"
+#include "core/Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+
+// Indexed polygon soup shared by every shape, plus the per-face and
+// per-vertex attributes derived from it
+struct Polygons {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::vector<uint32_t> offsets{0};   // nbFaces + 1
+    std::vector<uint32_t> indices;
+
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec3> faceNormals;
+    std::vector<glm::vec3> faceCenters;
+    std::vector<float> faceAreas;
+
+    uint32_t addVertex(glm::vec3 p, glm::vec2 uv) {
+        positions.push_back(p);
+        texCoords.push_back(uv);
+        return static_cast<uint32_t>(positions.size() - 1);
+    }
+    void addFace(std::initializer_list<uint32_t> face) {
+        indices.insert(indices.end(), face.begin(), face.end());
+        offsets.push_back(static_cast<uint32_t>(indices.size()));
+    }
+    uint32_t faceCount() const { return static_cast<uint32_t>(offsets.size() - 1); }
+};
+
+glm::vec2 sphericalUV(glm::vec3 d) {
+    return glm::vec2(0.5f + std::atan2(d.z, d.x) / (2.0f * kPi),
+                     0.5f - std::asin(std::clamp(d.y, -1.0f, 1.0f)) / kPi);
+}
+
+// ============================================================================
+// Shapes
+// ============================================================================
+
+void buildGrid(Polygons& poly, uint32_t n, float size) {
+    const uint32_t w = n + 1;
+    const float cell = size / float(n);
+    const float half = size * 0.5f;
+    poly.positions.reserve(size_t(w) * w);
+    poly.texCoords.reserve(size_t(w) * w);
+    for (uint32_t row = 0; row <= n; ++row)
+        for (uint32_t col = 0; col <= n; ++col)
+            poly.addVertex(glm::vec3(col * cell - half, 0.0f, row * cell - half),
+                           glm::vec2(float(col) / n, float(row) / n));
+
+    poly.indices.reserve(size_t(n) * n * 4);
+    poly.offsets.reserve(size_t(n) * n + 1);
+    for (uint32_t row = 0; row < n; ++row) {
+        for (uint32_t col = 0; col < n; ++col) {
+            uint32_t v0 = row * w + col;
+            poly.addFace({v0, v0 + w, v0 + w + 1, v0 + 1});  // CCW seen from +Y
+        }
+    }
+}
+
+// Geodesic sphere: every icosahedron face carries a triangular lattice of
+// frequency n. Lattice points on icosahedron edges are stored once per
+// edge, oriented from its lower to its higher corner.
+void buildIcosphere(Polygons& poly, uint32_t n, float radius) {
+    const float phi = (1.0f + std::sqrt(5.0f)) * 0.5f;
+    const std::array<glm::vec3, 12> corners = {{
+        {-1,  phi, 0}, { 1,  phi, 0}, {-1, -phi, 0}, { 1, -phi, 0},
+        { 0, -1,  phi}, { 0,  1,  phi}, { 0, -1, -phi}, { 0,  1, -phi},
+        { phi, 0, -1}, { phi, 0,  1}, {-phi, 0, -1}, {-phi, 0,  1},
+    }};
+    // Counter-clockwise seen from outside (same table as scripts/gen_icosphere.py)
+    const std::array<std::array<uint32_t, 3>, 20> faces = {{
+        {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+        {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+        {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+        {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1},
+    }};
+
+    auto addPoint = [&](glm::vec3 p) {
+        glm::vec3 d = glm::normalize(p);
+        return poly.addVertex(d * radius, sphericalUV(d));
+    };
+
+    const size_t edgePoints = n - 1;
+    const size_t innerPoints = size_t(n - 1) * (n - 2) / 2;
+    poly.positions.reserve(12 + 30 * edgePoints + 20 * innerPoints);
+    poly.texCoords.reserve(poly.positions.capacity());
+
+    for (const glm::vec3& c : corners) addPoint(c);
+
+    // Edge lattice points; edges keyed by their corner pair
+    std::array<std::array<int, 12>, 12> edgeBase;
+    for (auto& row : edgeBase) row.fill(-1);
+    for (const auto& f : faces) {
+        for (int e = 0; e < 3; ++e) {
+            uint32_t a = std::min(f[e], f[(e + 1) % 3]);
+            uint32_t b = std::max(f[e], f[(e + 1) % 3]);
+            if (edgeBase[a][b] >= 0) continue;
+            edgeBase[a][b] = static_cast<int>(poly.positions.size());
+            for (uint32_t k = 1; k < n; ++k) {
+                float t = float(k) / n;
+                addPoint(corners[a] * (1.0f - t) + corners[b] * t);
+            }
+        }
+    }
+    // Lattice point t steps from corner u towards corner v
+    auto edgePoint = [&](uint32_t u, uint32_t v, uint32_t t) -> uint32_t {
+        if (t == 0) return u;
+        if (t == n) return v;
+        uint32_t k = (u < v) ? t : n - t;
+        return static_cast<uint32_t>(edgeBase[std::min(u, v)][std::max(u, v)]) + k - 1;
+    };
+
+    poly.indices.reserve(size_t(60) * n * n);
+    poly.offsets.reserve(size_t(20) * n * n + 1);
+    std::vector<uint32_t> lattice;
+    for (const auto& f : faces) {
+        const uint32_t a = f[0], b = f[1], c = f[2];
+        // Point (i, j) = a + i/n (b - a) + j/n (c - a), i + j <= n
+        lattice.assign(size_t(n + 1) * (n + 1), 0);
+        auto at = [&](uint32_t i, uint32_t j) -> uint32_t& { return lattice[size_t(i) * (n + 1) + j]; };
+        for (uint32_t i = 0; i <= n; ++i) {
+            for (uint32_t j = 0; i + j <= n; ++j) {
+                if (j == 0)          at(i, j) = edgePoint(a, b, i);
+                else if (i == 0)     at(i, j) = edgePoint(a, c, j);
+                else if (i + j == n) at(i, j) = edgePoint(b, c, j);
+                else {
+                    float fi = float(i) / n, fj = float(j) / n;
+                    at(i, j) = addPoint(corners[a] * (1.0f - fi - fj) + corners[b] * fi + corners[c] * fj);
+                }
+            }
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            for (uint32_t j = 0; i + j < n; ++j) {
+                poly.addFace({at(i, j), at(i + 1, j), at(i, j + 1)});
+                if (i + j + 1 < n)
+                    poly.addFace({at(i + 1, j), at(i + 1, j + 1), at(i, j + 1)});
+            }
+        }
+    }
+}
+
+// Cube lattice of n cells per edge, each point mapped onto the sphere with
+// the area-preserving-ish "spherified cube" formula (much more even than
+// normalizing). Surface points are numbered in closed form: the y = 0 and
+// y = n layers as full (n+1)^2 grids, the layers between as rings of 4n.
+void buildQuadSphere(Polygons& poly, uint32_t n, float radius) {
+    const size_t w = n + 1;
+    const size_t total = 2 * w * w + size_t(n - 1) * 4 * n;
+    poly.positions.resize(total);
+    poly.texCoords.resize(total);
+
+    auto ringIndex = [n](uint32_t x, uint32_t z) -> uint32_t {
+        if (z == 0 && x < n) return x;
+        if (x == n && z < n) return n + z;
+        if (z == n && x > 0) return 2 * n + (n - x);
+        return 3 * n + (n - z);  // x == 0, z > 0
+    };
+    auto index = [&](uint32_t x, uint32_t y, uint32_t z) -> uint32_t {
+        if (y == 0) return static_cast<uint32_t>(x * w + z);
+        if (y == n) return static_cast<uint32_t>(w * w + x * w + z);
+        return static_cast<uint32_t>(2 * w * w + size_t(y - 1) * 4 * n + ringIndex(x, z));
+    };
+    auto place = [&](uint32_t x, uint32_t y, uint32_t z) {
+        glm::vec3 c = glm::vec3(x, y, z) * (2.0f / n) - 1.0f;
+        glm::vec3 c2 = c * c;
+        glm::vec3 s(c.x * std::sqrt(1.0f - c2.y * 0.5f - c2.z * 0.5f + c2.y * c2.z / 3.0f),
+                    c.y * std::sqrt(1.0f - c2.z * 0.5f - c2.x * 0.5f + c2.z * c2.x / 3.0f),
+                    c.z * std::sqrt(1.0f - c2.x * 0.5f - c2.y * 0.5f + c2.x * c2.y / 3.0f));
+        glm::vec3 d = glm::normalize(s);
+        uint32_t id = index(x, y, z);
+        poly.positions[id] = d * radius;
+        poly.texCoords[id] = sphericalUV(d);
+    };
+
+    poly.indices.reserve(size_t(24) * n * n);
+    poly.offsets.reserve(size_t(6) * n * n + 1);
+    // Face on axis a at coordinate 0 or n, spanned by the two other axes in
+    // cyclic order (swapped on the 0 side) so cross(du, dv) points outward
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            int ua = (axis + 1) % 3, va = (axis + 2) % 3;
+            if (side == 0) std::swap(ua, va);
+            auto point = [&](uint32_t u, uint32_t v) {
+                std::array<uint32_t, 3> p;
+                p[axis] = side ? n : 0;
+                p[ua] = u;
+                p[va] = v;
+                return p;
+            };
+            for (uint32_t u = 0; u <= n; ++u)
+                for (uint32_t v = 0; v <= n; ++v) {
+                    auto p = point(u, v);
+                    place(p[0], p[1], p[2]);
+                }
+            auto id = [&](uint32_t u, uint32_t v) {
+                auto p = point(u, v);
+                return index(p[0], p[1], p[2]);
+            };
+            for (uint32_t u = 0; u < n; ++u)
+                for (uint32_t v = 0; v < n; ++v)
+                    poly.addFace({id(u, v), id(u + 1, v), id(u + 1, v + 1), id(u, v + 1)});
+        }
+    }
+}
+
+// Torus around +Y; the ring count follows the radius ratio so the quads stay
+// roughly square
+void buildTorus(Polygons& poly, uint32_t minorSegments, float majorRadius, float minorRadius) {
+    const uint32_t m = minorSegments;
+    const uint32_t M = std::max(3u, static_cast<uint32_t>(
+        std::lround(m * majorRadius / std::max(minorRadius, 1e-6f))));
+    poly.positions.reserve(size_t(M) * m);
+    poly.texCoords.reserve(size_t(M) * m);
+    for (uint32_t i = 0; i < M; ++i) {
+        float theta = 2.0f * kPi * i / M;
+        for (uint32_t j = 0; j < m; ++j) {
+            float phi = 2.0f * kPi * j / m;
+            float ring = majorRadius + minorRadius * std::cos(phi);
+            poly.addVertex(glm::vec3(ring * std::cos(theta), minorRadius * std::sin(phi), ring * std::sin(theta)),
+                           glm::vec2(float(i) / M, float(j) / m));
+        }
+    }
+    poly.indices.reserve(size_t(M) * m * 4);
+    poly.offsets.reserve(size_t(M) * m + 1);
+    for (uint32_t i = 0; i < M; ++i) {
+        uint32_t i1 = (i + 1) % M;
+        for (uint32_t j = 0; j < m; ++j) {
+            uint32_t j1 = (j + 1) % m;
+            poly.addFace({i * m + j, i * m + j1, i1 * m + j1, i1 * m + j});
+        }
+    }
+}
+
+uint32_t hashCell(uint32_t x, uint32_t y, uint32_t z, uint32_t seed) {
+    uint32_t h = seed * 0x9E3779B9u;
+    h ^= x * 0x85EBCA6Bu; h = (h ^ (h >> 15)) * 0x2C1B3C6Du;
+    h ^= y * 0xC2B2AE35u; h = (h ^ (h >> 13)) * 0x27D4EB2Fu;
+    h ^= z * 0x165667B1u; h = (h ^ (h >> 16)) * 0x85EBCA6Bu;
+    return h ^ (h >> 16);
+}
+
+// The ground plane's pentagon pairs: columns (2k, 2k+1) share a midpoint
+// placed at the center of the left cell. With mixed = true each pair instead
+// picks between that, two quads and four triangles, giving one manifold
+// mesh with valence-3/4/5 faces side by side. An odd n leaves the last
+// column unpaired: quads, or in a mixed tiling quads and triangle pairs.
+void buildTiling(Polygons& poly, uint32_t n, float size, bool mixed, uint32_t seed) {
+    const uint32_t w = n + 1;
+    const float cell = size / float(n);
+    const float half = size * 0.5f;
+    poly.positions.reserve(size_t(w) * w + size_t(n / 2) * n);
+    poly.texCoords.reserve(poly.positions.capacity());
+    for (uint32_t row = 0; row <= n; ++row)
+        for (uint32_t col = 0; col <= n; ++col)
+            poly.addVertex(glm::vec3(col * cell - half, 0.0f, row * cell - half),
+                           glm::vec2(float(col) / n, float(row) / n));
+    auto corner = [w](uint32_t row, uint32_t col) { return row * w + col; };
+
+    poly.indices.reserve(size_t(n) * n * 5);
+    poly.offsets.reserve(size_t(n) * n * 2 + 1);
+    for (uint32_t pc = 0; pc < n / 2; ++pc) {
+        const uint32_t cl = 2 * pc, cr = cl + 1;
+        for (uint32_t row = 0; row < n; ++row) {
+            const uint32_t kind = mixed ? hashCell(pc, row, 0, seed) % 3 : 0;
+            // Corners as in generateGroundPlane: T = row, B = row + 1;
+            // faces listed in reverse of its order to face +Y
+            const uint32_t tl = corner(row, cl), tm = corner(row, cr), tr = corner(row, cr + 1);
+            const uint32_t bl = corner(row + 1, cl), bm = corner(row + 1, cr), br = corner(row + 1, cr + 1);
+            if (kind == 0) {
+                uint32_t m = poly.addVertex(glm::vec3((cr - 0.5f) * cell - half, 0.0f, (row + 0.5f) * cell - half),
+                                            glm::vec2(float(cr) / n, (row + 0.5f) / n));
+                poly.addFace({bl, bm, m, tm, tl});
+                poly.addFace({m, bm, br, tr, tm});
+            } else if (kind == 1) {
+                poly.addFace({tl, bl, bm, tm});
+                poly.addFace({tm, bm, br, tr});
+            } else {
+                poly.addFace({tl, bl, bm});
+                poly.addFace({tl, bm, tm});
+                poly.addFace({tm, bm, tr});
+                poly.addFace({bm, br, tr});
+            }
+        }
+    }
+    if (n % 2 == 1) {
+        const uint32_t cl = n - 1;
+        for (uint32_t row = 0; row < n; ++row) {
+            const uint32_t tl = corner(row, cl), tr = corner(row, cl + 1);
+            const uint32_t bl = corner(row + 1, cl), br = corner(row + 1, cl + 1);
+            if (mixed && hashCell(n / 2, row, 0, seed) % 2 == 1) {
+                poly.addFace({tl, bl, br});
+                poly.addFace({tl, br, tr});
+            } else {
+                poly.addFace({tl, bl, br, tr});
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Displacement and derived attributes
+// ============================================================================
+
+float latticeValue(int x, int y, int z, uint32_t seed) {
+    uint32_t h = hashCell(static_cast<uint32_t>(x), static_cast<uint32_t>(y),
+                          static_cast<uint32_t>(z), seed);
+    return float(h & 0xFFFFFF) / float(0xFFFFFF) * 2.0f - 1.0f;
+}
+
+// Trilinear value noise in [-1, 1] with smoothstep fade
+float valueNoise(glm::vec3 p, uint32_t seed) {
+    glm::vec3 fl = glm::floor(p);
+    glm::vec3 f = p - fl;
+    glm::vec3 u = f * f * (3.0f - 2.0f * f);
+    int x = static_cast<int>(fl.x), y = static_cast<int>(fl.y), z = static_cast<int>(fl.z);
+    auto lerp = [](float a, float b, float t) { return a + (b - a) * t; };
+    float x00 = lerp(latticeValue(x, y,     z,     seed), latticeValue(x + 1, y,     z,     seed), u.x);
+    float x10 = lerp(latticeValue(x, y + 1, z,     seed), latticeValue(x + 1, y + 1, z,     seed), u.x);
+    float x01 = lerp(latticeValue(x, y,     z + 1, seed), latticeValue(x + 1, y,     z + 1, seed), u.x);
+    float x11 = lerp(latticeValue(x, y + 1, z + 1, seed), latticeValue(x + 1, y + 1, z + 1, seed), u.x);
+    return lerp(lerp(x00, x10, u.y), lerp(x01, x11, u.y), u.z);
+}
+
+float fractalNoise(glm::vec3 p, uint32_t seed) {
+    float sum = 0.0f, amplitude = 1.0f, norm = 0.0f;
+    for (uint32_t octave = 0; octave < 4; ++octave) {
+        sum += valueNoise(p, seed + octave) * amplitude;
+        norm += amplitude;
+        amplitude *= 0.5f;
+        p *= 2.0f;
+    }
+    return sum / norm;
+}
+
+// Newell normals (robust for the non-planar faces displacement creates),
+// centroids and areas per face; area-weighted vertex normals
+void computeAttributes(Polygons& poly) {
+    const uint32_t nbFaces = poly.faceCount();
+    poly.faceNormals.resize(nbFaces);
+    poly.faceCenters.resize(nbFaces);
+    poly.faceAreas.resize(nbFaces);
+    std::vector<glm::vec3> weighted(nbFaces);
+
+    parallelFor(nbFaces, 4096, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            const uint32_t first = poly.offsets[f], count = poly.offsets[f + 1] - first;
+            glm::vec3 newell(0.0f), center(0.0f);
+            for (uint32_t i = 0; i < count; ++i) {
+                const glm::vec3& a = poly.positions[poly.indices[first + i]];
+                const glm::vec3& b = poly.positions[poly.indices[first + (i + 1) % count]];
+                newell += glm::cross(a, b);
+                center += a;
+            }
+            float len = glm::length(newell);
+            weighted[f] = newell;
+            poly.faceNormals[f] = len > 1e-20f ? newell / len : glm::vec3(0.0f, 0.0f, 1.0f);
+            poly.faceCenters[f] = center / float(count);
+            poly.faceAreas[f] = 0.5f * len;
+        }
+    });
+
+    poly.normals.assign(poly.positions.size(), glm::vec3(0.0f));
+    for (uint32_t f = 0; f < nbFaces; ++f)
+        for (uint32_t i = poly.offsets[f]; i < poly.offsets[f + 1]; ++i)
+            poly.normals[poly.indices[i]] += weighted[f];
+    parallelFor(poly.normals.size(), 16384, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            float len = glm::length(poly.normals[v]);
+            poly.normals[v] = len > 1e-20f ? poly.normals[v] / len : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    });
+}
+
+Polygons buildPolygons(const MeshGenerator::Settings& settings) {
+    const uint32_t res = settings.resolution;
+    Polygons poly;
+    switch (settings.shape) {
+        case MeshGenerator::Shape::Grid:           buildGrid(poly, std::max(res, 1u), settings.size); break;
+        case MeshGenerator::Shape::Icosphere:      buildIcosphere(poly, std::max(res, 1u), settings.size); break;
+        case MeshGenerator::Shape::QuadSphere:     buildQuadSphere(poly, std::max(res, 1u), settings.size); break;
+        case MeshGenerator::Shape::Torus:          buildTorus(poly, std::max(res, 3u), settings.size, settings.minorRadius); break;
+        case MeshGenerator::Shape::PentagonTiling: buildTiling(poly, std::max(res, 1u), settings.size, false, settings.seed); break;
+        case MeshGenerator::Shape::MixedTiling:    buildTiling(poly, std::max(res, 1u), settings.size, true, settings.seed); break;
+    }
+    if (poly.indices.size() > size_t(INT_MAX))
+        throw std::runtime_error("Generated mesh too large for the half-edge structure");
+
+    computeAttributes(poly);
+
+    if (settings.noiseAmplitude != 0.0f) {
+        const float amplitude = settings.noiseAmplitude * settings.size;
+        const float frequency = settings.noiseFrequency / std::max(settings.size, 1e-6f);
+        parallelFor(poly.positions.size(), 16384, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                glm::vec3& p = poly.positions[v];
+                p += poly.normals[v] * (amplitude * fractalNoise(p * frequency, settings.seed));
+            }
+        });
+        computeAttributes(poly);
+    }
+
+    std::cout << "Generated " << MeshGenerator::shapeName(settings.shape)
+              << " (resolution " << res << "): " << poly.positions.size() << " vertices, "
+              << poly.faceCount() << " faces" << std::endl;
+    return poly;
+}
+
+} // namespace
+
+HalfEdgeMesh MeshGenerator::generate(const Settings& settings) {
+    TRACE_ZONE("MeshGenerator::generate");
+    Polygons poly = buildPolygons(settings);
+
+    HalfEdgeMesh mesh;
+    mesh.nbVertices = static_cast<uint32_t>(poly.positions.size());
+    mesh.nbFaces = poly.faceCount();
+    mesh.nbHalfEdges = static_cast<uint32_t>(poly.indices.size());
+
+    mesh.vertexPositions.resize(mesh.nbVertices);
+    mesh.vertexColors.assign(mesh.nbVertices, glm::vec4(1.0f));
+    mesh.vertexNormals.resize(mesh.nbVertices);
+    mesh.vertexTexCoords.assign(poly.texCoords.begin(), poly.texCoords.end());
+    mesh.vertexEdges.assign(mesh.nbVertices, -1);
+    for (uint32_t v = 0; v < mesh.nbVertices; ++v) {
+        mesh.vertexPositions[v] = glm::vec4(poly.positions[v], 1.0f);
+        mesh.vertexNormals[v] = glm::vec4(poly.normals[v], 0.0f);
+    }
+
+    mesh.faceEdges.resize(mesh.nbFaces);
+    mesh.faceVertCounts.resize(mesh.nbFaces);
+    mesh.faceOffsets.resize(mesh.nbFaces);
+    mesh.faceNormals.resize(mesh.nbFaces);
+    mesh.faceCenters.resize(mesh.nbFaces);
+    mesh.faceAreas.assign(poly.faceAreas.begin(), poly.faceAreas.end());
+    for (uint32_t f = 0; f < mesh.nbFaces; ++f) {
+        mesh.faceEdges[f] = static_cast<int>(poly.offsets[f]);
+        mesh.faceVertCounts[f] = static_cast<int>(poly.offsets[f + 1] - poly.offsets[f]);
+        mesh.faceOffsets[f] = static_cast<int>(poly.offsets[f]);
+        mesh.faceNormals[f] = glm::vec4(poly.faceNormals[f], 0.0f);
+        mesh.faceCenters[f] = glm::vec4(poly.faceCenters[f], 1.0f);
+    }
+
+    // Half-edge h is corner h of the flattened face lists
+    mesh.heVertex.resize(mesh.nbHalfEdges);
+    mesh.heFace.resize(mesh.nbHalfEdges);
+    mesh.heNext.resize(mesh.nbHalfEdges);
+    mesh.hePrev.resize(mesh.nbHalfEdges);
+    mesh.heTwin.assign(mesh.nbHalfEdges, -1);
+    for (uint32_t f = 0; f < mesh.nbFaces; ++f) {
+        const int first = static_cast<int>(poly.offsets[f]);
+        const int count = mesh.faceVertCounts[f];
+        for (int i = 0; i < count; ++i) {
+            const int he = first + i;
+            const int v = static_cast<int>(poly.indices[he]);
+            mesh.heVertex[he] = v;
+            mesh.heFace[he] = static_cast<int>(f);
+            mesh.heNext[he] = first + (i + 1) % count;
+            mesh.hePrev[he] = first + (i + count - 1) % count;
+            if (mesh.vertexEdges[v] == -1) mesh.vertexEdges[v] = he;
+        }
+    }
+
+    // Twins: outgoing half-edges bucketed by origin vertex, so a -> b only
+    // scans the few edges leaving b for one that returns to a
+    std::vector<uint32_t> outStart(mesh.nbVertices + 1, 0);
+    for (uint32_t he = 0; he < mesh.nbHalfEdges; ++he) outStart[mesh.heVertex[he] + 1]++;
+    for (uint32_t v = 0; v < mesh.nbVertices; ++v) outStart[v + 1] += outStart[v];
+    std::vector<int> outgoing(mesh.nbHalfEdges);
+    {
+        std::vector<uint32_t> cursor(outStart.begin(), outStart.end() - 1);
+        for (uint32_t he = 0; he < mesh.nbHalfEdges; ++he)
+            outgoing[cursor[mesh.heVertex[he]]++] = static_cast<int>(he);
+    }
+    parallelFor(mesh.nbHalfEdges, 65536, [&](size_t begin, size_t end) {
+        for (size_t he = begin; he < end; ++he) {
+            const int a = mesh.heVertex[he];
+            const int b = mesh.heVertex[mesh.heNext[he]];
+            for (uint32_t k = outStart[b]; k < outStart[b + 1]; ++k) {
+                const int candidate = outgoing[k];
+                if (mesh.heVertex[mesh.heNext[candidate]] == a) {
+                    mesh.heTwin[he] = candidate;
+                    break;
+                }
+            }
+        }
+    });
+
+    mesh.vertexFaceIndices.assign(poly.indices.begin(), poly.indices.end());
+    return mesh;
+}
+
+NGonMesh MeshGenerator::generateNGon(const Settings& settings) {
+    TRACE_ZONE("MeshGenerator::generateNGon");
+    Polygons poly = buildPolygons(settings);
+
+    NGonMesh mesh;
+    mesh.nbVertices = static_cast<uint32_t>(poly.positions.size());
+    mesh.nbFaces = poly.faceCount();
+    mesh.positions = std::move(poly.positions);
+    mesh.normals = std::move(poly.normals);
+    mesh.texCoords = std::move(poly.texCoords);
+    mesh.colors.assign(mesh.nbVertices, glm::vec3(1.0f));
+    mesh.originalVertexIndices.resize(mesh.nbVertices);
+    for (uint32_t v = 0; v < mesh.nbVertices; ++v) mesh.originalVertexIndices[v] = v;
+    mesh.originalVertexCount = mesh.nbVertices;
+
+    mesh.faces.resize(mesh.nbFaces);
+    for (uint32_t f = 0; f < mesh.nbFaces; ++f) {
+        NGonFace& face = mesh.faces[f];
+        face.offset = poly.offsets[f];
+        face.count = poly.offsets[f + 1] - poly.offsets[f];
+        face.vertexIndices.assign(poly.indices.begin() + face.offset,
+                                  poly.indices.begin() + face.offset + face.count);
+        face.normal = glm::vec4(poly.faceNormals[f], 0.0f);
+        face.center = glm::vec4(poly.faceCenters[f], 1.0f);
+        face.area = poly.faceAreas[f];
+    }
+    mesh.faceVertexIndices = std::move(poly.indices);
+    return mesh;
+}
+
+const char* MeshGenerator::shapeName(Shape shape) {
+    switch (shape) {
+        case Shape::Grid:           return "grid";
+        case Shape::Icosphere:      return "icosphere";
+        case Shape::QuadSphere:     return "quadsphere";
+        case Shape::Torus:          return "torus";
+        case Shape::PentagonTiling: return "pentagons";
+        case Shape::MixedTiling:    return "mixed";
+    }
+    return "unknown";
+}
+
+bool MeshGenerator::parseShape(const std::string& name, Shape& shape) {
+    for (Shape s : {Shape::Grid, Shape::Icosphere, Shape::QuadSphere,
+                    Shape::Torus, Shape::PentagonTiling, Shape::MixedTiling}) {
+        if (name == shapeName(s)) {
+            shape = s;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,244 @@
+#include "geometry/MeshletBuilder.h"
+#include "core/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr uint32_t kChunkTriangles = 4096;  // parallel work unit, whole pieces
+constexpr uint8_t  kNoSlot = 0xFF;
+
+glm::vec3 xyz(const glm::vec4& v) { return glm::vec3(v.x, v.y, v.z); }
+
+} // namespace
+
+void MeshletBuilder::Result::clear() {
+    meshlets.clear();
+    vertices.clear();
+    triangles.clear();
+}
+
+void MeshletBuilder::build(const glm::vec4* positions, const uint32_t* indices,
+                           uint32_t triangleCount, Result& out) {
+    out.clear();
+    if (triangleCount == 0) return;
+
+    // A piece starts where a triangle only uses vertices past everything
+    // before it; chunks gather whole pieces up to the work unit size
+    std::vector<uint32_t> chunkStarts{0};
+    uint32_t maxVertex = 0;
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        const uint32_t* tri = indices + size_t(t) * 3;
+        uint32_t lo = std::min({tri[0], tri[1], tri[2]});
+        uint32_t hi = std::max({tri[0], tri[1], tri[2]});
+        if (t > 0 && lo > maxVertex && t - chunkStarts.back() >= kChunkTriangles) {
+            chunkStarts.push_back(t);
+        }
+        maxVertex = (t == 0) ? hi : std::max(maxVertex, hi);
+    }
+    chunkStarts.push_back(triangleCount);
+
+    const size_t chunkCount = chunkStarts.size() - 1;
+    std::vector<Result> chunks(chunkCount);
+    parallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) {
+            buildChunk(positions, indices, chunkStarts[c], chunkStarts[c + 1] - chunkStarts[c], chunks[c]);
+        }
+    });
+
+    size_t meshletTotal = 0, vertexTotal = 0, triangleTotal = 0;
+    for (const Result& r : chunks) {
+        meshletTotal += r.meshlets.size();
+        vertexTotal += r.vertices.size();
+        triangleTotal += r.triangles.size();
+    }
+    out.meshlets.reserve(meshletTotal);
+    out.vertices.reserve(vertexTotal);
+    out.triangles.reserve(triangleTotal);
+    for (const Result& r : chunks) {
+        const uint32_t vertexBase = static_cast<uint32_t>(out.vertices.size());
+        const uint32_t triangleBase = static_cast<uint32_t>(out.triangles.size() / 3);
+        for (Meshlet m : r.meshlets) {
+            m.vertexOffset += vertexBase;
+            m.triangleOffset += triangleBase;
+            out.meshlets.push_back(m);
+        }
+        out.vertices.insert(out.vertices.end(), r.vertices.begin(), r.vertices.end());
+        out.triangles.insert(out.triangles.end(), r.triangles.begin(), r.triangles.end());
+    }
+}
+
+void MeshletBuilder::buildChunk(const glm::vec4* positions, const uint32_t* indices,
+                                uint32_t firstTriangle, uint32_t triangleCount, Result& out) {
+    const uint32_t* tris = indices + size_t(firstTriangle) * 3;
+
+    // Vertex -> triangle adjacency over the chunk's vertex range
+    uint32_t vmin = std::numeric_limits<uint32_t>::max(), vmax = 0;
+    for (size_t k = 0; k < size_t(triangleCount) * 3; k++) {
+        vmin = std::min(vmin, tris[k]);
+        vmax = std::max(vmax, tris[k]);
+    }
+    const uint32_t rangeSize = vmax - vmin + 1;
+    std::vector<uint32_t> adjOffsets(rangeSize + 1, 0);
+    for (size_t k = 0; k < size_t(triangleCount) * 3; k++) adjOffsets[tris[k] - vmin + 1]++;
+    for (uint32_t v = 0; v < rangeSize; v++) adjOffsets[v + 1] += adjOffsets[v];
+    std::vector<uint32_t> adjacency(adjOffsets[rangeSize]);
+    {
+        std::vector<uint32_t> fill(adjOffsets.begin(), adjOffsets.end() - 1);
+        for (uint32_t t = 0; t < triangleCount; t++)
+            for (int k = 0; k < 3; k++) adjacency[fill[tris[t * 3 + k] - vmin]++] = t;
+    }
+
+    std::vector<glm::vec3> centroids(triangleCount);
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        centroids[t] = (xyz(positions[tris[t * 3]]) + xyz(positions[tris[t * 3 + 1]]) +
+                        xyz(positions[tris[t * 3 + 2]])) * (1.0f / 3.0f);
+    }
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> queuedFor(triangleCount, ~0u);  // meshlet a candidate was queued for
+    std::vector<uint8_t> slot(rangeSize, kNoSlot);  // local slot in the open meshlet
+    std::vector<uint32_t> candidates;
+    Meshlet current{};
+    glm::vec3 centroidSum(0.0f);
+    uint32_t seed = 0;
+
+    auto flush = [&]() {
+        if (current.triangleCount == 0) return;
+        for (uint32_t i = 0; i < current.vertexCount; i++)
+            slot[out.vertices[current.vertexOffset + i] - vmin] = kNoSlot;
+        computeBounds(positions, out, current);
+        out.meshlets.push_back(current);
+        current = Meshlet{};
+        current.vertexOffset = static_cast<uint32_t>(out.vertices.size());
+        current.triangleOffset = static_cast<uint32_t>(out.triangles.size() / 3);
+        centroidSum = glm::vec3(0.0f);
+        candidates.clear();
+    };
+    auto newVertices = [&](uint32_t t) {
+        uint32_t n = 0;
+        for (int k = 0; k < 3; k++) n += (slot[tris[t * 3 + k] - vmin] == kNoSlot) ? 1 : 0;
+        return n;
+    };
+
+    for (;;) {
+        // Adjacent triangle adding the fewest vertices, then the one nearest
+        // the meshlet's centroid so meshlets grow as compact patches
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        uint32_t bestNew = 4;
+        float bestDist = 0.0f;
+        const glm::vec3 centroid = current.vertexCount > 0
+            ? centroidSum / static_cast<float>(current.vertexCount) : glm::vec3(0.0f);
+        size_t live = 0;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            uint32_t t = candidates[i];
+            if (emitted[t]) continue;
+            candidates[live++] = t;
+            uint32_t n = newVertices(t);
+            if (n > bestNew) continue;
+            glm::vec3 d = centroids[t] - centroid;
+            float dist = glm::dot(d, d);
+            if (n < bestNew || dist < bestDist || (dist == bestDist && t < best)) {
+                best = t;
+                bestNew = n;
+                bestDist = dist;
+            }
+        }
+        candidates.resize(live);
+
+        if (best == std::numeric_limits<uint32_t>::max()) {
+            // Nothing adjacent left: continue from the next triangle in order
+            while (seed < triangleCount && emitted[seed]) seed++;
+            if (seed == triangleCount) break;
+            best = seed;
+            bestNew = newVertices(best);
+        }
+
+        if (current.vertexCount + bestNew > MAX_VERTICES || current.triangleCount + 1 > MAX_TRIANGLES) {
+            flush();
+            bestNew = 3;
+        }
+
+        emitted[best] = 1;
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = tris[best * 3 + k];
+            uint8_t& s = slot[v - vmin];
+            if (s == kNoSlot) {
+                s = static_cast<uint8_t>(current.vertexCount++);
+                out.vertices.push_back(v);
+                centroidSum += xyz(positions[v]);
+                const uint32_t meshletId = static_cast<uint32_t>(out.meshlets.size());
+                for (uint32_t a = adjOffsets[v - vmin]; a < adjOffsets[v - vmin + 1]; a++) {
+                    uint32_t t = adjacency[a];
+                    if (emitted[t] || queuedFor[t] == meshletId) continue;
+                    queuedFor[t] = meshletId;
+                    candidates.push_back(t);
+                }
+            }
+            out.triangles.push_back(s);
+        }
+        current.triangleCount++;
+    }
+    flush();
+}
+
+void MeshletBuilder::computeBounds(const glm::vec4* positions, const Result& result, Meshlet& meshlet) {
+    // Sphere around the vertices' box centre
+    glm::vec3 lo(std::numeric_limits<float>::max()), hi(-std::numeric_limits<float>::max());
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        glm::vec3 p = xyz(positions[result.vertices[meshlet.vertexOffset + i]]);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    const glm::vec3 center = (lo + hi) * 0.5f;
+    float radiusSq = 0.0f;
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        glm::vec3 d = xyz(positions[result.vertices[meshlet.vertexOffset + i]]) - center;
+        radiusSq = std::max(radiusSq, glm::dot(d, d));
+    }
+    meshlet.center = center;
+    meshlet.radius = std::sqrt(radiusSq);
+
+    // Normal cone of the face normals, with an apex that keeps the cone
+    // test conservative under perspective (as meshoptimizer computes it)
+    const uint32_t* vertices = result.vertices.data() + meshlet.vertexOffset;
+    const uint8_t* local = result.triangles.data() + size_t(meshlet.triangleOffset) * 3;
+    glm::vec3 normals[MAX_TRIANGLES];
+    glm::vec3 corners[MAX_TRIANGLES];
+    uint32_t faceCount = 0;
+    glm::vec3 axis(0.0f);
+    for (uint32_t t = 0; t < meshlet.triangleCount; t++) {
+        glm::vec3 a = xyz(positions[vertices[local[t * 3 + 0]]]);
+        glm::vec3 b = xyz(positions[vertices[local[t * 3 + 1]]]);
+        glm::vec3 c = xyz(positions[vertices[local[t * 3 + 2]]]);
+        glm::vec3 n = glm::cross(b - a, c - a);
+        float len = glm::length(n);
+        if (len <= 1e-20f) continue;  // degenerate triangles do not constrain the cone
+        normals[faceCount] = n / len;
+        corners[faceCount] = a;
+        axis += normals[faceCount];
+        faceCount++;
+    }
+
+    meshlet.coneApex = center;
+    meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    meshlet.coneCutoff = 1.0f;  // never culled
+    float axisLen = glm::length(axis);
+    if (faceCount == 0 || axisLen <= 1e-20f) return;
+    axis /= axisLen;
+
+    float minDot = 1.0f;
+    for (uint32_t i = 0; i < faceCount; i++) minDot = std::min(minDot, glm::dot(axis, normals[i]));
+    meshlet.coneAxis = axis;
+    if (minDot <= 0.1f) return;  // wider than ~84 degrees: not worth testing
+
+    float maxT = 0.0f;
+    for (uint32_t i = 0; i < faceCount; i++) {
+        float t = glm::dot(center - corners[i], normals[i]) / glm::dot(axis, normals[i]);
+        maxT = std::max(maxT, t);
+    }
+    meshlet.coneApex = center - axis * maxT;
+    meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
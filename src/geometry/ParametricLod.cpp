@@ -0,0 +1,119 @@
+#include "geometry/ParametricLod.h"
+#include "core/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+uint64_t totalTriangles(const std::vector<float>& sizes, const ParametricLod::Settings& settings,
+                        float factorScale) {
+    std::atomic<uint64_t> total{0};
+    parallelFor(sizes.size(), 4096, [&](size_t begin, size_t end) {
+        uint64_t sum = 0;
+        for (size_t e = begin; e < end; e++) {
+            uint64_t r = ParametricLod::resolution(sizes[e], settings, factorScale);
+            sum += 2 * r * r;
+        }
+        total += sum;
+    });
+    return total;
+}
+
+} // namespace
+
+float ParametricLod::screenSpaceSize(const glm::vec3& boxMin, const glm::vec3& boxMax,
+                                     const ParametricSurface::ElementFrame& frame,
+                                     float userScaling, const glm::mat4& mvp) {
+    const float scale = std::sqrt(frame.area) * userScaling;
+
+    // alignRotationToVector
+    glm::vec3 n = glm::normalize(frame.normal);
+    glm::vec3 helper = std::abs(n.z) < 0.999f ? glm::vec3(0, 0, 1) : glm::vec3(1, 0, 0);
+    glm::vec3 t = glm::normalize(glm::cross(helper, n));
+    glm::vec3 b = glm::cross(n, t);
+
+    glm::vec2 screenMin(1e10f), screenMax(-1e10f);
+    for (int i = 0; i < 8; i++) {
+        glm::vec3 c((i & 1) ? boxMax.x : boxMin.x,
+                    (i & 2) ? boxMax.y : boxMin.y,
+                    (i & 4) ? boxMax.z : boxMin.z);
+        c *= scale;
+        glm::vec3 worldPos = frame.position + t * c.x + b * c.y + n * c.z;
+        glm::vec4 clip = mvp * glm::vec4(worldPos, 1.0f);
+        if (clip.w <= 0.0f) return 10.0f;  // behind the camera: as the shader, never coarsen
+
+        glm::vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+        screenMin = glm::min(screenMin, ndc);
+        screenMax = glm::max(screenMax, ndc);
+    }
+    return std::max(screenMax.x - screenMin.x, screenMax.y - screenMin.y);
+}
+
+uint32_t ParametricLod::resolution(float screenSize, const Settings& settings, float factorScale) {
+    float target = float(settings.baseResolution) * std::sqrt(screenSize * settings.lodFactor * factorScale);
+    // uint(target) in the shader; clamp first so huge sizes cannot overflow
+    uint32_t r = static_cast<uint32_t>(std::min(target, float(settings.maxResolution)));
+    return std::clamp(r, settings.minResolution, settings.maxResolution);
+}
+
+ParametricLod::Result ParametricLod::compute(const ParametricSurface::Params& surface,
+                                             const ParametricSurface::ElementFrames& frames,
+                                             const Settings& settings) {
+    // parametricBoundingBox: the 9 samples at u, v in {0, 0.5, 1} are
+    // exactly a 2x2 grid, evaluated for element 0 like the shader
+    ParametricSurface::Params boxParams = surface;
+    boxParams.resolutionM = 2;
+    boxParams.resolutionN = 2;
+    ParametricSurface box(boxParams);
+    glm::vec3 samplePos[9], sampleNrm[9];
+    box.evaluateLocal(0, 0.0f, samplePos, sampleNrm);
+    glm::vec3 boxMin(1e10f), boxMax(-1e10f);
+    for (const glm::vec3& p : samplePos) {
+        boxMin = glm::min(boxMin, p);
+        boxMax = glm::max(boxMax, p);
+    }
+
+    const size_t count = frames.size();
+    std::vector<float> sizes(count);
+    parallelFor(count, 4096, [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; e++)
+            sizes[e] = screenSpaceSize(boxMin, boxMax, frames[e], surface.userScaling, settings.mvp);
+    });
+
+    Result result;
+    result.triangles = totalTriangles(sizes, settings, 1.0f);
+
+    // Triangles grow linearly with the factor (resolution ~ sqrt), so bisect
+    // its scale in log space for the finest LOD that fits the budget
+    if (settings.triangleBudget > 0 && result.triangles > settings.triangleBudget) {
+        float lo = -30.0f, hi = 0.0f;  // log2 of the scale
+        uint64_t loTriangles = totalTriangles(sizes, settings, std::exp2(lo));
+        for (int i = 0; i < 24 && loTriangles < settings.triangleBudget; i++) {
+            float mid = 0.5f * (lo + hi);
+            uint64_t t = totalTriangles(sizes, settings, std::exp2(mid));
+            if (t <= settings.triangleBudget) { lo = mid; loTriangles = t; }
+            else hi = mid;
+        }
+        result.budgetScale = std::exp2(lo);
+        result.triangles = loTriangles;
+    }
+
+    // Counting sort by resolution keeps element order within each run
+    std::vector<uint32_t> res(count);
+    std::vector<uint32_t> offsets(settings.maxResolution + 2, 0);
+    for (size_t e = 0; e < count; e++) {
+        res[e] = resolution(sizes[e], settings, result.budgetScale);
+        offsets[res[e] + 1]++;
+    }
+    for (uint32_t r = 0; r <= settings.maxResolution; r++) {
+        if (offsets[r + 1] > 0)
+            result.runs.push_back({r, offsets[r], offsets[r + 1]});
+        offsets[r + 1] += offsets[r];
+    }
+    result.elements.resize(count);
+    for (size_t e = 0; e < count; e++)
+        result.elements[offsets[res[e]]++] = static_cast<uint32_t>(e);
+    return result;
+}
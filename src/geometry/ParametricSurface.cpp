@@ -0,0 +1,459 @@
+#include "geometry/ParametricSurface.h"
+#include "geometry/HalfEdge.h"
+#include "core/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Same constants as the shaders
+constexpr float kPi = 3.14159265359f;
+constexpr float kGoldenRatioFrac = 0.618033988749895f;
+constexpr float kBSplineNormalOffset = 0.001f;
+
+float fract(float x) { return x - std::floor(x); }
+
+float smoothstep(float edge0, float edge1, float x) {
+    float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// normalize(cross(a, b)) into slot i of the normal arrays
+inline void storeCrossNormal(float ax, float ay, float az, float bx, float by, float bz,
+                             float* nx, float* ny, float* nz, size_t i) {
+    float cx = ay * bz - az * by;
+    float cy = az * bx - ax * bz;
+    float cz = ax * by - ay * bx;
+    float inv = 1.0f / std::sqrt(cx * cx + cy * cy + cz * cz);
+    nx[i] = cx * inv;
+    ny[i] = cy * inv;
+    nz[i] = cz * inv;
+}
+
+inline void storeNormalized(float x, float y, float z,
+                            float* nx, float* ny, float* nz, size_t i) {
+    float inv = 1.0f / std::sqrt(x * x + y * y + z * z);
+    nx[i] = x * inv;
+    ny[i] = y * inv;
+    nz[i] = z * inv;
+}
+
+// Uniform cubic B-spline weights (bspline.glsl BSPLINE_MATRIX_4 * [t^3, t^2, t, 1])
+inline void bsplineWeights(float t, float w[4]) {
+    float t2 = t * t, t3 = t2 * t;
+    w[0] = (-t3 + 3.0f * t2 - 3.0f * t + 1.0f) / 6.0f;
+    w[1] = (3.0f * t3 - 6.0f * t2 + 4.0f) / 6.0f;
+    w[2] = (-3.0f * t3 + 3.0f * t2 + 3.0f * t + 1.0f) / 6.0f;
+    w[3] = t3 / 6.0f;
+}
+
+// evaluateBSplinePatch: P[i][j] is U-column i, V-row j
+glm::vec3 evaluatePatch(float u, float v, const glm::vec3 P[4][4]) {
+    float wu[4], wv[4];
+    bsplineWeights(u, wu);
+    bsplineWeights(v, wv);
+    glm::vec3 result(0.0f);
+    for (int j = 0; j < 4; j++) {
+        glm::vec3 row = P[0][j] * wu[0] + P[1][j] * wu[1] + P[2][j] * wu[2] + P[3][j] * wu[3];
+        result = result + row * wv[j];
+    }
+    return result;
+}
+
+glm::vec3 edgeTangentFrom(const glm::vec3& from, const glm::vec3& to, const glm::vec3& normal) {
+    glm::vec3 edgeDir = to - from;
+    return glm::normalize(edgeDir - glm::dot(edgeDir, normal) * normal);
+}
+
+} // namespace
+
+ParametricSurface::ElementFrames ParametricSurface::buildFrames(const HalfEdgeMesh& mesh) {
+    ElementFrames frames(size_t(mesh.nbFaces) + mesh.nbVertices);
+    auto vertexPos = [&](int v) { return glm::vec3(mesh.vertexPositions[v]); };
+
+    for (uint32_t f = 0; f < mesh.nbFaces; f++) {
+        ElementFrame& frame = frames[f];
+        frame.position = glm::vec3(mesh.faceCenters[f]);
+        frame.normal = glm::vec3(mesh.faceNormals[f]);
+        frame.area = mesh.faceAreas[f];
+        frame.faceColor = mesh.faceNormals[f].w;
+
+        // Edge tangent from first edge
+        int edge = mesh.faceEdges[f];
+        int v0 = mesh.heVertex[edge];
+        int v1 = mesh.heVertex[mesh.heNext[edge]];
+        frame.edgeTangent = edgeTangentFrom(vertexPos(v0), vertexPos(v1), frame.normal);
+    }
+
+    for (uint32_t v = 0; v < mesh.nbVertices; v++) {
+        ElementFrame& frame = frames[size_t(mesh.nbFaces) + v];
+        frame.position = vertexPos(static_cast<int>(v));
+        frame.normal = glm::vec3(mesh.vertexNormals[v]);
+
+        int edge = mesh.vertexEdges[v];
+        uint32_t adjFace = (edge >= 0) ? static_cast<uint32_t>(mesh.heFace[edge]) : 0u;
+        if (adjFace < mesh.nbFaces) {
+            frame.area = mesh.faceAreas[adjFace];
+            frame.faceColor = 1.0f - mesh.faceNormals[adjFace].w;
+        }
+
+        // Edge tangent from outgoing edge
+        if (edge >= 0) {
+            int next = mesh.heVertex[mesh.heNext[edge]];
+            frame.edgeTangent = edgeTangentFrom(frame.position, vertexPos(next), frame.normal);
+        } else {
+            frame.edgeTangent = glm::vec3(1.0f, 0.0f, 0.0f);
+        }
+    }
+    return frames;
+}
+
+void ParametricSurface::Grid::resize(size_t n) {
+    px.resize(n); py.resize(n); pz.resize(n);
+    nx.resize(n); ny.resize(n); nz.resize(n);
+}
+
+ParametricSurface::ParametricSurface(const Params& p)
+    : params(p), M(std::max(1u, p.resolutionM)), N(std::max(1u, p.resolutionN)) {
+    if (params.elementType == 5 &&
+        (!params.lutPoints || params.lutNx < 4 || params.lutNy < 4)) {
+        throw std::runtime_error("Dragon scale evaluation needs a loaded scale LUT (at least 4x4)");
+    }
+
+    // Same uv as the export shader: vec2(u, v) / vec2(M, N)
+    gridU.resize(M + 1);
+    gridV.resize(N + 1);
+    cosU.resize(M + 1);
+    sinU.resize(M + 1);
+    for (uint32_t i = 0; i <= M; i++) {
+        gridU[i] = static_cast<float>(i) / static_cast<float>(M);
+        float angle = gridU[i] * 2.0f * kPi;
+        cosU[i] = std::cos(angle);
+        sinU[i] = std::sin(angle);
+    }
+    for (uint32_t j = 0; j <= N; j++)
+        gridV[j] = static_cast<float>(j) / static_cast<float>(N);
+
+    // Export quad split: (v00, v10, v11), (v00, v11, v01)
+    const uint32_t W = M + 1;
+    gridIndices.reserve(size_t(M) * N * 6);
+    for (uint32_t qv = 0; qv < N; qv++) {
+        for (uint32_t qu = 0; qu < M; qu++) {
+            uint32_t v00 = qv * W + qu;
+            uint32_t v10 = v00 + 1;
+            uint32_t v01 = v00 + W;
+            uint32_t v11 = v01 + 1;
+            gridIndices.insert(gridIndices.end(), {v00, v10, v11, v00, v11, v01});
+        }
+    }
+
+    if (!shapeVariesPerElement()) evaluateGrid(0, 0.0f, sharedGrid);
+}
+
+bool ParametricSurface::shapeVariesPerElement() const {
+    switch (params.elementType) {
+        case 6: return params.strawBendRandomness != 0.0f;
+        case 7: return params.studTreadPlate || params.studRotationRandomness != 0.0f;
+        default: return false;
+    }
+}
+
+void ParametricSurface::evaluateGrid(uint32_t elementId, float faceColor, Grid& grid) const {
+    const size_t W = M + 1;
+    grid.resize(W * (N + 1));
+    if (params.elementType == 5) {
+        evaluateDragonScale(grid);
+        return;
+    }
+
+    const float* cu = cosU.data();
+    const float* su = sinU.data();
+
+    // Per-element constants of the straw and stud
+    float bendCos = 0.0f, bendSin = 0.0f, rotCos = 1.0f, rotSin = 0.0f;
+    if (params.elementType == 6) {
+        float randomAngle = fract(static_cast<float>(elementId) * kGoldenRatioFrac) * 2.0f * kPi;
+        float bendAngle = params.strawBendDirection + params.strawBendRandomness * randomAngle;
+        bendCos = std::cos(bendAngle);
+        bendSin = std::sin(bendAngle);
+    } else if (params.elementType == 7) {
+        float angle;
+        if (params.studTreadPlate) {
+            angle = params.studRotation + faceColor * kPi * 0.5f;
+        } else {
+            float randomAngle = fract(static_cast<float>(elementId) * kGoldenRatioFrac) * 2.0f * kPi;
+            angle = params.studRotation + params.studRotationRandomness * randomAngle;
+        }
+        rotCos = std::cos(angle);
+        rotSin = std::sin(angle);
+    }
+
+    for (uint32_t j = 0; j <= N; j++) {
+        const float v = gridV[j];
+        float* px = grid.px.data() + j * W;
+        float* py = grid.py.data() + j * W;
+        float* pz = grid.pz.data() + j * W;
+        float* nx = grid.nx.data() + j * W;
+        float* ny = grid.ny.data() + j * W;
+        float* nz = grid.nz.data() + j * W;
+
+        switch (params.elementType) {
+        case 0: {  // torus
+            const float R = params.torusMajorR, r = params.torusMinorR;
+            const float cosV = std::cos(v * 2.0f * kPi), sinV = std::sin(v * 2.0f * kPi);
+            const float tube = R + r * cosV;
+            for (size_t i = 0; i < W; i++) {
+                px[i] = tube * cu[i];
+                py[i] = tube * su[i];
+                pz[i] = r * sinV;
+                storeCrossNormal(-tube * su[i], tube * cu[i], 0.0f,
+                                 -r * sinV * cu[i], -r * sinV * su[i], r * cosV,
+                                 nx, ny, nz, i);
+            }
+            break;
+        }
+        case 2: {  // cone, radius 0.5, height 1
+            const float radius = 0.5f, height = 1.0f;
+            const float r = radius * (1.0f - v);
+            for (size_t i = 0; i < W; i++) {
+                px[i] = r * cu[i];
+                py[i] = r * su[i];
+                pz[i] = height * v;
+                storeCrossNormal(-r * su[i], r * cu[i], 0.0f,
+                                 -radius * cu[i], -radius * su[i], height,
+                                 nx, ny, nz, i);
+            }
+            break;
+        }
+        case 3: {  // cylinder, radius 0.5, height 1
+            const float radius = 0.5f, height = 1.0f;
+            for (size_t i = 0; i < W; i++) {
+                px[i] = radius * cu[i];
+                py[i] = radius * su[i];
+                pz[i] = height * (v - 0.5f);
+                storeNormalized(cu[i], su[i], 0.0f, nx, ny, nz, i);
+            }
+            break;
+        }
+        case 6: {  // straw
+            const float baseRadius = params.strawBaseRadius;
+            const float bendAmount = params.strawBendAmount;
+            const float height = 2.0f;
+            const float taperStart = std::clamp(1.0f - 1.0f / params.strawTaperPower, 0.5f, 0.98f);
+            const float r = baseRadius * (1.0f - smoothstep(taperStart, 1.0f, v));
+            const float bend = bendAmount * v * v;
+            const float bendX = bend * bendCos, bendY = bend * bendSin;
+
+            const float taperRange = 1.0f - taperStart;
+            const float t = std::clamp((v - taperStart) / taperRange, 0.0f, 1.0f);
+            const float drdv = baseRadius * (-6.0f * t * (1.0f - t) / taperRange);
+            const float dbdv = 2.0f * bendAmount * v;
+            const float dbxdv = dbdv * bendCos, dbydv = dbdv * bendSin;
+            for (size_t i = 0; i < W; i++) {
+                px[i] = r * cu[i] + bendX;
+                py[i] = r * su[i] + bendY;
+                pz[i] = height * v;
+                storeCrossNormal(-r * su[i], r * cu[i], 0.0f,
+                                 drdv * cu[i] + dbxdv, drdv * su[i] + dbydv, height,
+                                 nx, ny, nz, i);
+            }
+            break;
+        }
+        case 7: {  // stud
+            const float elongation = params.studElongation;
+            const float d = v * v;
+            const float h = params.studHeight * std::pow(std::max(1.0f - d, 0.0f), params.studPower);
+            const float dhdv = -2.0f * v * params.studHeight * params.studPower
+                             * std::pow(std::max(1.0f - d, 0.0001f), params.studPower - 1.0f);
+            for (size_t i = 0; i < W; i++) {
+                float x = v * cu[i] * elongation;
+                float y = v * su[i];
+                px[i] = x * rotCos - y * rotSin;
+                py[i] = x * rotSin + y * rotCos;
+                pz[i] = h;
+                // Tangents before rotation, then rotated about z
+                float dux = -v * su[i] * elongation, duy = v * cu[i];
+                float dvx = cu[i] * elongation, dvy = su[i];
+                storeCrossNormal(dux * rotCos - duy * rotSin, dux * rotSin + duy * rotCos, 0.0f,
+                                 dvx * rotCos - dvy * rotSin, dvx * rotSin + dvy * rotCos, dhdv,
+                                 nx, ny, nz, i);
+            }
+            break;
+        }
+        default: {  // 1 sphere, 4 hemisphere (top half), anything else as a sphere
+            const float radius = params.sphereRadius;
+            const float phi = v * (params.elementType == 4 ? 0.5f : 1.0f) * kPi;
+            const float sinPhi = std::sin(phi), cosPhi = std::cos(phi);
+            for (size_t i = 0; i < W; i++) {
+                px[i] = radius * sinPhi * cu[i];
+                py[i] = radius * sinPhi * su[i];
+                pz[i] = radius * cosPhi;
+                storeNormalized(px[i], py[i], pz[i], nx, ny, nz, i);
+            }
+            break;
+        }
+        }
+    }
+}
+
+void ParametricSurface::evaluateDragonScale(Grid& grid) const {
+    const uint32_t Nx = params.lutNx, Ny = params.lutNy;
+    const uint32_t numPatchesU = Nx - 3, numPatchesV = Ny - 3;
+
+    const glm::vec3 extentMin = params.lutMinExtent, extentMax = params.lutMaxExtent;
+    const glm::vec3 center = (extentMin + extentMax) * 0.5f;
+    const float scale = std::max(std::max(std::max(extentMax.x - extentMin.x,
+                                                   extentMax.y - extentMin.y),
+                                          extentMax.z - extentMin.z) * 0.5f, 0.0001f);
+    const float zOffset = (center.y - extentMin.y) / scale;
+
+    const size_t W = M + 1;
+    for (uint32_t j = 0; j <= N; j++) {
+        float pV = gridV[j] * static_cast<float>(numPatchesV);
+        uint32_t pv = std::min(static_cast<uint32_t>(pV), numPatchesV - 1);
+        float localV = pV - static_cast<float>(pv);
+
+        for (uint32_t i = 0; i <= M; i++) {
+            float pU = gridU[i] * static_cast<float>(numPatchesU);
+            uint32_t pu = std::min(static_cast<uint32_t>(pU), numPatchesU - 1);
+            float localU = pU - static_cast<float>(pu);
+
+            glm::vec3 P[4][4];
+            for (uint32_t b = 0; b < 4; b++)
+                for (uint32_t a = 0; a < 4; a++)
+                    P[a][b] = glm::vec3(params.lutPoints[(pv + b) * Nx + (pu + a)]);
+
+            // Into unit space, then Y<->Z so the scale lies on the face with
+            // its base (LUT minY) at z = 0
+            glm::vec3 pos = (evaluatePatch(localU, localV, P) - center) / scale;
+            size_t k = j * W + i;
+            grid.px[k] = pos.x;
+            grid.py[k] = pos.z;
+            grid.pz[k] = pos.y + zOffset;
+
+            glm::vec3 dU = evaluatePatch(localU + kBSplineNormalOffset, localV, P)
+                         - evaluatePatch(localU - kBSplineNormalOffset, localV, P);
+            glm::vec3 dV = evaluatePatch(localU, localV + kBSplineNormalOffset, P)
+                         - evaluatePatch(localU, localV - kBSplineNormalOffset, P);
+            glm::vec3 n = glm::normalize(glm::cross(dU, dV));
+            grid.nx[k] = n.x;
+            grid.ny[k] = n.z;
+            grid.nz[k] = n.y;
+        }
+    }
+}
+
+void ParametricSurface::evaluateLocal(uint32_t elementId, float faceColor,
+                                      glm::vec3* positions, glm::vec3* normals) const {
+    Grid scratch;
+    const Grid* grid = &sharedGrid;
+    if (shapeVariesPerElement()) {
+        evaluateGrid(elementId, faceColor, scratch);
+        grid = &scratch;
+    }
+    for (size_t k = 0; k < grid->px.size(); k++) {
+        positions[k] = glm::vec3(grid->px[k], grid->py[k], grid->pz[k]);
+        normals[k] = glm::vec3(grid->nx[k], grid->ny[k], grid->nz[k]);
+    }
+}
+
+void ParametricSurface::transformElement(const Grid& grid, const ElementFrame& frame,
+                                         glm::vec4* positions, glm::vec4* normals) const {
+    const float scale = std::sqrt(frame.area) * params.userScaling;
+    glm::vec3 origin = frame.position;
+    glm::vec3 T, B, Nrm;
+
+    if (params.chainmailMode) {
+        // offsetVertexChainmail: lifted off the surface, TBN from the mesh
+        // edge, tilted about T by the face's 2-colouring
+        Nrm = glm::normalize(frame.normal);
+        origin = origin + Nrm * (params.chainmailSurfaceOffset * scale);
+        T = glm::normalize(frame.edgeTangent);
+        B = glm::cross(Nrm, T);
+        float sign = 1.0f - 2.0f * frame.faceColor;
+        float angle = sign * params.chainmailTiltAngle * (3.14159265f / 2.0f);
+        float c = std::cos(angle), s = std::sin(angle);
+        glm::vec3 Bt = B, Nt = Nrm;
+        B = c * Bt + s * Nt;
+        Nrm = -s * Bt + c * Nt;
+    } else {
+        // offsetVertex: alignRotationToVector(normal)
+        Nrm = glm::normalize(frame.normal);
+        glm::vec3 helper = std::abs(Nrm.z) < 0.999f ? glm::vec3(0, 0, 1) : glm::vec3(1, 0, 0);
+        T = glm::normalize(glm::cross(helper, Nrm));
+        B = glm::cross(Nrm, T);
+    }
+
+    const size_t count = grid.px.size();
+    const float* px = grid.px.data();
+    const float* py = grid.py.data();
+    const float* pz = grid.pz.data();
+    const float* nx = grid.nx.data();
+    const float* ny = grid.ny.data();
+    const float* nz = grid.nz.data();
+    for (size_t k = 0; k < count; k++) {
+        float sx = px[k] * scale, sy = py[k] * scale, sz = pz[k] * scale;
+        positions[k] = glm::vec4(origin.x + T.x * sx + B.x * sy + Nrm.x * sz,
+                                 origin.y + T.y * sx + B.y * sy + Nrm.y * sz,
+                                 origin.z + T.z * sx + B.z * sy + Nrm.z * sz, 1.0f);
+        // The shader renormalises after the (identity) model matrix
+        float wx = T.x * nx[k] + B.x * ny[k] + Nrm.x * nz[k];
+        float wy = T.y * nx[k] + B.y * ny[k] + Nrm.y * nz[k];
+        float wz = T.z * nx[k] + B.z * ny[k] + Nrm.z * nz[k];
+        float inv = 1.0f / std::sqrt(wx * wx + wy * wy + wz * wz);
+        normals[k] = glm::vec4(wx * inv, wy * inv, wz * inv, 0.0f);
+    }
+}
+
+void ParametricSurface::evaluateElementRange(const ElementFrames& frames,
+                                             uint32_t firstElement, uint32_t count,
+                                             glm::vec4* positions, glm::vec4* normals,
+                                             glm::vec2* uvs, uint32_t* indices) const {
+    evaluateElements(frames, nullptr, firstElement, count, positions, normals, uvs, indices);
+}
+
+void ParametricSurface::evaluateElementList(const ElementFrames& frames,
+                                            const uint32_t* elementIds, uint32_t count,
+                                            glm::vec4* positions, glm::vec4* normals,
+                                            glm::vec2* uvs, uint32_t* indices) const {
+    evaluateElements(frames, elementIds, 0, count, positions, normals, uvs, indices);
+}
+
+// Elements are elementIds[e] when given, otherwise firstElement + e
+void ParametricSurface::evaluateElements(const ElementFrames& frames,
+                                         const uint32_t* elementIds, uint32_t firstElement,
+                                         uint32_t count,
+                                         glm::vec4* positions, glm::vec4* normals,
+                                         glm::vec2* uvs, uint32_t* indices) const {
+    const uint32_t vpe = vertsPerElement();
+    const size_t ipe = gridIndices.size();
+    const bool varies = shapeVariesPerElement();
+
+    parallelFor(count, 64, [&](size_t begin, size_t end) {
+        Grid scratch;  // per-thread, for shapes that differ per element
+        for (size_t e = begin; e < end; e++) {
+            const uint32_t elementId = elementIds ? elementIds[e]
+                                                  : firstElement + static_cast<uint32_t>(e);
+            const ElementFrame& frame = frames[elementId];
+            const Grid* grid = &sharedGrid;
+            if (varies) {
+                evaluateGrid(elementId, frame.faceColor, scratch);
+                grid = &scratch;
+            }
+
+            const size_t vertBase = e * vpe;
+            transformElement(*grid, frame, positions + vertBase, normals + vertBase);
+
+            glm::vec2* uv = uvs + vertBase;
+            for (uint32_t j = 0; j <= N; j++)
+                for (uint32_t i = 0; i <= M; i++)
+                    *uv++ = glm::vec2(gridU[i], gridV[j]);
+
+            uint32_t* idx = indices + e * ipe;
+            const uint32_t base = static_cast<uint32_t>(vertBase);
+            for (size_t k = 0; k < ipe; k++) idx[k] = base + gridIndices[k];
+        }
+    });
+}
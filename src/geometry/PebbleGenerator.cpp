@@ -0,0 +1,448 @@
+#include "geometry/PebbleGenerator.h"
+#include "core/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t kMaxSubdivPerWorkgroup = 3;  // pebble.glsl MAX_SUBDIV_PER_WORKGROUP
+
+// ---- noise.glsl ----
+
+uint32_t pcg(uint32_t& seed) {
+    uint32_t state = seed * 747796405u + 2891336453u;
+    uint32_t tmp = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (seed = (tmp >> 22u) ^ tmp);
+}
+
+float randRange(uint32_t& seed, float minVal, float maxVal) {
+    float t = static_cast<float>(pcg(seed)) / static_cast<float>(0xffffffffu);
+    return minVal * (1.0f - t) + maxVal * t;
+}
+
+float glslMod(float x, float y) { return x - y * std::floor(x / y); }
+float glslFract(float x) { return x - std::floor(x); }
+float permute(float x) { return glslMod((x * 34.0f + 1.0f) * x, 289.0f); }
+float taylorInvSqrt(float r) { return 1.79284291400159f - 0.85373472095314f * r; }
+
+// perlinNoise3D: value in about [-1, 1] and its analytic gradient
+float perlinNoise3D(const glm::vec3& P, glm::vec3& gradient) {
+    glm::vec3 Pi0(std::floor(P.x), std::floor(P.y), std::floor(P.z));
+    glm::vec3 Pi1 = Pi0 + glm::vec3(1.0f);
+    Pi0 = glm::vec3(glslMod(Pi0.x, 289.0f), glslMod(Pi0.y, 289.0f), glslMod(Pi0.z, 289.0f));
+    Pi1 = glm::vec3(glslMod(Pi1.x, 289.0f), glslMod(Pi1.y, 289.0f), glslMod(Pi1.z, 289.0f));
+    glm::vec3 Pf0(glslFract(P.x), glslFract(P.y), glslFract(P.z));
+    glm::vec3 Pf1 = Pf0 - glm::vec3(1.0f);
+
+    const float ix[4] = {Pi0.x, Pi1.x, Pi0.x, Pi1.x};
+    const float iy[4] = {Pi0.y, Pi0.y, Pi1.y, Pi1.y};
+
+    // Gradients of the 8 corners; lane k of layer z is corner (k & 1, k >> 1, z)
+    glm::vec3 g[2][4];
+    for (int z = 0; z < 2; z++) {
+        float iz = (z == 0) ? Pi0.z : Pi1.z;
+        for (int k = 0; k < 4; k++) {
+            float ixy = permute(permute(ix[k]) + iy[k]);
+            float gx = permute(ixy + iz) / 7.0f;
+            float gy = glslFract(std::floor(gx) / 7.0f) - 0.5f;
+            gx = glslFract(gx);
+            float gz = 0.5f - std::abs(gx) - std::abs(gy);
+            float sz = (0.0f < gz) ? 0.0f : 1.0f;
+            gx -= sz * ((gx < 0.0f ? 0.0f : 1.0f) - 0.5f);
+            gy -= sz * ((gy < 0.0f ? 0.0f : 1.0f) - 0.5f);
+            glm::vec3 grad(gx, gy, gz);
+            g[z][k] = grad * taylorInvSqrt(glm::dot(grad, grad));
+        }
+    }
+
+    auto cornerDot = [&](int x, int y, int z) {
+        glm::vec3 d(x ? Pf1.x : Pf0.x, y ? Pf1.y : Pf0.y, z ? Pf1.z : Pf0.z);
+        return glm::dot(g[z][x + 2 * y], d);
+    };
+    float n000 = cornerDot(0, 0, 0), n100 = cornerDot(1, 0, 0);
+    float n010 = cornerDot(0, 1, 0), n110 = cornerDot(1, 1, 0);
+    float n001 = cornerDot(0, 0, 1), n101 = cornerDot(1, 0, 1);
+    float n011 = cornerDot(0, 1, 1), n111 = cornerDot(1, 1, 1);
+
+    auto mix = [](float a, float b, float t) { return a * (1.0f - t) + b * t; };
+    auto fade = [](float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); };
+    auto dFade = [](float t) { return 30.0f * t * t * (t * (t - 2.0f) + 1.0f); };
+    glm::vec3 f(fade(Pf0.x), fade(Pf0.y), fade(Pf0.z));
+    glm::vec3 df(dFade(Pf0.x), dFade(Pf0.y), dFade(Pf0.z));
+
+    float x00 = mix(n000, n100, f.x), x10 = mix(n010, n110, f.x);
+    float x01 = mix(n001, n101, f.x), x11 = mix(n011, n111, f.x);
+    float xy0 = mix(x00, x10, f.y), xy1 = mix(x01, x11, f.y);
+
+    float dxyz = mix(mix(n100 - n000, n110 - n010, f.y), mix(n101 - n001, n111 - n011, f.y), f.z);
+    float dyz = mix(x10 - x00, x11 - x01, f.z);
+    float dz = xy1 - xy0;
+    gradient = glm::vec3(dxyz * df.x, dyz * df.y, dz * df.z);
+    return mix(xy0, xy1, f.z);
+}
+
+// ---- pebble.mesh B-spline (BSPLINE_MATRIX_4 * [1, t, t^2, t^3]) ----
+
+void bsplineBasis(float t, float w[4]) {
+    float t2 = t * t, t3 = t2 * t;
+    w[0] = (1.0f - 3.0f * t + 3.0f * t2 - t3) / 6.0f;
+    w[1] = (4.0f - 6.0f * t2 + 3.0f * t3) / 6.0f;
+    w[2] = (1.0f + 3.0f * t + 3.0f * t2 - 3.0f * t3) / 6.0f;
+    w[3] = t3 / 6.0f;
+}
+
+glm::vec3 mix3(const glm::vec3& a, const glm::vec3& b, float t) {
+    return a * (1.0f - t) + b * t;
+}
+
+// Edge patch vertex count per side at level N (N >= 1)
+uint32_t edgeResolution(uint32_t level) { return (1u << (level - 1)) + 1; }
+
+// Fill curve vertices: 2^min(N - 1 - subdivOffset, 5) + 1, in the shader's
+// unsigned arithmetic (an offset past the level wraps and clamps to 5)
+uint32_t fillResolutionFor(uint32_t level, uint32_t subdivOffset) {
+    uint32_t exponent = std::min((level - 1) - subdivOffset, 5u);
+    return (1u << exponent) + 1;
+}
+
+} // namespace
+
+void PebbleGenerator::Arena::clear() {
+    positions.clear();
+    normals.clear();
+    uvs.clear();
+    indices.clear();
+}
+
+PebbleGenerator::PebbleGenerator(const Params& p, const Faces& f)
+    : params(p), faces(f), level(std::min(p.subdivisionLevel, MAX_SUBDIVISION_LEVEL)) {
+    if (level > 0) {
+        patchResolution = edgeResolution(level);
+        fillResolution = fillResolutionFor(level, params.subdivOffset);
+
+        bsplineWeights.resize(size_t(patchResolution) * 4);
+        for (uint32_t x = 0; x < patchResolution; x++) {
+            float t = static_cast<float>(x) / static_cast<float>(patchResolution - 1);
+            bsplineBasis(t, &bsplineWeights[size_t(x) * 4]);
+        }
+    }
+}
+
+uint32_t PebbleGenerator::cornerCount(uint32_t face) const {
+    return faces.faceVertOffsets[face + 1] - faces.faceVertOffsets[face];
+}
+
+glm::vec3 PebbleGenerator::corner(uint32_t face, uint32_t i) const {
+    return faces.vertexPositions[faces.faceVertIndices[faces.faceVertOffsets[face] + i]];
+}
+
+PebbleGenerator::FaceFrame PebbleGenerator::faceFrame(uint32_t face) const {
+    FaceFrame frame;
+    frame.center = faces.faceCenters[face];
+    frame.normal = faces.faceNormals[face];
+    frame.scale = 1.0f;
+
+    // Same seed (the face id) for every patch of the face
+    uint32_t seed = face;
+    frame.extrusion = randRange(seed, params.extrusionAmount * (1.0f - params.extrusionVariation),
+                                params.extrusionAmount * (1.0f + params.extrusionVariation));
+
+    if (params.usePathway) {
+        glm::vec2 toFace(frame.center.x - params.playerWorldPos.x,
+                         frame.center.z - params.playerWorldPos.z);
+        glm::vec2 fwd = glm::normalize(glm::vec2(params.playerForward.x, params.playerForward.z));
+        float projFwd = glm::dot(toFace, fwd);
+        float projSide = glm::length(toFace - projFwd * fwd);
+        float radius = (projFwd >= 0.0f) ? params.pathwayRadius
+                                         : params.pathwayRadius * params.pathwayBackScale;
+        float dist = glm::length(glm::vec2(projFwd / radius, projSide / params.pathwayRadius));
+        float t = std::clamp((1.0f - dist) * params.pathwayFalloff, 0.0f, 1.0f);
+        frame.scale = t * t * (3.0f - 2.0f * t);
+        if (frame.scale < 0.01f) frame.scale = 0.0f;
+    }
+    return frame;
+}
+
+uint64_t PebbleGenerator::faceVertexCount(uint32_t face) const {
+    uint64_t V = cornerCount(face);
+    if (V < 3 || faceFrame(face).scale == 0.0f) return 0;
+    if (level == 0) return 2 * V;
+    return 6 * V * patchResolution * patchResolution + 2 * V * (2 * fillResolution + 1);
+}
+
+uint64_t PebbleGenerator::faceTriangleCount(uint32_t face) const {
+    uint64_t V = cornerCount(face);
+    if (V < 3 || faceFrame(face).scale == 0.0f) return 0;
+    if (level == 0) return 3 * V - 2;
+    uint64_t quads = uint64_t(patchResolution - 1) * (patchResolution - 1);
+    return 6 * V * quads * 2 + 2 * V * 3 * (fillResolution - 1);
+}
+
+void PebbleGenerator::generate(uint32_t firstFace, uint32_t count, std::vector<Arena>& arenas) const {
+    size_t runs = parallelThreadCount();
+    runs = std::max<size_t>(1, std::min<size_t>(runs, count));
+    arenas.resize(runs);
+
+    parallelFor(runs, 1, [&](size_t begin, size_t end) {
+        for (size_t run = begin; run < end; run++) {
+            Arena& arena = arenas[run];
+            arena.clear();
+            uint32_t faceBegin = firstFace + static_cast<uint32_t>(count * run / runs);
+            uint32_t faceEnd = firstFace + static_cast<uint32_t>(count * (run + 1) / runs);
+            for (uint32_t face = faceBegin; face < faceEnd; face++)
+                generateFace(face, arena);
+        }
+    });
+}
+
+void PebbleGenerator::generateFace(uint32_t face, Arena& out) const {
+    const uint32_t V = cornerCount(face);
+    if (V < 3) return;
+    FaceFrame frame = faceFrame(face);
+    if (frame.scale == 0.0f) return;
+
+    if (level == 0) {
+        generateExtrusion(face, frame, out);
+        return;
+    }
+    // Edge patches ring by ring (2 per edge), then the fill fans
+    for (uint32_t ring = 0; ring < 3; ring++)
+        for (uint32_t patch = 0; patch < 2 * V; patch++)
+            generateEdgePatch(face, frame, ring, patch, out);
+    for (uint32_t patch = 0; patch < 2 * V; patch++)
+        generateFillPatch(face, frame, patch, out);
+}
+
+void PebbleGenerator::emitVertex(const FaceFrame& frame, glm::vec3 pos, glm::vec3 normal,
+                                 glm::vec2 uv, Arena& out) const {
+    glm::vec3 desiredPos = (pos - frame.center) * frame.scale + frame.center;
+    glm::vec3 desiredNormal = normal;
+
+    if (params.doNoise) {
+        glm::vec3 gradient;
+        float value = perlinNoise3D(pos * params.noiseFrequency, gradient);
+        desiredPos = desiredPos + value * desiredNormal * params.noiseAmplitude * frame.scale;
+        desiredNormal = glm::normalize(desiredNormal + gradient * params.normalOffset);
+    }
+
+    out.positions.push_back(glm::vec4(desiredPos, 1.0f));
+    out.normals.push_back(glm::vec4(desiredNormal, 0.0f));
+    out.uvs.push_back(uv);
+}
+
+void PebbleGenerator::generateExtrusion(uint32_t face, const FaceFrame& frame, Arena& out) const {
+    // Level 0 uses the unrandomised extrusion amount
+    const uint32_t V = cornerCount(face);
+    const uint32_t base = out.vertexCount();
+    const glm::vec3 offset = params.extrusionAmount * frame.normal;
+
+    // Bottom ring at [0, V), extruded ring at [V, 2V)
+    std::vector<glm::vec3> ring(V);
+    for (uint32_t i = 0; i < V; i++) ring[i] = corner(face, i);
+    for (uint32_t i = 0; i < V; i++)
+        emitVertex(frame, ring[i], glm::normalize(ring[i] - frame.center), glm::vec2(0.0f), out);
+    for (uint32_t i = 0; i < V; i++)
+        emitVertex(frame, ring[i] + offset, frame.normal, glm::vec2(0.0f), out);
+
+    // Sides, then the top as a fan
+    for (uint32_t i = 0; i < V; i++) {
+        uint32_t right = (i + 1) % V;
+        out.indices.insert(out.indices.end(), {base + i, base + i + V, base + right + V,
+                                               base + i, base + right + V, base + right});
+    }
+    for (uint32_t i = 0; i + 2 < V; i++)
+        out.indices.insert(out.indices.end(), {base + V, base + V + i + 1, base + V + i + 2});
+}
+
+void PebbleGenerator::generateEdgePatch(uint32_t face, const FaceFrame& frame, uint32_t ring,
+                                        uint32_t patch, Arena& out) const {
+    const uint32_t V = cornerCount(face);
+    const uint32_t edge = patch / 2;
+    const glm::vec3 c = frame.center;
+    const glm::vec3 n = frame.normal;
+
+    // adjustedVertexPos: moves the control point so the curve passes
+    // through the face corner despite B-spline contraction
+    auto adjusted = [&](uint32_t i) {
+        glm::vec3 prev = corner(face, (i + V - 1) % V);
+        glm::vec3 next = corner(face, (i + 1) % V);
+        return (5.0f * corner(face, i) - (prev + next) / 2.0f) / 4.0f;
+    };
+    const uint32_t next = (edge + 1) % V;
+    glm::vec3 base[4];
+    if (patch % 2 == 0) {
+        uint32_t prev = (edge + V - 1) % V;
+        base[0] = (corner(face, prev) + corner(face, edge)) / 2.0f;
+        base[1] = adjusted(edge);
+        base[2] = (corner(face, edge) + corner(face, next)) / 2.0f;
+        base[3] = adjusted(next);
+    } else {
+        uint32_t next2 = (edge + 2) % V;
+        base[0] = adjusted(edge);
+        base[1] = (corner(face, edge) + corner(face, next)) / 2.0f;
+        base[2] = adjusted(next);
+        base[3] = (corner(face, next2) + corner(face, next)) / 2.0f;
+    }
+
+    // Ring control cage, rows top to bottom, and the normals at the four
+    // inner control points (5, 6, 9, 10)
+    const float e = frame.extrusion;
+    const float roundness = 0.95f * (1.0f - params.roundness) + 0.5f * params.roundness;
+    const float fill = params.fillradius;
+    glm::vec3 S[16];
+    glm::vec3 rounded[2], radial[2];
+    for (uint32_t k = 0; k < 4; k++) {
+        const glm::vec3 b = base[k];
+        switch (ring) {
+        case 0:   // side wall
+            S[k]      = b + e * n;
+            S[4 + k]  = b + roundness * e * n;
+            S[8 + k]  = b;
+            S[12 + k] = b - roundness * e * n;
+            break;
+        case 1:   // shoulder into the top
+            S[k]      = c + fill * (b - c) + e * n;
+            S[4 + k]  = b + e * n;
+            S[8 + k]  = b + roundness * e * n;
+            S[12 + k] = b;
+            break;
+        default:  // top towards the fill
+            S[k]      = c + (2.0f * fill - 1.0f) * (b - c) + e * n;
+            S[4 + k]  = c + fill * (b - c) + e * n;
+            S[8 + k]  = b + e * n;
+            S[12 + k] = b + roundness * e * n;
+            break;
+        }
+    }
+    for (uint32_t k = 0; k < 2; k++) {
+        rounded[k] = mix3(base[k + 1] - c, n, roundness);
+        radial[k] = glm::normalize(base[k + 1] - c);
+    }
+
+    glm::vec3 N5, N6, N9, N10;
+    if (params.normalCalculationMethod == 0) {
+        N5  = -glm::normalize(glm::cross(S[6] - S[4], S[9] - S[1]));
+        N6  = -glm::normalize(glm::cross(S[7] - S[5], S[10] - S[2]));
+        N9  = -glm::normalize(glm::cross(S[10] - S[8], S[13] - S[5]));
+        N10 = -glm::normalize(glm::cross(S[11] - S[9], S[14] - S[6]));
+    } else if (ring == 0) {
+        N5 = radial[0];  N6 = radial[1];
+        N9 = radial[0];  N10 = radial[1];
+    } else if (ring == 1) {
+        N5 = rounded[0]; N6 = rounded[1];
+        N9 = radial[0];  N10 = radial[1];
+    } else {
+        N5 = n;          N6 = n;
+        N9 = rounded[0]; N10 = rounded[1];
+    }
+
+    // Tensor product: curve each cage row along u once per column, then
+    // blend the four row curves along v
+    const uint32_t R = patchResolution;
+    const float* w = bsplineWeights.data();
+    std::vector<glm::vec3> rowCurves(size_t(R) * 4);
+    for (uint32_t x = 0; x < R; x++) {
+        const float* wx = w + size_t(x) * 4;
+        for (uint32_t row = 0; row < 4; row++) {
+            const glm::vec3* P = S + row * 4;
+            rowCurves[size_t(row) * R + x] = P[0] * wx[0] + P[1] * wx[1] + P[2] * wx[2] + P[3] * wx[3];
+        }
+    }
+    auto surfacePoint = [&](uint32_t x, uint32_t y) {
+        const float* wy = w + size_t(y) * 4;
+        return rowCurves[x] * wy[0] + rowCurves[R + x] * wy[1]
+             + rowCurves[2 * R + x] * wy[2] + rowCurves[3 * R + x] * wy[3];
+    };
+
+    // subdivOffset stitching: ring 2's v = 0 edge meets the coarser fill
+    // curve, so in-between vertices are snapped onto its segments. The GPU
+    // only does this while a workgroup's grid (at most 9 wide) spans a segment.
+    const uint32_t span = 1u << params.subdivOffset;
+    const uint32_t workgroupGrid = std::min(R - 1, 1u << kMaxSubdivPerWorkgroup) + 1;
+    const bool stitch = (ring == 2) && workgroupGrid >= span + 1;
+
+    const uint32_t first = out.vertexCount();
+    const float invR = 1.0f / static_cast<float>(R - 1);
+    for (uint32_t y = 0; y < R; y++) {
+        const float v = static_cast<float>(y) * invR;
+        for (uint32_t x = 0; x < R; x++) {
+            const float u = static_cast<float>(x) * invR;
+            glm::vec3 pos;
+            uint32_t local = x % span;
+            if (stitch && y == 0 && local != 0) {
+                uint32_t prevX = x - local;
+                pos = mix3(surfacePoint(prevX, 0), surfacePoint(prevX + span, 0),
+                           static_cast<float>(local) / static_cast<float>(span));
+            } else {
+                pos = surfacePoint(x, y);
+            }
+            glm::vec3 normal = glm::normalize(mix3(mix3(N5, N6, u), mix3(N9, N10, u), v));
+            emitVertex(frame, pos, normal, glm::vec2(u, v), out);
+        }
+    }
+
+    // emitSingleQuad(i, i + R, i + R + 1, i + 1)
+    for (uint32_t y = 0; y + 1 < R; y++) {
+        for (uint32_t x = 0; x + 1 < R; x++) {
+            uint32_t i = first + y * R + x;
+            out.indices.insert(out.indices.end(), {i, i + R, i + R + 1, i, i + R + 1, i + 1});
+        }
+    }
+}
+
+void PebbleGenerator::generateFillPatch(uint32_t face, const FaceFrame& frame, uint32_t patch,
+                                        Arena& out) const {
+    const uint32_t V = cornerCount(face);
+    const uint32_t edge = patch / 2;
+    const uint32_t nextEdge = (edge + 1) % V;
+    const glm::vec3 c = frame.center;
+    const glm::vec3 n = frame.normal;
+    const float e = frame.extrusion;
+
+    auto fillCorner = [&](uint32_t i) {
+        return c + params.fillradius * (corner(face, i) - c) + n * e;
+    };
+    glm::vec3 vertA = fillCorner(edge);
+    glm::vec3 vertB = fillCorner(nextEdge);
+    glm::vec3 P[4];
+    if (patch % 2 == 0) {
+        glm::vec3 prev = fillCorner((edge + V - 1) % V);
+        P[0] = (prev + vertA) * 0.5f;
+        P[1] = vertA;
+        P[2] = (vertA + vertB) * 0.5f;
+        P[3] = vertB;
+    } else {
+        glm::vec3 nextNext = fillCorner((nextEdge + 1) % V);
+        P[0] = vertA;
+        P[1] = (vertA + vertB) * 0.5f;
+        P[2] = vertB;
+        P[3] = (vertB + nextNext) * 0.5f;
+    }
+
+    // Outer curve at [0, R), inner ring at [R, 2R), fan centre at 2R
+    const uint32_t R = fillResolution;
+    const uint32_t first = out.vertexCount();
+    const glm::vec3 fanCenter = c + n * e;
+    std::vector<glm::vec3> outer(R);
+    for (uint32_t v = 0; v < R; v++) {
+        float w[4];
+        bsplineBasis(static_cast<float>(v) / static_cast<float>(R - 1), w);
+        outer[v] = P[0] * w[0] + P[1] * w[1] + P[2] * w[2] + P[3] * w[3];
+    }
+    for (uint32_t v = 0; v < R; v++)
+        emitVertex(frame, outer[v], n, glm::vec2(0.0f), out);
+    for (uint32_t v = 0; v < R; v++)
+        emitVertex(frame, outer[v] + (fanCenter - outer[v]) * params.ringoffset, n, glm::vec2(0.0f), out);
+    emitVertex(frame, fanCenter, n, glm::vec2(0.0f), out);
+
+    const uint32_t inner = first + R;
+    const uint32_t centre = first + 2 * R;
+    for (uint32_t v = 0; v + 1 < R; v++) {
+        uint32_t o0 = first + v, o1 = o0 + 1;
+        uint32_t i0 = inner + v, i1 = i0 + 1;
+        out.indices.insert(out.indices.end(), {o0, o1, i1, o0, i1, i0});
+    }
+    for (uint32_t v = 0; v + 1 < R; v++)
+        out.indices.insert(out.indices.end(), {centre, inner + v, inner + v + 1});
+}
@@ -0,0 +1,501 @@
+#include "loaders/BinaryMeshLoader.h"
+#include "core/Trace.h"
+#include "loaders/MappedFile.h"
+#include "loaders/MeshletWriter.h"
+#include "json.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little,
+              "GLB, binary_little_endian PLY and GMLT are read by copying memory as-is");
+
+namespace {
+
+std::string lowerExtension(const std::string& filepath) {
+    std::string ext = std::filesystem::path(filepath).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+// ---------------------------------------------------------------------------
+// GLB
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t kGlbMagic = 0x46546C67;  // "glTF"
+constexpr uint32_t kChunkJson = 0x4E4F534A;
+constexpr uint32_t kChunkBin  = 0x004E4942;
+
+constexpr int kComponentUByte  = 5121;
+constexpr int kComponentUShort = 5123;
+constexpr int kComponentUInt   = 5125;
+constexpr int kComponentFloat  = 5126;
+
+struct GlbView {
+    const nlohmann::json& json;
+    const uint8_t* bin;
+    size_t binSize;
+    std::string path;
+};
+
+// Resolve an accessor to (data, count, stride) after validating it
+const uint8_t* accessorData(const GlbView& glb, int accessorIndex,
+                            int expectedComponent, int components,
+                            size_t& count, size_t& stride) {
+    const auto& accessor = glb.json.at("accessors").at(accessorIndex);
+    if (accessor.contains("sparse") || !accessor.contains("bufferView")) {
+        throw std::runtime_error("Unsupported sparse or view-less accessor in " + glb.path);
+    }
+    int componentType = accessor.at("componentType").get<int>();
+    if (expectedComponent >= 0 && componentType != expectedComponent) {
+        throw std::runtime_error("Unsupported accessor component type in " + glb.path);
+    }
+    const auto& view = glb.json.at("bufferViews").at(accessor.at("bufferView").get<int>());
+    if (view.value("buffer", 0) != 0) {
+        throw std::runtime_error("Only the GLB BIN buffer is supported: " + glb.path);
+    }
+
+    size_t componentSize = componentType == kComponentUByte ? 1
+                         : componentType == kComponentUShort ? 2 : 4;
+    count = accessor.at("count").get<size_t>();
+    stride = view.value("byteStride", size_t(0));
+    if (stride == 0) stride = componentSize * components;
+
+    size_t offset = view.value("byteOffset", size_t(0)) + accessor.value("byteOffset", size_t(0));
+    size_t viewEnd = view.value("byteOffset", size_t(0)) + view.at("byteLength").get<size_t>();
+    if (count > 0 && (viewEnd > glb.binSize ||
+                      offset + (count - 1) * stride + componentSize * components > viewEnd)) {
+        throw std::runtime_error("Accessor out of range in " + glb.path);
+    }
+    return glb.bin + offset;
+}
+
+template <typename Vec>
+void appendAttribute(const GlbView& glb, int accessorIndex, std::vector<Vec>& out) {
+    size_t count, stride;
+    const uint8_t* src = accessorData(glb, accessorIndex, kComponentFloat,
+                                      static_cast<int>(sizeof(Vec) / sizeof(float)), count, stride);
+    size_t first = out.size();
+    out.resize(first + count);
+    if (stride == sizeof(Vec)) {
+        std::memcpy(&out[first], src, count * sizeof(Vec));
+    } else {
+        for (size_t i = 0; i < count; i++) std::memcpy(&out[first + i], src + i * stride, sizeof(Vec));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// PLY
+// ---------------------------------------------------------------------------
+
+enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+PlyType parsePlyType(const std::string& name) {
+    if (name == "char" || name == "int8") return PlyType::Int8;
+    if (name == "uchar" || name == "uint8") return PlyType::UInt8;
+    if (name == "short" || name == "int16") return PlyType::Int16;
+    if (name == "ushort" || name == "uint16") return PlyType::UInt16;
+    if (name == "int" || name == "int32") return PlyType::Int32;
+    if (name == "uint" || name == "uint32") return PlyType::UInt32;
+    if (name == "float" || name == "float32") return PlyType::Float32;
+    if (name == "double" || name == "float64") return PlyType::Float64;
+    throw std::runtime_error("Unknown PLY property type: " + name);
+}
+
+size_t plyTypeSize(PlyType type) {
+    switch (type) {
+        case PlyType::Int8: case PlyType::UInt8: return 1;
+        case PlyType::Int16: case PlyType::UInt16: return 2;
+        case PlyType::Float64: return 8;
+        default: return 4;
+    }
+}
+
+double readPly(PlyType type, const uint8_t* p) {
+    switch (type) {
+        case PlyType::Int8:    { int8_t v;   std::memcpy(&v, p, 1); return v; }
+        case PlyType::UInt8:   return *p;
+        case PlyType::Int16:   { int16_t v;  std::memcpy(&v, p, 2); return v; }
+        case PlyType::UInt16:  { uint16_t v; std::memcpy(&v, p, 2); return v; }
+        case PlyType::Int32:   { int32_t v;  std::memcpy(&v, p, 4); return v; }
+        case PlyType::UInt32:  { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        case PlyType::Float32: { float v;    std::memcpy(&v, p, 4); return v; }
+        case PlyType::Float64: { double v;   std::memcpy(&v, p, 8); return v; }
+    }
+    return 0.0;
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::Float32;
+    bool isList = false;
+    PlyType countType = PlyType::UInt8;
+};
+
+struct PlyElement {
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> properties;
+
+    bool hasList() const {
+        return std::any_of(properties.begin(), properties.end(),
+                           [](const PlyProperty& p) { return p.isList; });
+    }
+    size_t fixedSize() const {
+        size_t size = 0;
+        for (const auto& p : properties) size += plyTypeSize(p.type);
+        return size;
+    }
+    int find(std::initializer_list<const char*> names) const {
+        for (size_t i = 0; i < properties.size(); i++)
+            for (const char* n : names)
+                if (properties[i].name == n) return static_cast<int>(i);
+        return -1;
+    }
+};
+
+} // namespace
+
+bool BinaryMeshLoader::canLoad(const std::string& filepath) {
+    std::string ext = lowerExtension(filepath);
+    return ext == ".glb" || ext == ".ply" || ext == ".gmlt";
+}
+
+TriangleMesh BinaryMeshLoader::load(const std::string& filepath) {
+    TRACE_ZONE("BinaryMeshLoader::load");
+    std::string ext = lowerExtension(filepath);
+    if (ext == ".glb") return loadGlb(filepath);
+    if (ext == ".ply") return loadPly(filepath);
+    if (ext == ".gmlt") return loadGmlt(filepath);
+    throw std::runtime_error("Unsupported binary mesh format: " + filepath);
+}
+
+TriangleMesh BinaryMeshLoader::loadGlb(const std::string& filepath) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    MappedFile file;
+    file.open(filepath);
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+
+    uint32_t header[3];
+    if (size < 20) throw std::runtime_error("Truncated GLB: " + filepath);
+    std::memcpy(header, data, sizeof(header));
+    if (header[0] != kGlbMagic || header[1] != 2) {
+        throw std::runtime_error("Not a glTF 2.0 binary: " + filepath);
+    }
+
+    // JSON chunk, then an optional BIN chunk
+    uint32_t chunk[2];
+    std::memcpy(chunk, data + 12, sizeof(chunk));
+    if (chunk[1] != kChunkJson || 20 + size_t(chunk[0]) > size) {
+        throw std::runtime_error("GLB missing JSON chunk: " + filepath);
+    }
+    nlohmann::json json = nlohmann::json::parse(data + 20, data + 20 + chunk[0]);
+
+    const uint8_t* bin = nullptr;
+    size_t binSize = 0;
+    size_t binHeader = 20 + ((size_t(chunk[0]) + 3) & ~size_t(3));
+    if (binHeader + 8 <= size) {
+        std::memcpy(chunk, data + binHeader, sizeof(chunk));
+        if (chunk[1] == kChunkBin && binHeader + 8 + chunk[0] <= size) {
+            bin = data + binHeader + 8;
+            binSize = chunk[0];
+        }
+    }
+    GlbView glb{ json, bin, binSize, filepath };
+
+    TriangleMesh mesh;
+    bool allNormals = true, allUvs = true;
+    for (const auto& gltfMesh : json.value("meshes", nlohmann::json::array())) {
+        for (const auto& prim : gltfMesh.value("primitives", nlohmann::json::array())) {
+            if (prim.value("mode", 4) != 4) continue;
+            const auto& attributes = prim.at("attributes");
+            if (!attributes.contains("POSITION")) continue;
+
+            uint32_t base = static_cast<uint32_t>(mesh.positions.size());
+            appendAttribute(glb, attributes.at("POSITION").get<int>(), mesh.positions);
+            size_t vertexCount = mesh.positions.size() - base;
+
+            // One entry per POSITION, or the attribute is dropped for the
+            // whole mesh as if a primitive lacked it
+            auto matchesPositions = [&](const char* name) {
+                if (!attributes.contains(name)) return false;
+                const auto& accessor = json.at("accessors").at(attributes.at(name).get<int>());
+                size_t count = accessor.at("count").get<size_t>();
+                if (count == vertexCount) return true;
+                std::cerr << "  Warning: GLB " << name << " has " << count << " entries for "
+                          << vertexCount << " positions, dropped: " << filepath << std::endl;
+                return false;
+            };
+            allNormals = allNormals && matchesPositions("NORMAL");
+            allUvs = allUvs && matchesPositions("TEXCOORD_0");
+            if (allNormals) appendAttribute(glb, attributes.at("NORMAL").get<int>(), mesh.normals);
+            if (allUvs) appendAttribute(glb, attributes.at("TEXCOORD_0").get<int>(), mesh.uvs);
+
+            size_t first = mesh.indices.size();
+            if (prim.contains("indices")) {
+                size_t count, stride;
+                const uint8_t* src = accessorData(glb, prim.at("indices").get<int>(), -1, 1, count, stride);
+                int type = json.at("accessors").at(prim.at("indices").get<int>()).at("componentType").get<int>();
+                mesh.indices.resize(first + count);
+                uint32_t* dst = &mesh.indices[first];
+                if (type == kComponentUInt && stride == 4) {
+                    std::memcpy(dst, src, count * 4);
+                    for (size_t i = 0; i < count; i++) dst[i] += base;
+                } else {
+                    for (size_t i = 0; i < count; i++) {
+                        const uint8_t* p = src + i * stride;
+                        uint32_t v = 0;
+                        if (type == kComponentUByte) v = *p;
+                        else if (type == kComponentUShort) { uint16_t s; std::memcpy(&s, p, 2); v = s; }
+                        else std::memcpy(&v, p, 4);
+                        dst[i] = v + base;
+                    }
+                }
+            } else {
+                mesh.indices.resize(first + vertexCount);
+                for (size_t i = 0; i < vertexCount; i++)
+                    mesh.indices[first + i] = base + static_cast<uint32_t>(i);
+            }
+        }
+    }
+    if (!allNormals) mesh.normals.clear();
+    if (!allUvs) mesh.uvs.clear();
+    if (mesh.positions.empty()) throw std::runtime_error("GLB has no triangle primitives: " + filepath);
+    for (uint32_t idx : mesh.indices) {
+        if (idx >= mesh.positions.size()) throw std::runtime_error("GLB index out of range: " + filepath);
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    std::cout << "Loaded GLB: " << mesh.positions.size() << " vertices, "
+              << mesh.indices.size() / 3 << " triangles in " << ms << " ms" << std::endl;
+    return mesh;
+}
+
+TriangleMesh BinaryMeshLoader::loadPly(const std::string& filepath) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    MappedFile file;
+    file.open(filepath);
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+
+    // Header: ASCII lines up to "end_header"
+    const char* text = reinterpret_cast<const char*>(data);
+    static const char kEnd[] = "end_header";
+    const char* endPos = std::search(text, text + std::min(size, size_t(64 * 1024)),
+                                     kEnd, kEnd + sizeof(kEnd) - 1);
+    if (size < 4 || std::memcmp(text, "ply", 3) != 0 || endPos == text + std::min(size, size_t(64 * 1024))) {
+        throw std::runtime_error("Not a PLY file: " + filepath);
+    }
+    const char* bodyPos = static_cast<const char*>(std::memchr(endPos, '\n', size - (endPos - text)));
+    if (!bodyPos) throw std::runtime_error("Truncated PLY header: " + filepath);
+
+    std::istringstream header(std::string(text, endPos));
+    std::vector<PlyElement> elements;
+    std::string line;
+    bool binaryLE = false;
+    while (std::getline(header, line)) {
+        std::istringstream words(line);
+        std::string keyword;
+        words >> keyword;
+        if (keyword == "format") {
+            std::string format;
+            words >> format;
+            binaryLE = (format == "binary_little_endian");
+        } else if (keyword == "element") {
+            PlyElement element;
+            words >> element.name >> element.count;
+            elements.push_back(element);
+        } else if (keyword == "property" && !elements.empty()) {
+            PlyProperty prop;
+            std::string type;
+            words >> type;
+            if (type == "list") {
+                std::string countType, itemType;
+                words >> countType >> itemType;
+                prop.isList = true;
+                prop.countType = parsePlyType(countType);
+                prop.type = parsePlyType(itemType);
+            } else {
+                prop.type = parsePlyType(type);
+            }
+            words >> prop.name;
+            elements.back().properties.push_back(prop);
+        }
+    }
+    if (!binaryLE) {
+        throw std::runtime_error("Only binary_little_endian PLY is supported: " + filepath);
+    }
+
+    TriangleMesh mesh;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(bodyPos + 1);
+    const uint8_t* end = data + size;
+    auto need = [&](size_t bytes) {
+        if (static_cast<size_t>(end - p) < bytes) throw std::runtime_error("Truncated PLY body: " + filepath);
+    };
+
+    for (const PlyElement& element : elements) {
+        if (element.name == "vertex") {
+            if (element.hasList()) throw std::runtime_error("PLY vertex lists are not supported: " + filepath);
+            std::vector<size_t> offsets;
+            size_t stride = 0;
+            for (const auto& prop : element.properties) {
+                offsets.push_back(stride);
+                stride += plyTypeSize(prop.type);
+            }
+            int ix = element.find({"x"}), iy = element.find({"y"}), iz = element.find({"z"});
+            int inx = element.find({"nx"}), iny = element.find({"ny"}), inz = element.find({"nz"});
+            int iu = element.find({"s", "u", "texture_u"}), iv = element.find({"t", "v", "texture_v"});
+            if (ix < 0 || iy < 0 || iz < 0) throw std::runtime_error("PLY vertex lacks x/y/z: " + filepath);
+            bool hasNormals = inx >= 0 && iny >= 0 && inz >= 0;
+            bool hasUvs = iu >= 0 && iv >= 0;
+
+            need(element.count * stride);
+            mesh.positions.resize(element.count);
+            if (hasNormals) mesh.normals.resize(element.count);
+            if (hasUvs) mesh.uvs.resize(element.count);
+            auto get = [&](const uint8_t* record, int prop) {
+                const PlyProperty& pp = element.properties[prop];
+                if (pp.type == PlyType::Float32) {
+                    float v;
+                    std::memcpy(&v, record + offsets[prop], 4);
+                    return v;
+                }
+                return static_cast<float>(readPly(pp.type, record + offsets[prop]));
+            };
+            for (size_t i = 0; i < element.count; i++, p += stride) {
+                mesh.positions[i] = glm::vec3(get(p, ix), get(p, iy), get(p, iz));
+                if (hasNormals) mesh.normals[i] = glm::vec3(get(p, inx), get(p, iny), get(p, inz));
+                if (hasUvs) mesh.uvs[i] = glm::vec2(get(p, iu), get(p, iv));
+            }
+        } else if (element.name == "face") {
+            int listProp = element.find({"vertex_indices", "vertex_index"});
+            if (listProp < 0 || !element.properties[listProp].isList) {
+                throw std::runtime_error("PLY face lacks vertex_indices: " + filepath);
+            }
+            mesh.indices.reserve(mesh.indices.size() + element.count * 3);
+            for (size_t f = 0; f < element.count; f++) {
+                for (size_t k = 0; k < element.properties.size(); k++) {
+                    const PlyProperty& prop = element.properties[k];
+                    if (!prop.isList) {
+                        need(plyTypeSize(prop.type));
+                        p += plyTypeSize(prop.type);
+                        continue;
+                    }
+                    need(plyTypeSize(prop.countType));
+                    size_t n = static_cast<size_t>(readPly(prop.countType, p));
+                    p += plyTypeSize(prop.countType);
+                    size_t itemSize = plyTypeSize(prop.type);
+                    need(n * itemSize);
+                    if (static_cast<int>(k) == listProp && n >= 3) {
+                        auto index = [&](size_t c) {
+                            if (prop.type == PlyType::UInt32 || prop.type == PlyType::Int32) {
+                                uint32_t v;
+                                std::memcpy(&v, p + c * 4, 4);
+                                return v;
+                            }
+                            return static_cast<uint32_t>(readPly(prop.type, p + c * itemSize));
+                        };
+                        uint32_t first = index(0);
+                        for (size_t c = 1; c + 1 < n; c++) {
+                            mesh.indices.push_back(first);
+                            mesh.indices.push_back(index(c));
+                            mesh.indices.push_back(index(c + 1));
+                        }
+                    }
+                    p += n * itemSize;
+                }
+            }
+        } else {
+            if (element.hasList()) throw std::runtime_error("Unsupported PLY element with lists: " + element.name);
+            need(element.count * element.fixedSize());
+            p += element.count * element.fixedSize();
+        }
+    }
+
+    for (uint32_t idx : mesh.indices) {
+        if (idx >= mesh.positions.size()) throw std::runtime_error("PLY face index out of range: " + filepath);
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    std::cout << "Loaded PLY: " << mesh.positions.size() << " vertices, "
+              << mesh.indices.size() / 3 << " triangles in " << ms << " ms" << std::endl;
+    return mesh;
+}
+
+TriangleMesh BinaryMeshLoader::loadGmlt(const std::string& filepath) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    MappedFile file;
+    file.open(filepath);
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+
+    MeshletWriter::FileHeader header;
+    if (size < sizeof(header)) throw std::runtime_error("Truncated meshlet file: " + filepath);
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != MeshletWriter::MAGIC || header.version != MeshletWriter::VERSION) {
+        throw std::runtime_error("Not a meshlet file: " + filepath);
+    }
+    auto inRange = [&](uint64_t offset, uint64_t count, uint64_t stride) {
+        return offset <= size && count <= (size - offset) / stride;
+    };
+    if (!inRange(header.vertexOffset, header.vertexCount, sizeof(MeshletWriter::Vertex)) ||
+        !inRange(header.dataOffset, header.dataSize, 1) || header.dataSize % 4 != 0 ||
+        !inRange(header.meshletOffset, header.meshletCount, sizeof(MeshletWriter::Meshlet))) {
+        throw std::runtime_error("Meshlet file sections out of range: " + filepath);
+    }
+
+    TriangleMesh mesh;
+    mesh.positions.resize(header.vertexCount);
+    mesh.normals.resize(header.vertexCount);
+    mesh.uvs.resize(header.vertexCount);
+    const uint8_t* src = data + header.vertexOffset;
+    for (size_t i = 0; i < header.vertexCount; i++, src += sizeof(MeshletWriter::Vertex)) {
+        MeshletWriter::Vertex v;
+        std::memcpy(&v, src, sizeof(v));
+        mesh.positions[i] = glm::vec3(v.position[0], v.position[1], v.position[2]);
+        mesh.normals[i] = MeshletWriter::decodeNormal(v.normal);
+        mesh.uvs[i] = glm::vec2(v.uv[0], v.uv[1]);
+    }
+
+    // Meshlet-local triangles back to global indices
+    const uint64_t dataWords = header.dataSize / 4;
+    const uint8_t* words = data + header.dataOffset;
+    const uint8_t* records = data + header.meshletOffset;
+    for (size_t m = 0; m < header.meshletCount; m++) {
+        MeshletWriter::Meshlet meshlet;
+        std::memcpy(&meshlet, records + m * sizeof(meshlet), sizeof(meshlet));
+        if (meshlet.vertexCount > header.maxVertices || meshlet.triangleCount > header.maxTriangles ||
+            uint64_t(meshlet.vertexOffset) + meshlet.vertexCount > dataWords ||
+            uint64_t(meshlet.triangleOffset) + (meshlet.triangleCount * 3 + 3) / 4 > dataWords) {
+            throw std::runtime_error("Meshlet out of range in " + filepath);
+        }
+        const uint8_t* local = words + size_t(meshlet.triangleOffset) * 4;
+        for (uint32_t k = 0; k < meshlet.triangleCount * 3; k++) {
+            if (local[k] >= meshlet.vertexCount) {
+                throw std::runtime_error("Meshlet local index out of range: " + filepath);
+            }
+            uint32_t idx;
+            std::memcpy(&idx, words + (size_t(meshlet.vertexOffset) + local[k]) * 4, 4);
+            if (idx >= header.vertexCount) throw std::runtime_error("Meshlet vertex out of range: " + filepath);
+            mesh.indices.push_back(idx);
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    std::cout << "Loaded GMLT: " << mesh.positions.size() << " vertices, "
+              << mesh.indices.size() / 3 << " triangles (" << header.meshletCount
+              << " meshlets) in " << ms << " ms" << std::endl;
+    return mesh;
+}
@@ -0,0 +1,194 @@
+#include "loaders/GlbWriter.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little,
+              "GLB is little-endian; the writer copies memory as-is");
+
+namespace {
+
+constexpr uint32_t kGlbMagic     = 0x46546C67;  // "glTF"
+constexpr uint32_t kGlbVersion   = 2;
+constexpr uint32_t kChunkJson    = 0x4E4F534A;  // "JSON"
+constexpr uint32_t kChunkBin     = 0x004E4942;  // "BIN\0"
+constexpr uint32_t kJsonReserve  = 256;         // room for the final min/max text
+
+struct GlbHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t length;
+};
+
+struct GlbChunkHeader {
+    uint32_t length;
+    uint32_t type;
+};
+
+// BIN chunk layout: positions, normals, uvs, indices
+struct Sections {
+    uint64_t positions, normals, uvs, indices, end;
+};
+
+Sections sectionsFor(uint64_t vertices, uint64_t triangles) {
+    Sections s;
+    s.positions = 0;
+    s.normals = s.positions + vertices * sizeof(glm::vec3);
+    s.uvs = s.normals + vertices * sizeof(glm::vec3);
+    s.indices = s.uvs + vertices * sizeof(glm::vec2);
+    s.end = s.indices + triangles * 3 * sizeof(uint32_t);
+    return s;
+}
+
+} // namespace
+
+std::string GlbWriter::Stream::buildJson() const {
+    Sections s = sectionsFor(totalVertices, totalTriangles);
+    auto u = [](uint64_t v) { return std::to_string(v); };
+    auto f = [](float v) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.9g", v);
+        return std::string(buf);
+    };
+
+    std::string json;
+    json += "{\"asset\":{\"version\":\"2.0\",\"generator\":\"Gravel procedural mesh renderer\"},";
+    json += "\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],";
+    json += "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},"
+            "\"indices\":3,\"mode\":4}]}],";
+    json += "\"buffers\":[{\"byteLength\":" + u(s.end) + "}],";
+    json += "\"bufferViews\":["
+            "{\"buffer\":0,\"byteOffset\":" + u(s.positions) + ",\"byteLength\":" + u(s.normals - s.positions) + ",\"target\":34962},"
+            "{\"buffer\":0,\"byteOffset\":" + u(s.normals) + ",\"byteLength\":" + u(s.uvs - s.normals) + ",\"target\":34962},"
+            "{\"buffer\":0,\"byteOffset\":" + u(s.uvs) + ",\"byteLength\":" + u(s.indices - s.uvs) + ",\"target\":34962},"
+            "{\"buffer\":0,\"byteOffset\":" + u(s.indices) + ",\"byteLength\":" + u(s.end - s.indices) + ",\"target\":34963}],";
+    json += "\"accessors\":["
+            "{\"bufferView\":0,\"componentType\":5126,\"count\":" + u(totalVertices) + ",\"type\":\"VEC3\","
+            "\"min\":[" + f(boundsMin.x) + "," + f(boundsMin.y) + "," + f(boundsMin.z) + "],"
+            "\"max\":[" + f(boundsMax.x) + "," + f(boundsMax.y) + "," + f(boundsMax.z) + "]},"
+            "{\"bufferView\":1,\"componentType\":5126,\"count\":" + u(totalVertices) + ",\"type\":\"VEC3\"},"
+            "{\"bufferView\":2,\"componentType\":5126,\"count\":" + u(totalVertices) + ",\"type\":\"VEC2\"},"
+            "{\"bufferView\":3,\"componentType\":5125,\"count\":" + u(totalTriangles * 3) + ",\"type\":\"SCALAR\"}]}";
+    return json;
+}
+
+void GlbWriter::Stream::writeAt(uint64_t offset, const void* data, size_t size) {
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+void GlbWriter::Stream::open(const std::string& filepath,
+                             uint64_t numVertices, uint64_t numTriangles) {
+    if (numVertices > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("GLB export: too many vertices for uint32 indices");
+    }
+    totalVertices = numVertices;
+    totalTriangles = numTriangles;
+    vertexBase = 0;
+    triangleBase = 0;
+    boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+    writeSeconds = 0.0;
+
+    // Reserve the JSON chunk with worst-case room for the bounds text
+    std::string json = buildJson();
+    jsonChunkLength = (static_cast<uint32_t>(json.size()) + kJsonReserve + 3) & ~3u;
+    uint64_t binLength = sectionsFor(totalVertices, totalTriangles).end;
+    uint64_t fileLength = sizeof(GlbHeader) + sizeof(GlbChunkHeader) + jsonChunkLength
+                        + sizeof(GlbChunkHeader) + binLength;
+    if (fileLength > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("GLB export: output exceeds the 4 GB GLB limit, use PLY");
+    }
+    binStart = fileLength - binLength;
+
+    file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + filepath);
+    }
+    path = filepath;
+
+    GlbHeader header{ kGlbMagic, kGlbVersion, static_cast<uint32_t>(fileLength) };
+    GlbChunkHeader jsonHeader{ jsonChunkLength, kChunkJson };
+    GlbChunkHeader binHeader{ static_cast<uint32_t>(binLength), kChunkBin };
+    writeAt(0, &header, sizeof(header));
+    writeAt(sizeof(GlbHeader), &jsonHeader, sizeof(jsonHeader));
+    writeAt(binStart - sizeof(GlbChunkHeader), &binHeader, sizeof(binHeader));
+}
+
+void GlbWriter::Stream::appendBatch(const glm::vec4* positions,
+                                    const glm::vec4* normals,
+                                    const glm::vec2* uvs,
+                                    const uint32_t* indices,
+                                    uint32_t numVertices,
+                                    uint32_t numTriangles) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (vertexBase + numVertices > totalVertices || triangleBase + numTriangles > totalTriangles) {
+        throw std::runtime_error("GLB export: batch exceeds the declared totals");
+    }
+    Sections s = sectionsFor(totalVertices, totalTriangles);
+
+    scratch.resize(std::max(size_t(numVertices) * sizeof(glm::vec3),
+                            size_t(numTriangles) * 3 * sizeof(uint32_t)));
+    glm::vec3* packed = reinterpret_cast<glm::vec3*>(scratch.data());
+
+    for (uint32_t i = 0; i < numVertices; i++) {
+        packed[i] = glm::vec3(positions[i]);
+        boundsMin = glm::min(boundsMin, packed[i]);
+        boundsMax = glm::max(boundsMax, packed[i]);
+    }
+    writeAt(binStart + s.positions + vertexBase * sizeof(glm::vec3), packed,
+            size_t(numVertices) * sizeof(glm::vec3));
+
+    for (uint32_t i = 0; i < numVertices; i++) packed[i] = glm::vec3(normals[i]);
+    writeAt(binStart + s.normals + vertexBase * sizeof(glm::vec3), packed,
+            size_t(numVertices) * sizeof(glm::vec3));
+
+    writeAt(binStart + s.uvs + vertexBase * sizeof(glm::vec2), uvs,
+            size_t(numVertices) * sizeof(glm::vec2));
+
+    uint32_t* rebased = reinterpret_cast<uint32_t*>(scratch.data());
+    const uint32_t base = static_cast<uint32_t>(vertexBase);
+    for (size_t i = 0; i < size_t(numTriangles) * 3; i++) rebased[i] = indices[i] + base;
+    writeAt(binStart + s.indices + triangleBase * 3 * sizeof(uint32_t), rebased,
+            size_t(numTriangles) * 3 * sizeof(uint32_t));
+
+    if (!file) {
+        throw std::runtime_error("Write failed: " + path);
+    }
+    vertexBase += numVertices;
+    triangleBase += numTriangles;
+    writeSeconds += std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void GlbWriter::Stream::close() {
+    if (!file.is_open()) return;
+
+    if (vertexBase == 0) {
+        boundsMin = glm::vec3(0.0f);
+        boundsMax = glm::vec3(0.0f);
+    }
+    std::string json = buildJson();
+    if (json.size() > jsonChunkLength) {
+        file.close();
+        throw std::runtime_error("GLB export: JSON outgrew its reserved chunk");
+    }
+    json.resize(jsonChunkLength, ' ');
+    writeAt(sizeof(GlbHeader) + sizeof(GlbChunkHeader), json.data(), json.size());
+
+    double mb = static_cast<double>(binStart + sectionsFor(totalVertices, totalTriangles).end)
+              / (1024.0 * 1024.0);
+    file.close();
+    scratch.clear();
+    scratch.shrink_to_fit();
+
+    std::cout << "Exported GLB: " << path
+              << " (" << vertexBase << " vertices, "
+              << triangleBase << " triangles, " << mb << " MB, "
+              << (writeSeconds > 0.0 ? mb / writeSeconds : 0.0) << " MB/s)" << std::endl;
+}
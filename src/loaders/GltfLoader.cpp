@@ -4,6 +4,10 @@
 #include <tiny_gltf.h>
 
 #include "loaders/GltfLoader.h"
+#include "loaders/MappedFile.h"
+#include "geometry/KdTree.h"
+#include "core/Parallel.h"
+#include "core/Trace.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
@@ -12,6 +16,11 @@
 #include <algorithm>
 #include <unordered_map>
 #include <set>
+#include <limits>
+#include <functional>
+#include <filesystem>
+#include <stdexcept>
+#include <cctype>
 
 // ============================================================================
 // Helper functions for node transforms
@@ -67,13 +76,44 @@ static bool dummyLoadImageData(tinygltf::Image*, const int, std::string*,
     return true;  // pretend success, skip actual image loading
 }
 
+size_t Skeleton::sizeBytes() const {
+    size_t bytes = MemoryTracker::capacityBytes(bones);
+    for (const Bone& bone : bones)
+        bytes += bone.name.capacity() + MemoryTracker::capacityBytes(bone.childrenIndices);
+    return bytes;
+}
+
+size_t Animation::sizeBytes() const {
+    size_t bytes = name.capacity() + MemoryTracker::capacityBytes(channels);
+    for (const AnimationChannel& channel : channels)
+        bytes += MemoryTracker::capacityBytes(channel.keyframes);
+    return bytes;
+}
+
 tinygltf::Model GltfLoader::loadModel(const std::string& filepath) {
+    TRACE_ZONE("GltfLoader::loadModel");
     tinygltf::TinyGLTF loader;
     tinygltf::Model model;
     std::string error, warning;
 
     loader.SetImageLoader(dummyLoadImageData, nullptr);
-    bool loaded = loader.LoadASCIIFromFile(&model, &error, &warning, filepath);
+
+    bool loaded;
+    std::string ext = std::filesystem::path(filepath).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (ext == ".glb") {
+        // Parse from the mapping; tinygltf still copies the BIN chunk into
+        // model.buffers, but the file itself is never read into a temp buffer
+        MappedFile file;
+        file.open(filepath);
+        std::string baseDir = std::filesystem::path(filepath).parent_path().string();
+        loaded = loader.LoadBinaryFromMemory(&model, &error, &warning,
+                                             file.data(), static_cast<unsigned int>(file.size()),
+                                             baseDir);
+    } else {
+        loaded = loader.LoadASCIIFromFile(&model, &error, &warning, filepath);
+    }
 
     if (!warning.empty()) {
         std::cerr << "glTF Warning: " << warning << std::endl;
@@ -88,7 +128,307 @@ tinygltf::Model GltfLoader::loadModel(const std::string& filepath) {
     return model;
 }
 
+// First element of an accessor, after checking that its count elements of
+// elementBytes, stride apart (0 = packed), lie inside its buffer view and
+// the view inside its buffer. Throws on a malformed file rather than
+// reading past the data.
+static const unsigned char* checkedAccessorData(const tinygltf::Model& model,
+                                                const tinygltf::Accessor& accessor,
+                                                size_t elementBytes, size_t stride = 0) {
+    if (accessor.bufferView < 0 || accessor.bufferView >= static_cast<int>(model.bufferViews.size()))
+        throw std::runtime_error("glTF accessor has no valid buffer view");
+    if (elementBytes == 0) throw std::runtime_error("glTF accessor has an unknown element type");
+    const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+    if (view.buffer < 0 || view.buffer >= static_cast<int>(model.buffers.size()))
+        throw std::runtime_error("glTF buffer view has no valid buffer");
+    const size_t bufferSize = model.buffers[view.buffer].data.size();
+    if (view.byteOffset > bufferSize || view.byteLength > bufferSize - view.byteOffset)
+        throw std::runtime_error("glTF buffer view out of range of its buffer");
+    if (stride == 0) stride = elementBytes;
+    if (accessor.count > 0) {
+        if (accessor.byteOffset > view.byteLength || elementBytes > view.byteLength - accessor.byteOffset
+            || (accessor.count - 1) > (view.byteLength - accessor.byteOffset - elementBytes) / stride)
+            throw std::runtime_error("glTF accessor out of range of its buffer view");
+    }
+    return model.buffers[view.buffer].data.data() + view.byteOffset + accessor.byteOffset;
+}
+
+// Packed size of one accessor element; 0 for an unknown type
+static size_t accessorElementBytes(const tinygltf::Accessor& accessor) {
+    int componentBytes = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+    int components = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+    return (componentBytes > 0 && components > 0) ? size_t(componentBytes) * components : 0;
+}
+
+// Read an accessor as floats (count * components), honouring byteStride and
+// converting integer / normalized integer component types
+static void readAccessorFloats(const tinygltf::Model& model, int accessorIndex,
+                               int components, std::vector<float>& out) {
+    const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+    out.assign(accessor.count * components, 0.0f);
+    if (accessor.bufferView < 0) return;
+
+    const tinygltf::BufferView& bufferView = model.bufferViews.at(accessor.bufferView);
+    int stride = accessor.ByteStride(bufferView);
+    int available = std::min(components, tinygltf::GetNumComponentsInType(accessor.type));
+    int componentBytes = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+    if (stride <= 0 || available <= 0 || componentBytes <= 0) return;
+    const unsigned char* base = checkedAccessorData(model, accessor, size_t(componentBytes) * available, stride);
+
+    for (size_t i = 0; i < accessor.count; ++i) {
+        const unsigned char* elem = base + i * stride;
+        for (int c = 0; c < available; ++c) {
+            float v = 0.0f;
+            switch (accessor.componentType) {
+                case TINYGLTF_COMPONENT_TYPE_FLOAT: {
+                    memcpy(&v, elem + c * sizeof(float), sizeof(float));
+                    break;
+                }
+                // Signed normalized (KHR_mesh_quantization normals, tangents):
+                // the most negative value clamps to -1 as the spec maps it
+                case TINYGLTF_COMPONENT_TYPE_BYTE: {
+                    int8_t u;
+                    memcpy(&u, elem + c, 1);
+                    v = accessor.normalized ? std::max(u / 127.0f, -1.0f) : static_cast<float>(u);
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_SHORT: {
+                    int16_t u;
+                    memcpy(&u, elem + c * sizeof(int16_t), sizeof(int16_t));
+                    v = accessor.normalized ? std::max(u / 32767.0f, -1.0f) : static_cast<float>(u);
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+                    uint8_t u = elem[c];
+                    v = accessor.normalized ? u / 255.0f : static_cast<float>(u);
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+                    uint16_t u;
+                    memcpy(&u, elem + c * sizeof(uint16_t), sizeof(uint16_t));
+                    v = accessor.normalized ? u / 65535.0f : static_cast<float>(u);
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
+                    uint32_t u;
+                    memcpy(&u, elem + c * sizeof(uint32_t), sizeof(uint32_t));
+                    v = static_cast<float>(u);
+                    break;
+                }
+                default: break;
+            }
+            out[i * components + c] = v;
+        }
+    }
+}
+
+// Read an index accessor (u8 / u16 / u32) as uint32
+static void readAccessorIndices(const tinygltf::Model& model, int accessorIndex,
+                                std::vector<uint32_t>& out) {
+    const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+    out.assign(accessor.count, 0u);
+    if (accessor.bufferView < 0) return;
+
+    const tinygltf::BufferView& bufferView = model.bufferViews.at(accessor.bufferView);
+    int stride = accessor.ByteStride(bufferView);
+    if (stride <= 0) return;
+    const unsigned char* base = checkedAccessorData(model, accessor, accessorElementBytes(accessor), stride);
+
+    for (size_t i = 0; i < accessor.count; ++i) {
+        const unsigned char* elem = base + i * stride;
+        if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+            out[i] = elem[0];
+        } else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
+            uint16_t u; memcpy(&u, elem, sizeof(u)); out[i] = u;
+        } else {
+            uint32_t u; memcpy(&u, elem, sizeof(u)); out[i] = u;
+        }
+    }
+}
+
+NGonMesh GltfLoader::loadMesh(const tinygltf::Model& model,
+                              JointData& jointIndices,
+                              JointData& jointWeights) {
+    TRACE_ZONE("GltfLoader::loadMesh");
+    NGonMesh mesh;
+    jointIndices.clear();
+    jointWeights.clear();
+    std::vector<bool> hasNormal;
+    std::vector<float> scratch;
+    std::vector<uint32_t> indices;
+    uint32_t faceOffset = 0;
+    uint32_t skippedPrimitives = 0;
+
+    auto appendPrimitive = [&](const tinygltf::Primitive& primitive, const glm::mat4& transform) {
+        if (primitive.mode != -1 && primitive.mode != TINYGLTF_MODE_TRIANGLES) {
+            skippedPrimitives++;
+            return;
+        }
+        auto attr = [&](const char* name) {
+            auto it = primitive.attributes.find(name);
+            return it == primitive.attributes.end() ? -1 : it->second;
+        };
+        int posAcc = attr("POSITION");
+        if (posAcc < 0) { skippedPrimitives++; return; }
+
+        uint32_t base = static_cast<uint32_t>(mesh.positions.size());
+        size_t count = model.accessors[posAcc].count;
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+        readAccessorFloats(model, posAcc, 3, scratch);
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 p(scratch[i * 3 + 0], scratch[i * 3 + 1], scratch[i * 3 + 2]);
+            mesh.positions.push_back(glm::vec3(transform * glm::vec4(p, 1.0f)));
+        }
+
+        // Other attributes need one entry per POSITION; one that differs is
+        // dropped for this primitive as if it were absent
+        auto matched = [&](const char* name) {
+            int acc = attr(name);
+            if (acc < 0 || model.accessors[acc].count == count) return acc;
+            std::cerr << "  Warning: glTF " << name << " has " << model.accessors[acc].count
+                      << " entries for " << count << " positions, dropped" << std::endl;
+            return -1;
+        };
+
+        int nrmAcc = matched("NORMAL");
+        if (nrmAcc >= 0) readAccessorFloats(model, nrmAcc, 3, scratch);
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 n(0.0f, 0.0f, 1.0f);
+            if (nrmAcc >= 0) {
+                n = normalMatrix * glm::vec3(scratch[i * 3 + 0], scratch[i * 3 + 1], scratch[i * 3 + 2]);
+                float len = glm::length(n);
+                n = (len > 1e-8f) ? n / len : glm::vec3(0.0f, 0.0f, 1.0f);
+            }
+            mesh.normals.push_back(n);
+            hasNormal.push_back(nrmAcc >= 0);
+        }
+
+        int uvAcc = matched("TEXCOORD_0");
+        if (uvAcc >= 0) readAccessorFloats(model, uvAcc, 2, scratch);
+        for (size_t i = 0; i < count; ++i) {
+            mesh.texCoords.push_back(uvAcc >= 0
+                ? glm::vec2(scratch[i * 2 + 0], scratch[i * 2 + 1]) : glm::vec2(0.0f));
+        }
+
+        int jointAcc = matched("JOINTS_0");
+        int weightAcc = matched("WEIGHTS_0");
+        bool skinned = jointAcc >= 0 && weightAcc >= 0;
+        if (skinned) readAccessorFloats(model, jointAcc, 4, scratch);
+        for (size_t i = 0; i < count; ++i) {
+            jointIndices.push_back(skinned ? glm::make_vec4(&scratch[i * 4]) : glm::vec4(0.0f));
+        }
+        if (skinned) readAccessorFloats(model, weightAcc, 4, scratch);
+        for (size_t i = 0; i < count; ++i) {
+            jointWeights.push_back(skinned ? glm::make_vec4(&scratch[i * 4]) : glm::vec4(0.0f));
+        }
+
+        if (primitive.indices >= 0) {
+            readAccessorIndices(model, primitive.indices, indices);
+        } else {
+            indices.resize(count);
+            for (size_t i = 0; i < count; ++i) indices[i] = static_cast<uint32_t>(i);
+        }
+
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            if (indices[t] >= count || indices[t + 1] >= count || indices[t + 2] >= count) continue;
+            NGonFace face;
+            face.vertexIndices = { base + indices[t], base + indices[t + 1], base + indices[t + 2] };
+            face.count = 3;
+            face.offset = faceOffset;
+            face.normal = glm::vec4(ObjLoader::computeFaceNormal(mesh.positions, face.vertexIndices), 0.0f);
+            face.center = glm::vec4(ObjLoader::computeFaceCentroid(mesh.positions, face.vertexIndices), 1.0f);
+            face.area   = ObjLoader::computeFaceArea(mesh.positions, face.vertexIndices);
+            for (uint32_t idx : face.vertexIndices) mesh.faceVertexIndices.push_back(idx);
+            faceOffset += 3;
+            mesh.faces.push_back(std::move(face));
+        }
+    };
+
+    // Walk the default scene so static meshes pick up their node transforms.
+    // Skinned meshes ignore the node transform (glTF spec: skinning defines it).
+    std::function<void(int, const glm::mat4&)> visit = [&](int nodeIndex, const glm::mat4& parent) {
+        const tinygltf::Node& node = model.nodes[nodeIndex];
+        glm::mat4 global = parent * getNodeTransform(node);
+        if (node.mesh >= 0) {
+            glm::mat4 meshTransform = (node.skin >= 0) ? glm::mat4(1.0f) : global;
+            for (const auto& primitive : model.meshes[node.mesh].primitives) {
+                appendPrimitive(primitive, meshTransform);
+            }
+        }
+        for (int child : node.children) visit(child, global);
+    };
+
+    if (!model.scenes.empty()) {
+        int sceneIndex = (model.defaultScene >= 0) ? model.defaultScene : 0;
+        for (int root : model.scenes[sceneIndex].nodes) visit(root, glm::mat4(1.0f));
+    } else {
+        for (const auto& gltfMesh : model.meshes) {
+            for (const auto& primitive : gltfMesh.primitives) {
+                appendPrimitive(primitive, glm::mat4(1.0f));
+            }
+        }
+    }
+
+    if (mesh.faces.empty()) {
+        throw std::runtime_error("glTF model has no triangle primitives");
+    }
+
+    // Area-weighted normals for primitives that did not provide NORMAL
+    if (std::find(hasNormal.begin(), hasNormal.end(), false) != hasNormal.end()) {
+        std::vector<glm::vec3> accum(mesh.positions.size(), glm::vec3(0.0f));
+        for (const auto& face : mesh.faces) {
+            glm::vec3 weighted = glm::vec3(face.normal) * face.area;
+            for (uint32_t idx : face.vertexIndices) accum[idx] += weighted;
+        }
+        for (size_t i = 0; i < accum.size(); ++i) {
+            if (hasNormal[i]) continue;
+            float len = glm::length(accum[i]);
+            if (len > 1e-8f) mesh.normals[i] = accum[i] / len;
+        }
+    }
+
+    // glTF splits vertices at UV / normal seams; weld exact positions to
+    // recover the original-vertex mapping (same role as ObjLoader's OBJ v index)
+    struct PosKey {
+        float x, y, z;
+        bool operator==(const PosKey& o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+    struct PosKeyHash {
+        size_t operator()(const PosKey& k) const {
+            uint32_t h[3];
+            memcpy(h, &k, sizeof(h));
+            return (size_t(h[0]) * 73856093u) ^ (size_t(h[1]) * 19349663u) ^ (size_t(h[2]) * 83492791u);
+        }
+    };
+    std::unordered_map<PosKey, uint32_t, PosKeyHash> welded;
+    welded.reserve(mesh.positions.size());
+    mesh.originalVertexIndices.resize(mesh.positions.size());
+    for (size_t i = 0; i < mesh.positions.size(); ++i) {
+        const glm::vec3& p = mesh.positions[i];
+        // + 0.0f folds -0 into +0 so equal keys hash equally
+        auto [it, inserted] = welded.try_emplace(PosKey{ p.x + 0.0f, p.y + 0.0f, p.z + 0.0f },
+                                                 static_cast<uint32_t>(welded.size()));
+        mesh.originalVertexIndices[i] = it->second;
+    }
+    mesh.originalVertexCount = static_cast<uint32_t>(welded.size());
+
+    mesh.colors.resize(mesh.positions.size(), glm::vec3(1.0f));
+    mesh.nbVertices = static_cast<uint32_t>(mesh.positions.size());
+    mesh.nbFaces = static_cast<uint32_t>(mesh.faces.size());
+
+    std::cout << "Loaded glTF mesh: " << mesh.nbVertices << " vertices ("
+              << mesh.originalVertexCount << " unique positions), "
+              << mesh.nbFaces << " triangles" << std::endl;
+    if (skippedPrimitives > 0) {
+        std::cout << "  Skipped " << skippedPrimitives
+                  << " non-triangle or position-less primitives" << std::endl;
+    }
+    return mesh;
+}
+
 void GltfLoader::extractSkeleton(const tinygltf::Model& model, Skeleton& skeleton) {
+    TRACE_ZONE("GltfLoader::extractSkeleton");
     if (model.skins.empty()) {
         std::cerr << "No skins found in the glTF model." << std::endl;
         return;
@@ -100,9 +440,7 @@ void GltfLoader::extractSkeleton(const tinygltf::Model& model, Skeleton& skeleto
     std::vector<glm::mat4> inverseBindMatrices;
     if (skin.inverseBindMatrices >= 0) {
         const tinygltf::Accessor& accessor = model.accessors[skin.inverseBindMatrices];
-        const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
-        const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
-        const unsigned char* dataPtr = &buffer.data[accessor.byteOffset + bufferView.byteOffset];
+        const unsigned char* dataPtr = checkedAccessorData(model, accessor, sizeof(glm::mat4));
 
         size_t numMatrices = accessor.count;
         inverseBindMatrices.resize(numMatrices);
@@ -243,6 +581,7 @@ void GltfLoader::computeBoneMatrices(const Skeleton& skeleton,
 void GltfLoader::extractAnimations(const tinygltf::Model& model,
                                     const Skeleton& skeleton,
                                     std::vector<Animation>& animations) {
+    TRACE_ZONE("GltfLoader::extractAnimations");
     for (const auto& gltfAnimation : model.animations) {
         Animation animation;
         animation.name = gltfAnimation.name;
@@ -257,9 +596,7 @@ void GltfLoader::extractAnimations(const tinygltf::Model& model,
             std::vector<float> times;
             {
                 const tinygltf::Accessor& accessor = model.accessors[sampler.input];
-                const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
-                const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
-                const unsigned char* dataPtr = &buffer.data[accessor.byteOffset + bufferView.byteOffset];
+                const unsigned char* dataPtr = checkedAccessorData(model, accessor, sizeof(float));
                 times.resize(accessor.count);
                 memcpy(times.data(), dataPtr, sizeof(float) * accessor.count);
             }
@@ -268,10 +605,9 @@ void GltfLoader::extractAnimations(const tinygltf::Model& model,
             std::vector<float> values;
             {
                 const tinygltf::Accessor& accessor = model.accessors[sampler.output];
-                const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
-                const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
-                const unsigned char* dataPtr = &buffer.data[accessor.byteOffset + bufferView.byteOffset];
-                size_t count = accessor.count * tinygltf::GetNumComponentsInType(accessor.type);
+                int components = std::max(0, tinygltf::GetNumComponentsInType(accessor.type));
+                const unsigned char* dataPtr = checkedAccessorData(model, accessor, sizeof(float) * components);
+                size_t count = accessor.count * components;
                 values.resize(count);
                 memcpy(values.data(), dataPtr, sizeof(float) * count);
             }
@@ -390,6 +726,121 @@ void GltfLoader::updateSkeleton(const Animation& animation, float time,
     }
 }
 
+size_t GltfLoader::bakedSizeBytes(const Animation& animation, const Skeleton& skeleton,
+                                  float sampleRate) {
+    // One frame per 1/sampleRate, plus a closing frame at t = duration so
+    // the last interval blends into the end pose before wrapping.
+    uint32_t frameCount = (animation.duration > 0.0f && sampleRate > 0.0f)
+        ? static_cast<uint32_t>(std::ceil(animation.duration * sampleRate)) + 1
+        : 1;
+    return size_t(frameCount) * skeleton.bones.size() * sizeof(glm::mat4);
+}
+
+bool GltfLoader::bakeAnimation(const Animation& animation, const Skeleton& skeleton,
+                                float sampleRate, size_t maxBytes,
+                                BakedAnimation& baked) {
+    TRACE_ZONE("GltfLoader::bakeAnimation");
+    baked = BakedAnimation{};
+    if (skeleton.bones.empty() || sampleRate <= 0.0f) return false;
+
+    uint32_t boneCount = static_cast<uint32_t>(skeleton.bones.size());
+    size_t bytes = bakedSizeBytes(animation, skeleton, sampleRate);
+    uint32_t frameCount = static_cast<uint32_t>(bytes / (size_t(boneCount) * sizeof(glm::mat4)));
+    if (bytes > maxBytes) {
+        std::cout << "  Bake skipped: \"" << animation.name << "\" needs "
+                  << (bytes / 1024) << " KB (budget " << (maxBytes / 1024)
+                  << " KB), using live evaluation" << std::endl;
+        return false;
+    }
+
+    // Evaluate on a scratch copy so the caller's pose is left untouched
+    Skeleton pose = skeleton;
+    std::vector<glm::mat4> boneMatrices;
+    baked.frames.resize(size_t(frameCount) * boneCount);
+    for (uint32_t f = 0; f < frameCount; ++f) {
+        float t = std::min(static_cast<float>(f) / sampleRate, animation.duration);
+        updateSkeleton(animation, t, pose);
+        computeBoneMatrices(pose, boneMatrices);
+        std::copy(boneMatrices.begin(), boneMatrices.end(),
+                  baked.frames.begin() + size_t(f) * boneCount);
+    }
+
+    baked.sampleRate = sampleRate;
+    baked.duration = animation.duration;
+    baked.frameCount = frameCount;
+    baked.boneCount = boneCount;
+    return true;
+}
+
+void GltfLoader::bakeAnimations(const std::vector<Animation>& animations, const Skeleton& skeleton,
+                                float sampleRate, size_t budgetBytes,
+                                std::vector<BakedAnimation>& baked) {
+    TRACE_ZONE("GltfLoader::bakeAnimations");
+    baked.clear();
+    baked.resize(animations.size());
+    if (skeleton.bones.empty()) return;
+
+    // Budget in clip order first, then bake the clips that fit in parallel
+    size_t used = 0;
+    std::vector<size_t> toBake;
+    for (size_t i = 0; i < animations.size(); i++) {
+        size_t bytes = bakedSizeBytes(animations[i], skeleton, sampleRate);
+        if (sampleRate > 0.0f && bytes <= budgetBytes - used) {
+            used += bytes;
+            toBake.push_back(i);
+        } else {
+            // Logs why and leaves the clip to live evaluation
+            bakeAnimation(animations[i], skeleton, sampleRate, budgetBytes - used, baked[i]);
+        }
+    }
+    parallelFor(toBake.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            size_t i = toBake[k];
+            bakeAnimation(animations[i], skeleton, sampleRate, budgetBytes, baked[i]);
+        }
+    });
+    for (size_t i : toBake) {
+        std::cout << "  Baked \"" << animations[i].name << "\": "
+                  << baked[i].frameCount << " frames, "
+                  << (baked[i].sizeBytes() / 1024) << " KB" << std::endl;
+    }
+    std::cout << "  Animation bake: " << (used / 1024) << " KB of "
+              << (budgetBytes / (1024 * 1024)) << " MB budget" << std::endl;
+}
+
+void GltfLoader::sampleBakedAnimation(const BakedAnimation& baked, float time,
+                                       bool interpolate,
+                                       std::vector<glm::mat4>& boneMatrices) {
+    boneMatrices.resize(baked.boneCount);
+    if (!baked.valid()) return;
+
+    float t = (baked.duration > 0.0f) ? std::fmod(time, baked.duration) : 0.0f;
+    if (t < 0.0f) t += baked.duration;
+
+    // Frame f was sampled at min(f / sampleRate, duration), so the closing
+    // interval is shorter when duration is not a whole number of frames
+    uint32_t f0 = std::min(static_cast<uint32_t>(t * baked.sampleRate), baked.frameCount - 1);
+    uint32_t f1 = std::min(f0 + 1, baked.frameCount - 1);
+    float t0 = std::min(static_cast<float>(f0) / baked.sampleRate, baked.duration);
+    float t1 = std::min(static_cast<float>(f1) / baked.sampleRate, baked.duration);
+    float alpha = (t1 > t0) ? std::clamp((t - t0) / (t1 - t0), 0.0f, 1.0f) : 0.0f;
+
+    const glm::mat4* m0 = &baked.frames[size_t(f0) * baked.boneCount];
+    const glm::mat4* m1 = &baked.frames[size_t(f1) * baked.boneCount];
+
+    if (!interpolate || f0 == f1) {
+        const glm::mat4* src = (interpolate || alpha < 0.5f) ? m0 : m1;
+        std::copy(src, src + baked.boneCount, boneMatrices.begin());
+        return;
+    }
+
+    // Component-wise blend of neighbouring skinning matrices; at bake rates
+    // the poses are close enough that this matches slerp within tolerance
+    for (uint32_t b = 0; b < baked.boneCount; ++b) {
+        boneMatrices[b] = m0[b] + (m1[b] - m0[b]) * alpha;
+    }
+}
+
 // ============================================================================
 // Spatial matching helpers (shared by matchBoneDataToObjMesh & matchUVsToObjMesh)
 // ============================================================================
@@ -427,255 +878,143 @@ static void computeAlignment(const std::vector<glm::vec3>& objPositions,
     outOffset = objCenter - outScale * gltfCenter;
 }
 
-// For each OBJ vertex, find the index of the closest aligned glTF vertex (or SIZE_MAX).
-// alignedGltfPos must already be transformed to OBJ coordinate space.
-static std::vector<size_t> spatialMatch(
-    const std::vector<glm::vec3>& objPositions,
-    const std::vector<glm::vec3>& alignedGltfPos) {
-
-    size_t objVertCount = objPositions.size();
-    size_t gltfVertCount = alignedGltfPos.size();
-
-    // Compute OBJ bounding box for epsilon scaling
-    glm::vec3 objMin(std::numeric_limits<float>::max());
-    glm::vec3 objMax(std::numeric_limits<float>::lowest());
-    for (const auto& p : objPositions) {
-        objMin = glm::min(objMin, p);
-        objMax = glm::max(objMax, p);
-    }
-    glm::vec3 objExtent = objMax - objMin;
-    int bestAxis = 0;
-    for (int a = 1; a < 3; ++a) {
-        if (objExtent[a] > objExtent[bestAxis]) bestAxis = a;
-    }
-
-    // Adaptive epsilon from sampled nearest-neighbor distances
-    float epsilon = 1e-5f;
-    {
-        size_t sampleCount = std::min(size_t(200), gltfVertCount);
-        size_t step = std::max(size_t(1), gltfVertCount / sampleCount);
-        std::vector<float> nnDists;
-        nnDists.reserve(sampleCount);
-
-        for (size_t s = 0; s < gltfVertCount && nnDists.size() < sampleCount; s += step) {
-            float bestDist = std::numeric_limits<float>::max();
-            for (size_t j = 0; j < objVertCount; ++j) {
-                float d = glm::distance(alignedGltfPos[s], objPositions[j]);
-                if (d < bestDist) bestDist = d;
-            }
-            float maxReasonable = objExtent[bestAxis] * 0.1f;
-            if (bestDist < maxReasonable) {
-                nnDists.push_back(bestDist);
-            }
-        }
-
-        if (!nnDists.empty()) {
-            std::sort(nnDists.begin(), nnDists.end());
-            float median = nnDists[nnDists.size() / 2];
-            epsilon = std::clamp(median * 3.0f, 1e-5f, objExtent[bestAxis] * 0.02f);
-        }
-    }
-
-    float cellSize = std::max(epsilon * 3.0f, 1e-4f);
-
-    // Spatial hash
-    struct CellKey {
-        int x, y, z;
-        bool operator==(const CellKey& o) const { return x == o.x && y == o.y && z == o.z; }
-    };
-    struct CellHash {
-        size_t operator()(const CellKey& k) const {
-            return size_t(k.x * 73856093) ^ size_t(k.y * 19349663) ^ size_t(k.z * 83492791);
-        }
-    };
-
-    auto toCell = [cellSize](const glm::vec3& p) -> CellKey {
-        return { static_cast<int>(std::floor(p.x / cellSize)),
-                 static_cast<int>(std::floor(p.y / cellSize)),
-                 static_cast<int>(std::floor(p.z / cellSize)) };
-    };
-
-    // Build spatial hash from OBJ positions
-    std::unordered_map<CellKey, std::vector<size_t>, CellHash> grid;
-    for (size_t j = 0; j < objVertCount; ++j) {
-        grid[toCell(objPositions[j])].push_back(j);
-    }
-
-    // For each OBJ vertex, track the closest glTF match
-    std::vector<size_t> objToGltf(objVertCount, SIZE_MAX);
-    std::vector<float> objBestDist(objVertCount, std::numeric_limits<float>::max());
-
-    // Match each glTF vertex to closest OBJ vertex within epsilon
-    for (size_t gi = 0; gi < gltfVertCount; ++gi) {
-        CellKey cell = toCell(alignedGltfPos[gi]);
-
-        float bestDist = epsilon;
-        size_t bestIdx = SIZE_MAX;
-
-        for (int dx = -1; dx <= 1; ++dx) {
-            for (int dy = -1; dy <= 1; ++dy) {
-                for (int dz = -1; dz <= 1; ++dz) {
-                    CellKey neighbor = { cell.x + dx, cell.y + dy, cell.z + dz };
-                    auto it = grid.find(neighbor);
-                    if (it == grid.end()) continue;
-
-                    for (size_t j : it->second) {
-                        float d = glm::distance(alignedGltfPos[gi], objPositions[j]);
-                        if (d < bestDist) {
-                            bestDist = d;
-                            bestIdx = j;
-                        }
-                    }
-                }
-            }
-        }
-
-        if (bestIdx != SIZE_MAX && bestDist < objBestDist[bestIdx]) {
-            objBestDist[bestIdx] = bestDist;
-            objToGltf[bestIdx] = gi;
-        }
-    }
-
-    // Fallback: brute-force for unmatched OBJ vertices
-    uint32_t matchedCount = 0;
-    for (size_t j = 0; j < objVertCount; ++j) {
-        if (objToGltf[j] != SIZE_MAX) { matchedCount++; continue; }
-
-        float bestDist = std::numeric_limits<float>::max();
-        size_t bestGi = SIZE_MAX;
-        for (size_t gi = 0; gi < gltfVertCount; ++gi) {
-            float d = glm::distance(objPositions[j], alignedGltfPos[gi]);
-            if (d < bestDist) { bestDist = d; bestGi = gi; }
-        }
-        if (bestGi != SIZE_MAX) {
-            objToGltf[j] = bestGi;
-        }
-    }
-
-    return objToGltf;
+// Raw pointer to an accessor's first element (tightly packed data assumed)
+static const unsigned char* accessorData(const tinygltf::Model& model, int accessorIndex) {
+    const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+    return checkedAccessorData(model, accessor, accessorElementBytes(accessor));
 }
 
-void GltfLoader::matchBoneDataToObjMesh(const tinygltf::Model& model,
-                                         const std::vector<glm::vec3>& objPositions,
-                                         Skeleton& skeleton,
-                                         std::vector<glm::vec4>& jointIndices,
-                                         std::vector<glm::vec4>& jointWeights) {
-    size_t objVertCount = objPositions.size();
-    jointIndices.assign(objVertCount, glm::vec4(0.0f));
-    jointWeights.assign(objVertCount, glm::vec4(0.0f));
+void GltfLoader::buildVertexMatch(const tinygltf::Model& model,
+                                   const std::vector<glm::vec3>& objPositions,
+                                   Skeleton& skeleton,
+                                   GltfVertexMatch& match) {
+    TRACE_ZONE("GltfLoader::buildVertexMatch");
+    match = GltfVertexMatch{};
 
-    // Collect all glTF vertex positions and per-primitive bone data pointers
-    struct PrimitiveData {
-        const uint8_t* jointData;
-        const float* weightData;
-        int jointComponentType;
-    };
-    std::vector<PrimitiveData> primitives;
+    // Flatten every primitive's POSITION into one glTF vertex array
     std::vector<glm::vec3> gltfPositions;
-    std::vector<size_t> gltfPrimIdx;   // per-vertex: which primitive
-    std::vector<size_t> gltfVertIdx;   // per-vertex: index within primitive
-
-    for (const auto& mesh : model.meshes) {
-        for (const auto& primitive : mesh.primitives) {
-            const auto& attributes = primitive.attributes;
-            auto jointsIt = attributes.find("JOINTS_0");
-            auto weightsIt = attributes.find("WEIGHTS_0");
-            auto posIt = attributes.find("POSITION");
-
-            if (jointsIt == attributes.end() || weightsIt == attributes.end() ||
-                posIt == attributes.end()) {
-                std::cerr << "JOINTS_0, WEIGHTS_0, or POSITION not found in glTF mesh." << std::endl;
-                continue;
-            }
-
-            const tinygltf::Accessor& jointAccessor = model.accessors[jointsIt->second];
-            const tinygltf::Accessor& weightAccessor = model.accessors[weightsIt->second];
-            const tinygltf::Accessor& posAccessor = model.accessors[posIt->second];
-
-            const tinygltf::BufferView& jointBV = model.bufferViews[jointAccessor.bufferView];
-            const tinygltf::BufferView& weightBV = model.bufferViews[weightAccessor.bufferView];
-            const tinygltf::BufferView& posBV = model.bufferViews[posAccessor.bufferView];
-
-            const uint8_t* jointRaw = reinterpret_cast<const uint8_t*>(
-                &model.buffers[jointBV.buffer].data[jointAccessor.byteOffset + jointBV.byteOffset]);
-            const float* weightData = reinterpret_cast<const float*>(
-                &model.buffers[weightBV.buffer].data[weightAccessor.byteOffset + weightBV.byteOffset]);
-            const float* posData = reinterpret_cast<const float*>(
-                &model.buffers[posBV.buffer].data[posAccessor.byteOffset + posBV.byteOffset]);
+    for (size_t m = 0; m < model.meshes.size(); ++m) {
+        const auto& primitives = model.meshes[m].primitives;
+        for (size_t p = 0; p < primitives.size(); ++p) {
+            auto posIt = primitives[p].attributes.find("POSITION");
+            if (posIt == primitives[p].attributes.end()) continue;
 
-            size_t primIdx = primitives.size();
-            primitives.push_back({ jointRaw, weightData, jointAccessor.componentType });
+            const float* posData = reinterpret_cast<const float*>(accessorData(model, posIt->second));
+            size_t count = model.accessors[posIt->second].count;
+            uint32_t primSlot = static_cast<uint32_t>(match.primitives.size());
+            match.primitives.push_back({ static_cast<int>(m), static_cast<int>(p) });
 
-            size_t count = posAccessor.count;
             for (size_t i = 0; i < count; ++i) {
                 gltfPositions.push_back(glm::vec3(posData[i * 3 + 0], posData[i * 3 + 1], posData[i * 3 + 2]));
-                gltfPrimIdx.push_back(primIdx);
-                gltfVertIdx.push_back(i);
+                match.gltfPrim.push_back(primSlot);
+                match.gltfVert.push_back(static_cast<uint32_t>(i));
             }
         }
     }
 
+    match.objToGltf.assign(objPositions.size(), SIZE_MAX);
     if (gltfPositions.empty()) {
-        std::cerr << "  No glTF vertices found for bone matching." << std::endl;
+        std::cerr << "  No glTF vertices found for matching." << std::endl;
         return;
     }
 
-    // Compute alignment and store in skeleton for bone matrix conjugation
+    // Alignment: reuse the skeleton's if already set, otherwise AABB-fit and
+    // store it for bone matrix conjugation
     float scale;
     glm::vec3 offset;
-    computeAlignment(objPositions, gltfPositions, scale, offset);
-
-    skeleton.objAlignTransform = glm::translate(glm::mat4(1.0f), offset) *
-                                  glm::scale(glm::mat4(1.0f), glm::vec3(scale));
-    skeleton.objAlignInverse = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / scale)) *
-                                glm::translate(glm::mat4(1.0f), -offset);
+    if (skeleton.objAlignTransform != glm::mat4(1.0f)) {
+        scale = skeleton.objAlignTransform[0][0];
+        offset = glm::vec3(skeleton.objAlignTransform[3]);
+    } else {
+        computeAlignment(objPositions, gltfPositions, scale, offset);
+        skeleton.objAlignTransform = glm::translate(glm::mat4(1.0f), offset) *
+                                      glm::scale(glm::mat4(1.0f), glm::vec3(scale));
+        skeleton.objAlignInverse = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / scale)) *
+                                    glm::translate(glm::mat4(1.0f), -offset);
+    }
+    std::cout << "  Vertex matching: scale=" << scale << ", "
+              << gltfPositions.size() << " glTF verts -> "
+              << objPositions.size() << " OBJ verts" << std::endl;
+
+    // Transform glTF positions to OBJ space and index them once
+    for (auto& p : gltfPositions) p = scale * p + offset;
+    KdTree tree;
+    tree.build(gltfPositions);
+
+    // Nearest aligned glTF vertex for every OBJ vertex, queried in parallel
+    parallelFor(objPositions.size(), 4096, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+            match.objToGltf[j] = tree.nearest(objPositions[j]);
+        }
+    });
+}
 
-    std::cout << "  Bone matching: scale=" << scale << std::endl;
+void GltfLoader::matchBoneDataToObjMesh(const tinygltf::Model& model,
+                                         const GltfVertexMatch& match,
+                                         JointData& jointIndices,
+                                         JointData& jointWeights) {
+    size_t objVertCount = match.objToGltf.size();
+    jointIndices.assign(objVertCount, glm::vec4(0.0f));
+    jointWeights.assign(objVertCount, glm::vec4(0.0f));
 
-    // Transform glTF positions to OBJ space
-    std::vector<glm::vec3> alignedGltfPos(gltfPositions.size());
-    for (size_t i = 0; i < gltfPositions.size(); ++i) {
-        alignedGltfPos[i] = scale * gltfPositions[i] + offset;
+    // Per-primitive bone data pointers (null when the primitive is unskinned)
+    struct PrimitiveData {
+        const uint8_t* jointData = nullptr;
+        const float* weightData = nullptr;
+        int jointComponentType = 0;
+    };
+    std::vector<PrimitiveData> primitives(match.primitives.size());
+    bool anySkinned = false;
+    for (size_t p = 0; p < match.primitives.size(); ++p) {
+        const auto& primitive = model.meshes[match.primitives[p].mesh]
+                                     .primitives[match.primitives[p].primitive];
+        auto jointsIt = primitive.attributes.find("JOINTS_0");
+        auto weightsIt = primitive.attributes.find("WEIGHTS_0");
+        if (jointsIt == primitive.attributes.end() || weightsIt == primitive.attributes.end())
+            continue;
+        // Indexed per POSITION entry, so shorter arrays are skipped like absent ones
+        size_t vertexCount = model.accessors[primitive.attributes.at("POSITION")].count;
+        if (model.accessors[jointsIt->second].count != vertexCount ||
+            model.accessors[weightsIt->second].count != vertexCount)
+            continue;
+        primitives[p].jointData = accessorData(model, jointsIt->second);
+        primitives[p].weightData = reinterpret_cast<const float*>(accessorData(model, weightsIt->second));
+        primitives[p].jointComponentType = model.accessors[jointsIt->second].componentType;
+        anySkinned = true;
+    }
+    if (!anySkinned) {
+        std::cerr << "JOINTS_0 or WEIGHTS_0 not found in glTF mesh." << std::endl;
+        return;
     }
 
-    // Spatial match: for each OBJ vertex, find the closest glTF vertex
-    std::vector<size_t> objToGltf = spatialMatch(objPositions, alignedGltfPos);
-
-    // Helper to read joint/weight data from a glTF vertex
-    auto readGltfBoneData = [&](size_t gi, glm::vec4& outJoints, glm::vec4& outWeights) {
-        const auto& prim = primitives[gltfPrimIdx[gi]];
-        size_t i = gltfVertIdx[gi];
+    // Transfer bone data using the shared match results
+    uint32_t matchedCount = 0;
+    for (size_t j = 0; j < objVertCount; ++j) {
+        size_t gi = match.objToGltf[j];
+        if (gi == SIZE_MAX) continue;
+        const auto& prim = primitives[match.gltfPrim[gi]];
+        if (!prim.jointData) continue;
+        size_t i = match.gltfVert[gi];
 
         if (prim.jointComponentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
             const uint16_t* jointData16 = reinterpret_cast<const uint16_t*>(prim.jointData);
-            outJoints = glm::vec4(
+            jointIndices[j] = glm::vec4(
                 static_cast<float>(jointData16[i * 4 + 0]),
                 static_cast<float>(jointData16[i * 4 + 1]),
                 static_cast<float>(jointData16[i * 4 + 2]),
                 static_cast<float>(jointData16[i * 4 + 3]));
         } else {
-            outJoints = glm::vec4(
+            jointIndices[j] = glm::vec4(
                 static_cast<float>(prim.jointData[i * 4 + 0]),
                 static_cast<float>(prim.jointData[i * 4 + 1]),
                 static_cast<float>(prim.jointData[i * 4 + 2]),
                 static_cast<float>(prim.jointData[i * 4 + 3]));
         }
-
-        outWeights = glm::vec4(
+        jointWeights[j] = glm::vec4(
             prim.weightData[i * 4 + 0],
             prim.weightData[i * 4 + 1],
             prim.weightData[i * 4 + 2],
             prim.weightData[i * 4 + 3]);
-    };
-
-    // Transfer bone data using the spatial match results
-    uint32_t matchedCount = 0;
-    for (size_t j = 0; j < objVertCount; ++j) {
-        if (objToGltf[j] == SIZE_MAX) continue;
-        glm::vec4 joints, weights;
-        readGltfBoneData(objToGltf[j], joints, weights);
-        jointIndices[j] = joints;
-        jointWeights[j] = weights;
         matchedCount++;
     }
 
@@ -684,76 +1023,63 @@ void GltfLoader::matchBoneDataToObjMesh(const tinygltf::Model& model,
 }
 
 void GltfLoader::matchUVsToObjMesh(const tinygltf::Model& model,
-                                    const std::vector<glm::vec3>& objPositions,
-                                    const Skeleton& skeleton,
+                                    const GltfVertexMatch& match,
                                     std::vector<glm::vec2>& outUVs) {
-    size_t objVertCount = objPositions.size();
+    size_t objVertCount = match.objToGltf.size();
     outUVs.assign(objVertCount, glm::vec2(0.0f));
 
-    // Collect glTF vertex positions and UVs
-    std::vector<glm::vec3> gltfPositions;
-    std::vector<glm::vec2> gltfUVs;
-
-    for (const auto& mesh : model.meshes) {
-        for (const auto& primitive : mesh.primitives) {
-            auto posIt = primitive.attributes.find("POSITION");
-            auto uvIt = primitive.attributes.find("TEXCOORD_0");
-            if (posIt == primitive.attributes.end() || uvIt == primitive.attributes.end())
-                continue;
-
-            const tinygltf::Accessor& posAcc = model.accessors[posIt->second];
-            const tinygltf::BufferView& posBV = model.bufferViews[posAcc.bufferView];
-            const float* posData = reinterpret_cast<const float*>(
-                &model.buffers[posBV.buffer].data[posAcc.byteOffset + posBV.byteOffset]);
-
-            const tinygltf::Accessor& uvAcc = model.accessors[uvIt->second];
-            const tinygltf::BufferView& uvBV = model.bufferViews[uvAcc.bufferView];
-            const float* uvData = reinterpret_cast<const float*>(
-                &model.buffers[uvBV.buffer].data[uvAcc.byteOffset + uvBV.byteOffset]);
-
-            size_t count = posAcc.count;
-            for (size_t i = 0; i < count; ++i) {
-                gltfPositions.push_back(glm::vec3(posData[i * 3 + 0], posData[i * 3 + 1], posData[i * 3 + 2]));
-                gltfUVs.push_back(glm::vec2(uvData[i * 2 + 0], uvData[i * 2 + 1]));
-            }
-        }
+    std::vector<const float*> uvData(match.primitives.size(), nullptr);
+    bool anyUVs = false;
+    for (size_t p = 0; p < match.primitives.size(); ++p) {
+        const auto& primitive = model.meshes[match.primitives[p].mesh]
+                                     .primitives[match.primitives[p].primitive];
+        auto uvIt = primitive.attributes.find("TEXCOORD_0");
+        if (uvIt == primitive.attributes.end() ||
+            model.accessors[uvIt->second].count != model.accessors[primitive.attributes.at("POSITION")].count)
+            continue;
+        uvData[p] = reinterpret_cast<const float*>(accessorData(model, uvIt->second));
+        anyUVs = true;
     }
-
-    if (gltfPositions.empty()) {
+    if (!anyUVs) {
         std::cerr << "  No TEXCOORD_0 found in glTF mesh." << std::endl;
         return;
     }
 
-    std::cout << "  UV matching: " << gltfPositions.size() << " glTF verts -> "
-              << objVertCount << " OBJ verts" << std::endl;
-
-    // Compute alignment: reuse skeleton's if available, otherwise compute from AABBs
-    float scale;
-    glm::vec3 offset;
-    if (skeleton.objAlignTransform != glm::mat4(1.0f)) {
-        scale = skeleton.objAlignTransform[0][0];
-        offset = glm::vec3(skeleton.objAlignTransform[3]);
-    } else {
-        computeAlignment(objPositions, gltfPositions, scale, offset);
-    }
-
-    // Transform glTF positions to OBJ space
-    std::vector<glm::vec3> alignedPos(gltfPositions.size());
-    for (size_t i = 0; i < gltfPositions.size(); ++i) {
-        alignedPos[i] = scale * gltfPositions[i] + offset;
-    }
-
-    // Spatial match: for each OBJ vertex, find the closest glTF vertex
-    std::vector<size_t> objToGltf = spatialMatch(objPositions, alignedPos);
-
-    // Transfer UV data using the spatial match results
+    // Transfer UV data using the shared match results
     uint32_t matchedCount = 0;
     for (size_t j = 0; j < objVertCount; ++j) {
-        if (objToGltf[j] == SIZE_MAX) continue;
-        outUVs[j] = gltfUVs[objToGltf[j]];
+        size_t gi = match.objToGltf[j];
+        if (gi == SIZE_MAX) continue;
+        const float* uv = uvData[match.gltfPrim[gi]];
+        if (!uv) continue;
+        size_t i = match.gltfVert[gi];
+        outUVs[j] = glm::vec2(uv[i * 2 + 0], uv[i * 2 + 1]);
         matchedCount++;
     }
 
     std::cout << "  UV data matched: " << matchedCount << " / " << objVertCount
               << " vertices" << std::endl;
 }
+
+void GltfLoader::matchBoneDataToObjMesh(const tinygltf::Model& model,
+                                         const std::vector<glm::vec3>& objPositions,
+                                         Skeleton& skeleton,
+                                         JointData& jointIndices,
+                                         JointData& jointWeights) {
+    // Bone matching always re-fits the alignment
+    skeleton.objAlignTransform = glm::mat4(1.0f);
+    skeleton.objAlignInverse = glm::mat4(1.0f);
+    GltfVertexMatch match;
+    buildVertexMatch(model, objPositions, skeleton, match);
+    matchBoneDataToObjMesh(model, match, jointIndices, jointWeights);
+}
+
+void GltfLoader::matchUVsToObjMesh(const tinygltf::Model& model,
+                                    const std::vector<glm::vec3>& objPositions,
+                                    const Skeleton& skeleton,
+                                    std::vector<glm::vec2>& outUVs) {
+    Skeleton alignment = skeleton;
+    GltfVertexMatch match;
+    buildVertexMatch(model, objPositions, alignment, match);
+    matchUVsToObjMesh(model, match, outUVs);
+}
@@ -2,10 +2,12 @@
 #include <stb_image.h>
 
 #include "loaders/ImageLoader.h"
+#include "core/Trace.h"
 #include <stdexcept>
 #include <iostream>
 
 ImageData ImageLoader::load(const std::string& filepath) {
+    TRACE_ZONE("ImageLoader::load");
     int width, height, channels;
     stbi_uc* pixels = stbi_load(filepath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
 
@@ -26,3 +28,27 @@ ImageData ImageLoader::load(const std::string& filepath) {
 
     return data;
 }
+
+ImageData ImageLoader::loadFromMemory(const uint8_t* data, size_t size, const std::string& name) {
+    TRACE_ZONE("ImageLoader::loadFromMemory");
+    int width, height, channels;
+    stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size),
+                                            &width, &height, &channels, STBI_rgb_alpha);
+
+    if (!pixels) {
+        throw std::runtime_error("Failed to load image: " + name);
+    }
+
+    ImageData image;
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    size_t imageSize = static_cast<size_t>(width) * height * 4;
+    image.pixels.assign(pixels, pixels + imageSize);
+
+    stbi_image_free(pixels);
+
+    std::cout << "Loaded image: " << name
+              << " (" << width << "x" << height << ", " << channels << " channels)" << std::endl;
+
+    return image;
+}
@@ -0,0 +1,116 @@
+#include "loaders/MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(mappedData, other.mappedData);
+        std::swap(mappedSize, other.mappedSize);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#else
+        std::swap(fd, other.fd);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+void MappedFile::open(const std::string& filepath) {
+    close();
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file for mapping: " + filepath);
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map empty or unreadable file: " + filepath);
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map file: " + filepath);
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    mappedData = static_cast<const uint8_t*>(view);
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+}
+
+void MappedFile::close() {
+    if (mappedData) UnmapViewOfFile(mappedData);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    mappedData = nullptr;
+    mappedSize = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+#else
+
+void MappedFile::open(const std::string& filepath) {
+    close();
+    int file = ::open(filepath.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Failed to open file for mapping: " + filepath);
+    }
+    struct stat st{};
+    if (fstat(file, &st) != 0 || st.st_size == 0) {
+        ::close(file);
+        throw std::runtime_error("Failed to map empty or unreadable file: " + filepath);
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    if (view == MAP_FAILED) {
+        ::close(file);
+        throw std::runtime_error("Failed to map file: " + filepath);
+    }
+    fd = file;
+    mappedData = static_cast<const uint8_t*>(view);
+    mappedSize = static_cast<size_t>(st.st_size);
+}
+
+void MappedFile::close() {
+    if (mappedData) munmap(const_cast<uint8_t*>(mappedData), mappedSize);
+    if (fd >= 0) ::close(fd);
+    mappedData = nullptr;
+    mappedSize = 0;
+    fd = -1;
+}
+
+#endif
+
+uint64_t MappedFile::hash() const {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < mappedSize; i++) {
+        h ^= mappedData[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
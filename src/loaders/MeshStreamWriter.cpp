@@ -0,0 +1,25 @@
+#include "loaders/MeshStreamWriter.h"
+#include "loaders/ObjWriter.h"
+#include "loaders/GlbWriter.h"
+#include "loaders/PlyWriter.h"
+#include "loaders/MeshletWriter.h"
+
+std::unique_ptr<MeshStreamWriter> MeshStreamWriter::create(MeshFileFormat format) {
+    switch (format) {
+        case MeshFileFormat::Glb: return std::make_unique<GlbWriter::Stream>();
+        case MeshFileFormat::Ply: return std::make_unique<PlyWriter::Stream>();
+        case MeshFileFormat::Meshlet: return std::make_unique<MeshletWriter::Stream>();
+        case MeshFileFormat::Obj:
+        default:                  return std::make_unique<ObjWriter::Stream>();
+    }
+}
+
+const char* MeshStreamWriter::extension(MeshFileFormat format) {
+    switch (format) {
+        case MeshFileFormat::Glb: return ".glb";
+        case MeshFileFormat::Ply: return ".ply";
+        case MeshFileFormat::Meshlet: return ".gmlt";
+        case MeshFileFormat::Obj:
+        default:                  return ".obj";
+    }
+}
@@ -0,0 +1,222 @@
+#include "loaders/MeshletWriter.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little,
+              "meshlet files are written by copying memory as-is");
+
+namespace {
+
+int16_t toSnorm16(float v) {
+    return static_cast<int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+}
+
+float signNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+
+} // namespace
+
+void MeshletWriter::encodeNormal(const glm::vec3& n, int16_t out[2]) {
+    float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1 <= 0.0f) {
+        out[0] = out[1] = 0;
+        return;
+    }
+    float x = n.x / l1, y = n.y / l1;
+    if (n.z < 0.0f) {
+        float fx = (1.0f - std::abs(y)) * signNotZero(x);
+        float fy = (1.0f - std::abs(x)) * signNotZero(y);
+        x = fx;
+        y = fy;
+    }
+    out[0] = toSnorm16(x);
+    out[1] = toSnorm16(y);
+}
+
+glm::vec3 MeshletWriter::decodeNormal(const int16_t in[2]) {
+    float x = std::max(in[0] / 32767.0f, -1.0f);
+    float y = std::max(in[1] / 32767.0f, -1.0f);
+    glm::vec3 n(x, y, 1.0f - std::abs(x) - std::abs(y));
+    if (n.z < 0.0f) {
+        float fx = (1.0f - std::abs(y)) * signNotZero(x);
+        float fy = (1.0f - std::abs(x)) * signNotZero(y);
+        n.x = fx;
+        n.y = fy;
+    }
+    return glm::normalize(n);
+}
+
+void MeshletWriter::Stream::writeAt(uint64_t offset, const void* data, size_t size) {
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+void MeshletWriter::Stream::open(const std::string& filepath,
+                                 uint64_t numVertices, uint64_t numTriangles) {
+    if (numVertices > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Meshlet export: too many vertices for uint indices");
+    }
+    totalVertices = numVertices;
+    totalTriangles = numTriangles;
+    vertexBase = 0;
+    triangleBase = 0;
+    meshletCount = 0;
+    dataWords = 0;
+    buildSeconds = 0.0;
+    writeSeconds = 0.0;
+
+    file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + filepath);
+    }
+    path = filepath;
+    meshletPath = filepath + ".meshlets.tmp";
+    meshletFile.open(meshletPath, std::ios::binary | std::ios::trunc);
+    if (!meshletFile.is_open()) {
+        file.close();
+        throw std::runtime_error("Cannot open file for writing: " + meshletPath);
+    }
+
+    vertexStart = sizeof(FileHeader);
+    dataStart = vertexStart + totalVertices * sizeof(Vertex);
+
+    // Counts and offsets are final only on close()
+    FileHeader header{};
+    writeAt(0, &header, sizeof(header));
+}
+
+void MeshletWriter::Stream::appendBatch(const glm::vec4* positions,
+                                        const glm::vec4* normals,
+                                        const glm::vec2* uvs,
+                                        const uint32_t* indices,
+                                        uint32_t numVertices,
+                                        uint32_t numTriangles) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (vertexBase + numVertices > totalVertices || triangleBase + numTriangles > totalTriangles) {
+        throw std::runtime_error("Meshlet export: batch exceeds the declared totals");
+    }
+
+    MeshletBuilder::build(positions, indices, numTriangles, meshlets);
+    auto builtTime = std::chrono::high_resolution_clock::now();
+    buildSeconds += std::chrono::duration<double>(builtTime - startTime).count();
+
+    // Vertices in place
+    scratch.resize(size_t(numVertices) * sizeof(Vertex));
+    Vertex* vertices = reinterpret_cast<Vertex*>(scratch.data());
+    for (uint32_t i = 0; i < numVertices; i++) {
+        Vertex& v = vertices[i];
+        v.position[0] = positions[i].x;
+        v.position[1] = positions[i].y;
+        v.position[2] = positions[i].z;
+        encodeNormal(glm::vec3(normals[i].x, normals[i].y, normals[i].z), v.normal);
+        v.uv[0] = uvs[i].x;
+        v.uv[1] = uvs[i].y;
+    }
+    writeAt(vertexStart + vertexBase * sizeof(Vertex), vertices, scratch.size());
+
+    // Meshlet data behind everything written so far; indices become global
+    size_t batchWords = 0;
+    for (const MeshletBuilder::Meshlet& m : meshlets.meshlets)
+        batchWords += m.vertexCount + (m.triangleCount * 3 + 3) / 4;
+    if (!dataFits(dataWords, batchWords)) {
+        throw std::runtime_error("Meshlet export: meshlet data exceeds 16 GiB");
+    }
+    scratch.assign(batchWords * sizeof(uint32_t), 0);
+    uint32_t* words = reinterpret_cast<uint32_t*>(scratch.data());
+    records.resize(meshlets.meshlets.size());
+    const uint32_t base = static_cast<uint32_t>(vertexBase);
+    size_t w = 0;
+    for (size_t i = 0; i < meshlets.meshlets.size(); i++) {
+        const MeshletBuilder::Meshlet& m = meshlets.meshlets[i];
+        Meshlet& r = records[i];
+        r.center[0] = m.center.x;
+        r.center[1] = m.center.y;
+        r.center[2] = m.center.z;
+        r.radius = m.radius;
+        r.coneApex[0] = m.coneApex.x;
+        r.coneApex[1] = m.coneApex.y;
+        r.coneApex[2] = m.coneApex.z;
+        r.coneCutoff = m.coneCutoff;
+        r.coneAxis[0] = m.coneAxis.x;
+        r.coneAxis[1] = m.coneAxis.y;
+        r.coneAxis[2] = m.coneAxis.z;
+        r.vertexCount = m.vertexCount;
+        r.triangleCount = m.triangleCount;
+        r.reserved = 0;
+
+        r.vertexOffset = static_cast<uint32_t>(dataWords + w);
+        for (uint32_t k = 0; k < m.vertexCount; k++)
+            words[w++] = meshlets.vertices[m.vertexOffset + k] + base;
+
+        r.triangleOffset = static_cast<uint32_t>(dataWords + w);
+        std::memcpy(&words[w], &meshlets.triangles[size_t(m.triangleOffset) * 3], m.triangleCount * 3);
+        w += (m.triangleCount * 3 + 3) / 4;
+    }
+    writeAt(dataStart + dataWords * sizeof(uint32_t), words, batchWords * sizeof(uint32_t));
+    meshletFile.write(reinterpret_cast<const char*>(records.data()),
+                      static_cast<std::streamsize>(records.size() * sizeof(Meshlet)));
+
+    if (!file || !meshletFile) {
+        throw std::runtime_error("Write failed: " + path);
+    }
+    vertexBase += numVertices;
+    triangleBase += numTriangles;
+    meshletCount += records.size();
+    dataWords += batchWords;
+    writeSeconds += std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - builtTime).count();
+}
+
+void MeshletWriter::Stream::close() {
+    if (!file.is_open()) return;
+    meshletFile.close();
+
+    // Meshlet table after the data, then the final header
+    FileHeader header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.maxVertices = MeshletBuilder::MAX_VERTICES;
+    header.maxTriangles = MeshletBuilder::MAX_TRIANGLES;
+    header.vertexCount = totalVertices;
+    header.meshletCount = meshletCount;
+    header.vertexOffset = vertexStart;
+    header.dataOffset = dataStart;
+    header.dataSize = dataWords * sizeof(uint32_t);
+    header.meshletOffset = dataStart + header.dataSize;
+
+    std::ifstream staged(meshletPath, std::ios::binary);
+    file.seekp(static_cast<std::streamoff>(header.meshletOffset));
+    if (meshletCount > 0) file << staged.rdbuf();
+    staged.close();
+    std::remove(meshletPath.c_str());
+    writeAt(0, &header, sizeof(header));
+
+    bool ok = static_cast<bool>(file);
+    file.close();
+    double mb = static_cast<double>(header.meshletOffset + meshletCount * sizeof(Meshlet))
+              / (1024.0 * 1024.0);
+    meshlets = {};
+    scratch.clear();
+    scratch.shrink_to_fit();
+    records.clear();
+    records.shrink_to_fit();
+    if (!ok) {
+        std::cerr << "Write failed: " << path << std::endl;
+        return;
+    }
+
+    std::cout << "Exported meshlets: " << path
+              << " (" << vertexBase << " vertices, " << triangleBase << " triangles in "
+              << meshletCount << " meshlets, "
+              << (meshletCount ? double(triangleBase) / double(meshletCount) : 0.0)
+              << " triangles/meshlet, " << mb << " MB, build " << buildSeconds
+              << " s, write " << (writeSeconds > 0.0 ? mb / writeSeconds : 0.0)
+              << " MB/s)" << std::endl;
+}
@@ -1,4 +1,6 @@
 #include "loaders/ObjLoader.h"
+#include "core/MemoryTracker.h"
+#include "core/Trace.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -7,7 +9,20 @@
 #include <set>
 #include <unordered_map>
 
+size_t NGonMesh::sizeBytes() const {
+    size_t bytes = MemoryTracker::capacityBytes(positions) + MemoryTracker::capacityBytes(normals)
+                 + MemoryTracker::capacityBytes(texCoords) + MemoryTracker::capacityBytes(colors)
+                 + MemoryTracker::capacityBytes(faces) + MemoryTracker::capacityBytes(faceVertexIndices)
+                 + MemoryTracker::capacityBytes(originalVertexIndices);
+    for (const NGonFace& face : faces) {
+        bytes += MemoryTracker::capacityBytes(face.vertexIndices) + MemoryTracker::capacityBytes(face.normalIndices)
+               + MemoryTracker::capacityBytes(face.texCoordIndices);
+    }
+    return bytes;
+}
+
 NGonMesh ObjLoader::load(const std::string& filepath) {
+    TRACE_ZONE("ObjLoader::load");
     std::ifstream file(filepath);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open OBJ file: " + filepath);
@@ -179,6 +194,7 @@ NGonMesh ObjLoader::load(const std::string& filepath) {
 }
 
 void ObjLoader::triangulate(NGonMesh& mesh) {
+    TRACE_ZONE("ObjLoader::triangulate");
     std::vector<NGonFace> newFaces;
     std::vector<uint32_t> newFaceVertexIndices;
     uint32_t offset = 0;
@@ -275,6 +291,7 @@ float ObjLoader::computeFaceArea(
 }
 
 void ObjLoader::subdivideFlat(NGonMesh& mesh, int levels) {
+    TRACE_ZONE("ObjLoader::subdivideFlat");
     using Edge = std::pair<uint32_t, uint32_t>;
     auto makeEdge = [](uint32_t a, uint32_t b) -> Edge {
         return a < b ? Edge{a, b} : Edge{b, a};
@@ -373,6 +390,7 @@ void ObjLoader::subdivideFlat(NGonMesh& mesh, int levels) {
 }
 
 void ObjLoader::subdivide(NGonMesh& mesh, int levels) {
+    TRACE_ZONE("ObjLoader::subdivide");
     using Edge = std::pair<uint32_t, uint32_t>;
     auto makeEdge = [](uint32_t a, uint32_t b) -> Edge {
         return a < b ? Edge{a, b} : Edge{b, a};
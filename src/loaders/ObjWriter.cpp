@@ -1,9 +1,88 @@
 #include "loaders/ObjWriter.h"
 #include "loaders/ObjLoader.h"
+#include "core/Parallel.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 
+namespace {
+
+// Records are formatted in blocks, a window of blocks at a time in
+// parallel, and the blocks are then written in order
+constexpr size_t kRecordsPerBlock = 1 << 15;
+
+// Worst-case lengths: "%.6g" of a float is at most 13 chars ("-1.17549e-38")
+constexpr size_t kMaxFloatChars = 16;
+constexpr size_t kMaxIndexChars = 20;
+constexpr size_t kMaxVec3Record = 3 + 3 * (kMaxFloatChars + 1);
+constexpr size_t kMaxVec2Record = 3 + 2 * (kMaxFloatChars + 1);
+constexpr size_t kMaxFaceRecord = 2 + 3 * (3 * kMaxIndexChars + 3);
+
+// Same text as ostream's default float formatting (%.6g), without the locale
+char* putFloat(char* p, float v) {
+    return std::to_chars(p, p + kMaxFloatChars, v, std::chars_format::general, 6).ptr;
+}
+
+char* putIndex(char* p, uint64_t v) {
+    return std::to_chars(p, p + kMaxIndexChars, v).ptr;
+}
+
+char* putVec3(char* p, const char* tag, const glm::vec4& v) {
+    *p++ = tag[0];
+    if (tag[1]) *p++ = tag[1];
+    *p++ = ' '; p = putFloat(p, v.x);
+    *p++ = ' '; p = putFloat(p, v.y);
+    *p++ = ' '; p = putFloat(p, v.z);
+    *p++ = '\n';
+    return p;
+}
+
+// "i/i/i": position, uv and normal share one index
+char* putCorner(char* p, uint64_t i) {
+    char digits[kMaxIndexChars];
+    char* end = putIndex(digits, i);
+    size_t len = static_cast<size_t>(end - digits);
+    for (int k = 0; k < 3; k++) {
+        if (k) *p++ = '/';
+        std::copy_n(digits, len, p);
+        p += len;
+    }
+    return p;
+}
+
+size_t formatWindowBlocks() {
+    return 2 * parallelThreadCount();
+}
+
+// Format count records with format(out, i) -> end and write them in order
+template <typename Format>
+void writeRecords(std::ofstream& file, std::vector<std::string>& blocks,
+                    size_t count, size_t maxRecordLen, Format&& format) {
+    const size_t blockCount = (count + kRecordsPerBlock - 1) / kRecordsPerBlock;
+    for (size_t first = 0; first < blockCount; first += blocks.size()) {
+        size_t n = std::min(blocks.size(), blockCount - first);
+        parallelFor(n, 1, [&](size_t b0, size_t b1) {
+            for (size_t b = b0; b < b1; b++) {
+                size_t begin = (first + b) * kRecordsPerBlock;
+                size_t end = std::min(count, begin + kRecordsPerBlock);
+                std::string& buf = blocks[b];
+                buf.resize((end - begin) * maxRecordLen);
+                char* p = buf.data();
+                for (size_t i = begin; i < end; i++) p = format(p, i);
+                buf.resize(static_cast<size_t>(p - buf.data()));
+            }
+        });
+        for (size_t b = 0; b < n; b++) {
+            file.write(blocks[b].data(), static_cast<std::streamsize>(blocks[b].size()));
+        }
+    }
+}
+
+} // namespace
+
 void ObjWriter::write(const std::string& filepath,
                       const glm::vec4* positions,
                       const glm::vec4* normals,
@@ -11,53 +90,91 @@ void ObjWriter::write(const std::string& filepath,
                       const uint32_t* indices,
                       uint32_t numVertices,
                       uint32_t numTriangles) {
-    std::ofstream file(filepath);
+    Stream stream;
+    stream.open(filepath, numVertices, numTriangles);
+    stream.appendBatch(positions, normals, uvs, indices, numVertices, numTriangles);
+    stream.close();
+}
+
+void ObjWriter::Stream::open(const std::string& filepath,
+                             uint64_t totalVertices, uint64_t totalTriangles) {
+    file.open(filepath);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open file for writing: " + filepath);
     }
+    path = filepath;
+    vertexBase = 0;
+    triangleCount = 0;
+    writeSeconds = 0.0;
 
     file << "# Exported from Gravel procedural mesh renderer\n";
-    file << "# Vertices: " << numVertices
-         << ", Triangles: " << numTriangles << "\n\n";
+    file << "# Vertices: " << totalVertices
+         << ", Triangles: " << totalTriangles << "\n\n";
+}
+
+void ObjWriter::Stream::appendBatch(const glm::vec4* positions,
+                                    const glm::vec4* normals,
+                                    const glm::vec2* uvs,
+                                    const uint32_t* indices,
+                                    uint32_t numVertices,
+                                    uint32_t numTriangles) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (blocks.empty()) blocks.resize(formatWindowBlocks());
 
     // Write vertex positions
-    for (uint32_t i = 0; i < numVertices; i++) {
-        file << "v " << positions[i].x << " "
-             << positions[i].y << " "
-             << positions[i].z << "\n";
-    }
+    writeRecords(file, blocks, numVertices, kMaxVec3Record,
+        [&](char* p, size_t i) { return putVec3(p, "v", positions[i]); });
     file << "\n";
 
     // Write vertex normals
-    for (uint32_t i = 0; i < numVertices; i++) {
-        file << "vn " << normals[i].x << " "
-             << normals[i].y << " "
-             << normals[i].z << "\n";
-    }
+    writeRecords(file, blocks, numVertices, kMaxVec3Record,
+        [&](char* p, size_t i) { return putVec3(p, "vn", normals[i]); });
     file << "\n";
 
     // Write texture coordinates
-    for (uint32_t i = 0; i < numVertices; i++) {
-        file << "vt " << uvs[i].x << " "
-             << uvs[i].y << "\n";
-    }
+    writeRecords(file, blocks, numVertices, kMaxVec2Record,
+        [&](char* p, size_t i) {
+            *p++ = 'v'; *p++ = 't';
+            *p++ = ' '; p = putFloat(p, uvs[i].x);
+            *p++ = ' '; p = putFloat(p, uvs[i].y);
+            *p++ = '\n';
+            return p;
+        });
     file << "\n";
 
-    // Write faces (OBJ is 1-indexed)
-    for (uint32_t t = 0; t < numTriangles; t++) {
-        uint32_t i0 = indices[t * 3 + 0] + 1;
-        uint32_t i1 = indices[t * 3 + 1] + 1;
-        uint32_t i2 = indices[t * 3 + 2] + 1;
-        file << "f " << i0 << "/" << i0 << "/" << i0 << " "
-             << i1 << "/" << i1 << "/" << i1 << " "
-             << i2 << "/" << i2 << "/" << i2 << "\n";
+    // Write faces (OBJ is 1-indexed, and counts from the start of the file)
+    const uint64_t base = vertexBase + 1;
+    writeRecords(file, blocks, numTriangles, kMaxFaceRecord,
+        [&](char* p, size_t t) {
+            *p++ = 'f';
+            for (int k = 0; k < 3; k++) {
+                *p++ = ' ';
+                p = putCorner(p, indices[t * 3 + k] + base);
+            }
+            *p++ = '\n';
+            return p;
+        });
+
+    if (!file) {
+        throw std::runtime_error("Write failed: " + path);
     }
+    vertexBase += numVertices;
+    triangleCount += numTriangles;
+    writeSeconds += std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
 
+void ObjWriter::Stream::close() {
+    if (!file.is_open()) return;
+    double mb = static_cast<double>(file.tellp()) / (1024.0 * 1024.0);
     file.close();
+    blocks.clear();
+    blocks.shrink_to_fit();
 
-    std::cout << "Exported OBJ: " << filepath
-              << " (" << numVertices << " vertices, "
-              << numTriangles << " triangles)" << std::endl;
+    std::cout << "Exported OBJ: " << path
+              << " (" << vertexBase << " vertices, "
+              << triangleCount << " triangles, " << mb << " MB, "
+              << (writeSeconds > 0.0 ? mb / writeSeconds : 0.0) << " MB/s)" << std::endl;
 }
 
 void ObjWriter::appendMesh(const std::string& filepath,
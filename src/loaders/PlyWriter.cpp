@@ -0,0 +1,135 @@
+#include "loaders/PlyWriter.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little,
+              "binary_little_endian PLY is written by copying memory as-is");
+
+namespace {
+
+#pragma pack(push, 1)
+struct PlyVertex {
+    float x, y, z;
+    float nx, ny, nz;
+    float s, t;
+};
+
+struct PlyFace {
+    uint8_t  count;
+    uint32_t indices[3];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PlyVertex) == 32, "PLY vertex record must be packed");
+static_assert(sizeof(PlyFace) == 13, "PLY face record must be packed");
+
+} // namespace
+
+void PlyWriter::Stream::writeAt(uint64_t offset, const void* data, size_t size) {
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+void PlyWriter::Stream::open(const std::string& filepath,
+                             uint64_t numVertices, uint64_t numTriangles) {
+    if (numVertices > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("PLY export: too many vertices for uint indices");
+    }
+    totalVertices = numVertices;
+    totalTriangles = numTriangles;
+    vertexBase = 0;
+    triangleBase = 0;
+    writeSeconds = 0.0;
+
+    file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + filepath);
+    }
+    path = filepath;
+
+    std::string header =
+        "ply\n"
+        "format binary_little_endian 1.0\n"
+        "comment Exported from Gravel procedural mesh renderer\n"
+        "element vertex " + std::to_string(totalVertices) + "\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "property float nx\n"
+        "property float ny\n"
+        "property float nz\n"
+        "property float s\n"
+        "property float t\n"
+        "element face " + std::to_string(totalTriangles) + "\n"
+        "property list uchar uint vertex_indices\n"
+        "end_header\n";
+    writeAt(0, header.data(), header.size());
+
+    vertexStart = header.size();
+    faceStart = vertexStart + totalVertices * sizeof(PlyVertex);
+}
+
+void PlyWriter::Stream::appendBatch(const glm::vec4* positions,
+                                    const glm::vec4* normals,
+                                    const glm::vec2* uvs,
+                                    const uint32_t* indices,
+                                    uint32_t numVertices,
+                                    uint32_t numTriangles) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (vertexBase + numVertices > totalVertices || triangleBase + numTriangles > totalTriangles) {
+        throw std::runtime_error("PLY export: batch exceeds the declared totals");
+    }
+
+    scratch.resize(std::max(size_t(numVertices) * sizeof(PlyVertex),
+                            size_t(numTriangles) * sizeof(PlyFace)));
+
+    PlyVertex* vertices = reinterpret_cast<PlyVertex*>(scratch.data());
+    for (uint32_t i = 0; i < numVertices; i++) {
+        vertices[i] = { positions[i].x, positions[i].y, positions[i].z,
+                        normals[i].x, normals[i].y, normals[i].z,
+                        uvs[i].x, uvs[i].y };
+    }
+    writeAt(vertexStart + vertexBase * sizeof(PlyVertex), vertices,
+            size_t(numVertices) * sizeof(PlyVertex));
+
+    PlyFace* faces = reinterpret_cast<PlyFace*>(scratch.data());
+    const uint32_t base = static_cast<uint32_t>(vertexBase);
+    for (uint32_t t = 0; t < numTriangles; t++) {
+        PlyFace face;
+        face.count = 3;
+        face.indices[0] = indices[t * 3 + 0] + base;
+        face.indices[1] = indices[t * 3 + 1] + base;
+        face.indices[2] = indices[t * 3 + 2] + base;
+        std::memcpy(&faces[t], &face, sizeof(PlyFace));
+    }
+    writeAt(faceStart + triangleBase * sizeof(PlyFace), faces,
+            size_t(numTriangles) * sizeof(PlyFace));
+
+    if (!file) {
+        throw std::runtime_error("Write failed: " + path);
+    }
+    vertexBase += numVertices;
+    triangleBase += numTriangles;
+    writeSeconds += std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void PlyWriter::Stream::close() {
+    if (!file.is_open()) return;
+    double mb = static_cast<double>(faceStart + totalTriangles * sizeof(PlyFace))
+              / (1024.0 * 1024.0);
+    file.close();
+    scratch.clear();
+    scratch.shrink_to_fit();
+
+    std::cout << "Exported PLY: " << path
+              << " (" << vertexBase << " vertices, "
+              << triangleBase << " triangles, " << mb << " MB, "
+              << (writeSeconds > 0.0 ? mb / writeSeconds : 0.0) << " MB/s)" << std::endl;
+}
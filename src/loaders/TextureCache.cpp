@@ -0,0 +1,107 @@
+#include "loaders/TextureCache.h"
+#include "loaders/MappedFile.h"
+#include "core/Trace.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr char     kMagic[4] = {'G', 'R', 'T', 'X'};
+constexpr uint32_t kVersion  = 1;
+
+// Followed by width * height * 4 bytes of RGBA8
+struct EntryHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+};
+static_assert(sizeof(EntryHeader) == 32, "cache entry header must stay unpadded");
+
+bool readEntry(const std::string& entryPath, uint64_t hash, uint64_t size, ImageData& image) {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(entryPath, ec)) return false;
+    try {
+        MappedFile entry;
+        entry.open(entryPath);
+        EntryHeader header;
+        if (entry.size() < sizeof(header)) return false;
+        std::memcpy(&header, entry.data(), sizeof(header));
+        size_t pixelBytes = size_t(header.width) * header.height * 4;
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+            || header.sourceHash != hash || header.sourceSize != size
+            || entry.size() != sizeof(header) + pixelBytes) {
+            return false;
+        }
+        image.width = header.width;
+        image.height = header.height;
+        const uint8_t* pixels = entry.data() + sizeof(header);
+        image.pixels.assign(pixels, pixels + pixelBytes);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void writeEntry(const std::string& entryPath, uint64_t hash, uint64_t size, const ImageData& image) {
+    // Written next to the entry and renamed into place, so a reader never
+    // maps a partial file and concurrent writers of one entry do not clash
+    std::string tmpPath = entryPath + "."
+        + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    try {
+        std::filesystem::create_directories(std::filesystem::path(entryPath).parent_path());
+        {
+            EntryHeader header{};
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.width = image.width;
+            header.height = image.height;
+            header.sourceHash = hash;
+            header.sourceSize = size;
+            std::ofstream out(tmpPath, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(image.pixels.data()),
+                      static_cast<std::streamsize>(image.pixels.size()));
+            if (!out) throw std::runtime_error("Write failed: " + tmpPath);
+        }
+        std::filesystem::rename(tmpPath, entryPath);
+    } catch (const std::exception& e) {
+        std::error_code ec;
+        std::filesystem::remove(tmpPath, ec);
+        std::cerr << "  Warning: texture cache: " << e.what() << std::endl;
+    }
+}
+
+} // namespace
+
+ImageData TextureCache::load(const std::string& path, const std::string& cacheDir) {
+    TRACE_ZONE("TextureCache::load");
+    if (cacheDir.empty()) return ImageLoader::load(path);
+
+    // The source is mapped once: hashed for the key, and decoded from the
+    // mapping on a miss
+    MappedFile source;
+    source.open(path);
+    uint64_t hash = source.hash();
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.rgba", static_cast<unsigned long long>(hash));
+    std::string entryPath = (std::filesystem::path(cacheDir) / name).string();
+
+    ImageData image;
+    if (readEntry(entryPath, hash, source.size(), image)) {
+        std::cout << "Loaded image: " << path << " (" << image.width << "x" << image.height
+                  << ", cached)" << std::endl;
+        return image;
+    }
+    image = ImageLoader::loadFromMemory(source.data(), source.size(), path);
+    writeEntry(entryPath, hash, source.size(), image);
+    return image;
+}
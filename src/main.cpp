@@ -2,10 +2,13 @@
 #include "renderer/renderer.h"
 #include "loaders/ObjLoader.h"
 #include "geometry/HalfEdge.h"
+#include "core/Trace.h"
+#include <cstdlib>
 #include <iostream>
 #include <stdexcept>
 
 int main() {
+    TRACE_THREAD_NAME("main");
     std::cout << "=== Gravel - GPU Mesh Shader Resurfacing ===" << std::endl;
     std::cout << std::endl;
 
@@ -120,6 +123,17 @@ int main() {
         }
 
         renderer.waitIdle();
+#if GRAVEL_TRACING
+        // GRAVEL_TRACE=<file> writes the trace on every exit
+        const char* tracePath = std::getenv("GRAVEL_TRACE");
+        if (tracePath || renderer.traceOnExit) {
+            try {
+                Trace::writeChromeJson(tracePath ? tracePath : BUILD_DIR "gravel_trace.json");
+            } catch (const std::exception& e) {
+                std::cerr << "Trace save failed: " << e.what() << std::endl;
+            }
+        }
+#endif
         std::cout << "\nApplication closed successfully" << std::endl;
 
     } catch (const std::exception& e) {
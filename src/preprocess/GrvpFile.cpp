@@ -0,0 +1,253 @@
+#include "preprocess/GrvpFile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <cstring>
+
+namespace {
+
+uint64_t alignUp(uint64_t value) {
+    return (value + GRVP_V2_ALIGNMENT - 1) & ~(GRVP_V2_ALIGNMENT - 1);
+}
+
+// Read one v1 file (header + payload) with a single open. Returns false if
+// the file does not exist.
+bool readV1File(const std::string& path, PreprocessHeader& hdr,
+                std::vector<uint8_t>& payload, size_t elementSize,
+                uint64_t (*countFromHeader)(const PreprocessHeader&)) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+
+    f.read(reinterpret_cast<char*>(&hdr), sizeof(PreprocessHeader));
+    if (!f.good() || hdr.magic != GRVP_MAGIC || hdr.version != GRVP_VERSION_1) {
+        throw std::runtime_error("Invalid GRVP v1 header: " + path);
+    }
+    // The payload must be exactly the header's count, checked before
+    // allocating so a corrupt count cannot ask for a huge buffer
+    f.seekg(0, std::ios::end);
+    const uint64_t payloadSize = static_cast<uint64_t>(f.tellg()) - sizeof(PreprocessHeader);
+    f.seekg(sizeof(PreprocessHeader));
+    const uint64_t count = countFromHeader(hdr);
+    if (payloadSize % elementSize != 0 || payloadSize / elementSize != count) {
+        throw std::runtime_error("GRVP v1 file size does not match its header counts: " + path);
+    }
+    payload.resize(count * elementSize);
+    f.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    if (static_cast<size_t>(f.gcount()) != payload.size()) {
+        throw std::runtime_error("Truncated GRVP v1 file: " + path);
+    }
+    return true;
+}
+
+} // namespace
+
+void GrvpFile::close() {
+    mapped.close();
+    v1Curvature.clear();
+    v1Features.clear();
+    ownedSlots.clear();
+    ownedPriorities.clear();
+    curvaturePtr = nullptr;
+    featuresPtr = nullptr;
+    slotsPtr = nullptr;
+    prioritiesPtr = nullptr;
+    version = vertexCount = faceCount = edgeCount = slotsPerFace = 0;
+}
+
+bool GrvpFile::open(const std::string& preprocessDir, bool preferV2) {
+    close();
+
+    std::filesystem::path v2Path = std::filesystem::path(preprocessDir) / V2_FILENAME;
+    if (preferV2 && std::filesystem::exists(v2Path)) {
+        openV2(v2Path.string());
+        return true;
+    }
+    return openV1(preprocessDir);
+}
+
+void GrvpFile::packSlots(const SlotEntry* entries, size_t count) {
+    ownedSlots.resize(count);
+    ownedPriorities.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        ownedSlots[i] = packSlotUV(entries[i].u, entries[i].v);
+        ownedPriorities[i] = packSlotPriority(entries[i].priority);
+    }
+    slotsPtr = ownedSlots.data();
+    prioritiesPtr = ownedPriorities.data();
+}
+
+void GrvpFile::openV2(const std::string& path) {
+    mapped.open(path);
+    const uint8_t* base = mapped.data();
+    const size_t fileSize = mapped.size();
+
+    if (fileSize < sizeof(GrvpHeaderV2)) {
+        throw std::runtime_error("GRVP v2 file too small: " + path);
+    }
+    GrvpHeaderV2 hdr;
+    std::memcpy(&hdr, base, sizeof(hdr));
+    if (hdr.magic != GRVP_MAGIC || hdr.version != GRVP_VERSION_2) {
+        throw std::runtime_error("Invalid GRVP v2 header: " + path);
+    }
+    uint64_t tableEnd = sizeof(GrvpHeaderV2) + uint64_t(hdr.section_count) * sizeof(GrvpSection);
+    if (tableEnd > fileSize) {
+        throw std::runtime_error("GRVP v2 section table out of bounds: " + path);
+    }
+
+    const GrvpSection* table = reinterpret_cast<const GrvpSection*>(base + sizeof(GrvpHeaderV2));
+    auto find = [&](GrvpSectionType type) -> const GrvpSection* {
+        for (uint32_t i = 0; i < hdr.section_count; i++)
+            if (table[i].type == static_cast<uint32_t>(type)) return &table[i];
+        return nullptr;
+    };
+    auto resolve = [&](GrvpSectionType type, uint32_t elementSize, uint64_t expectedCount) -> const void* {
+        const GrvpSection* s = find(type);
+        if (!s) {
+            throw std::runtime_error("GRVP v2 missing section " +
+                                     std::to_string(static_cast<uint32_t>(type)) + ": " + path);
+        }
+        // Divide rather than multiply: count * element_size can overflow
+        if (s->element_size != elementSize || s->count != expectedCount
+            || s->offset % GRVP_V2_ALIGNMENT != 0
+            || s->offset > fileSize || s->count > (fileSize - s->offset) / elementSize) {
+            throw std::runtime_error("Malformed GRVP v2 section " + std::to_string(s->type)
+                                     + ": " + path);
+        }
+        return base + s->offset;
+    };
+
+    uint64_t slotCount = uint64_t(hdr.face_count) * hdr.slots_per_face;
+    curvaturePtr = static_cast<const float*>(
+        resolve(GrvpSectionType::Curvature, sizeof(float), hdr.vertex_count));
+    featuresPtr = static_cast<const uint32_t*>(
+        resolve(GrvpSectionType::Features, sizeof(uint32_t), hdr.face_count));
+    if (find(GrvpSectionType::PackedSlots)) {
+        slotsPtr = static_cast<const PackedSlot*>(
+            resolve(GrvpSectionType::PackedSlots, sizeof(PackedSlot), slotCount));
+        prioritiesPtr = static_cast<const uint16_t*>(
+            resolve(GrvpSectionType::SlotPriorities, sizeof(uint16_t), slotCount));
+    } else {
+        packSlots(static_cast<const SlotEntry*>(
+            resolve(GrvpSectionType::Slots, sizeof(SlotEntry), slotCount)), slotCount);
+    }
+
+    version = GRVP_VERSION_2;
+    vertexCount = hdr.vertex_count;
+    faceCount = hdr.face_count;
+    edgeCount = hdr.edge_count;
+    slotsPerFace = hdr.slots_per_face;
+}
+
+bool GrvpFile::openV1(const std::string& preprocessDir) {
+    std::filesystem::path dir(preprocessDir);
+    PreprocessHeader curvHdr{}, featHdr{}, slotsHdr{};
+    std::vector<uint8_t> curvBytes, featBytes, slotBytes;
+
+    bool found =
+        readV1File((dir / "curvature.bin").string(), curvHdr, curvBytes, sizeof(float),
+                   [](const PreprocessHeader& h) -> uint64_t { return h.vertex_count; })
+        && readV1File((dir / "features.bin").string(), featHdr, featBytes, sizeof(uint8_t),
+                   [](const PreprocessHeader& h) -> uint64_t { return h.face_count; })
+        && readV1File((dir / "slots.bin").string(), slotsHdr, slotBytes, sizeof(SlotEntry),
+                   [](const PreprocessHeader& h) -> uint64_t {
+                       return uint64_t(h.face_count) * h.slots_per_face;
+                   });
+    if (!found) return false;
+
+    if (featHdr.face_count != slotsHdr.face_count) {
+        throw std::runtime_error("GRVP v1 features/slots face counts differ in " + preprocessDir);
+    }
+
+    v1Curvature.resize(curvHdr.vertex_count);
+    std::memcpy(v1Curvature.data(), curvBytes.data(), curvBytes.size());
+    v1Features.assign(featBytes.begin(), featBytes.end());
+    {
+        std::vector<SlotEntry> entries(slotBytes.size() / sizeof(SlotEntry));
+        std::memcpy(entries.data(), slotBytes.data(), slotBytes.size());
+        packSlots(entries.data(), entries.size());
+    }
+
+    curvaturePtr = v1Curvature.data();
+    featuresPtr = v1Features.data();
+
+    version = GRVP_VERSION_1;
+    vertexCount = curvHdr.vertex_count;
+    faceCount = featHdr.face_count;
+    edgeCount = featHdr.edge_count;
+    slotsPerFace = slotsHdr.slots_per_face;
+    return true;
+}
+
+void GrvpFile::writeV2(const std::string& path, uint32_t vertexCount, uint32_t faceCount,
+                       uint32_t edgeCount, uint32_t slotsPerFace,
+                       const float* curvature, const uint32_t* features,
+                       const PackedSlot* slots, const uint16_t* slotPriorities) {
+    struct Payload {
+        GrvpSectionType type;
+        uint32_t elementSize;
+        uint64_t count;
+        const void* data;
+    };
+    const uint64_t slotCount = uint64_t(faceCount) * slotsPerFace;
+    const Payload payloads[] = {
+        { GrvpSectionType::Curvature,      sizeof(float),      vertexCount, curvature },
+        { GrvpSectionType::Features,       sizeof(uint32_t),   faceCount,   features },
+        { GrvpSectionType::PackedSlots,    sizeof(PackedSlot), slotCount,   slots },
+        { GrvpSectionType::SlotPriorities, sizeof(uint16_t),   slotCount,   slotPriorities },
+    };
+    constexpr uint32_t sectionCount = sizeof(payloads) / sizeof(payloads[0]);
+
+    GrvpHeaderV2 hdr{};
+    hdr.magic = GRVP_MAGIC;
+    hdr.version = GRVP_VERSION_2;
+    hdr.vertex_count = vertexCount;
+    hdr.face_count = faceCount;
+    hdr.edge_count = edgeCount;
+    hdr.slots_per_face = slotsPerFace;
+    hdr.section_count = sectionCount;
+
+    GrvpSection table[sectionCount]{};
+    uint64_t offset = alignUp(sizeof(GrvpHeaderV2) + sizeof(table));
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        table[i].type = static_cast<uint32_t>(payloads[i].type);
+        table[i].element_size = payloads[i].elementSize;
+        table[i].offset = offset;
+        table[i].count = payloads[i].count;
+        offset = alignUp(offset + payloads[i].count * payloads[i].elementSize);
+    }
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) {
+        throw std::runtime_error("Failed to open for writing: " + path);
+    }
+    const char zeros[GRVP_V2_ALIGNMENT] = {};
+    auto padTo = [&](uint64_t target) {
+        uint64_t pos = static_cast<uint64_t>(f.tellp());
+        if (target > pos) f.write(zeros, static_cast<std::streamsize>(target - pos));
+    };
+
+    f.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    f.write(reinterpret_cast<const char*>(table), sizeof(table));
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        padTo(table[i].offset);
+        f.write(static_cast<const char*>(payloads[i].data),
+                static_cast<std::streamsize>(payloads[i].count * payloads[i].elementSize));
+    }
+    padTo(offset);
+    if (!f) {
+        throw std::runtime_error("Failed to write: " + path);
+    }
+}
+
+void GrvpFile::convertV1ToV2(const std::string& preprocessDir) {
+    GrvpFile v1;
+    if (!v1.open(preprocessDir, false)) {
+        throw std::runtime_error("No GRVP v1 files in " + preprocessDir);
+    }
+    std::string outPath = (std::filesystem::path(preprocessDir) / V2_FILENAME).string();
+    writeV2(outPath, v1.vertexCount, v1.faceCount, v1.edgeCount, v1.slotsPerFace,
+            v1.curvature(), v1.features(), v1.slots(), v1.slotPriorities());
+    std::cout << "Converted GRVP v1 -> v2: " << outPath << std::endl;
+}
@@ -0,0 +1,373 @@
+#include "preprocess/GrwmJobManager.h"
+#include "preprocess/GrwmPreprocessor.h"
+#include "loaders/GltfLoader.h"
+#include "loaders/MappedFile.h"
+#include <tiny_gltf.h>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char* const kOutputFiles[] = { "curvature.bin", "features.bin", "slots.bin", "grwm.grvp" };
+const char* const kCompleteMarker = ".complete";
+
+// Bump whenever the preprocess output format or algorithm changes, so
+// entries written by an older build are never reused
+constexpr uint32_t kCacheVersion = 1;
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// The external binary by absolute path, size and modification time, so a
+// rebuilt or different cuda_preprocess misses the cache
+uint64_t binaryStamp(const std::string& binaryPath) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    std::string path = fs::absolute(binaryPath, ec).string();
+    if (ec) path = binaryPath;
+    uint64_t size = fs::file_size(binaryPath, ec);
+    if (ec) size = 0;
+    auto mtime = fs::last_write_time(binaryPath, ec);
+    int64_t ticks = ec ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count());
+    uint64_t hash = fnv1a(path.data(), path.size());
+    hash = fnv1a(&size, sizeof(size), hash);
+    return fnv1a(&ticks, sizeof(ticks), hash);
+}
+
+// Last "NN%" or "NN.N%" in a line, as a fraction; negative if none
+float parsePercent(const std::string& line) {
+    size_t pct = line.rfind('%');
+    if (pct == std::string::npos || pct == 0) return -1.0f;
+    size_t begin = pct;
+    while (begin > 0 && (std::isdigit(static_cast<unsigned char>(line[begin - 1])) || line[begin - 1] == '.'))
+        begin--;
+    if (begin == pct) return -1.0f;
+    float value = std::strtof(line.substr(begin, pct - begin).c_str(), nullptr);
+    return std::clamp(value / 100.0f, 0.0f, 1.0f);
+}
+
+} // namespace
+
+GrwmJobManager::~GrwmJobManager() {
+    cancel();
+    if (worker.joinable()) worker.join();
+}
+
+bool GrwmJobManager::start(const Request& request) {
+    if (isRunning()) return false;
+    if (worker.joinable()) worker.join();
+
+    cancelRequested = false;
+    completed = false;
+    progress = -1.0f;
+    {
+        std::lock_guard<std::mutex> lock(textMutex);
+        log.clear();
+        status = "Starting...";
+    }
+    state = State::Running;
+    worker = std::thread(&GrwmJobManager::run, this, request);
+    return true;
+}
+
+void GrwmJobManager::cancel() {
+    if (isRunning()) cancelRequested = true;
+}
+
+std::string GrwmJobManager::getStatus() const {
+    std::lock_guard<std::mutex> lock(textMutex);
+    return status;
+}
+
+std::vector<std::string> GrwmJobManager::getLog() const {
+    std::lock_guard<std::mutex> lock(textMutex);
+    return std::vector<std::string>(log.begin(), log.end());
+}
+
+void GrwmJobManager::setStatus(const std::string& text) {
+    std::lock_guard<std::mutex> lock(textMutex);
+    status = text;
+}
+
+void GrwmJobManager::appendLog(const std::string& line) {
+    std::lock_guard<std::mutex> lock(textMutex);
+    log.push_back(line);
+    while (log.size() > MAX_LOG_LINES) log.pop_front();
+}
+
+void GrwmJobManager::finish(State finalState, const std::string& text) {
+    setStatus(text);
+    appendLog(text);
+    if (finalState == State::Succeeded) {
+        progress = 1.0f;
+        completed = true;
+    }
+    state = finalState;
+}
+
+uint64_t GrwmJobManager::hashFile(const std::string& path) {
+    MappedFile file;
+    file.open(path);
+    return file.hash();
+}
+
+std::string GrwmJobManager::cacheKey(const Request& request) {
+    // The threshold goes in by its bits: any rounding would let two
+    // thresholds share the other's cached features
+    char backend[32] = "cpu";
+    if (!request.binaryPath.empty()) {
+        std::snprintf(backend, sizeof(backend), "cuda%016llx",
+                      static_cast<unsigned long long>(binaryStamp(request.binaryPath)));
+    }
+    char key[128];
+    std::snprintf(key, sizeof(key), "v%u-%016llx-s%d-t%08x-%s", kCacheVersion,
+                  static_cast<unsigned long long>(hashFile(request.meshPath)),
+                  request.slotsPerFace, std::bit_cast<uint32_t>(request.featureThreshold),
+                  backend);
+    return key;
+}
+
+void GrwmJobManager::installOutputs(const std::string& fromDir, const std::string& toDir) {
+    namespace fs = std::filesystem;
+    fs::create_directories(toDir);
+    // Drop every previous output so a stale v2 container cannot shadow new v1 files
+    for (const char* name : kOutputFiles) fs::remove(fs::path(toDir) / name);
+    for (const auto& entry : fs::directory_iterator(fromDir)) {
+        if (!entry.is_regular_file() || entry.path().filename() == kCompleteMarker) continue;
+        fs::copy_file(entry.path(), fs::path(toDir) / entry.path().filename(),
+                      fs::copy_options::overwrite_existing);
+    }
+}
+
+void GrwmJobManager::run(Request request) {
+    namespace fs = std::filesystem;
+    std::string workDir = request.outputDir;
+    bool cached = !request.cacheRoot.empty();
+    std::string key;  // hashed once, also written to the completion marker
+
+    try {
+        if (cached) {
+            setStatus("Hashing mesh...");
+            key = cacheKey(request);
+            workDir = (fs::path(request.cacheRoot) / key).string();
+            appendLog("Cache key: " + key);
+
+            if (fs::exists(fs::path(workDir) / kCompleteMarker)) {
+                installOutputs(workDir, request.outputDir);
+                finish(State::Succeeded, "Done (cached) — will load next frame");
+                return;
+            }
+            fs::remove_all(workDir);
+        } else {
+            for (const char* name : kOutputFiles) fs::remove(fs::path(workDir) / name);
+        }
+        fs::create_directories(workDir);
+
+        bool ok = request.binaryPath.empty()
+            ? runInProcess(request, workDir)
+            : runProcess(request, workDir);
+
+        if (cancelRequested) {
+            if (cached) fs::remove_all(workDir);
+            finish(State::Cancelled, "Cancelled");
+            return;
+        }
+        if (!ok) {
+            if (cached) fs::remove_all(workDir);
+            finish(State::Failed, getStatus());
+            return;
+        }
+
+        if (cached) {
+            std::ofstream(fs::path(workDir) / kCompleteMarker) << key << "\n";
+            installOutputs(workDir, request.outputDir);
+        }
+        finish(State::Succeeded, "Done — will load next frame");
+    } catch (const GrwmCancelled&) {
+        if (cached) fs::remove_all(workDir);
+        finish(State::Cancelled, "Cancelled");
+    } catch (const std::exception& e) {
+        if (cached) {
+            std::error_code ec;
+            fs::remove_all(workDir, ec);
+        }
+        finish(State::Failed, std::string("Failed: ") + e.what());
+    }
+}
+
+bool GrwmJobManager::runInProcess(const Request& request, const std::string& outputDir) {
+    setStatus("Loading mesh (CPU)...");
+    std::string ext = std::filesystem::path(request.meshPath).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    // Same view of the mesh as cuda_preprocess: the source file as-is
+    NGonMesh source;
+    if (ext == ".gltf" || ext == ".glb") {
+        JointData ji, jw;
+        tinygltf::Model model = GltfLoader::loadModel(request.meshPath);
+        source = GltfLoader::loadMesh(model, ji, jw);
+    } else {
+        source = ObjLoader::load(request.meshPath);
+    }
+
+    GrwmSettings settings;
+    settings.slotsPerFace = static_cast<uint32_t>(std::max(1, request.slotsPerFace));
+    settings.featureThresholdDeg = request.featureThreshold;
+
+    GrwmProgress hooks;
+    hooks.cancel = &cancelRequested;
+    hooks.report = [this](float fraction, const std::string& stage) {
+        progress = fraction;
+        setStatus("CPU: " + stage);
+        appendLog("CPU: " + stage);
+    };
+
+    GrwmResult result = GrwmPreprocessor::run(source, settings, &hooks);
+    setStatus("Writing output...");
+    GrwmPreprocessor::writeGrvp(outputDir, result);
+    return true;
+}
+
+#ifndef _WIN32
+
+bool GrwmJobManager::runProcess(const Request& request, const std::string& outputDir) {
+    std::vector<std::string> args = {
+        request.binaryPath, request.meshPath,
+        "--output", outputDir,
+        "--slots", std::to_string(request.slotsPerFace),
+        "--feature-threshold", std::to_string(request.featureThreshold),
+    };
+    std::vector<char*> argv;
+    for (auto& a : args) argv.push_back(a.data());
+    argv.push_back(nullptr);
+
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) {
+        setStatus("Failed to create pipe");
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        setStatus("Failed to fork");
+        return false;
+    }
+    if (pid == 0) {
+        // Child: stdout and stderr both go to the pipe
+        dup2(pipeFds[1], STDOUT_FILENO);
+        dup2(pipeFds[1], STDERR_FILENO);
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+    close(pipeFds[1]);
+
+    setStatus("Running...");
+    std::string pending;
+    char buffer[4096];
+    bool killed = false;
+    for (;;) {
+        if (cancelRequested && !killed) {
+            kill(pid, SIGTERM);
+            killed = true;
+        }
+        pollfd pfd{ pipeFds[0], POLLIN, 0 };
+        int ready = poll(&pfd, 1, 100);
+        if (ready < 0) break;
+        if (ready == 0) continue;
+
+        ssize_t n = read(pipeFds[0], buffer, sizeof(buffer));
+        if (n <= 0) break;
+        pending.append(buffer, static_cast<size_t>(n));
+
+        // Split on \n and \r so carriage-return progress bars update live
+        size_t start = 0;
+        for (size_t i = 0; i < pending.size(); i++) {
+            if (pending[i] != '\n' && pending[i] != '\r') continue;
+            if (i > start) {
+                std::string line = pending.substr(start, i - start);
+                float p = parsePercent(line);
+                if (p >= 0.0f) progress = p;
+                if (pending[i] == '\n') appendLog(line);
+                setStatus(line);
+            }
+            start = i + 1;
+        }
+        pending.erase(0, start);
+    }
+    if (!pending.empty()) appendLog(pending);
+    close(pipeFds[0]);
+
+    int exitStatus = 0;
+    waitpid(pid, &exitStatus, 0);
+    if (cancelRequested) return false;
+    if (!WIFEXITED(exitStatus) || WEXITSTATUS(exitStatus) != 0) {
+        int code = WIFEXITED(exitStatus) ? WEXITSTATUS(exitStatus) : -1;
+        setStatus("Pipeline failed (exit code " + std::to_string(code) + ")");
+        return false;
+    }
+    return true;
+}
+
+#else
+
+// Windows: output is streamed through _popen. The child cannot be killed
+// from here, so cancellation stops reading and takes effect when it exits.
+bool GrwmJobManager::runProcess(const Request& request, const std::string& outputDir) {
+    std::string cmd = "\"\"" + request.binaryPath + "\" \"" + request.meshPath
+        + "\" --output \"" + outputDir
+        + "\" --slots " + std::to_string(request.slotsPerFace)
+        + " --feature-threshold " + std::to_string(request.featureThreshold)
+        + " 2>&1\"";
+
+    FILE* pipe = _popen(cmd.c_str(), "r");
+    if (!pipe) {
+        setStatus("Failed to start " + request.binaryPath);
+        return false;
+    }
+
+    setStatus("Running...");
+    char line[1024];
+    while (!cancelRequested && fgets(line, sizeof(line), pipe)) {
+        std::string text(line);
+        while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) text.pop_back();
+        float p = parsePercent(text);
+        if (p >= 0.0f) progress = p;
+        appendLog(text);
+        setStatus(text);
+    }
+    int result = _pclose(pipe);
+    if (cancelRequested) return false;
+    if (result != 0) {
+        setStatus("Pipeline failed (exit code " + std::to_string(result) + ")");
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,274 @@
+#include "preprocess/GrwmPreprocessor.h"
+#include "core/Parallel.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <chrono>
+
+namespace {
+
+constexpr size_t kMinChunk = 2048;
+
+// R2 low-discrepancy sequence (Roberts 2018): successive points fill the unit
+// square evenly, so any prefix of a face's slots is well spread
+constexpr double kR2A1 = 0.7548776662466927;
+constexpr double kR2A2 = 0.5698402909980532;
+
+// Priority of the face-centre slot, above any sampled slot (matches cuda_preprocess)
+constexpr float kCenterSlotPriority = 1.0e6f;
+
+struct TriangleGeom {
+    glm::vec3 normal;   // unit normal, zero if degenerate
+    float     area;
+    float     cot[3];   // cotangent of the angle at each corner
+};
+
+void writeGrvpFile(const std::string& path, const PreprocessHeader& hdr,
+                   const void* payload, size_t payloadBytes) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) {
+        throw std::runtime_error("Failed to open for writing: " + path);
+    }
+    f.write(reinterpret_cast<const char*>(&hdr), sizeof(PreprocessHeader));
+    if (payloadBytes > 0) {
+        f.write(reinterpret_cast<const char*>(payload), static_cast<std::streamsize>(payloadBytes));
+    }
+    if (!f) {
+        throw std::runtime_error("Failed to write: " + path);
+    }
+}
+
+} // namespace
+
+GrwmResult GrwmPreprocessor::run(const NGonMesh& mesh, const GrwmSettings& settings,
+                                 const GrwmProgress* progress) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    auto stage = [progress](float fraction, const char* name) {
+        if (!progress) return;
+        if (progress->cancel && progress->cancel->load()) throw GrwmCancelled();
+        if (progress->report) progress->report(fraction, name);
+    };
+
+    GrwmResult result;
+    result.slotsPerFace = std::max(1u, settings.slotsPerFace);
+
+    // --- Original (unsplit) positions, as GRWM sees the source file ---
+    const bool hasSplitMap = mesh.originalVertexCount > 0
+                             && mesh.originalVertexIndices.size() == mesh.positions.size();
+    const uint32_t vertexCount = hasSplitMap
+        ? mesh.originalVertexCount
+        : static_cast<uint32_t>(mesh.positions.size());
+
+    std::vector<glm::vec3> positions(vertexCount, glm::vec3(0.0f));
+    auto toOriginal = [&](uint32_t v) -> uint32_t {
+        return hasSplitMap ? mesh.originalVertexIndices[v] : v;
+    };
+    for (size_t i = 0; i < mesh.positions.size(); i++)
+        positions[toOriginal(static_cast<uint32_t>(i))] = mesh.positions[i];
+
+    stage(0.0f, "triangulating");
+
+    // --- Fan triangulation: face of N verts -> N-2 consecutive triangles ---
+    std::vector<uint32_t> faceTriOffset(mesh.faces.size() + 1, 0);
+    for (size_t f = 0; f < mesh.faces.size(); f++) {
+        uint32_t n = static_cast<uint32_t>(mesh.faces[f].vertexIndices.size());
+        faceTriOffset[f + 1] = faceTriOffset[f] + (n >= 3 ? n - 2 : 0);
+    }
+    const uint32_t triCount = faceTriOffset.back();
+
+    std::vector<uint32_t> tris(size_t(triCount) * 3);
+    parallelFor(mesh.faces.size(), kMinChunk, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; f++) {
+            const auto& idx = mesh.faces[f].vertexIndices;
+            uint32_t t = faceTriOffset[f];
+            for (size_t k = 1; k + 1 < idx.size(); k++, t++) {
+                tris[t * 3 + 0] = toOriginal(idx[0]);
+                tris[t * 3 + 1] = toOriginal(idx[k]);
+                tris[t * 3 + 2] = toOriginal(idx[k + 1]);
+            }
+        }
+    });
+
+    stage(0.1f, "triangle geometry");
+
+    // --- Per-triangle normal, area and corner cotangents ---
+    std::vector<TriangleGeom> geom(triCount);
+    parallelFor(triCount, kMinChunk, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            const glm::vec3 p[3] = { positions[tris[t * 3]], positions[tris[t * 3 + 1]],
+                                     positions[tris[t * 3 + 2]] };
+            glm::vec3 c = glm::cross(p[1] - p[0], p[2] - p[0]);
+            float len = glm::length(c);
+            TriangleGeom& g = geom[t];
+            g.area = 0.5f * len;
+            g.normal = (len > 1e-20f) ? c / len : glm::vec3(0.0f);
+            for (int k = 0; k < 3; k++) {
+                glm::vec3 e1 = p[(k + 1) % 3] - p[k];
+                glm::vec3 e2 = p[(k + 2) % 3] - p[k];
+                g.cot[k] = (len > 1e-20f) ? glm::dot(e1, e2) / len : 0.0f;
+            }
+        }
+    });
+
+    // --- Vertex -> incident triangle corners (CSR) ---
+    std::vector<uint32_t> vertCornerOffset(size_t(vertexCount) + 1, 0);
+    for (uint32_t v : tris) vertCornerOffset[v + 1]++;
+    for (uint32_t v = 0; v < vertexCount; v++) vertCornerOffset[v + 1] += vertCornerOffset[v];
+    std::vector<uint32_t> vertCorners(tris.size());
+    {
+        std::vector<uint32_t> cursor(vertCornerOffset.begin(), vertCornerOffset.end() - 1);
+        for (uint32_t c = 0; c < tris.size(); c++) vertCorners[cursor[tris[c]]++] = c;
+    }
+
+    stage(0.25f, "curvature");
+
+    // --- Mean curvature: |cotangent Laplacian| / (4 * barycentric area) ---
+    result.curvature.assign(vertexCount, 0.0f);
+    parallelFor(vertexCount, kMinChunk, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            glm::vec3 lap(0.0f);
+            float area = 0.0f;
+            const glm::vec3 xi = positions[v];
+            for (uint32_t i = vertCornerOffset[v]; i < vertCornerOffset[v + 1]; i++) {
+                uint32_t corner = vertCorners[i];
+                uint32_t t = corner / 3, k = corner % 3;
+                const TriangleGeom& g = geom[t];
+                uint32_t kj = (k + 1) % 3, kk = (k + 2) % 3;
+                // Edge (i,j) is opposite corner kk, edge (i,k) opposite corner kj
+                lap += g.cot[kk] * (positions[tris[t * 3 + kj]] - xi)
+                     + g.cot[kj] * (positions[tris[t * 3 + kk]] - xi);
+                area += g.area / 3.0f;
+            }
+            result.curvature[v] = (area > 1e-20f) ? glm::length(lap) / (4.0f * area) : 0.0f;
+        }
+    });
+
+    stage(0.4f, "feature edges");
+
+    // --- Edges and dihedral-angle feature flags ---
+    struct EdgeRef {
+        uint64_t key;
+        uint32_t tri;
+    };
+    std::vector<EdgeRef> edges(tris.size());
+    parallelFor(triCount, kMinChunk, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            for (int k = 0; k < 3; k++) {
+                uint64_t a = tris[t * 3 + k], b = tris[t * 3 + (k + 1) % 3];
+                if (a > b) std::swap(a, b);
+                edges[t * 3 + k] = { (a << 32) | b, static_cast<uint32_t>(t) };
+            }
+        }
+    });
+    std::sort(edges.begin(), edges.end(), [](const EdgeRef& a, const EdgeRef& b) {
+        return a.key < b.key || (a.key == b.key && a.tri < b.tri);
+    });
+
+    const float cosThreshold = std::cos(glm::radians(settings.featureThresholdDeg));
+    result.featureFlags.assign(triCount, 0);
+    uint32_t edgeCount = 0;
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j].key == edges[i].key) j++;
+        edgeCount++;
+
+        bool feature = false;
+        if (j - i == 2) {
+            const glm::vec3& na = geom[edges[i].tri].normal;
+            const glm::vec3& nb = geom[edges[i + 1].tri].normal;
+            bool degenerate = (glm::dot(na, na) == 0.0f || glm::dot(nb, nb) == 0.0f);
+            feature = !degenerate && glm::dot(na, nb) < cosThreshold;
+        } else if (j - i > 2) {
+            feature = true;  // non-manifold edge
+        }
+        if (feature) {
+            for (size_t e = i; e < j; e++) result.featureFlags[edges[e].tri] = 1;
+        }
+        i = j;
+    }
+
+    stage(0.55f, "slots");
+
+    // --- Prioritized slots ---
+    // Slot 0 is the face-centre sentinel (the shader keeps that element at
+    // the face centre). The rest follow the R2 sequence folded into the
+    // triangle; priority in [0,1] mixes the interpolated curvature (relative
+    // to the median) with the sample's rank, so flat faces keep their
+    // low-discrepancy order and curved regions fill in first.
+    float medianCurvature = 0.0f;
+    if (vertexCount > 0) {
+        std::vector<float> sorted = result.curvature;
+        std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+        medianCurvature = sorted[sorted.size() / 2];
+    }
+    const float curvatureScale = (medianCurvature > 1e-6f) ? 1.0f / medianCurvature : 1.0f;
+
+    const uint32_t S = result.slotsPerFace;
+    std::vector<glm::vec2> pattern(S);
+    for (uint32_t s = 1; s < S; s++) {
+        float u = static_cast<float>(std::fmod(0.5 + s * kR2A1, 1.0));
+        float v = static_cast<float>(std::fmod(0.5 + s * kR2A2, 1.0));
+        if (u + v > 1.0f) { u = 1.0f - u; v = 1.0f - v; }
+        pattern[s] = glm::vec2(u, v);
+    }
+
+    result.slots.resize(size_t(triCount) * S);
+    parallelFor(triCount, kMinChunk / 8, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            float c0 = result.curvature[tris[t * 3]] * curvatureScale;
+            float c1 = result.curvature[tris[t * 3 + 1]] * curvatureScale;
+            float c2 = result.curvature[tris[t * 3 + 2]] * curvatureScale;
+
+            SlotEntry* out = &result.slots[t * S];
+            out[0] = { 0.5f, 0.5f, kCenterSlotPriority, 0u };
+            for (uint32_t s = 1; s < S; s++) {
+                float u = pattern[s].x, v = pattern[s].y;
+                float c = (1.0f - u - v) * c0 + u * c1 + v * c2;
+                float rank = 1.0f - static_cast<float>(s) / static_cast<float>(S);
+                out[s] = { u, v, 0.5f * c / (1.0f + c) + 0.5f * rank, s };
+            }
+            std::stable_sort(out + 1, out + S, [](const SlotEntry& a, const SlotEntry& b) {
+                return a.priority > b.priority;
+            });
+        }
+    });
+
+    stage(1.0f, "done");
+
+    result.vertexCount = vertexCount;
+    result.triangleCount = triCount;
+    result.edgeCount = edgeCount;
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    std::cout << "GRWM (CPU): " << vertexCount << " vertices, " << triCount << " triangles, "
+              << edgeCount << " edges, " << S << " slots/face in " << ms << " ms" << std::endl;
+
+    return result;
+}
+
+void GrwmPreprocessor::writeGrvp(const std::string& outputDir, const GrwmResult& result) {
+    std::filesystem::create_directories(outputDir);
+
+    PreprocessHeader hdr{};
+    hdr.magic = GRVP_MAGIC;
+    hdr.version = GRVP_VERSION_1;
+    hdr.vertex_count = result.vertexCount;
+    hdr.face_count = result.triangleCount;
+    hdr.edge_count = result.edgeCount;
+    hdr.slots_per_face = result.slotsPerFace;
+
+    std::filesystem::path dir(outputDir);
+    writeGrvpFile((dir / "curvature.bin").string(), hdr,
+                  result.curvature.data(), result.curvature.size() * sizeof(float));
+    writeGrvpFile((dir / "features.bin").string(), hdr,
+                  result.featureFlags.data(), result.featureFlags.size());
+    writeGrvpFile((dir / "slots.bin").string(), hdr,
+                  result.slots.data(), result.slots.size() * sizeof(SlotEntry));
+}
@@ -0,0 +1,121 @@
+#include "preprocess/GrwmRemap.h"
+#include "core/Parallel.h"
+#include "core/Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+std::vector<uint32_t> GrwmRemap::faceTriangleOffsets(const int* faceVertCounts, uint32_t nbFaces) {
+    std::vector<uint32_t> offsets(size_t(nbFaces) + 1);
+    offsets[0] = 0;
+    for (uint32_t i = 0; i < nbFaces; i++)
+        offsets[i + 1] = offsets[i] + static_cast<uint32_t>(faceVertCounts[i]) - 2;
+    return offsets;
+}
+
+void GrwmRemap::curvature(const float* curvature, const uint32_t* originalVertexIndices,
+                          uint32_t nbVertices, std::vector<float>& out) {
+    TRACE_ZONE("GrwmRemap::curvature");
+    out.resize(nbVertices);
+    parallelFor(nbVertices, 16384, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            out[i] = curvature[originalVertexIndices[i]];
+    });
+}
+
+void GrwmRemap::features(const uint32_t* triFlags, const std::vector<uint32_t>& faceTriOffset,
+                         std::vector<uint32_t>& out) {
+    TRACE_ZONE("GrwmRemap::features");
+    const size_t nbFaces = faceTriOffset.size() - 1;
+    out.resize(nbFaces);
+    parallelFor(nbFaces, 16384, [&](size_t begin, size_t end) {
+        for (size_t faceId = begin; faceId < end; faceId++) {
+            uint32_t flags = 0;
+            for (uint32_t t = faceTriOffset[faceId]; t < faceTriOffset[faceId + 1]; t++)
+                flags |= triFlags[t];
+            out[faceId] = flags;
+        }
+    });
+}
+
+void GrwmRemap::slots(const PackedSlot* triSlots, const uint16_t* triPriorities,
+                      uint32_t slotsPerFace, const std::vector<uint32_t>& faceTriOffset,
+                      std::vector<PackedSlot>& out) {
+    TRACE_ZONE("GrwmRemap::slots");
+    const size_t nbFaces = faceTriOffset.size() - 1;
+    out.resize(nbFaces * slotsPerFace);
+    std::atomic<size_t> unsortedTris{0};
+    parallelFor(nbFaces, 1024, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> cursor, order;  // per-thread, reused across faces
+        for (size_t faceId = begin; faceId < end; faceId++) {
+            uint32_t firstTri = faceTriOffset[faceId];
+            uint32_t numTris = faceTriOffset[faceId + 1] - firstTri;
+            PackedSlot* dst = &out[faceId * slotsPerFace];
+            const size_t inBase = size_t(firstTri) * slotsPerFace;
+
+            // The merge needs every child list in descending priority;
+            // otherwise sort this face's slots as a whole
+            bool sorted = true;
+            for (uint32_t t = 0; t < numTris; t++) {
+                const uint16_t* p = triPriorities + inBase + size_t(t) * slotsPerFace;
+                for (uint32_t s = 1; s < slotsPerFace; s++) {
+                    if (unpackSlotPriority(p[s]) > unpackSlotPriority(p[s - 1])) {
+                        sorted = false;
+                        unsortedTris.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+            if (!sorted) {
+                // Ties keep input order, as in the merge; NaN sorts last
+                auto priority = [&](uint32_t i) {
+                    float p = unpackSlotPriority(triPriorities[inBase + i]);
+                    return std::isnan(p) ? -std::numeric_limits<float>::infinity() : p;
+                };
+                order.resize(size_t(numTris) * slotsPerFace);
+                std::iota(order.begin(), order.end(), 0u);
+                std::partial_sort(order.begin(), order.begin() + slotsPerFace, order.end(),
+                    [&](uint32_t a, uint32_t b) {
+                        float pa = priority(a), pb = priority(b);
+                        return pa > pb || (pa == pb && a < b);
+                    });
+                for (uint32_t s = 0; s < slotsPerFace; s++) dst[s] = triSlots[inBase + order[s]];
+                continue;
+            }
+
+            if (numTris == 1) {
+                std::copy(triSlots + inBase, triSlots + inBase + slotsPerFace, dst);
+                continue;
+            }
+
+            cursor.assign(numTris, 0);
+            for (uint32_t s = 0; s < slotsPerFace; s++) {
+                int best = -1;
+                float bestPriority = 0.0f;
+                for (uint32_t t = 0; t < numTris; t++) {
+                    if (cursor[t] >= slotsPerFace) continue;
+                    float p = unpackSlotPriority(
+                        triPriorities[inBase + size_t(t) * slotsPerFace + cursor[t]]);
+                    if (best < 0 || p > bestPriority) {
+                        best = static_cast<int>(t);
+                        bestPriority = p;
+                    }
+                }
+                if (best < 0) {
+                    dst[s] = packSlotUV(0.5f, 0.5f);
+                    continue;
+                }
+                dst[s] = triSlots[inBase + size_t(best) * slotsPerFace + cursor[best]];
+                cursor[best]++;
+            }
+        }
+    });
+    if (size_t count = unsortedTris.load()) {
+        std::cerr << "  Warning: " << count << " GRWM triangles have slots out of priority"
+                  << " order; their faces were sorted on load" << std::endl;
+    }
+}
@@ -0,0 +1,162 @@
+#include "preprocess/SlotGenerator.h"
+#include "core/Parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// R2 low-discrepancy sequence, rotated per face so neighbouring faces differ
+constexpr double kR2A1 = 0.7548776662466927;
+constexpr double kR2A2 = 0.5698402909980532;
+
+float hashToUnit(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+}
+
+float pointSegmentDistSq(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b) {
+    glm::vec3 ab = b - a;
+    float len2 = glm::dot(ab, ab);
+    float t = (len2 > 1e-30f) ? std::clamp(glm::dot(p - a, ab) / len2, 0.0f, 1.0f) : 0.0f;
+    glm::vec3 d = p - (a + t * ab);
+    return glm::dot(d, d);
+}
+
+// Candidate pool as parallel arrays so the per-slot distance update vectorizes
+struct CandidatePool {
+    std::vector<float> u, v, x, y, z;
+    std::vector<float> weight;
+    std::vector<float> minDistSq;  // to the closest placed slot or boundary; < 0 once placed
+
+    explicit CandidatePool(size_t n)
+        : u(n), v(n), x(n), y(n), z(n), weight(n), minDistSq(n) {}
+};
+
+} // namespace
+
+std::vector<PackedSlot> SlotGenerator::generate(const Faces& faces, const Settings& settings) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    const size_t faceCount = faces.nbFaces;
+    const glm::vec3* positions = faces.vertexPositions;
+    const glm::vec3* normals = faces.vertexNormals;
+    const uint32_t* faceVertOffsets = faces.faceVertOffsets;
+    const uint32_t* faceVertIndices = faces.faceVertIndices;
+    const uint32_t S = std::max(1u, settings.slotsPerFace);
+    const uint32_t C = S * std::max(1u, settings.candidatesPerSlot);
+    const bool hasNormals = normals != nullptr;
+    const PackedSlot center = packSlotUV(0.5f, 0.5f);
+
+    std::vector<PackedSlot> slots(faceCount * S, center);
+
+    parallelFor(faceCount, 256, [&](size_t begin, size_t end) {
+        CandidatePool pool(C);  // per-thread scratch
+        for (size_t f = begin; f < end; f++) {
+            const uint32_t first = faceVertOffsets[f];
+            const uint32_t count = faceVertOffsets[f + 1] - first;
+            if (count < 3) continue;
+
+            const uint32_t* idx = &faceVertIndices[first];
+            const bool isTri = (count == 3);
+            glm::vec3 p[4], n[4];
+            for (uint32_t k = 0; k < 4; k++) {
+                uint32_t vi = idx[std::min(k, count - 1)];
+                p[k] = positions[vi];
+                n[k] = hasNormals ? normals[vi] : glm::vec3(0.0f);
+            }
+            glm::vec3 faceCenter(0.0f);
+            for (uint32_t k = 0; k < count; k++) faceCenter += positions[idx[k]];
+            faceCenter /= static_cast<float>(count);
+            glm::vec3 faceNormal = glm::cross(p[1] - p[0], p[2] - p[0]);
+            if (!isTri) faceNormal += glm::cross(p[2] - p[0], p[3] - p[0]);
+            float fnLen = glm::length(faceNormal);
+            faceNormal = (fnLen > 1e-20f) ? faceNormal / fnLen : glm::vec3(0.0f);
+
+            // Candidate pool in the shader's parameterisation
+            const float rotU = hashToUnit(static_cast<uint32_t>(f) * 2u + 1u);
+            const float rotV = hashToUnit(static_cast<uint32_t>(f) * 2u + 2u);
+            float maxBend = 0.0f;
+            for (uint32_t c = 0; c < C; c++) {
+                float u = static_cast<float>(std::fmod(rotU + (c + 1) * kR2A1, 1.0));
+                float v = static_cast<float>(std::fmod(rotV + (c + 1) * kR2A2, 1.0));
+                glm::vec3 pos, nrm;
+                if (isTri) {
+                    if (u + v > 1.0f) { u = 1.0f - u; v = 1.0f - v; }
+                    float w = 1.0f - u - v;
+                    pos = w * p[0] + u * p[1] + v * p[2];
+                    nrm = w * n[0] + u * n[1] + v * n[2];
+                } else {
+                    float w0 = (1.0f - u) * (1.0f - v), w1 = u * (1.0f - v);
+                    float w2 = u * v, w3 = (1.0f - u) * v;
+                    pos = w0 * p[0] + w1 * p[1] + w2 * p[2] + w3 * p[3];
+                    nrm = w0 * n[0] + w1 * n[1] + w2 * n[2] + w3 * n[3];
+                }
+                float nLen = glm::length(nrm);
+                float bend = (nLen > 1e-20f) ? 1.0f - glm::dot(nrm / nLen, faceNormal) : 0.0f;
+                maxBend = std::max(maxBend, bend);
+
+                // Neighbouring faces place their own slots just across each
+                // edge, so treat the boundary as a mirrored slot (2x distance)
+                glm::vec3 d = pos - faceCenter;
+                float distSq = glm::dot(d, d);
+                uint32_t edgeCount = isTri ? 3 : 4;
+                for (uint32_t e = 0; e < edgeCount; e++)
+                    distSq = std::min(distSq, 4.0f * pointSegmentDistSq(pos, p[e], p[(e + 1) % edgeCount]));
+                pool.u[c] = u;
+                pool.v[c] = v;
+                pool.x[c] = pos.x;
+                pool.y[c] = pos.y;
+                pool.z[c] = pos.z;
+                pool.weight[c] = bend;
+                pool.minDistSq[c] = distSq;
+            }
+
+            // Bend normalised per face, so the bias picks where in the face
+            // to densify rather than depending on the mesh's tessellation
+            for (uint32_t c = 0; c < C; c++) {
+                float bend = (maxBend > 1e-6f) ? pool.weight[c] / maxBend : 0.0f;
+                pool.weight[c] = 1.0f + settings.curvatureBias * bend;
+            }
+
+            // Slot 0 is the face centre sentinel; the rest by best candidate
+            PackedSlot* out = &slots[f * S];
+            float* md = pool.minDistSq.data();
+            const float* px = pool.x.data();
+            const float* py = pool.y.data();
+            const float* pz = pool.z.data();
+            const float* pw = pool.weight.data();
+            // One pass per slot folds in the last pick and finds the next one;
+            // placed candidates stay negative since min(-1, d) = -1
+            uint32_t best = 0;
+            float bestScore = -1.0f;
+            for (uint32_t c = 0; c < C; c++) {
+                float score = md[c] * pw[c];
+                if (score > bestScore) { bestScore = score; best = c; }
+            }
+            for (uint32_t s = 1; s < S && bestScore >= 0.0f; s++) {
+                out[s] = packSlotUV(pool.u[best], pool.v[best]);
+                const float cx = px[best], cy = py[best], cz = pz[best];
+                md[best] = -1.0f;
+
+                bestScore = -1.0f;
+                for (uint32_t c = 0; c < C; c++) {
+                    float dx = px[c] - cx, dy = py[c] - cy, dz = pz[c] - cz;
+                    md[c] = std::min(md[c], dx * dx + dy * dy + dz * dz);
+                    float score = md[c] * pw[c];
+                    if (score > bestScore) { bestScore = score; best = c; }
+                }
+            }
+        }
+    });
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    std::cout << "  Generated slots: " << faceCount << " faces x " << S
+              << " slots in " << ms << " ms" << std::endl;
+    return slots;
+}
@@ -3,30 +3,35 @@
 #include <iostream>
 
 void MeshExportBuffers::allocate(VkDevice device, VkPhysicalDevice physDevice,
-                                  uint32_t numVerts, uint32_t numTris,
-                                  const std::vector<ExportElementOffset>& elementOffsets) {
+                                  uint32_t numVerts, uint32_t numTris, uint32_t numElements) {
     totalVertices = numVerts;
     totalTriangles = numTris;
+    maxElements = numElements;
 
     if (numVerts == 0 || numTris == 0) {
         throw std::runtime_error("MeshExportBuffers: zero vertices or triangles");
     }
 
-    positions.create(device, physDevice, numVerts * sizeof(glm::vec4));
-    normals.create(device, physDevice, numVerts * sizeof(glm::vec4));
-    uvs.create(device, physDevice, numVerts * sizeof(glm::vec2));
-    indices.create(device, physDevice, numTris * 3 * sizeof(uint32_t));
-    offsets.create(device, physDevice,
-                   elementOffsets.size() * sizeof(ExportElementOffset),
-                   elementOffsets.data());
+    positions.create(device, physDevice, size_t(numVerts) * sizeof(glm::vec4));
+    normals.create(device, physDevice, size_t(numVerts) * sizeof(glm::vec4));
+    uvs.create(device, physDevice, size_t(numVerts) * sizeof(glm::vec2));
+    indices.create(device, physDevice, size_t(numTris) * 3 * sizeof(uint32_t));
+    offsets.create(device, physDevice, numElements * sizeof(ExportElementOffset));
 
     std::cout << "Export buffers allocated: " << numVerts << " verts, "
               << numTris << " tris ("
-              << (numVerts * (sizeof(glm::vec4) * 2 + sizeof(glm::vec2))
-                  + numTris * 3 * sizeof(uint32_t)) / (1024 * 1024)
+              << (size_t(numVerts) * (sizeof(glm::vec4) * 2 + sizeof(glm::vec2))
+                  + size_t(numTris) * 3 * sizeof(uint32_t)) / (1024 * 1024)
               << " MB)" << std::endl;
 }
 
+void MeshExportBuffers::setOffsets(const std::vector<ExportElementOffset>& elementOffsets) {
+    if (elementOffsets.size() > maxElements) {
+        throw std::runtime_error("MeshExportBuffers: batch exceeds allocated element count");
+    }
+    offsets.update(elementOffsets.data(), elementOffsets.size() * sizeof(ExportElementOffset));
+}
+
 void MeshExportBuffers::destroy() {
     positions.destroy();
     normals.destroy();
@@ -35,4 +40,5 @@ void MeshExportBuffers::destroy() {
     offsets.destroy();
     totalVertices = 0;
     totalTriangles = 0;
+    maxElements = 0;
 }
@@ -0,0 +1,425 @@
+#include "renderer/MeshPackage.h"
+#include "loaders/ObjLoader.h"
+#include "loaders/TextureCache.h"
+#include "preprocess/GrvpFile.h"
+#include "preprocess/GrwmRemap.h"
+#include "core/JobSystem.h"
+#include "core/Trace.h"
+#include <tiny_gltf.h>
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <exception>
+
+void CpuMeshCopies::addBuildNodes(TaskGraph& graph, const HalfEdgeMesh& mesh) {
+    graph.add("CpuMeshCopies: face copies", [this, &mesh] {
+        faceCenters.resize(mesh.nbFaces);
+        faceNormals.resize(mesh.nbFaces);
+        faceAreas.assign(mesh.faceAreas.begin(), mesh.faceAreas.end());
+        faceVertCounts.assign(mesh.faceVertCounts.begin(), mesh.faceVertCounts.end());
+        for (uint32_t i = 0; i < mesh.nbFaces; i++) {
+            faceCenters[i] = glm::vec3(mesh.faceCenters[i]);
+            faceNormals[i] = glm::vec3(mesh.faceNormals[i]);
+        }
+        faceUVs.resize(mesh.nbFaces);
+        for (uint32_t i = 0; i < mesh.nbFaces; i++) {
+            // Mirror GPU logic: face baseUV = texcoord of first vertex of face
+            int edge = mesh.faceEdges[i];
+            uint32_t firstVert = static_cast<uint32_t>(mesh.heVertex[edge]);
+            faceUVs[i] = mesh.vertexTexCoords[firstVert];
+        }
+    });
+    graph.add("CpuMeshCopies: face corners", [this, &mesh] {
+        // Face corners in half-edge order (corner 0 = faceEdges vertex), as the task shader walks them
+        faceVertOffsets.resize(size_t(mesh.nbFaces) + 1);
+        faceVertIndices.clear();
+        for (uint32_t i = 0; i < mesh.nbFaces; i++) {
+            faceVertOffsets[i] = static_cast<uint32_t>(faceVertIndices.size());
+            int first = mesh.faceEdges[i];
+            int edge = first;
+            do {
+                faceVertIndices.push_back(static_cast<uint32_t>(mesh.heVertex[edge]));
+                edge = mesh.heNext[edge];
+            } while (edge != first && edge >= 0);
+        }
+        faceVertOffsets[mesh.nbFaces] = static_cast<uint32_t>(faceVertIndices.size());
+    });
+    graph.add("CpuMeshCopies: vertex copies", [this, &mesh] {
+        vertexPositions.resize(mesh.nbVertices);
+        vertexNormals.resize(mesh.nbVertices);
+        vertexFaceAreas.resize(mesh.nbVertices);
+        vertexUVs.resize(mesh.nbVertices);
+        for (uint32_t i = 0; i < mesh.nbVertices; i++) {
+            vertexPositions[i] = glm::vec3(mesh.vertexPositions[i]);
+            vertexNormals[i]   = glm::vec3(mesh.vertexNormals[i]);
+            int edge = mesh.vertexEdges[i];
+            vertexFaceAreas[i] = (edge >= 0) ? mesh.faceAreas[mesh.heFace[edge]] : 0.0f;
+            vertexUVs[i] = mesh.vertexTexCoords[i];
+        }
+    });
+    graph.add("CpuMeshCopies: element frames", [this, &mesh] {
+        elementFrames = ParametricSurface::buildFrames(mesh);
+    });
+}
+
+GrwmPreprocessData GrwmPreprocessData::read(const std::string& meshPath,
+                                            uint32_t nbVertices, uint32_t nbFaces,
+                                            const int* faceVertCounts,
+                                            const uint32_t* originalVertexIndices,
+                                            size_t originalVertexIndexCount,
+                                            uint32_t originalVertexCount) {
+    TRACE_ZONE("GrwmPreprocessData::read");
+    GrwmPreprocessData data;
+
+    std::string dir = meshPath.substr(0, meshPath.find_last_of("/\\") + 1);
+    std::string preprocessDir = dir + "preprocess/";
+
+    if (!std::filesystem::is_directory(preprocessDir)) {
+        std::cout << "  No preprocess directory found at " << preprocessDir << std::endl;
+        return data;
+    }
+
+    // v2 container is mmapped; v1 files are each read once. Kept open in
+    // data, since unremapped arrays are uploaded from it directly.
+    GrvpFile& grvp = data.source;
+    try {
+        if (!grvp.open(preprocessDir)) {
+            std::cerr << "  Warning: GRWM preprocess files missing" << std::endl;
+            return data;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "  Warning: " << e.what() << std::endl;
+        return data;
+    }
+
+    // Check if we need vertex remapping (split vertices from UV/normal seams)
+    bool needsVertexRemap = (grvp.vertexCount != nbVertices)
+                            && originalVertexIndexCount > 0
+                            && grvp.vertexCount == originalVertexCount;
+
+    if (grvp.vertexCount != nbVertices && !needsVertexRemap) {
+        std::cerr << "  Warning: curvature vertex count (" << grvp.vertexCount
+                  << ") != mesh (" << nbVertices << ")" << std::endl;
+        return data;
+    }
+
+    // Determine if we need tri->ngon remapping.
+    // GRWM always triangulates, so its face_count may differ from ours.
+    bool needsRemap = (grvp.faceCount != nbFaces);
+
+    // face -> first GRWM triangle, shared by the feature and slot remaps below
+    std::vector<uint32_t> faceTriOffset;
+    if (needsRemap) {
+        // Verify the triangle count is consistent: each original face of N verts
+        // produces (N-2) triangles. Sum should equal GRWM face count.
+        faceTriOffset = GrwmRemap::faceTriangleOffsets(faceVertCounts, nbFaces);
+        uint32_t expectedTriCount = faceTriOffset[nbFaces];
+
+        if (expectedTriCount != grvp.faceCount) {
+            std::cerr << "  Warning: GRWM face count (" << grvp.faceCount
+                      << ") != expected triangulated count (" << expectedTriCount
+                      << ") from " << nbFaces << " original faces" << std::endl;
+            return data;
+        }
+        std::cout << "  Remapping GRWM data: " << grvp.faceCount << " triangles -> "
+                  << nbFaces << " original faces" << std::endl;
+    }
+
+    // --- Curvature (per-vertex, remap if vertices were split at UV/normal seams) ---
+    if (needsVertexRemap) {
+        GrwmRemap::curvature(grvp.curvature(), originalVertexIndices, nbVertices, data.remappedCurvature);
+        data.curvature = data.remappedCurvature;
+        std::cout << "  Remapping curvature: " << grvp.vertexCount
+                  << " original -> " << nbVertices << " split vertices" << std::endl;
+    } else {
+        data.curvature = {grvp.curvature(), nbVertices};
+    }
+    if (!data.curvature.empty()) {
+        // Median curvature for normalization
+        std::vector<float> sorted(data.curvature.begin(), data.curvature.end());
+        std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+        float median = sorted[sorted.size() / 2];
+        data.curvatureScale = (median > 1e-6f) ? (1.0f / median) : 1.0f;
+        std::cout << "  Loaded curvature (" << grvp.vertexCount
+                  << " vertices, median=" << median << ")" << std::endl;
+    }
+
+    // --- Features (per-face, remap: OR child triangle flags) ---
+    if (needsRemap) {
+        GrwmRemap::features(grvp.features(), faceTriOffset, data.remappedFeatures);
+        data.features = data.remappedFeatures;
+    } else {
+        data.features = {grvp.features(), nbFaces};
+    }
+    std::cout << "  Loaded features (" << nbFaces << " faces)" << std::endl;
+
+    // --- Slots (per-face, remap: merge child triangle slots, sort, keep top N) ---
+    // GPU slots are packed unorm16 u,v (4 bytes); priorities stay on the CPU
+    data.slotsPerFace = grvp.slotsPerFace;
+    if (needsRemap) {
+        GrwmRemap::slots(grvp.slots(), grvp.slotPriorities(), data.slotsPerFace, faceTriOffset, data.remappedSlots);
+        data.slots = data.remappedSlots;
+    } else {
+        data.slots = {grvp.slots(), size_t(nbFaces) * data.slotsPerFace};
+    }
+    std::cout << "  Loaded slots (" << nbFaces << " faces x "
+              << data.slotsPerFace << " slots, GRVP v" << grvp.version << ")" << std::endl;
+
+    data.version = grvp.version;
+    // Every array was copied by a remap; nothing points into the file
+    if (needsRemap && needsVertexRemap) grvp.close();
+    data.loaded = true;
+    return data;
+}
+
+namespace {
+
+// Texture files the renderer picks up next to the mesh; paths left empty
+// when absent. The first existing candidate of each list wins.
+void findTextures(MeshPackage& package, const std::string& dir) {
+    auto& textures = package.textures;
+    auto pick = [&](MeshPackage::TextureSlot slot, const std::vector<std::string>& candidates) {
+        for (const auto& candidate : candidates) {
+            if (std::filesystem::exists(candidate)) {
+                textures[slot].path = candidate;
+                return;
+            }
+        }
+    };
+    std::string filename = package.path.substr(package.path.find_last_of("/\\") + 1);
+    std::string stem = std::filesystem::path(package.path).stem().string();
+
+    // AO texture name depends on the mesh filename
+    if (filename.find("dragon_coat") != std::string::npos) {
+        pick(MeshPackage::Ao, {dir + "dragon_coat_ao.png"});
+    } else if (filename.find("dragon") != std::string::npos) {
+        // Note: the AO file is named "dargon_ao.png" (typo in asset)
+        pick(MeshPackage::Ao, {dir + "dargon_ao.png"});
+    }
+
+    // Element type map (shared across dragon meshes)
+    pick(MeshPackage::ElementType, {dir + "dragon_element_type_map_2k.png"});
+    // Per-face generation mask
+    pick(MeshPackage::Mask, {dir + "mask.png"});
+    pick(MeshPackage::Skin, {dir + "skin.png"});
+    pick(MeshPackage::Diffuse, {
+        dir + "diffuse.png", dir + "color.png", dir + "albedo.png",
+        dir + stem + "_diffuse.png", dir + stem + "_color.png", dir + stem + "_albedo.png",
+        dir + "diffuse.jpg", dir + "color.jpg", dir + "albedo.jpg",
+        dir + stem + "_diffuse.jpg", dir + stem + "_color.jpg", dir + stem + "_albedo.jpg",
+    });
+    pick(MeshPackage::Normal, {
+        dir + "normal.png", dir + "normals.png",
+        dir + stem + "_normal.png", dir + stem + "_normals.png",
+        dir + "normal.jpg", dir + "normals.jpg",
+        dir + stem + "_normal.jpg", dir + stem + "_normals.jpg",
+    });
+    // Occlusion/Roughness/Metallic packed in R/G/B
+    pick(MeshPackage::Orm, {
+        dir + "orm.png", dir + "ORM.png",
+        dir + stem + "_orm.png", dir + stem + "_ORM.png",
+        dir + "orm.jpg", dir + "ORM.jpg",
+        dir + stem + "_orm.jpg", dir + stem + "_ORM.jpg",
+    });
+}
+
+// Skeleton, animations and bake; for an OBJ + glTF pair also the joint data
+// and UVs recovered by spatial matching (written into the half-edge mesh)
+void loadSkeleton(MeshPackage& package, const NGonMesh& ngon, tinygltf::Model& nativeModel,
+                  const MeshPackage::Settings& settings) {
+    const std::string& path = package.path;
+
+    // Auto-detect glTF skeleton (same name as OBJ, or any .gltf in same directory)
+    std::string baseName = path.substr(0, path.find_last_of('.'));
+    std::string gltfPath = package.gltfNative ? path : baseName + ".gltf";
+    if (!std::filesystem::exists(gltfPath)) {
+        // Fallback: search directory for any .gltf file
+        std::string gltfDir = path.substr(0, path.find_last_of("/\\") + 1);
+        if (!gltfDir.empty()) {
+            for (const auto& entry : std::filesystem::directory_iterator(gltfDir)) {
+                if (entry.path().extension() == ".gltf") {
+                    gltfPath = entry.path().string();
+                    break;
+                }
+            }
+        }
+    }
+    bool gltfExists = std::filesystem::exists(gltfPath);
+    std::cout << "  glTF path check: " << gltfPath << " exists=" << gltfExists << std::endl;
+    if (!gltfExists) {
+        std::cout << "  No glTF file found for skeleton" << std::endl;
+        return;
+    }
+    // Native per-vertex skin data does not survive any subdivision
+    bool skinTopologyChanged = settings.subdivideLevel > 0
+                            || (package.gltfNative && settings.subdivideFlatLevel > 0);
+    if (skinTopologyChanged) {
+        std::cout << "  Skipping glTF skeleton (subdivided mesh)" << std::endl;
+        package.jointIndices.clear();
+        package.jointWeights.clear();
+        return;
+    }
+
+    std::cout << "  Loading glTF skeleton: " << gltfPath << std::endl;
+    TRACE_ZONE("MeshPackage: skeleton");
+    try {
+        tinygltf::Model gltfModel = package.gltfNative ? std::move(nativeModel)
+                                                       : GltfLoader::loadModel(gltfPath);
+        std::cout << "  glTF model loaded OK" << std::endl;
+        GltfLoader::extractSkeleton(gltfModel, package.skeleton);
+        std::cout << "  Skeleton extracted: " << package.skeleton.bones.size() << " bones" << std::endl;
+        GltfLoader::extractAnimations(gltfModel, package.skeleton, package.animations);
+        std::cout << "  Animations extracted: " << package.animations.size() << std::endl;
+        package.skinningBytes = package.skeleton.sizeBytes();
+        for (const Animation& animation : package.animations) package.skinningBytes += animation.sizeBytes();
+
+        // OBJ + glTF pair: recover joints and UVs by spatial matching
+        if (!package.gltfNative) {
+            TRACE_ZONE("MeshPackage: bone and UV transfer");
+            // One k-d tree match shared by bone and UV transfer
+            GltfVertexMatch vertexMatch;
+            GltfLoader::buildVertexMatch(gltfModel, ngon.positions, package.skeleton, vertexMatch);
+            GltfLoader::matchBoneDataToObjMesh(gltfModel, vertexMatch,
+                                                package.jointIndices, package.jointWeights);
+            std::cout << "  Bone matching done" << std::endl;
+
+            // OBJ has no UVs: take them from the glTF before the upload
+            std::vector<glm::vec2> gltfUVs;
+            GltfLoader::matchUVsToObjMesh(gltfModel, vertexMatch, gltfUVs);
+            bool hasUVs = std::any_of(gltfUVs.begin(), gltfUVs.end(),
+                                      [](const glm::vec2& uv) { return uv.x != 0.0f || uv.y != 0.0f; });
+            if (hasUVs) {
+                HEVector<glm::vec2>& texCoords = package.mesh.vertexTexCoords;
+                size_t count = std::min(gltfUVs.size(), texCoords.size());
+                std::copy(gltfUVs.begin(), gltfUVs.begin() + count, texCoords.begin());
+                std::cout << "  UVs taken from glTF data" << std::endl;
+            }
+        }
+
+        // After the match: it sets the OBJ alignment the baked matrices carry
+        size_t budget = size_t(std::max(settings.bakeBudgetMB, 0)) * 1024 * 1024;
+        GltfLoader::bakeAnimations(package.animations, package.skeleton, settings.bakeRate,
+                                   budget, package.bakedAnimations);
+        package.hasSkeleton = true;
+    } catch (const std::exception& e) {
+        std::cerr << "  glTF loading error: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "  glTF loading: unknown exception" << std::endl;
+    }
+    if (!package.hasSkeleton) {
+        package.skeleton = Skeleton{};
+        package.animations.clear();
+        package.bakedAnimations.clear();
+        package.skinningBytes = 0;
+    }
+}
+
+} // namespace
+
+bool MeshPackage::prepare(const std::string& meshPath, const Settings& settings,
+                          const std::atomic<bool>& cancel) {
+    TRACE_ZONE("MeshPackage::prepare");
+    auto cancelled = [&] { return cancel.load(std::memory_order_relaxed); };
+    JobSystem& jobs = JobSystem::get();
+    path = meshPath;
+    std::string dir = path.substr(0, path.find_last_of("/\\") + 1);
+
+    // Textures do not depend on the geometry: decode them alongside it,
+    // each on its own task
+    findTextures(*this, dir);
+    TaskGraph decode;
+    for (Texture& texture : textures) {
+        if (texture.path.empty()) continue;
+        decode.add("MeshPackage: decode texture", [&texture, &cancel, &settings] {
+            if (cancel.load(std::memory_order_relaxed)) return;
+            try {
+                texture.image = TextureCache::load(texture.path, settings.textureCacheDir);
+            } catch (const std::exception& e) {
+                std::cerr << "  Warning: " << e.what() << std::endl;
+            }
+        });
+    }
+    decode.start(jobs);
+
+    // Native glTF/GLB: geometry, UVs and skin weights come straight from the
+    // file, so no OBJ counterpart or spatial matching pass is needed
+    std::string meshExt = std::filesystem::path(path).extension().string();
+    std::transform(meshExt.begin(), meshExt.end(), meshExt.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    gltfNative = (meshExt == ".gltf" || meshExt == ".glb");
+    tinygltf::Model nativeModel;
+    NGonMesh ngon;
+    {
+        TRACE_ZONE("MeshPackage: geometry");
+        if (gltfNative) {
+            nativeModel = GltfLoader::loadModel(path);
+            ngon = GltfLoader::loadMesh(nativeModel, jointIndices, jointWeights);
+        } else {
+            ngon = ObjLoader::load(path);
+        }
+        if (settings.triangulate) {
+            ObjLoader::triangulate(ngon);
+        }
+        if (settings.subdivideLevel > 0) {
+            ObjLoader::subdivide(ngon, settings.subdivideLevel);
+        }
+        if (settings.subdivideFlatLevel > 0) {
+            ObjLoader::subdivideFlat(ngon, settings.subdivideFlatLevel);
+        }
+    }
+    if (cancelled()) return false;
+    // Kept until the skeleton pass below has matched against it
+    MemoryTracker::Charge ngonCharge(MemTag::MeshLoad, ngon.sizeBytes());
+
+    // Vertex split mapping from before the half-edge build, for GRWM curvature remapping
+    originalVertexIndices.assign(ngon.originalVertexIndices.begin(), ngon.originalVertexIndices.end());
+    originalVertexCount = ngon.originalVertexCount;
+
+    mesh = HalfEdgeBuilder::build(ngon);
+    computeFace2Coloring(mesh);
+    if (cancelled()) return false;
+
+    // May replace the mesh UVs, so it runs before the CPU copies are taken
+    loadSkeleton(*this, ngon, nativeModel, settings);
+    if (cancelled()) return false;
+
+    {
+        TaskGraph copyGraph;
+        copies.addBuildNodes(copyGraph, mesh);
+        copyGraph.run(jobs);
+    }
+
+    // GRWM preprocessed data if available, else built-in slots
+    preprocess = GrwmPreprocessData::read(path, mesh.nbVertices, mesh.nbFaces,
+                                          copies.faceVertCounts.data(),
+                                          originalVertexIndices.data(), originalVertexIndices.size(),
+                                          originalVertexCount);
+    if (!preprocess.loaded && settings.generateSlots) {
+        SlotGenerator::Faces faces;
+        faces.vertexPositions = copies.vertexPositions.data();
+        faces.vertexNormals = copies.vertexNormals.data();
+        faces.faceVertOffsets = copies.faceVertOffsets.data();
+        faces.faceVertIndices = copies.faceVertIndices.data();
+        faces.nbFaces = mesh.nbFaces;
+        generatedSlots = SlotGenerator::generate(faces, settings.slotSettings);
+        if (!generatedSlots.empty()) generatedSlotsPerFace = settings.slotSettings.slotsPerFace;
+    }
+
+    decode.wait(jobs);
+    const ImageData& mask = textures[Mask].image;
+    if (!mask.pixels.empty()) {
+        // Keep CPU copy of mask R channel for stats
+        maskWidth = mask.width;
+        maskHeight = mask.height;
+        maskPixels.resize(size_t(mask.width) * mask.height);
+        for (size_t i = 0; i < maskPixels.size(); i++)
+            maskPixels[i] = mask.pixels[i * 4];
+    }
+
+    // Coat mesh alongside (e.g. dragon_coat.obj next to dragon.obj)
+    std::string coat = dir + "dragon_coat.obj";
+    if (std::filesystem::exists(coat)) coatPath = coat;
+
+    return !cancelled();
+}
@@ -3,7 +3,9 @@
 #include "loaders/ObjWriter.h"
 #include "loaders/ObjLoader.h"
 #include "loaders/GltfLoader.h"
+#include "geometry/ElementCull.h"
 #include "core/window.h"
+#include "core/Trace.h"
 #include "imgui.h"
 #include "imgui_impl_vulkan.h"
 #include <stb_image.h>
@@ -14,6 +16,7 @@
 #include <cstring>
 #include <cmath>
 #include <chrono>
+#include <algorithm>
 
 Renderer::Renderer(Window& window) : window(window) {
     createInstance();
@@ -76,10 +79,12 @@ Renderer::Renderer(Window& window) : window(window) {
 }
 
 Renderer::~Renderer() {
+    cancelMeshLoads();
     vkDeviceWaitIdle(device);
     cleanupImGui();
     if (statsQueryPool != VK_NULL_HANDLE)
         vkDestroyQueryPool(device, statsQueryPool, nullptr);
+    destroyProceduralExport();
     cleanupExportPipelines();
     cleanupBenchmarkMesh();
     cleanupGroundMesh();
@@ -207,28 +212,55 @@ Renderer::~Renderer() {
 }
 
 void Renderer::beginFrame() {
+    TRACE_ZONE("Renderer::beginFrame");
+    // Mesh loads are prepared in the background while the current mesh keeps
+    // rendering, then committed here (not while an export still reads it)
+    if (!pendingMeshLoad.empty()) {
+        loadMesh(pendingMeshLoad);
+        meshLoad->preset = pendingPreset;
+        pendingMeshLoad.clear();
+        pendingPreset = nullptr;
+    }
+    if (!loadingActive) pollMeshLoad();
+
     // Check if any heavy operation is pending — show loading overlay first frame,
     // then do the actual work on the next frame
-    bool hasPendingWork = !pendingMeshLoad.empty() ||
-                          (!pendingBenchmarkLoad.empty() && pendingBenchmarkLoad != "__unload__") ||
+    bool hasPendingWork = (!pendingBenchmarkLoad.empty() && pendingBenchmarkLoad != "__unload__") ||
                           pendingExport;
 
     if (hasPendingWork && !loadingActive) {
         // First frame: just set loading flag, let this frame render the overlay
         loadingActive = true;
         loadingFrameCount = 0;
-        if (!pendingMeshLoad.empty())
-            loadingMessage = "Loading mesh...";
-        else if (!pendingBenchmarkLoad.empty())
+        if (!pendingBenchmarkLoad.empty())
             loadingMessage = "Loading benchmark mesh...";
         else if (pendingExport)
             loadingMessage = "Exporting mesh...";
         loadingStartTime = static_cast<float>(glfwGetTime());
+        loadingProgress = -1.0f;
         // Don't process the work yet — fall through to render a frame with the overlay
     } else if (loadingActive && loadingFrameCount < 2) {
         // Wait for overlay to be visible on screen (need 2 frames: render + present)
         loadingFrameCount++;
         // Fall through to render another frame with the overlay
+    } else if (loadingActive && exportJob.active) {
+        // Batched export spans frames: write for part of a frame, then let
+        // the overlay redraw with the new progress
+        try {
+            if (stepProceduralExport(EXPORT_FRAME_BUDGET_MS)) {
+                lastExportStatus = "Exported: " + exportFilePath;
+            }
+        } catch (const std::exception& e) {
+            destroyProceduralExport();
+            lastExportStatus = std::string("Export failed: ") + e.what();
+        }
+        if (exportJob.active) {
+            loadingProgress = static_cast<float>(exportJob.elementsWritten) / exportJob.numElements;
+            loadingMessage = "Exporting mesh... " + std::to_string(exportJob.elementsWritten)
+                           + " / " + std::to_string(exportJob.numElements) + " elements";
+        } else {
+            finishLoadingOverlay();
+        }
     } else if (loadingActive) {
         // Overlay has been shown for 2 frames, now do the actual work
         if (pendingGroundRegenerate) {
@@ -237,31 +269,6 @@ void Renderer::beginFrame() {
             generateGroundPlane(groundPlaneCellSize);
         }
 
-        if (!pendingMeshLoad.empty()) {
-            std::string path = std::move(pendingMeshLoad);
-            pendingMeshLoad.clear();
-            loadMesh(path);
-
-            if (pendingPreset) {
-                doSkinning = pendingPreset->doSkinning;
-                animationPlaying = pendingPreset->animationPlaying;
-                animationSpeed = pendingPreset->animationSpeed;
-                baseMeshMode = pendingPreset->baseMeshMode;
-                if (pendingPreset->chainmailMode) {
-                    applyPresetChainMail();
-                }
-                if (pendingPreset->enableDragonCoat && dragonCoatAvailable) {
-                    dragonCoatEnabled = true;
-                    loadSecondaryMesh(dragonCoatPath);
-                }
-                if (pendingPreset->applyDragonScales) {
-                    applyPresetDragonScales();
-                    dragonBaseMeshMode = 2;  // Solid
-                }
-                pendingPreset = nullptr;
-            }
-        }
-
         if (!pendingBenchmarkLoad.empty()) {
             std::string path = std::move(pendingBenchmarkLoad);
             pendingBenchmarkLoad.clear();
@@ -281,27 +288,35 @@ void Renderer::beginFrame() {
                 if (pos != std::string::npos) {
                     std::filesystem::create_directories(exportFilePath.substr(0, pos));
                 }
-                exportProceduralMesh(exportFilePath, exportMode);
-                lastExportStatus = "Exported: " + exportFilePath;
+                // Batches are written over the following frames
+                beginProceduralExport(exportFilePath, exportMode);
+                loadingProgress = 0.0f;
             } catch (const std::exception& e) {
                 lastExportStatus = std::string("Export failed: ") + e.what();
             }
         }
 
-        loadingDuration = static_cast<float>(glfwGetTime()) - loadingStartTime;
-        loadingActive = false;
-        loadingDone = true;
-        loadingDoneTime = static_cast<float>(glfwGetTime());
+        if (!exportJob.active) finishLoadingOverlay();
     } else {
         // Deferred GRWM buffer load (after pipeline run completes)
+        if (grwmJobs.consumeCompleted()) grwmPendingLoad = true;
         if (grwmPendingLoad) {
             grwmPendingLoad = false;
             vkDeviceWaitIdle(device);
             loadGrwmPreprocess(loadedMeshPath);
+            if (!preprocessLoaded && enableSlotGenerator) generateFaceSlots();
             writeGrwmDescriptors(heDescriptorSet);
             grwmStatus = preprocessLoaded ? "Loaded successfully" : "Failed to load output";
         }
 
+        // Deferred built-in slot regeneration (settings changed in the UI)
+        if (slotGenPending) {
+            slotGenPending = false;
+            vkDeviceWaitIdle(device);
+            generateFaceSlots();
+            writeGrwmDescriptors(heDescriptorSet);
+        }
+
         // Deferred dragon coat load/unload
         if (pendingCoatLoad) {
             pendingCoatLoad = false;
@@ -410,6 +425,7 @@ void Renderer::beginFrame() {
 }
 
 void Renderer::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
+    TRACE_ZONE("Renderer::recordCommandBuffer");
     frameDrawCalls = 0;
 
     VkCommandBufferBeginInfo beginInfo{};
@@ -506,6 +522,7 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
 
     // Update view UBO from current camera state
     {
+        TRACE_ZONE("UBO: view");
         float aspect = static_cast<float>(swapChainExtent.width) /
                        static_cast<float>(swapChainExtent.height);
 
@@ -550,20 +567,52 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
     memcpy(shadingUBOMapped[currentFrame], &shadingData, sizeof(GlobalShadingUBO));
 
     // Per-frame animation update
-    if (skeletonLoaded && animationPlaying && !animations.empty()) {
+    if (skeletonLoaded && !animations.empty() &&
+        useAnimationBlending && animBlender.isInitialized()) {
+        TRACE_ZONE("UBO: bone matrices");
+        // Base layer clock follows the panel's Time/Speed/Play controls
+        AnimationLayer& base = animBlender.current;
+        base.time  = animationTime;
+        base.speed = animationPlaying ? animationSpeed : 0.0f;
+        animBlender.update(lastDeltaTime);
+        float duration = (base.clip >= 0) ? animations[base.clip].duration : 0.0f;
+        if (duration > 0.0f && base.time > duration) {
+            base.time = std::fmod(base.time, duration);
+        }
+        animationTime = base.time;
+
+        std::vector<glm::mat4> boneMatrices;
+        if (useAnimationBake && animBlender.isSingleClip() &&
+            base.clip < static_cast<int>(bakedAnimations.size()) &&
+            bakedAnimations[base.clip].valid()) {
+            GltfLoader::sampleBakedAnimation(bakedAnimations[base.clip], animationTime,
+                                             animationBakeInterpolate, boneMatrices);
+        } else {
+            animBlender.evaluate(skeleton, animations, boneMatrices);
+        }
+        boneMatricesBuffer.update(boneMatrices.data(),
+                                  boneMatrices.size() * sizeof(glm::mat4));
+    } else if (skeletonLoaded && animationPlaying && !animations.empty()) {
+        TRACE_ZONE("UBO: bone matrices");
         animationTime += lastDeltaTime * animationSpeed;
         if (animationTime > animations[0].duration) {
             animationTime = std::fmod(animationTime, animations[0].duration);
         }
-        GltfLoader::updateSkeleton(animations[0], animationTime, skeleton);
         std::vector<glm::mat4> boneMatrices;
-        GltfLoader::computeBoneMatrices(skeleton, boneMatrices);
+        if (useAnimationBake && !bakedAnimations.empty() && bakedAnimations[0].valid()) {
+            GltfLoader::sampleBakedAnimation(bakedAnimations[0], animationTime,
+                                             animationBakeInterpolate, boneMatrices);
+        } else {
+            GltfLoader::updateSkeleton(animations[0], animationTime, skeleton);
+            GltfLoader::computeBoneMatrices(skeleton, boneMatrices);
+        }
         boneMatricesBuffer.update(boneMatrices.data(),
                                   boneMatrices.size() * sizeof(glm::mat4));
     }
 
     // Update ResurfacingUBO with current state
     {
+        TRACE_ZONE("UBO: resurfacing");
         ResurfacingUBO resurfData{};
         resurfData.elementType      = elementType;
         resurfData.userScaling      = userScaling;
@@ -627,6 +676,7 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
 
     // Update secondary ResurfacingUBO (used when dualMeshActive)
     if (dualMeshActive) {
+        TRACE_ZONE("UBO: secondary resurfacing");
         ResurfacingUBO secData{};
         secData.elementType      = secondaryElementType;
         secData.userScaling      = secondaryUserScaling;
@@ -672,8 +722,8 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
     pushConstants.chainmailMode = chainmailMode ? 1u : 0u;
     pushConstants.chainmailTiltAngle = chainmailTiltAngle;
     pushConstants.chainmailSurfaceOffset = chainmailSurfaceOffset;
-    pushConstants.activeSlots = (enableSlotPlacement && preprocessLoaded && enablePreprocess)
-        ? static_cast<uint32_t>(activeSlotCount) : 0u;
+    pushConstants.activeSlots = slotPlacementActive()
+        ? static_cast<uint32_t>(std::min<int>(activeSlotCount, static_cast<int>(slotsPerFace))) : 0u;
     pushConstants.slotUniformSizeFlag = slotUniformSize ? 1u : 0u;
 
     vkCmdPushConstants(cmd, pipelineLayout,
@@ -685,7 +735,6 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
             // CPU pre-cull: build compact visible element index list.
             // Only rebuilt when camera, scale, or culling settings change.
             bool doMaskCull = useMaskTexture && maskTextureLoaded && !cpuMaskPixels.empty();
-            bool doCulling   = enableFrustumCulling || enableBackfaceCulling;
 
             float aspect = static_cast<float>(swapChainExtent.width) /
                            static_cast<float>(swapChainExtent.height);
@@ -693,12 +742,11 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
             if (turntableMode) {
                 model = glm::mat4_cast(objectRotation) * model;
             }
-            glm::mat3 modelNormalMat = glm::mat3(model);  // for transforming normals
             glm::mat4 mvp = activeCamera->getProjectionMatrix(aspect) *
                             activeCamera->getViewMatrix() * model;
 
-            uint32_t slotK = (enableSlotPlacement && preprocessLoaded && enablePreprocess)
-                ? static_cast<uint32_t>(activeSlotCount) : 0u;
+            uint32_t slotK = slotPlacementActive()
+                ? static_cast<uint32_t>(std::min<int>(activeSlotCount, static_cast<int>(slotsPerFace))) : 0u;
 
             bool settingsChanged = (enableFrustumCulling  != lastEnableFrustumCulling)
                                 || (enableBackfaceCulling != lastEnableBackfaceCulling)
@@ -710,74 +758,38 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
             bool cameraChanged = (mvp != lastCullMVP);
 
             if (visibleCacheDirty || settingsChanged || cameraChanged) {
-                cachedVisibleIndices.clear();
-                cachedTotalElements = 0;
-
-                auto isMasked = [&](glm::vec2 uv) -> bool {
-                    if (!doMaskCull) return false;
-                    uint32_t x = static_cast<uint32_t>(uv.x * cpuMaskWidth)  % cpuMaskWidth;
-                    uint32_t y = static_cast<uint32_t>(uv.y * cpuMaskHeight) % cpuMaskHeight;
-                    return cpuMaskPixels[y * cpuMaskWidth + x] < 128;
-                };
-
-                auto isVisible = [&](glm::vec3 pos, glm::vec3 normal, float area) -> bool {
-                    if (!doCulling) return true;
-                    float radius = std::sqrt(area) * userScaling * 2.0f;
-                    if (enableFrustumCulling) {
-                        glm::vec4 clip = mvp * glm::vec4(pos, 1.0f);
-                        if (clip.w <= 0.0f) return false;
-                        float cr = radius / clip.w * 2.0f * 1.1f;
-                        glm::vec3 ndc = glm::vec3(clip) / clip.w;
-                        if (ndc.x + cr < -1.0f || ndc.x - cr > 1.0f) return false;
-                        if (ndc.y + cr < -1.0f || ndc.y - cr > 1.0f) return false;
-                        if (ndc.z + cr <  0.0f || ndc.z - cr > 1.0f) return false;
-                    }
-                    if (enableBackfaceCulling) {
-                        glm::vec3 worldPos = glm::vec3(model * glm::vec4(pos, 1.0f));
-                        glm::vec3 worldNormal = glm::normalize(modelNormalMat * normal);
-                        glm::vec3 viewDir = glm::normalize(activeCamera->getPosition() - worldPos);
-                        if (glm::dot(viewDir, worldNormal) <= cullingThreshold) return false;
-                    }
-                    return true;
-                };
-
-                uint32_t totalElements = heNbFaces + heNbVertices;
-                cachedVisibleIndices.reserve(std::min(totalElements, VISIBLE_INDICES_MAX));
+                ElementCull::Elements elements;
+                elements.faceCenters     = cpuFaceCenters.data();
+                elements.faceNormals     = cpuFaceNormals.data();
+                elements.faceAreas       = cpuFaceAreas.data();
+                elements.faceUVs         = cpuFaceUVs.data();
+                elements.nbFaces         = heNbFaces;
+                elements.vertexPositions = cpuVertexPositions.data();
+                elements.vertexNormals   = cpuVertexNormals.data();
+                elements.vertexFaceAreas = cpuVertexFaceAreas.data();
+                elements.vertexUVs       = cpuVertexUVs.data();
+                elements.nbVertices      = heNbVertices;
+
+                ElementCull::Settings cull;
+                cull.mvp              = mvp;
+                cull.model            = model;
+                cull.cameraPosition   = activeCamera->getPosition();
+                cull.frustumCulling   = enableFrustumCulling;
+                cull.backfaceCulling  = enableBackfaceCulling;
+                cull.cullingThreshold = cullingThreshold;
+                cull.userScaling      = userScaling;
+                cull.slotK            = slotK;
+                // Skip vertex elements in chainmail mode (face elements only)
+                cull.faceElementsOnly = chainmailMode;
+                if (doMaskCull) {
+                    cull.maskPixels = cpuMaskPixels.data();
+                    cull.maskWidth  = cpuMaskWidth;
+                    cull.maskHeight = cpuMaskHeight;
+                }
+                cull.maxVisible = VISIBLE_INDICES_MAX;
 
                 auto cullStart = std::chrono::high_resolution_clock::now();
-
-                if (slotK > 0) {
-                    // Slot mode: emit K indices per visible face
-                    for (uint32_t i = 0; i < heNbFaces; i++) {
-                        if (isMasked(cpuFaceUVs[i])) continue;
-                        cachedTotalElements += slotK;
-                        if (isVisible(cpuFaceCenters[i], cpuFaceNormals[i], cpuFaceAreas[i])) {
-                            for (uint32_t s = 0; s < slotK; s++) {
-                                if (cachedVisibleIndices.size() < VISIBLE_INDICES_MAX)
-                                    cachedVisibleIndices.push_back(i * slotK + s);
-                            }
-                        }
-                    }
-                    // Skip vertex elements in slot mode
-                } else {
-                    for (uint32_t i = 0; i < heNbFaces; i++) {
-                        if (isMasked(cpuFaceUVs[i])) continue;
-                        cachedTotalElements++;
-                        if (isVisible(cpuFaceCenters[i], cpuFaceNormals[i], cpuFaceAreas[i]))
-                            if (cachedVisibleIndices.size() < VISIBLE_INDICES_MAX)
-                                cachedVisibleIndices.push_back(i);
-                    }
-                    // Skip vertex elements in chainmail mode (face elements only)
-                    if (!chainmailMode) {
-                        for (uint32_t i = 0; i < heNbVertices; i++) {
-                            if (isMasked(cpuVertexUVs[i])) continue;
-                            cachedTotalElements++;
-                            if (isVisible(cpuVertexPositions[i], cpuVertexNormals[i], cpuVertexFaceAreas[i]))
-                                if (cachedVisibleIndices.size() < VISIBLE_INDICES_MAX)
-                                    cachedVisibleIndices.push_back(heNbFaces + i);
-                        }
-                    }
-                }
+                cachedTotalElements = ElementCull::run(elements, cull, cachedVisibleIndices);
 
                 cpuCullTimeMs = std::chrono::duration<float, std::milli>(
                     std::chrono::high_resolution_clock::now() - cullStart).count();
@@ -1123,6 +1135,7 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
 }
 
 void Renderer::endFrame() {
+    TRACE_ZONE("Renderer::endFrame");
     if (!frameStarted) return;
 
     recordCommandBuffer(commandBuffers[currentFrame], currentImageIndex);
@@ -1702,140 +1715,313 @@ void Renderer::precomputeProxyParams() {
 // Procedural Mesh Export
 // ============================================================================
 
+void Renderer::finishLoadingOverlay() {
+    loadingDuration = static_cast<float>(glfwGetTime()) - loadingStartTime;
+    loadingActive = false;
+    loadingProgress = -1.0f;
+    loadingDone = true;
+    loadingDoneTime = static_cast<float>(glfwGetTime());
+}
+
 void Renderer::exportProceduralMesh(const std::string& filepath, int mode) {
-    if (!heMeshUploaded) {
+    beginProceduralExport(filepath, mode);
+    try {
+        while (!stepProceduralExport(std::numeric_limits<double>::infinity())) {}
+    } catch (...) {
+        destroyProceduralExport();
+        throw;
+    }
+}
+
+void Renderer::beginProceduralExport(const std::string& filepath, int mode) {
+    TRACE_ZONE("Renderer::beginProceduralExport");
+    if (mode == 1 || mode == 2) {
+        beginPebbleExport(filepath, mode);
+        return;
+    }
+
+    if (!heMeshUploaded || heNbFaces + heNbVertices == 0) {
         throw std::runtime_error("No mesh loaded");
     }
 
+    const bool cpuBackend = (exportBackend == 1);
+    if ((cpuBackend || exportLod) && cpuElementFrames.size() != size_t(heNbFaces) + heNbVertices) {
+        throw std::runtime_error("CPU export: element frames do not match the loaded mesh");
+    }
+
     vkDeviceWaitIdle(device);
 
     // Ensure compute pipelines are created (lazy init)
-    createExportComputePipelines();
-
-    // --- 1. Calculate total counts and build offset buffer ---
-    uint32_t totalVerts = 0, totalTris = 0;
-    std::vector<ExportElementOffset> offsets;
-
-    if (mode == 0) {
-        // Parametric: fixed geometry per element
-        uint32_t M = resolutionM, N = resolutionN;
-        uint32_t vertsPerElement = (M + 1) * (N + 1);
-        uint32_t trisPerElement = M * N * 2;
-        uint32_t numElements = heNbFaces + heNbVertices;
-
-        offsets.resize(numElements);
-        for (uint32_t i = 0; i < numElements; i++) {
-            offsets[i].vertexOffset = totalVerts;
-            offsets[i].triangleOffset = totalTris;
-            offsets[i].isVertex = (i >= heNbFaces) ? 1 : 0;
-            offsets[i].faceId = (i >= heNbFaces) ? (i - heNbFaces) : i;
-            totalVerts += vertsPerElement;
-            totalTris += trisPerElement;
+    if (!cpuBackend) createExportComputePipelines();
+
+    destroyProceduralExport();
+    ProceduralExportJob& job = exportJob;
+    job.numElements = heNbFaces + heNbVertices;
+    job.cpuBackend = cpuBackend;
+    job.weld = exportWeld;
+    job.weldSeams = exportWeldSeams;
+
+    // Surface parameters, captured like the push constants below
+    ParametricSurface::Params params;
+    params.elementType = elementType;
+    params.resolutionM = resolutionM;
+    params.resolutionN = resolutionN;
+    params.userScaling = userScaling;
+    params.torusMajorR = torusMajorR;
+    params.torusMinorR = torusMinorR;
+    params.sphereRadius = sphereRadius;
+    params.chainmailMode = chainmailMode;
+    params.chainmailTiltAngle = chainmailTiltAngle;
+    params.chainmailSurfaceOffset = chainmailSurfaceOffset;
+    if (scaleLutLoaded) {
+        params.lutPoints = cpuScaleLutPoints.data();
+        params.lutNx = scaleLutNx;
+        params.lutNy = scaleLutNy;
+        params.lutMinExtent = glm::vec3(scaleLutMinExtent);
+        params.lutMaxExtent = glm::vec3(scaleLutMaxExtent);
+    }
+    params.strawTaperPower = strawTaperPower;
+    params.strawBendAmount = strawBendAmount;
+    params.strawBaseRadius = strawBaseRadius;
+    params.strawBendDirection = strawBendDirection;
+    params.strawBendRandomness = strawBendRandomness;
+    params.studElongation = studElongation;
+    params.studHeight = studHeight;
+    params.studPower = studPower;
+    params.studRotation = studRotation;
+    params.studRotationRandomness = studRotationRandomness;
+    params.studTreadPlate = studTreadPlate;
+
+    // --- 1. Runs of fixed per-element geometry ---
+    // Without LOD every element uses resolutionM x resolutionN. With LOD,
+    // each gets the resolution getLodMN picks for the current view, and
+    // elements are grouped by it.
+    try {
+        if (exportLod) {
+            float aspect = static_cast<float>(swapChainExtent.width) /
+                           static_cast<float>(swapChainExtent.height);
+            glm::mat4 model = thirdPersonMode ? player.getModelMatrix() : glm::mat4(1.0f);
+            if (turntableMode) {
+                model = glm::mat4_cast(objectRotation) * model;
+            }
+            ParametricLod::Settings lod;
+            lod.mvp = activeCamera->getProjectionMatrix(aspect) * activeCamera->getViewMatrix() * model;
+            lod.baseResolution = resolutionM;
+            // Screen size is in NDC, so a taller target scales the factor
+            lod.lodFactor = lodFactor;
+            if (exportLodTargetHeight > 0) {
+                lod.lodFactor *= static_cast<float>(exportLodTargetHeight) /
+                                 static_cast<float>(swapChainExtent.height);
+            }
+            lod.triangleBudget = static_cast<uint64_t>(std::max(0.0f, exportTriangleBudgetM) * 1e6);
+
+            ParametricLod::Result lodResult = ParametricLod::compute(params, cpuElementFrames, lod);
+            job.elementOrder = std::move(lodResult.elements);
+            for (const ParametricLod::Run& r : lodResult.runs) {
+                ExportRun run;
+                run.first = r.first;
+                run.count = r.count;
+                run.M = run.N = r.resolution;
+                job.runs.push_back(std::move(run));
+            }
+            std::cout << "Export LOD: " << lodResult.triangles << " triangles at "
+                      << job.runs.size() << " resolutions (full resolution: "
+                      << uint64_t(job.numElements) * resolutionM * resolutionN * 2 << ")";
+            if (lodResult.budgetScale < 1.0f) {
+                std::cout << ", LOD factor scaled by " << lodResult.budgetScale << " for the budget";
+            }
+            std::cout << std::endl;
+        } else {
+            ExportRun run;
+            run.count = job.numElements;
+            run.M = resolutionM;
+            run.N = resolutionN;
+            job.runs.push_back(std::move(run));
         }
-    } else {
-        throw std::runtime_error("Pebble export not yet implemented");
+    } catch (...) {
+        destroyProceduralExport();
+        throw;
     }
 
-    std::cout << "Export: " << totalVerts << " vertices, "
-              << totalTris << " triangles" << std::endl;
-
-    // --- 2. Allocate export buffers ---
-    MeshExportBuffers exportBufs;
-    exportBufs.allocate(device, physicalDevice, totalVerts, totalTris, offsets);
-
-    // --- 3. Create on-demand descriptor pool + set ---
-    VkDescriptorPool exportPool = VK_NULL_HANDLE;
-    VkDescriptorSet exportSet = VK_NULL_HANDLE;
-
-    {
-        VkDescriptorPoolSize poolSize{};
-        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        poolSize.descriptorCount = 5;
-
-        VkDescriptorPoolCreateInfo poolInfo{};
-        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolInfo.poolSizeCount = 1;
-        poolInfo.pPoolSizes = &poolSize;
-        poolInfo.maxSets = 1;
-
-        if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &exportPool) != VK_SUCCESS) {
-            exportBufs.destroy();
-            throw std::runtime_error("Failed to create export descriptor pool");
+    // Batches hold whole runs' elements: size each run's batch to the
+    // budget, and allocate GPU buffers for the largest
+    size_t batchBytes = size_t(std::max(1, exportBatchMB)) * 1024 * 1024;
+    uint64_t totalVerts = 0, totalTris = 0;
+    uint32_t maxBatchElements = 0, maxBatchVerts = 0, maxBatchTris = 0;
+    for (ExportRun& run : job.runs) {
+        run.vertsPerElement = (run.M + 1) * (run.N + 1);
+        run.trisPerElement = run.M * run.N * 2;
+        size_t bytesPerElement = size_t(run.vertsPerElement) * (sizeof(glm::vec4) * 2 + sizeof(glm::vec2))
+                               + size_t(run.trisPerElement) * 3 * sizeof(uint32_t)
+                               + sizeof(ExportElementOffset);
+        run.batchElements = static_cast<uint32_t>(std::clamp<size_t>(
+            batchBytes / bytesPerElement, 1, run.count));
+        maxBatchElements = std::max(maxBatchElements, run.batchElements);
+        maxBatchVerts = std::max(maxBatchVerts, run.batchElements * run.vertsPerElement);
+        maxBatchTris = std::max(maxBatchTris, run.batchElements * run.trisPerElement);
+
+        // The weld template fixes the per-element output counts up front
+        uint32_t outVerts = run.vertsPerElement;
+        uint32_t outTris = run.trisPerElement;
+        if (job.weld) {
+            run.gridWeld.build(run.M, run.N, GridWeld::topologyFor(elementType), job.weldSeams);
+            outVerts = run.gridWeld.vertexCount();
+            outTris = run.gridWeld.triangleCount();
         }
+        totalVerts += uint64_t(run.count) * outVerts;
+        totalTris += uint64_t(run.count) * outTris;
+    }
 
-        VkDescriptorSetAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = exportPool;
-        allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts = &exportOutputSetLayout;
+    std::cout << "Export: " << totalVerts << " vertices, "
+              << totalTris << " triangles in batches of up to "
+              << maxBatchElements << " elements";
+    if (job.weld) std::cout << " (welded)";
+    std::cout << std::endl;
+
+    try {
+        if (cpuBackend) {
+            // --- 2. CPU evaluator per run ---
+            for (ExportRun& run : job.runs) {
+                ParametricSurface::Params runParams = params;
+                runParams.resolutionM = run.M;
+                runParams.resolutionN = run.N;
+                run.cpuSurface = std::make_unique<ParametricSurface>(runParams);
+            }
+        } else {
+            // --- 2. Allocate two batch-sized buffer sets ---
+            for (auto& batch : job.batches) {
+                batch.buffers.allocate(device, physicalDevice,
+                                       maxBatchVerts, maxBatchTris, maxBatchElements);
+            }
 
-        if (vkAllocateDescriptorSets(device, &allocInfo, &exportSet) != VK_SUCCESS) {
-            vkDestroyDescriptorPool(device, exportPool, nullptr);
-            exportBufs.destroy();
-            throw std::runtime_error("Failed to allocate export descriptor set");
-        }
+            // --- 3. Descriptor pool: one output set per batch, plus the
+            // per-object set (layout counts) for the captured parameters ---
+            std::array<VkDescriptorPoolSize, 5> poolSizes{};
+            poolSizes[0] = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5 * static_cast<uint32_t>(job.batches.size()) + 4};
+            poolSizes[1] = {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1};
+            poolSizes[2] = {VK_DESCRIPTOR_TYPE_SAMPLER, 2};
+            poolSizes[3] = {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 7};
+            poolSizes[4] = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1};
+
+            VkDescriptorPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;  // perObjectSetLayout needs it
+            poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+            poolInfo.pPoolSizes = poolSizes.data();
+            poolInfo.maxSets = static_cast<uint32_t>(job.batches.size()) + 1;
+
+            if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &job.descriptorPool) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create export descriptor pool");
+            }
 
-        // Write descriptor set
-        std::array<VkDescriptorBufferInfo, 5> bufInfos{};
-        bufInfos[0] = {exportBufs.positions.getBuffer(), 0, exportBufs.positions.getSize()};
-        bufInfos[1] = {exportBufs.normals.getBuffer(), 0, exportBufs.normals.getSize()};
-        bufInfos[2] = {exportBufs.uvs.getBuffer(), 0, exportBufs.uvs.getSize()};
-        bufInfos[3] = {exportBufs.indices.getBuffer(), 0, exportBufs.indices.getSize()};
-        bufInfos[4] = {exportBufs.offsets.getBuffer(), 0, exportBufs.offsets.getSize()};
-
-        std::array<VkWriteDescriptorSet, 5> writes{};
-        for (uint32_t i = 0; i < 5; i++) {
-            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            writes[i].dstSet = exportSet;
-            writes[i].dstBinding = i;
-            writes[i].dstArrayElement = 0;
-            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            writes[i].descriptorCount = 1;
-            writes[i].pBufferInfo = &bufInfos[i];
-        }
+            // Straw, stud and dragon scale parameters live in the
+            // ResurfacingUBO, so capture it (and the LUT it indexes) now,
+            // like the push constants below
+            VkDescriptorSetAllocateInfo configAllocInfo{};
+            configAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            configAllocInfo.descriptorPool = job.descriptorPool;
+            configAllocInfo.descriptorSetCount = 1;
+            configAllocInfo.pSetLayouts = &perObjectSetLayout;
+            if (vkAllocateDescriptorSets(device, &configAllocInfo, &job.configDescriptorSet) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to allocate export config descriptor set");
+            }
 
-        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
-                               writes.data(), 0, nullptr);
-    }
+            createBuffer(sizeof(ResurfacingUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                         job.configUBO, job.configUBOMemory);
+            void* configMapped = nullptr;
+            vkMapMemory(device, job.configUBOMemory, 0, sizeof(ResurfacingUBO), 0, &configMapped);
+            memcpy(configMapped, resurfacingUBOMapped, sizeof(ResurfacingUBO));
+            vkUnmapMemory(device, job.configUBOMemory);
+
+            VkDescriptorBufferInfo configInfo{job.configUBO, 0, sizeof(ResurfacingUBO)};
+            std::array<VkWriteDescriptorSet, 2> configWrites{};
+            configWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            configWrites[0].dstSet = job.configDescriptorSet;
+            configWrites[0].dstBinding = 0;  // BINDING_CONFIG_UBO
+            configWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            configWrites[0].descriptorCount = 1;
+            configWrites[0].pBufferInfo = &configInfo;
+            uint32_t configWriteCount = 1;
+
+            VkDescriptorBufferInfo lutInfo{};
+            if (scaleLutLoaded) {
+                job.scaleLut.create(device, physicalDevice,
+                                    cpuScaleLutPoints.size() * sizeof(glm::vec4),
+                                    cpuScaleLutPoints.data());
+                lutInfo = {job.scaleLut.getBuffer(), 0, VK_WHOLE_SIZE};
+                configWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                configWrites[1].dstSet = job.configDescriptorSet;
+                configWrites[1].dstBinding = 6;  // BINDING_SCALE_LUT
+                configWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                configWrites[1].descriptorCount = 1;
+                configWrites[1].pBufferInfo = &lutInfo;
+                configWriteCount++;
+            }
+            vkUpdateDescriptorSets(device, configWriteCount, configWrites.data(), 0, nullptr);
 
-    // --- 4. Record and submit compute command buffer ---
-    VkCommandBufferAllocateInfo cmdAllocInfo{};
-    cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    cmdAllocInfo.commandPool = commandPool;
-    cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAllocInfo.commandBufferCount = 1;
+            for (auto& batch : job.batches) {
+                VkDescriptorSetAllocateInfo allocInfo{};
+                allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+                allocInfo.descriptorPool = job.descriptorPool;
+                allocInfo.descriptorSetCount = 1;
+                allocInfo.pSetLayouts = &exportOutputSetLayout;
 
-    VkCommandBuffer cmd;
-    vkAllocateCommandBuffers(device, &cmdAllocInfo, &cmd);
+                if (vkAllocateDescriptorSets(device, &allocInfo, &batch.descriptorSet) != VK_SUCCESS) {
+                    throw std::runtime_error("Failed to allocate export descriptor set");
+                }
 
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    vkBeginCommandBuffer(cmd, &beginInfo);
+                const MeshExportBuffers& bufs = batch.buffers;
+                std::array<VkDescriptorBufferInfo, 5> bufInfos{};
+                bufInfos[0] = {bufs.positions.getBuffer(), 0, bufs.positions.getSize()};
+                bufInfos[1] = {bufs.normals.getBuffer(), 0, bufs.normals.getSize()};
+                bufInfos[2] = {bufs.uvs.getBuffer(), 0, bufs.uvs.getSize()};
+                bufInfos[3] = {bufs.indices.getBuffer(), 0, bufs.indices.getSize()};
+                bufInfos[4] = {bufs.offsets.getBuffer(), 0, bufs.offsets.getSize()};
+
+                std::array<VkWriteDescriptorSet, 5> writes{};
+                for (uint32_t i = 0; i < 5; i++) {
+                    writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    writes[i].dstSet = batch.descriptorSet;
+                    writes[i].dstBinding = i;
+                    writes[i].dstArrayElement = 0;
+                    writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    writes[i].descriptorCount = 1;
+                    writes[i].pBufferInfo = &bufInfos[i];
+                }
 
-    VkPipeline pipeline = (mode == 0) ? parametricExportPipeline : parametricExportPipeline; // TODO: pebble
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+                vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
+                                       writes.data(), 0, nullptr);
 
-    // Bind descriptor sets 0-3
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            computePipelineLayout, 0, 1,
-                            &sceneDescriptorSets[currentFrame], 0, nullptr);
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            computePipelineLayout, 1, 1,
-                            &heDescriptorSet, 0, nullptr);
+                VkCommandBufferAllocateInfo cmdAllocInfo{};
+                cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                cmdAllocInfo.commandPool = commandPool;
+                cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+                cmdAllocInfo.commandBufferCount = 1;
+                if (vkAllocateCommandBuffers(device, &cmdAllocInfo, &batch.commandBuffer) != VK_SUCCESS) {
+                    throw std::runtime_error("Failed to allocate export command buffer");
+                }
 
-    VkDescriptorSet perObjSet = (mode == 0) ? perObjectDescriptorSet
-                                            : pebblePerObjectDescriptorSet;
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            computePipelineLayout, 2, 1,
-                            &perObjSet, 0, nullptr);
+                VkFenceCreateInfo fenceInfo{};
+                fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+                if (vkCreateFence(device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS) {
+                    throw std::runtime_error("Failed to create export fence");
+                }
+            }
+        }
 
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            computePipelineLayout, 3, 1,
-                            &exportSet, 0, nullptr);
+        job.writer = MeshStreamWriter::create(static_cast<MeshFileFormat>(exportFormat));
+        job.writer->open(filepath, totalVerts, totalTris);
+        job.appendBaseMesh = static_cast<MeshFileFormat>(exportFormat) == MeshFileFormat::Obj;
+    } catch (...) {
+        destroyProceduralExport();
+        throw;
+    }
 
-    // Push constants
-    PushConstants pc{};
+    // Push constants are captured now, so UI edits during a long export
+    // cannot change the geometry halfway through the file
+    PushConstants& pc = job.pushConstants;
+    pc = PushConstants{};
     pc.model = glm::mat4(1.0f);
     pc.nbFaces = heNbFaces;
     pc.nbVertices = heNbVertices;
@@ -1849,18 +2035,67 @@ void Renderer::exportProceduralMesh(const std::string& filepath, int mode) {
     pc.debugMode = 0;
     pc.enableCulling = 0;       // No culling for export
     pc.cullingThreshold = 0.0f;
-    pc.enableLod = 0;           // No LOD for export
+    pc.enableLod = 0;           // Resolution comes from the batch's run
     pc.lodFactor = 1.0f;
     pc.chainmailMode = chainmailMode ? 1 : 0;
     pc.chainmailTiltAngle = chainmailTiltAngle;
     pc.chainmailSurfaceOffset = chainmailSurfaceOffset;
 
+    job.filepath = filepath;
+    job.startTime = glfwGetTime();
+    job.active = true;
+}
+
+void Renderer::submitExportBatch(MeshExportBatch& batch) {
+    TRACE_ZONE("Renderer::submitExportBatch");
+    ProceduralExportJob& job = exportJob;
+    batch.elementCount = job.nextBatchSize();
+    batch.firstElement = job.nextElement;
+    batch.run = job.currentRun;
+    job.nextElement += batch.elementCount;
+    const ExportRun& run = job.runs[batch.run];
+
+    // Offsets are batch-local, so indices come back relative to this batch
+    std::vector<ExportElementOffset> offsets(batch.elementCount);
+    for (uint32_t i = 0; i < batch.elementCount; i++) {
+        uint32_t element = job.elementAt(batch.firstElement + i);
+        offsets[i].vertexOffset = i * run.vertsPerElement;
+        offsets[i].triangleOffset = i * run.trisPerElement;
+        offsets[i].isVertex = (element >= heNbFaces) ? 1 : 0;
+        offsets[i].faceId = (element >= heNbFaces) ? (element - heNbFaces) : element;
+    }
+    batch.buffers.setOffsets(offsets);
+
+    VkCommandBuffer cmd = batch.commandBuffer;
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, parametricExportPipeline);
+
+    // Bind descriptor sets 0-3
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            computePipelineLayout, 0, 1,
+                            &sceneDescriptorSets[currentFrame], 0, nullptr);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            computePipelineLayout, 1, 1,
+                            &heDescriptorSet, 0, nullptr);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            computePipelineLayout, 2, 1,
+                            &job.configDescriptorSet, 0, nullptr);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            computePipelineLayout, 3, 1,
+                            &batch.descriptorSet, 0, nullptr);
+
+    PushConstants pc = job.pushConstants;
+    pc.resolutionM = run.M;
+    pc.resolutionN = run.N;
     vkCmdPushConstants(cmd, computePipelineLayout,
                        VK_SHADER_STAGE_COMPUTE_BIT,
                        0, sizeof(PushConstants), &pc);
 
-    uint32_t numWorkgroups = static_cast<uint32_t>(offsets.size());
-    vkCmdDispatch(cmd, numWorkgroups, 1, 1);
+    vkCmdDispatch(cmd, batch.elementCount, 1, 1);
 
     vkEndCommandBuffer(cmd);
 
@@ -1868,48 +2103,314 @@ void Renderer::exportProceduralMesh(const std::string& filepath, int mode) {
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &cmd;
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, batch.fence) != VK_SUCCESS) {
+        batch.elementCount = 0;
+        throw std::runtime_error("Failed to submit export batch");
+    }
+}
 
-    vkFreeCommandBuffers(device, commandPool, 1, &cmd);
+// Pebbles of the loaded mesh (mode 1) or the ground pathway (mode 2), with
+// the parameters their UBOs are drawn with
+void Renderer::beginPebbleExport(const std::string& filepath, int mode) {
+    TRACE_ZONE("Renderer::beginPebbleExport");
+    const bool ground = (mode == 2);
+    if (ground ? !groundMeshActive : (!heMeshUploaded || heNbFaces == 0)) {
+        throw std::runtime_error(ground ? "No ground mesh" : "No mesh loaded");
+    }
 
-    // --- 5. Read back and write OBJ ---
-    void* posData = nullptr;
-    void* normData = nullptr;
-    void* uvData = nullptr;
-    void* idxData = nullptr;
-
-    vkMapMemory(device, exportBufs.positions.getMemory(), 0,
-                totalVerts * sizeof(glm::vec4), 0, &posData);
-    vkMapMemory(device, exportBufs.normals.getMemory(), 0,
-                totalVerts * sizeof(glm::vec4), 0, &normData);
-    vkMapMemory(device, exportBufs.uvs.getMemory(), 0,
-                totalVerts * sizeof(glm::vec2), 0, &uvData);
-    vkMapMemory(device, exportBufs.indices.getMemory(), 0,
-                totalTris * 3 * sizeof(uint32_t), 0, &idxData);
-
-    ObjWriter::write(filepath,
-                     static_cast<const glm::vec4*>(posData),
-                     static_cast<const glm::vec4*>(normData),
-                     static_cast<const glm::vec2*>(uvData),
-                     static_cast<const uint32_t*>(idxData),
-                     totalVerts, totalTris);
-
-    vkUnmapMemory(device, exportBufs.positions.getMemory());
-    vkUnmapMemory(device, exportBufs.normals.getMemory());
-    vkUnmapMemory(device, exportBufs.uvs.getMemory());
-    vkUnmapMemory(device, exportBufs.indices.getMemory());
-
-    // --- 6. Append base mesh if visible ---
-    if (baseMeshMode > 0 && !loadedMeshPath.empty()) {
+    vkDeviceWaitIdle(device);
+    destroyProceduralExport();
+    ProceduralExportJob& job = exportJob;
+
+    const PebbleUBO& ubo = ground ? groundPebbleUBO : pebbleUBO;
+    PebbleGenerator::Params params;
+    params.subdivisionLevel = ubo.subdivisionLevel;
+    params.subdivOffset = ubo.subdivOffset;
+    params.extrusionAmount = ubo.extrusionAmount * (ground ? groundPebbleScale : 1.0f);
+    params.extrusionVariation = ubo.extrusionVariation;
+    params.roundness = ubo.roundness;
+    params.normalCalculationMethod = ubo.normalCalculationMethod;
+    params.fillradius = ubo.fillradius;
+    params.ringoffset = ubo.ringoffset;
+    params.doNoise = ubo.doNoise != 0;
+    params.noiseAmplitude = ubo.noiseAmplitude;
+    params.noiseFrequency = ubo.noiseFrequency;
+    params.normalOffset = ubo.normalOffset;
+    if (ground) {
+        // The pathway around the player as currently drawn
+        params.usePathway = fogOfWar;
+        params.pathwayRadius = pathwayRadius;
+        params.pathwayBackScale = pathwayBackScale;
+        params.pathwayFalloff = pathwayFalloff;
+        params.playerWorldPos = player.position;
+        params.playerForward = playerForwardDir();
+    }
+
+    PebbleGenerator::Faces faces;
+    if (ground) {
+        faces.vertexPositions = groundCpuVertexPositions.data();
+        faces.faceCenters = groundCpuFaceCenters.data();
+        faces.faceNormals = groundCpuFaceNormals.data();
+        faces.faceVertOffsets = groundCpuFaceVertOffsets.data();
+        faces.faceVertIndices = groundCpuFaceVertIndices.data();
+        faces.nbFaces = groundNbFaces;
+    } else {
+        faces.vertexPositions = cpuVertexPositions.data();
+        faces.faceCenters = cpuFaceCenters.data();
+        faces.faceNormals = cpuFaceNormals.data();
+        faces.faceVertOffsets = cpuFaceVertOffsets.data();
+        faces.faceVertIndices = cpuFaceVertIndices.data();
+        faces.nbFaces = heNbFaces;
+    }
+    job.pebbles = std::make_unique<PebbleGenerator>(params, faces);
+    job.numElements = faces.nbFaces;
+
+    // Output varies per face (level, corner count, pathway fade), so sum the
+    // exact totals and size batches by the average face
+    uint64_t totalVerts = 0, totalTris = 0;
+    for (uint32_t f = 0; f < job.numElements; f++) {
+        totalVerts += job.pebbles->faceVertexCount(f);
+        totalTris += job.pebbles->faceTriangleCount(f);
+    }
+    uint64_t totalBytes = totalVerts * (sizeof(glm::vec4) * 2 + sizeof(glm::vec2))
+                        + totalTris * 3 * sizeof(uint32_t);
+    uint64_t batchBytes = uint64_t(std::max(1, exportBatchMB)) * 1024 * 1024;
+    ExportRun run;
+    run.count = job.numElements;
+    run.batchElements = static_cast<uint32_t>(std::clamp<uint64_t>(
+        totalBytes > 0 ? batchBytes * job.numElements / totalBytes : job.numElements,
+        1, job.numElements));
+    job.runs.push_back(std::move(run));
+
+    std::cout << "Export: " << totalVerts << " vertices, "
+              << totalTris << " triangles in batches of "
+              << job.runs[0].batchElements << " faces (" << (ground ? "pathway " : "")
+              << "pebbles, CPU)" << std::endl;
+
+    try {
+        job.writer = MeshStreamWriter::create(static_cast<MeshFileFormat>(exportFormat));
+        job.writer->open(filepath, totalVerts, totalTris);
+        job.appendBaseMesh = !ground &&
+            static_cast<MeshFileFormat>(exportFormat) == MeshFileFormat::Obj;
+    } catch (...) {
+        destroyProceduralExport();
+        throw;
+    }
+
+    job.filepath = filepath;
+    job.startTime = glfwGetTime();
+    job.active = true;
+}
+
+void Renderer::generatePebbleBatch(uint32_t faceCount) {
+    TRACE_ZONE("Renderer::generatePebbleBatch");
+    ProceduralExportJob& job = exportJob;
+    job.pebbles->generate(job.nextElement, faceCount, job.pebbleArenas);
+    job.nextElement += faceCount;
+
+    // Each arena holds whole faces with local indices; the writer rebases them
+    for (const auto& arena : job.pebbleArenas) {
+        if (arena.vertexCount() == 0) continue;
+        job.writer->appendBatch(arena.positions.data(), arena.normals.data(),
+                                arena.uvs.data(), arena.indices.data(),
+                                arena.vertexCount(), arena.triangleCount());
+    }
+    job.elementsWritten += faceCount;
+}
+
+void Renderer::evaluateExportBatchCpu(uint32_t elementCount) {
+    TRACE_ZONE("Renderer::evaluateExportBatchCpu");
+    ProceduralExportJob& job = exportJob;
+    const ExportRun& run = job.runs[job.currentRun];
+    size_t numVerts = size_t(elementCount) * run.vertsPerElement;
+    size_t numTris = size_t(elementCount) * run.trisPerElement;
+    job.cpuPositions.resize(numVerts);
+    job.cpuNormals.resize(numVerts);
+    job.cpuUVs.resize(numVerts);
+    job.cpuIndices.resize(numTris * 3);
+
+    if (job.elementOrder.empty()) {
+        run.cpuSurface->evaluateElementRange(cpuElementFrames, job.nextElement, elementCount,
+                                             job.cpuPositions.data(), job.cpuNormals.data(),
+                                             job.cpuUVs.data(), job.cpuIndices.data());
+    } else {
+        run.cpuSurface->evaluateElementList(cpuElementFrames, &job.elementOrder[job.nextElement],
+                                            elementCount,
+                                            job.cpuPositions.data(), job.cpuNormals.data(),
+                                            job.cpuUVs.data(), job.cpuIndices.data());
+    }
+    job.nextElement += elementCount;
+    writeExportBatch(job.cpuPositions.data(), job.cpuNormals.data(),
+                     job.cpuUVs.data(), job.cpuIndices.data(), elementCount, run);
+}
+
+// One evaluated batch (export shader layout) to the file, welded if enabled
+void Renderer::writeExportBatch(const glm::vec4* positions, const glm::vec4* normals,
+                                const glm::vec2* uvs, const uint32_t* indices,
+                                uint32_t elementCount, const ExportRun& run) {
+    TRACE_ZONE("Renderer::writeExportBatch");
+    ProceduralExportJob& job = exportJob;
+    if (job.weld) {
+        run.gridWeld.apply(positions, normals, uvs, elementCount,
+                           job.weldPositions, job.weldNormals,
+                           job.weldUVs, job.weldIndices);
+        job.writer->appendBatch(job.weldPositions.data(), job.weldNormals.data(),
+                                job.weldUVs.data(), job.weldIndices.data(),
+                                elementCount * run.gridWeld.vertexCount(),
+                                elementCount * run.gridWeld.triangleCount());
+    } else {
+        job.writer->appendBatch(positions, normals, uvs, indices,
+                                elementCount * run.vertsPerElement,
+                                elementCount * run.trisPerElement);
+    }
+    job.elementsWritten += elementCount;
+}
+
+bool Renderer::stepProceduralExport(double budgetMs) {
+    TRACE_ZONE("Renderer::stepProceduralExport");
+    ProceduralExportJob& job = exportJob;
+    if (!job.active) return true;
+
+    auto stepStart = std::chrono::high_resolution_clock::now();
+    for (;;) {
+        if (job.cpuBackend || job.pebbles) {
+            uint32_t count = job.nextBatchSize();
+            if (count == 0) break;
+            if (job.pebbles) generatePebbleBatch(count);
+            else evaluateExportBatchCpu(count);
+
+            auto now = std::chrono::high_resolution_clock::now();
+            if (std::chrono::duration<double, std::milli>(now - stepStart).count() >= budgetMs) break;
+            continue;
+        }
+
+        // Keep both batches busy: the GPU computes the next one while the
+        // previous one is written
+        while (job.nextBatchSize() > 0 &&
+               job.batches[job.submitSlot].elementCount == 0) {
+            submitExportBatch(job.batches[job.submitSlot]);
+            job.submitSlot ^= 1;
+        }
+
+        MeshExportBatch& batch = job.batches[job.writeSlot];
+        if (batch.elementCount == 0) break;  // nothing left in flight
+
+        vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        vkResetFences(device, 1, &batch.fence);
+
+        // --- Read back and append to the OBJ ---
+        const ExportRun& run = job.runs[batch.run];
+        uint32_t numVerts = batch.elementCount * run.vertsPerElement;
+        uint32_t numTris = batch.elementCount * run.trisPerElement;
+        const MeshExportBuffers& bufs = batch.buffers;
+
+        void* posData = nullptr;
+        void* normData = nullptr;
+        void* uvData = nullptr;
+        void* idxData = nullptr;
+
+        vkMapMemory(device, bufs.positions.getMemory(), 0,
+                    size_t(numVerts) * sizeof(glm::vec4), 0, &posData);
+        vkMapMemory(device, bufs.normals.getMemory(), 0,
+                    size_t(numVerts) * sizeof(glm::vec4), 0, &normData);
+        vkMapMemory(device, bufs.uvs.getMemory(), 0,
+                    size_t(numVerts) * sizeof(glm::vec2), 0, &uvData);
+        vkMapMemory(device, bufs.indices.getMemory(), 0,
+                    size_t(numTris) * 3 * sizeof(uint32_t), 0, &idxData);
+
+        try {
+            writeExportBatch(static_cast<const glm::vec4*>(posData),
+                             static_cast<const glm::vec4*>(normData),
+                             static_cast<const glm::vec2*>(uvData),
+                             static_cast<const uint32_t*>(idxData),
+                             batch.elementCount, run);
+        } catch (...) {
+            vkUnmapMemory(device, bufs.positions.getMemory());
+            vkUnmapMemory(device, bufs.normals.getMemory());
+            vkUnmapMemory(device, bufs.uvs.getMemory());
+            vkUnmapMemory(device, bufs.indices.getMemory());
+            throw;
+        }
+
+        vkUnmapMemory(device, bufs.positions.getMemory());
+        vkUnmapMemory(device, bufs.normals.getMemory());
+        vkUnmapMemory(device, bufs.uvs.getMemory());
+        vkUnmapMemory(device, bufs.indices.getMemory());
+
+        batch.elementCount = 0;
+        job.writeSlot ^= 1;
+
+        auto now = std::chrono::high_resolution_clock::now();
+        if (std::chrono::duration<double, std::milli>(now - stepStart).count() >= budgetMs) break;
+    }
+
+    if (job.elementsWritten < job.numElements) return false;
+
+    job.writer->close();
+
+    // Append base mesh if visible
+    if (job.appendBaseMesh && baseMeshMode > 0 && !loadedMeshPath.empty()) {
         NGonMesh baseMesh = ObjLoader::load(loadedMeshPath);
         // OBJ indices are 1-based; offset by the procedural vertex count
-        ObjWriter::appendMesh(filepath, baseMesh, totalVerts + 1);
+        ObjWriter::appendMesh(job.filepath, baseMesh,
+                              static_cast<uint32_t>(job.writer->verticesWritten()) + 1);
     }
 
-    // --- 7. Cleanup ---
-    vkDestroyDescriptorPool(device, exportPool, nullptr);
-    exportBufs.destroy();
+    std::cout << "Export complete: " << job.filepath << " ("
+              << (glfwGetTime() - job.startTime) << " s)" << std::endl;
+    destroyProceduralExport();
+    return true;
+}
 
-    std::cout << "Export complete: " << filepath << std::endl;
+void Renderer::destroyProceduralExport() {
+    ProceduralExportJob& job = exportJob;
+    for (auto& batch : job.batches) {
+        if (batch.fence != VK_NULL_HANDLE) {
+            if (batch.elementCount > 0) {
+                vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+            }
+            vkDestroyFence(device, batch.fence, nullptr);
+            batch.fence = VK_NULL_HANDLE;
+        }
+        if (batch.commandBuffer != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(device, commandPool, 1, &batch.commandBuffer);
+            batch.commandBuffer = VK_NULL_HANDLE;
+        }
+        batch.descriptorSet = VK_NULL_HANDLE;
+        batch.elementCount = 0;
+        batch.buffers.destroy();
+    }
+    if (job.descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, job.descriptorPool, nullptr);
+        job.descriptorPool = VK_NULL_HANDLE;
+    }
+    job.configDescriptorSet = VK_NULL_HANDLE;
+    if (job.configUBO != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, job.configUBO, nullptr);
+        vkFreeMemory(device, job.configUBOMemory, nullptr);
+        job.configUBO = VK_NULL_HANDLE;
+        job.configUBOMemory = VK_NULL_HANDLE;
+    }
+    job.scaleLut.destroy();
+    if (job.writer) job.writer->close();
+    job.writer.reset();
+    job.runs.clear();
+    job.elementOrder = {};
+    job.currentRun = 0;
+    job.cpuBackend = false;
+    job.pebbles.reset();
+    job.pebbleArenas = {};
+    job.cpuPositions = {};
+    job.cpuNormals = {};
+    job.cpuUVs = {};
+    job.cpuIndices = {};
+    job.weldPositions = {};
+    job.weldNormals = {};
+    job.weldUVs = {};
+    job.weldIndices = {};
+    job.active = false;
+    job.nextElement = 0;
+    job.elementsWritten = 0;
+    job.submitSlot = 0;
+    job.writeSlot = 0;
 }
@@ -1,6 +1,9 @@
 #include "renderer/renderer.h"
 #include "renderer/renderer_imgui.h"
 #include "core/window.h"
+#include "core/JobSystem.h"
+#include "core/MemoryTracker.h"
+#include "core/Trace.h"
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
@@ -225,6 +228,21 @@ void Renderer::renderImGui(VkCommandBuffer cmd) {
         ImGui::ProgressBar(usageMB / budgetMB, ImVec2(-1, 0), "");
     }
 
+    // Host RAM held by the tracked CPU-side copies (see MemoryTracker.h)
+    const float toMB = 1.0f / (1024.0f * 1024.0f);
+    ImGui::Text("Host RAM:   %.2f MB (peak %.2f MB)",
+                MemoryTracker::totalCurrent() * toMB, MemoryTracker::totalPeak() * toMB);
+    if (ImGui::TreeNode("Host RAM by subsystem")) {
+        for (uint32_t t = 0; t < static_cast<uint32_t>(MemTag::Count); t++) {
+            MemTag tag = static_cast<MemTag>(t);
+            MemoryTracker::Stats mem = MemoryTracker::stats(tag);
+            ImGui::Text("%-10s %8.2f MB  peak %8.2f MB", MemoryTracker::tagName(tag),
+                        mem.current * toMB, mem.peak * toMB);
+        }
+        if (ImGui::SmallButton("Reset Peaks")) MemoryTracker::resetPeaks();
+        ImGui::TreePop();
+    }
+
     ImGui::Separator();
 
     // Mesh stats
@@ -330,6 +348,28 @@ void Renderer::renderImGui(VkCommandBuffer cmd) {
     } else {
         ImGui::TextDisabled("(enable to count GPU invocations)");
     }
+    ImGui::Separator();
+    JobSystem::Stats jobStats = JobSystem::get().stats();
+    ImGui::Text("Job Threads:         %u + main", jobStats.workers);
+    ImGui::Text("Jobs Run:            %llu (%llu stolen)",
+                static_cast<unsigned long long>(jobStats.tasksRun),
+                static_cast<unsigned long long>(jobStats.steals));
+#if GRAVEL_TRACING
+    ImGui::Text("CPU Trace:           %zu events", Trace::eventCount());
+    if (ImGui::Button("Save Trace##trace")) {
+        try {
+            Trace::writeChromeJson(std::string(BUILD_DIR) + "gravel_trace.json");
+        } catch (const std::exception& e) {
+            std::cerr << "Trace save failed: " << e.what() << std::endl;
+        }
+    }
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Chrome trace JSON (chrome://tracing or ui.perfetto.dev)\n" BUILD_DIR "gravel_trace.json");
+    ImGui::SameLine();
+    if (ImGui::Button("Clear##trace")) Trace::clear();
+    ImGui::SameLine();
+    ImGui::Checkbox("Save on exit##trace", &traceOnExit);
+#endif
     ImGui::Unindent();
 
     ImGui::End();
@@ -400,6 +440,9 @@ void Renderer::renderImGui(VkCommandBuffer cmd) {
         ImGui::Checkbox("Triangulate", &triangulateMesh);
         ImGui::SliderInt("Subdivide", &subdivideLevel, 0, 3);
         ImGui::SliderInt("Subdivide Flat", &subdivideFlatLevel, 0, 3);
+        ImGui::Checkbox("Texture Cache", &useTextureCache);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Reuse decoded textures from " BUILD_DIR "texture_cache/ on later loads");
         if (selectedMesh != prev || triangulateMesh != prevTri || subdivideLevel != prevSubdiv || subdivideFlatLevel != prevFlatSubdiv)
             pendingMeshLoad = assetMeshPaths[selectedMesh];
         const char* baseMeshModes[] = { "Off", "Wireframe", "Solid", "Both", "Mask", "Skin", "Colored Faces" };
@@ -453,7 +496,9 @@ void Renderer::renderImGui(VkCommandBuffer cmd) {
                 exportPaths.clear();
                 if (std::filesystem::is_directory("exports")) {
                     for (const auto& entry : std::filesystem::directory_iterator("exports")) {
-                        if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+                        auto ext = entry.path().extension();
+                        if (entry.is_regular_file() && (ext == ".obj" || ext == ".glb" || ext == ".ply" ||
+                                                         ext == ".gmlt")) {
                             exportNames.push_back(entry.path().filename().string());
                             exportPaths.push_back(entry.path().string());
                         }
@@ -689,8 +734,8 @@ void Renderer::renderImGui(VkCommandBuffer cmd) {
 
     ImGui::End();
 
-    // Loading overlay (in progress)
-    if (loadingActive) {
+    // Loading overlay (in progress); background mesh loads share it
+    if (loadingActive || meshLoadInFlight()) {
         ImVec2 displaySize = ImGui::GetIO().DisplaySize;
         ImGui::SetNextWindowPos(ImVec2(displaySize.x * 0.5f, displaySize.y * 0.5f),
                                 posCond, ImVec2(0.5f, 0.5f));
@@ -699,9 +744,13 @@ void Renderer::renderImGui(VkCommandBuffer cmd) {
                      ImGuiWindowFlags_NoTitleBar  |
                      ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoScrollbar |
                      0);
-        ImGui::Text("%s", loadingMessage.c_str());
-        float progress = static_cast<float>(fmod(ImGui::GetTime() * 0.5, 1.0));
-        ImGui::ProgressBar(progress, ImVec2(-1, 0), "");
+        ImGui::Text("%s", loadingActive ? loadingMessage.c_str() : "Loading mesh...");
+        if (loadingActive && loadingProgress >= 0.0f) {
+            ImGui::ProgressBar(loadingProgress, ImVec2(-1, 0));
+        } else {
+            float progress = static_cast<float>(fmod(ImGui::GetTime() * 0.5, 1.0));
+            ImGui::ProgressBar(progress, ImVec2(-1, 0), "");
+        }
         ImGui::End();
     }
 
@@ -953,7 +953,7 @@ void Renderer::createDescriptorSetLayouts() {
     // Binding 3: float buffers[1] (faceAreas)
     // Binding 4: curvature float[1] (GRWM, optional)
     // Binding 5: feature flags uint[1] (GRWM, optional)
-    // Binding 6: slot entries SlotEntry[1] (GRWM, optional)
+    // Binding 6: packed slot u,v uint[1] (GRWM, optional)
     // Binding 7: proxy face data (written by task shader, read by base mesh frag)
     std::array<VkDescriptorSetLayoutBinding, 8> heBindings{};
     VkShaderStageFlags heStages = VK_SHADER_STAGE_TASK_BIT_EXT |
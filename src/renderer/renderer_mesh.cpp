@@ -2,8 +2,13 @@
 #include "renderer/renderer_mesh.h"
 #include "geometry/HalfEdge.h"
 #include "loaders/ObjLoader.h"
-#include "loaders/ImageLoader.h"
 #include "loaders/GltfLoader.h"
+#include "loaders/BinaryMeshLoader.h"
+#include "preprocess/GrvpFile.h"
+#include "preprocess/SlotGenerator.h"
+#include "core/JobSystem.h"
+#include "core/MemoryTracker.h"
+#include "core/Trace.h"
 #include <tiny_gltf.h>
 #include "core/window.h"
 #include "imgui.h"
@@ -16,8 +21,8 @@
 #include <stdexcept>
 #include <filesystem>
 #include <algorithm>
+#include <cctype>
 #include <set>
-#include <thread>
 
 #ifndef ASSETS_DIR
 #define ASSETS_DIR ""
@@ -34,15 +39,20 @@ void Renderer::scanAssetMeshes() {
         return;
     }
 
-    // Recursively find all .obj files in base mesh folder
+    // Recursively find all .obj / .gltf / .glb files in base mesh folder
     std::vector<std::pair<std::string, std::string>> entries; // (name, path)
     for (const auto& entry : std::filesystem::recursive_directory_iterator(baseMeshDir)) {
         if (!entry.is_regular_file()) continue;
-        if (entry.path().extension() != ".obj") continue;
+        std::string ext = entry.path().extension().string();
+        if (ext != ".obj" && ext != ".gltf" && ext != ".glb") continue;
 
         std::string fullPath = entry.path().string();
         std::string stem = entry.path().stem().string();
 
+        // glTF next to a same-named OBJ only supplies its skeleton
+        if (ext != ".obj" && std::filesystem::exists(
+                std::filesystem::path(fullPath).replace_extension(".obj"))) continue;
+
         // Skip secondary meshes (loaded via toggle, not standalone)
         if (stem == "dragon_coat") continue;
 
@@ -75,6 +85,7 @@ void Renderer::uploadHEBuffers(const HalfEdgeMesh& mesh,
                                 std::vector<StorageBuffer>& intBufs,
                                 std::vector<StorageBuffer>& floatBufs,
                                 VkBuffer& meshInfoBuf, VkDeviceMemory& meshInfoMem) {
+    TRACE_ZONE("Renderer::uploadHEBuffers");
     vec4Bufs.resize(5);
     vec2Bufs.resize(1);
     intBufs.resize(10);
@@ -188,39 +199,47 @@ void Renderer::writeHEDescriptorSet(VkDescriptorSet dstSet,
 }
 
 void Renderer::uploadHalfEdgeMesh(const HalfEdgeMesh& mesh) {
+    TRACE_ZONE("Renderer::uploadHalfEdgeMesh");
     std::cout << "Uploading half-edge mesh to GPU..." << std::endl;
 
+    // CPU copies for stats, culling and export build on the job system
+    // while the GPU buffers upload here
+    JobSystem& jobs = JobSystem::get();
+    CpuMeshCopies copies;
+    TaskGraph graph;
+    copies.addBuildNodes(graph, mesh);
+    graph.start(jobs);
+
     uploadHEBuffers(mesh, heVec4Buffers, heVec2Buffers, heIntBuffers, heFloatBuffers,
                     meshInfoBuffer, meshInfoMemory);
     writeHEDescriptorSet(heDescriptorSet, heVec4Buffers, heVec2Buffers, heIntBuffers, heFloatBuffers);
+    graph.wait(jobs);
 
-    // Store CPU copies for per-frame stats computation
-    cpuFaceCenters.resize(mesh.nbFaces);
-    cpuFaceNormals.resize(mesh.nbFaces);
-    cpuFaceAreas = mesh.faceAreas;
-    cpuFaceVertCounts = mesh.faceVertCounts;
-    cpuVertexPositions.resize(mesh.nbVertices);
-    cpuVertexNormals.resize(mesh.nbVertices);
-    cpuVertexFaceAreas.resize(mesh.nbVertices);
-    for (uint32_t i = 0; i < mesh.nbFaces; i++) {
-        cpuFaceCenters[i] = glm::vec3(mesh.faceCenters[i]);
-        cpuFaceNormals[i] = glm::vec3(mesh.faceNormals[i]);
-    }
-    cpuFaceUVs.resize(mesh.nbFaces);
-    for (uint32_t i = 0; i < mesh.nbFaces; i++) {
-        // Mirror GPU logic: face baseUV = texcoord of first vertex of face
-        int edge = mesh.faceEdges[i];
-        uint32_t firstVert = static_cast<uint32_t>(mesh.heVertex[edge]);
-        cpuFaceUVs[i] = mesh.vertexTexCoords[firstVert];
-    }
-    cpuVertexUVs.resize(mesh.nbVertices);
-    for (uint32_t i = 0; i < mesh.nbVertices; i++) {
-        cpuVertexPositions[i] = glm::vec3(mesh.vertexPositions[i]);
-        cpuVertexNormals[i]   = glm::vec3(mesh.vertexNormals[i]);
-        int edge = mesh.vertexEdges[i];
-        cpuVertexFaceAreas[i] = (edge >= 0) ? mesh.faceAreas[mesh.heFace[edge]] : 0.0f;
-        cpuVertexUVs[i] = mesh.vertexTexCoords[i];
-    }
+    adoptHalfEdgeMesh(mesh, std::move(copies));
+}
+
+void Renderer::uploadHalfEdgeMesh(const HalfEdgeMesh& mesh, CpuMeshCopies&& copies) {
+    TRACE_ZONE("Renderer::uploadHalfEdgeMesh");
+    std::cout << "Uploading half-edge mesh to GPU..." << std::endl;
+    uploadHEBuffers(mesh, heVec4Buffers, heVec2Buffers, heIntBuffers, heFloatBuffers,
+                    meshInfoBuffer, meshInfoMemory);
+    writeHEDescriptorSet(heDescriptorSet, heVec4Buffers, heVec2Buffers, heIntBuffers, heFloatBuffers);
+    adoptHalfEdgeMesh(mesh, std::move(copies));
+}
+
+void Renderer::adoptHalfEdgeMesh(const HalfEdgeMesh& mesh, CpuMeshCopies&& copies) {
+    cpuFaceCenters     = std::move(copies.faceCenters);
+    cpuFaceNormals     = std::move(copies.faceNormals);
+    cpuFaceAreas       = std::move(copies.faceAreas);
+    cpuVertexPositions = std::move(copies.vertexPositions);
+    cpuVertexNormals   = std::move(copies.vertexNormals);
+    cpuVertexFaceAreas = std::move(copies.vertexFaceAreas);
+    cpuFaceUVs         = std::move(copies.faceUVs);
+    cpuFaceVertCounts  = std::move(copies.faceVertCounts);
+    cpuFaceVertOffsets = std::move(copies.faceVertOffsets);
+    cpuFaceVertIndices = std::move(copies.faceVertIndices);
+    cpuVertexUVs       = std::move(copies.vertexUVs);
+    cpuElementFrames   = std::move(copies.elementFrames);
 
     heMeshUploaded = true;
     visibleCacheDirty = true;
@@ -433,6 +452,17 @@ void Renderer::processInput(Window& win, float deltaTime) {
         } else {
             animationPlaying = false;
         }
+
+        // Crossfade to the clip mapped to the new state. A dedicated idle clip
+        // keeps playing; an idle that shares the walk clip freezes as before.
+        if (useAnimationBlending && animBlender.isInitialized()) {
+            int clip = animStateClips[static_cast<int>(player.getAnimState())];
+            if (animBlender.crossfadeTo(clip, animCrossfadeTime)) animationTime = 0.0f;
+            if (!player.isMoving() && clip != animStateClips[1]) {
+                animationPlaying = true;
+                animationSpeed = 1.0f;
+            }
+        }
     }
 
     // Turntable: left-click drag rotates the object
@@ -533,10 +563,42 @@ void Renderer::cleanupMeshSkeleton() {
     boneCount = 0;
     skeleton = Skeleton{};
     animations.clear();
+    bakedAnimations.clear();
+    skeletonCharge.reset();
+    animBlender.clear();
     jointIndicesData.clear();
     jointWeightsData.clear();
 }
 
+void Renderer::bakeAnimations() {
+    TRACE_ZONE("Renderer::bakeAnimations");
+    size_t budget = size_t(std::max(animationBakeBudgetMB, 0)) * 1024 * 1024;
+    GltfLoader::bakeAnimations(animations, skeleton, animationBakeRate, budget, bakedAnimations);
+}
+
+void Renderer::setupAnimationBlending() {
+    animBlender.init(skeleton, animations);
+    if (animations.empty()) return;
+
+    // Map player states to clips by name; single-clip assets share clip 0
+    auto findClip = [&](std::initializer_list<const char*> keys, int fallback) {
+        for (size_t i = 0; i < animations.size(); i++) {
+            std::string name = animations[i].name;
+            std::transform(name.begin(), name.end(), name.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            for (const char* key : keys) {
+                if (name.find(key) != std::string::npos) return static_cast<int>(i);
+            }
+        }
+        return fallback;
+    };
+    animStateClips[0] = findClip({"idle"}, 0);
+    animStateClips[1] = findClip({"walk"}, 0);
+    animStateClips[2] = findClip({"run", "sprint"}, animStateClips[1]);
+
+    animBlender.crossfadeTo(0, 0.0f);
+}
+
 void Renderer::cleanupSecondaryMesh() {
     // Free descriptor sets before destroying the buffers they reference
     if (secondaryHeDescriptorSet != VK_NULL_HANDLE) {
@@ -590,18 +652,12 @@ void Renderer::cleanupBenchmarkMesh() {
 }
 
 void Renderer::loadBenchmarkMesh(const std::string& path) {
+    TRACE_ZONE("Renderer::loadBenchmarkMesh");
     std::cout << "Loading benchmark mesh: " << path << std::endl;
 
     vkDeviceWaitIdle(device);
     cleanupBenchmarkMesh();
 
-    NGonMesh ngon = ObjLoader::load(path);
-    ObjLoader::triangulate(ngon);
-
-    benchmarkTriCount = ngon.nbFaces;
-    benchmarkNbFaces = ngon.nbFaces;
-    benchmarkNbVertices = ngon.nbVertices;
-
     // Build interleaved vertex buffer: (pos vec3, normal vec3, uv vec2) per unique vertex combo
     // and an index buffer for triangles
     struct BenchmarkVertex {
@@ -610,33 +666,60 @@ void Renderer::loadBenchmarkMesh(const std::string& path) {
         float u, v;
     };
 
-    // Flatten: each face is a triangle with 3 vertices
-    // Use direct vertex expansion (no dedup) for simplicity and speed
-    uint32_t totalVerts = ngon.nbFaces * 3;
-    std::vector<BenchmarkVertex> vertices(totalVerts);
-    std::vector<uint32_t> indices(totalVerts);
+    std::vector<BenchmarkVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    if (BinaryMeshLoader::canLoad(path)) {
+        // Binary exports are already indexed: copy the attributes through
+        TriangleMesh tri = BinaryMeshLoader::load(path);
+        benchmarkTriCount = static_cast<uint32_t>(tri.indices.size() / 3);
+        benchmarkNbFaces = benchmarkTriCount;
+        benchmarkNbVertices = static_cast<uint32_t>(tri.positions.size());
+
+        vertices.resize(tri.positions.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            const glm::vec3& pos = tri.positions[i];
+            glm::vec3 norm = tri.normals.empty() ? glm::vec3(0.0f, 1.0f, 0.0f) : tri.normals[i];
+            glm::vec2 uv = tri.uvs.empty() ? glm::vec2(0.0f) : tri.uvs[i];
+            vertices[i] = { pos.x, pos.y, pos.z, norm.x, norm.y, norm.z, uv.x, uv.y };
+        }
+        indices = std::move(tri.indices);
+    } else {
+        NGonMesh ngon = ObjLoader::load(path);
+        ObjLoader::triangulate(ngon);
 
-    for (uint32_t f = 0; f < ngon.nbFaces; f++) {
-        const auto& face = ngon.faces[f];
-        glm::vec3 faceNormal = glm::vec3(face.normal);
+        benchmarkTriCount = ngon.nbFaces;
+        benchmarkNbFaces = ngon.nbFaces;
+        benchmarkNbVertices = ngon.nbVertices;
 
-        for (int v = 0; v < 3; v++) {
-            uint32_t idx = f * 3 + v;
-            uint32_t vi = face.vertexIndices[v];
-            const auto& pos = ngon.positions[vi];
+        // Flatten: each face is a triangle with 3 vertices
+        // Use direct vertex expansion (no dedup) for simplicity and speed
+        uint32_t totalVerts = ngon.nbFaces * 3;
+        vertices.resize(totalVerts);
+        indices.resize(totalVerts);
 
-            glm::vec3 norm = faceNormal;
-            if (!face.normalIndices.empty() && face.normalIndices[v] < ngon.normals.size()) {
-                norm = ngon.normals[face.normalIndices[v]];
-            }
+        for (uint32_t f = 0; f < ngon.nbFaces; f++) {
+            const auto& face = ngon.faces[f];
+            glm::vec3 faceNormal = glm::vec3(face.normal);
 
-            glm::vec2 uv(0.0f);
-            if (!face.texCoordIndices.empty() && face.texCoordIndices[v] < ngon.texCoords.size()) {
-                uv = ngon.texCoords[face.texCoordIndices[v]];
-            }
+            for (int v = 0; v < 3; v++) {
+                uint32_t idx = f * 3 + v;
+                uint32_t vi = face.vertexIndices[v];
+                const auto& pos = ngon.positions[vi];
 
-            vertices[idx] = { pos.x, pos.y, pos.z, norm.x, norm.y, norm.z, uv.x, uv.y };
-            indices[idx] = idx;
+                glm::vec3 norm = faceNormal;
+                if (!face.normalIndices.empty() && face.normalIndices[v] < ngon.normals.size()) {
+                    norm = ngon.normals[face.normalIndices[v]];
+                }
+
+                glm::vec2 uv(0.0f);
+                if (!face.texCoordIndices.empty() && face.texCoordIndices[v] < ngon.texCoords.size()) {
+                    uv = ngon.texCoords[face.texCoordIndices[v]];
+                }
+
+                vertices[idx] = { pos.x, pos.y, pos.z, norm.x, norm.y, norm.z, uv.x, uv.y };
+                indices[idx] = idx;
+            }
         }
     }
 
@@ -687,11 +770,12 @@ void Renderer::loadBenchmarkMesh(const std::string& path) {
     float vramMB = static_cast<float>(benchmarkVramBytes) / (1024.0f * 1024.0f);
     std::cout << "Benchmark mesh loaded: " << benchmarkNbFaces << " triangles, "
               << benchmarkNbVertices << " unique vertices, "
-              << totalVerts << " expanded vertices ("
+              << vertices.size() << " buffer vertices ("
               << vramMB << " MB VRAM)" << std::endl;
 }
 
 void Renderer::loadSecondaryMesh(const std::string& path) {
+    TRACE_ZONE("Renderer::loadSecondaryMesh");
     std::cout << "  Loading secondary mesh: " << path << std::endl;
 
     NGonMesh ngon = ObjLoader::load(path);
@@ -772,7 +856,7 @@ void Renderer::loadSecondaryMesh(const std::string& path) {
         if (std::filesystem::exists(gltfPath)) {
             try {
                 tinygltf::Model gltfModel = GltfLoader::loadModel(gltfPath);
-                std::vector<glm::vec4> secJointIndices, secJointWeights;
+                JointData secJointIndices, secJointWeights;
                 GltfLoader::matchBoneDataToObjMesh(gltfModel, ngon.positions,
                                                     skeleton, secJointIndices, secJointWeights);
 
@@ -848,6 +932,7 @@ void Renderer::loadSecondaryMesh(const std::string& path) {
 }
 
 void Renderer::generateGroundPlane(float cellSize) {
+    TRACE_ZONE("Renderer::generateGroundPlane");
     // Compute grid resolution from desired world size.
     uint32_t N = static_cast<uint32_t>(std::ceil(groundWorldSize / cellSize));
     N = std::max(N, 4u);
@@ -1049,6 +1134,23 @@ void Renderer::generateGroundPlane(float cellSize) {
     computeFace2Coloring(mesh);
     groundNbFaces = mesh.nbFaces;
 
+    groundCpuVertexPositions.resize(mesh.nbVertices);
+    for (uint32_t i = 0; i < mesh.nbVertices; i++)
+        groundCpuVertexPositions[i] = glm::vec3(mesh.vertexPositions[i]);
+    groundCpuFaceCenters.resize(mesh.nbFaces);
+    groundCpuFaceNormals.resize(mesh.nbFaces);
+    groundCpuFaceVertOffsets.resize(size_t(mesh.nbFaces) + 1);
+    groundCpuFaceVertIndices.clear();
+    for (uint32_t i = 0; i < mesh.nbFaces; i++) {
+        groundCpuFaceCenters[i] = glm::vec3(mesh.faceCenters[i]);
+        groundCpuFaceNormals[i] = glm::vec3(mesh.faceNormals[i]);
+        groundCpuFaceVertOffsets[i] = static_cast<uint32_t>(groundCpuFaceVertIndices.size());
+        for (int k = 0; k < mesh.faceVertCounts[i]; k++)
+            groundCpuFaceVertIndices.push_back(
+                static_cast<uint32_t>(mesh.vertexFaceIndices[mesh.faceOffsets[i] + k]));
+    }
+    groundCpuFaceVertOffsets[mesh.nbFaces] = static_cast<uint32_t>(groundCpuFaceVertIndices.size());
+
     // --- Upload new GPU buffers ---
     uploadHEBuffers(mesh, groundHeVec4Buffers, groundHeVec2Buffers,
                     groundHeIntBuffers, groundHeFloatBuffers,
@@ -1153,6 +1255,11 @@ void Renderer::cleanupGroundMesh() {
     groundPebbleDescriptorSet = VK_NULL_HANDLE;
     groundNbFaces    = 0;
     groundMeshActive = false;
+    groundCpuVertexPositions.clear();
+    groundCpuFaceCenters.clear();
+    groundCpuFaceNormals.clear();
+    groundCpuFaceVertOffsets.clear();
+    groundCpuFaceVertIndices.clear();
 }
 
 glm::vec3 Renderer::playerForwardDir() const {
@@ -1310,6 +1417,7 @@ void Renderer::loadScaleLut() {
     scaleLutBuffer.create(device, physicalDevice,
                           packed.size() * sizeof(glm::vec4),
                           packed.data());
+    cpuScaleLutPoints = std::move(packed);  // for the CPU export backend
 
     // Store LUT metadata as flat renderer member vars (picked up each frame by UBO upload)
     scaleLutNx        = Nx;
@@ -1343,6 +1451,7 @@ void Renderer::loadScaleLut() {
 
 void Renderer::cleanupScaleLut() {
     scaleLutBuffer.destroy();
+    cpuScaleLutPoints.clear();
     scaleLutLoaded = false;
 }
 
@@ -1351,17 +1460,23 @@ void Renderer::cleanupGrwmPreprocess() {
     heFeatureFlagsBuffer.destroy();
     heSlotsBuffer.destroy();
     preprocessLoaded = false;
+    slotsGenerated = false;
     slotsPerFace = 0;
+    preprocessVersion = 0;
 }
 
 void Renderer::runGrwmPreprocess() {
+    TRACE_ZONE("Renderer::runGrwmPreprocess");
     if (loadedMeshPath.empty()) {
         grwmStatus = "No mesh loaded";
         return;
     }
 
+    std::string dir = loadedMeshPath.substr(0, loadedMeshPath.find_last_of("/\\") + 1);
+    std::string outputDir = dir + "preprocess/";
+
     // Auto-detect GRWM binary: try submodule path first, then fallback
-    if (grwmBinaryPath.empty() || !std::filesystem::exists(grwmBinaryPath)) {
+    if (!grwmUseNative && (grwmBinaryPath.empty() || !std::filesystem::exists(grwmBinaryPath))) {
         std::string paths[] = { GRWM_BINARY_PATH, GRWM_BINARY_PATH_FALLBACK };
         grwmBinaryPath.clear();
         for (const auto& p : paths) {
@@ -1372,209 +1487,65 @@ void Renderer::runGrwmPreprocess() {
             }
         }
     }
-    if (grwmBinaryPath.empty()) {
-        grwmStatus = "GRWM binary not found";
+
+    // Job runs the binary, or the in-process CPU preprocessor when there is
+    // none; identical mesh content + settings are served from the cache
+    GrwmJobManager::Request request;
+    request.meshPath = loadedMeshPath;
+    request.outputDir = outputDir;
+    request.cacheRoot = grwmUseCache ? std::string(BUILD_DIR) + "grwm_cache/" : std::string();
+    request.binaryPath = grwmUseNative ? std::string() : grwmBinaryPath;
+    request.slotsPerFace = grwmSlotsPerFace;
+    request.featureThreshold = grwmFeatureThreshold;
+
+    if (!grwmJobs.start(request)) {
+        grwmStatus = "A GRWM job is already running";
         return;
     }
+    grwmStatus.clear();
+}
 
+void Renderer::convertGrwmPreprocessToV2() {
+    if (loadedMeshPath.empty()) return;
     std::string dir = loadedMeshPath.substr(0, loadedMeshPath.find_last_of("/\\") + 1);
-    std::string outputDir = dir + "preprocess/";
-    std::filesystem::create_directories(outputDir);
-
-    std::string cmd = grwmBinaryPath
-        + " " + loadedMeshPath
-        + " --output " + outputDir
-        + " --slots " + std::to_string(grwmSlotsPerFace)
-        + " --feature-threshold " + std::to_string(grwmFeatureThreshold)
-        + " 2>&1";
-
-    grwmStatus = "Running...";
-    grwmRunning = true;
-
-    // Run in background thread so the render loop keeps running
-    std::thread([this, cmd]() {
-        int result = system(cmd.c_str());
-
-        grwmRunning = false;
-        if (result == 0) {
-            grwmStatus = "Done — will load next frame";
-            grwmPendingLoad = true;
-        } else {
-            grwmStatus = "Pipeline failed (exit code " + std::to_string(result) + ")";
-        }
-    }).detach();
+    try {
+        GrvpFile::convertV1ToV2(dir + "preprocess/");
+        grwmStatus = "Converted to GRVP v2";
+        grwmPendingLoad = true;
+    } catch (const std::exception& e) {
+        grwmStatus = std::string("Conversion failed: ") + e.what();
+    }
 }
 
 void Renderer::loadGrwmPreprocess(const std::string& meshPath) {
+    TRACE_ZONE("Renderer::loadGrwmPreprocess");
     cleanupGrwmPreprocess();
+    GrwmPreprocessData data = GrwmPreprocessData::read(
+        meshPath, heNbVertices, heNbFaces, cpuFaceVertCounts.data(),
+        cpuOriginalVertexIndices.data(), cpuOriginalVertexIndices.size(), cpuOriginalVertexCount);
+    uploadGrwmPreprocess(data);
+}
 
-    std::string dir = meshPath.substr(0, meshPath.find_last_of("/\\") + 1);
-    std::string preprocessDir = dir + "preprocess/";
-
-    if (!std::filesystem::is_directory(preprocessDir)) {
-        std::cout << "  No preprocess directory found at " << preprocessDir << std::endl;
-        return;
-    }
-
-    auto readHeader = [](const std::string& path, PreprocessHeader& hdr) -> bool {
-        std::ifstream f(path, std::ios::binary);
-        if (!f) return false;
-        f.read(reinterpret_cast<char*>(&hdr), sizeof(PreprocessHeader));
-        return f.good() && hdr.magic == 0x47525650 && hdr.version == 1;
-    };
-
-    // Read all three headers first to validate
-    PreprocessHeader curvHdr{}, featHdr{}, slotsHdr{};
-    std::string curvPath = preprocessDir + "curvature.bin";
-    std::string featPath = preprocessDir + "features.bin";
-    std::string slotsPath = preprocessDir + "slots.bin";
-
-    if (!readHeader(curvPath, curvHdr) || !readHeader(featPath, featHdr) || !readHeader(slotsPath, slotsHdr)) {
-        std::cerr << "  Warning: GRWM preprocess files missing or invalid header" << std::endl;
-        return;
-    }
-
-    // Check if we need vertex remapping (split vertices from UV/normal seams)
-    bool needsVertexRemap = (curvHdr.vertex_count != heNbVertices)
-                            && !cpuOriginalVertexIndices.empty()
-                            && curvHdr.vertex_count == cpuOriginalVertexCount;
-
-    if (curvHdr.vertex_count != heNbVertices && !needsVertexRemap) {
-        std::cerr << "  Warning: curvature.bin vertex count (" << curvHdr.vertex_count
-                  << ") != mesh (" << heNbVertices << ")" << std::endl;
-        return;
-    }
-
-    // Determine if we need tri->ngon remapping.
-    // GRWM always triangulates, so its face_count may differ from ours.
-    bool needsRemap = (featHdr.face_count != heNbFaces);
-    uint32_t grwmFaceCount = featHdr.face_count;
-    uint32_t grwmSlotsPerFace = slotsHdr.slots_per_face;
-
-    if (needsRemap) {
-        // Verify the triangle count is consistent: each original face of N verts
-        // produces (N-2) triangles. Sum should equal GRWM face count.
-        uint32_t expectedTriCount = 0;
-        for (uint32_t i = 0; i < heNbFaces; i++)
-            expectedTriCount += static_cast<uint32_t>(cpuFaceVertCounts[i]) - 2;
-
-        if (expectedTriCount != grwmFaceCount) {
-            std::cerr << "  Warning: GRWM face count (" << grwmFaceCount
-                      << ") != expected triangulated count (" << expectedTriCount
-                      << ") from " << heNbFaces << " original faces" << std::endl;
-            return;
-        }
-        std::cout << "  Remapping GRWM data: " << grwmFaceCount << " triangles -> "
-                  << heNbFaces << " original faces" << std::endl;
-    }
-
-    // --- Curvature (per-vertex, remap if vertices were split at UV/normal seams) ---
-    {
-        std::vector<float> rawCurvature(curvHdr.vertex_count);
-        std::ifstream f(curvPath, std::ios::binary);
-        f.seekg(sizeof(PreprocessHeader));
-        f.read(reinterpret_cast<char*>(rawCurvature.data()), rawCurvature.size() * sizeof(float));
-
-        std::vector<float> curvature;
-        if (needsVertexRemap) {
-            curvature.resize(heNbVertices);
-            for (uint32_t i = 0; i < heNbVertices; i++)
-                curvature[i] = rawCurvature[cpuOriginalVertexIndices[i]];
-            std::cout << "  Remapping curvature: " << curvHdr.vertex_count
-                      << " original -> " << heNbVertices << " split vertices" << std::endl;
-        } else {
-            curvature = std::move(rawCurvature);
-        }
-
-        heCurvatureBuffer.create(device, physicalDevice,
-            curvature.size() * sizeof(float), curvature.data());
-
-        // Compute median curvature for normalization
-        std::vector<float> sorted = curvature;
-        std::sort(sorted.begin(), sorted.end());
-        float median = sorted[sorted.size() / 2];
-        preprocessCurvatureScale = (median > 1e-6f) ? (1.0f / median) : 1.0f;
-        std::cout << "  Loaded curvature.bin (" << curvHdr.vertex_count
-                  << " vertices, median=" << median << ")" << std::endl;
-    }
-
-    // --- Features (per-face, remap: OR child triangle flags) ---
-    {
-        std::vector<uint8_t> triFlags(grwmFaceCount);
-        std::ifstream f(featPath, std::ios::binary);
-        f.seekg(sizeof(PreprocessHeader));
-        f.read(reinterpret_cast<char*>(triFlags.data()), triFlags.size());
-
-        std::vector<uint32_t> flags(heNbFaces);
-        if (needsRemap) {
-            uint32_t triIdx = 0;
-            for (uint32_t faceId = 0; faceId < heNbFaces; faceId++) {
-                uint32_t numTris = static_cast<uint32_t>(cpuFaceVertCounts[faceId]) - 2;
-                uint32_t merged = 0;
-                for (uint32_t t = 0; t < numTris; t++)
-                    merged |= triFlags[triIdx++];
-                flags[faceId] = merged;
-            }
-        } else {
-            for (uint32_t i = 0; i < grwmFaceCount; i++) flags[i] = triFlags[i];
-        }
-
-        heFeatureFlagsBuffer.create(device, physicalDevice,
-            flags.size() * sizeof(uint32_t), flags.data());
-        std::cout << "  Loaded features.bin (" << heNbFaces << " faces)" << std::endl;
-    }
+void Renderer::uploadGrwmPreprocess(const GrwmPreprocessData& data) {
+    if (!data.loaded) return;
 
-    // --- Slots (per-face, remap: merge child triangle slots, sort, keep top N) ---
-    {
-        std::vector<SlotEntry> triSlots(grwmFaceCount * grwmSlotsPerFace);
-        std::ifstream f(slotsPath, std::ios::binary);
-        f.seekg(sizeof(PreprocessHeader));
-        f.read(reinterpret_cast<char*>(triSlots.data()), triSlots.size() * sizeof(SlotEntry));
-
-        slotsPerFace = grwmSlotsPerFace;
-        std::vector<SlotEntry> finalSlots(heNbFaces * slotsPerFace);
-
-        if (needsRemap) {
-            uint32_t triIdx = 0;
-            for (uint32_t faceId = 0; faceId < heNbFaces; faceId++) {
-                uint32_t numTris = static_cast<uint32_t>(cpuFaceVertCounts[faceId]) - 2;
-
-                // Gather all slots from child triangles
-                std::vector<SlotEntry> merged;
-                merged.reserve(numTris * grwmSlotsPerFace);
-                for (uint32_t t = 0; t < numTris; t++) {
-                    uint32_t base = (triIdx + t) * grwmSlotsPerFace;
-                    for (uint32_t s = 0; s < grwmSlotsPerFace; s++)
-                        merged.push_back(triSlots[base + s]);
-                }
-                triIdx += numTris;
-
-                // Sort by priority descending, keep top slotsPerFace
-                std::sort(merged.begin(), merged.end(),
-                    [](const SlotEntry& a, const SlotEntry& b) {
-                        return a.priority > b.priority;
-                    });
-
-                uint32_t outBase = faceId * slotsPerFace;
-                for (uint32_t s = 0; s < slotsPerFace; s++) {
-                    if (s < merged.size())
-                        finalSlots[outBase + s] = merged[s];
-                    else
-                        finalSlots[outBase + s] = {0.5f, 0.5f, 0.0f, s};
-                }
-            }
-        } else {
-            finalSlots = std::move(triSlots);
-        }
-
-        heSlotsBuffer.create(device, physicalDevice,
-            finalSlots.size() * sizeof(SlotEntry), finalSlots.data());
-        std::cout << "  Loaded slots.bin (" << heNbFaces << " faces x "
-                  << slotsPerFace << " slots)" << std::endl;
-    }
+    preprocessVersion = data.version;
+    preprocessCurvatureScale = data.curvatureScale;
+    slotsPerFace = data.slotsPerFace;
+    heCurvatureBuffer.create(device, physicalDevice,
+        data.curvature.size() * sizeof(float), data.curvature.data());
+    heFeatureFlagsBuffer.create(device, physicalDevice,
+        data.features.size() * sizeof(uint32_t), data.features.data());
+    heSlotsBuffer.create(device, physicalDevice,
+        data.slots.size() * sizeof(PackedSlot), data.slots.data());
 
     preprocessLoaded = true;
+    updateMeshInfoSlots();
+
+    std::cout << "  GRWM preprocessed data loaded successfully" << std::endl;
+}
 
+void Renderer::updateMeshInfoSlots() {
     // Re-upload MeshInfoUBO with slotsPerFace
     MeshInfoUBO meshInfo{};
     meshInfo.nbVertices = heNbVertices;
@@ -1585,12 +1556,44 @@ void Renderer::loadGrwmPreprocess(const std::string& meshPath) {
     vkMapMemory(device, meshInfoMemory, 0, sizeof(MeshInfoUBO), 0, &data);
     memcpy(data, &meshInfo, sizeof(MeshInfoUBO));
     vkUnmapMemory(device, meshInfoMemory);
+}
 
-    std::cout << "  GRWM preprocessed data loaded successfully" << std::endl;
+void Renderer::generateFaceSlots() {
+    TRACE_ZONE("Renderer::generateFaceSlots");
+    if (!heMeshUploaded || preprocessLoaded) return;
+
+    heSlotsBuffer.destroy();
+    slotsGenerated = false;
+    if (!enableSlotGenerator) {
+        slotsPerFace = 0;
+        updateMeshInfoSlots();
+        return;
+    }
+
+    SlotGenerator::Settings settings;
+    settings.slotsPerFace = static_cast<uint32_t>(std::max(1, slotGenCount));
+    settings.curvatureBias = std::max(0.0f, slotGenCurvatureBias);
+    SlotGenerator::Faces faces;
+    faces.vertexPositions = cpuVertexPositions.data();
+    faces.vertexNormals = cpuVertexNormals.size() == cpuVertexPositions.size() ? cpuVertexNormals.data() : nullptr;
+    faces.faceVertOffsets = cpuFaceVertOffsets.data();
+    faces.faceVertIndices = cpuFaceVertIndices.data();
+    faces.nbFaces = cpuFaceVertOffsets.empty() ? 0 : static_cast<uint32_t>(cpuFaceVertOffsets.size() - 1);
+    uploadGeneratedSlots(SlotGenerator::generate(faces, settings), settings.slotsPerFace);
+}
+
+void Renderer::uploadGeneratedSlots(const std::vector<PackedSlot>& slots, uint32_t perFace) {
+    if (slots.empty()) return;
+
+    heSlotsBuffer.create(device, physicalDevice, slots.size() * sizeof(PackedSlot), slots.data());
+    slotsPerFace = perFace;
+    slotsGenerated = true;
+    updateMeshInfoSlots();
 }
 
 void Renderer::writeGrwmDescriptors(VkDescriptorSet dstSet) {
-    if (!preprocessLoaded) return;
+    // Bindings are PARTIALLY_BOUND: generated slots come without curvature/features
+    if (!preprocessLoaded && !slotsGenerated) return;
 
     VkDescriptorBufferInfo curvInfo{};
     curvInfo.buffer = heCurvatureBuffer.getBuffer();
@@ -1611,78 +1614,157 @@ void Renderer::writeGrwmDescriptors(VkDescriptorSet dstSet) {
     for (auto& w : writes) w.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 
     writes[0].dstSet = dstSet;
-    writes[0].dstBinding = 4;
+    writes[0].dstBinding = 6;
     writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     writes[0].descriptorCount = 1;
-    writes[0].pBufferInfo = &curvInfo;
+    writes[0].pBufferInfo = &slotsInfo;
 
     writes[1].dstSet = dstSet;
-    writes[1].dstBinding = 5;
+    writes[1].dstBinding = 4;
     writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     writes[1].descriptorCount = 1;
-    writes[1].pBufferInfo = &featInfo;
+    writes[1].pBufferInfo = &curvInfo;
 
     writes[2].dstSet = dstSet;
-    writes[2].dstBinding = 6;
+    writes[2].dstBinding = 5;
     writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     writes[2].descriptorCount = 1;
-    writes[2].pBufferInfo = &slotsInfo;
+    writes[2].pBufferInfo = &featInfo;
 
-    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
-                           writes.data(), 0, nullptr);
+    uint32_t writeCount = preprocessLoaded ? 3u : 1u;
+    vkUpdateDescriptorSets(device, writeCount, writes.data(), 0, nullptr);
 }
 
-void Renderer::loadAndUploadTexture(const std::string& path, VulkanTexture& texture,
-                                     VkFormat format, bool& loadedFlag) {
-    if (!std::filesystem::exists(path)) return;
+void Renderer::uploadTexture(const MeshPackage::Texture& texture, VulkanTexture& target,
+                             VkFormat format, bool& loadedFlag) {
+    TRACE_ZONE("Renderer::uploadTexture");
+    if (!texture.loaded()) return;
 
-    ImageData img = ImageLoader::load(path);
-    if (img.pixels.empty()) return;
-
-    texture.create(device, physicalDevice, img.width, img.height, format);
-    texture.uploadData(commandPool, graphicsQueue, physicalDevice,
-                       img.pixels.data(), img.pixels.size());
+    const ImageData& img = texture.image;
+    target.create(device, physicalDevice, img.width, img.height, format);
+    target.uploadData(commandPool, graphicsQueue, physicalDevice,
+                      img.pixels.data(), img.pixels.size());
     loadedFlag = true;
 
-    std::cout << "  Loaded texture: " << path
+    std::cout << "  Loaded texture: " << texture.path
               << " (" << img.width << "x" << img.height << ")" << std::endl;
 }
 
+MeshPackage::Settings Renderer::meshLoadSettings() const {
+    MeshPackage::Settings settings;
+    settings.triangulate = triangulateMesh;
+    settings.subdivideLevel = subdivideLevel;
+    settings.subdivideFlatLevel = subdivideFlatLevel;
+    settings.generateSlots = enableSlotGenerator;
+    settings.slotSettings.slotsPerFace = static_cast<uint32_t>(std::max(1, slotGenCount));
+    settings.slotSettings.curvatureBias = std::max(0.0f, slotGenCurvatureBias);
+    settings.bakeRate = animationBakeRate;
+    settings.bakeBudgetMB = animationBakeBudgetMB;
+    settings.textureCacheDir = useTextureCache ? std::string(BUILD_DIR) + "texture_cache/" : std::string();
+    return settings;
+}
+
 void Renderer::loadMesh(const std::string& path) {
-    vkDeviceWaitIdle(device);
+    TRACE_ZONE("Renderer::loadMesh");
+    // The newer request wins; the old task stops at its next stage
+    if (meshLoad) {
+        meshLoad->cancel = true;
+        retiredMeshLoads.push_back(std::move(meshLoad));
+    }
+    meshLoad = std::make_unique<MeshLoadJob>();
+    meshLoad->startTime = static_cast<float>(glfwGetTime());
+
+    MeshLoadJob* job = meshLoad.get();
+    MeshPackage::Settings settings = meshLoadSettings();
+    std::cout << "Loading mesh: " << path << std::endl;
+    JobSystem::get().submitBackground([job, path, settings] {
+        try {
+            job->prepared = job->package.prepare(path, settings, job->cancel);
+        } catch (const std::exception& e) {
+            job->error = e.what();
+        } catch (...) {
+            job->error = "unknown exception";
+        }
+    }, job->done);
+}
 
-    // Cleanup previous mesh resources
-    cleanupSecondaryMesh();
-    cleanupMeshTextures();
-    cleanupMeshSkeleton();
-    cleanupGrwmPreprocess();
+void Renderer::pollMeshLoad() {
+    std::erase_if(retiredMeshLoads, [](const auto& job) { return job->done.done(); });
+    if (!meshLoad || !meshLoad->done.done()) return;
 
-    loadedMeshPath = path;
-    NGonMesh ngon = ObjLoader::load(path);
-    if (triangulateMesh) {
-        ObjLoader::triangulate(ngon);
+    std::unique_ptr<MeshLoadJob> job = std::move(meshLoad);
+    if (!job->prepared) {
+        // The previous mesh stays loaded
+        std::cerr << "Mesh load failed: " << job->package.path << ": " << job->error << std::endl;
+        return;
+    }
+    commitMeshPackage(job->package);
+
+    if (const LevelPreset* preset = job->preset) {
+        doSkinning = preset->doSkinning;
+        animationPlaying = preset->animationPlaying;
+        animationSpeed = preset->animationSpeed;
+        baseMeshMode = preset->baseMeshMode;
+        if (preset->chainmailMode) {
+            applyPresetChainMail();
+        }
+        if (preset->enableDragonCoat && dragonCoatAvailable) {
+            dragonCoatEnabled = true;
+            loadSecondaryMesh(dragonCoatPath);
+        }
+        if (preset->applyDragonScales) {
+            applyPresetDragonScales();
+            dragonBaseMeshMode = 2;  // Solid
+        }
     }
-    if (subdivideLevel > 0) {
-        ObjLoader::subdivide(ngon, subdivideLevel);
+
+    float now = static_cast<float>(glfwGetTime());
+    loadingDuration = now - job->startTime;
+    loadingDone = true;
+    loadingDoneTime = now;
+}
+
+void Renderer::cancelMeshLoads() {
+    if (meshLoad) {
+        meshLoad->cancel = true;
+        retiredMeshLoads.push_back(std::move(meshLoad));
     }
-    if (subdivideFlatLevel > 0) {
-        ObjLoader::subdivideFlat(ngon, subdivideFlatLevel);
+    JobSystem& jobs = JobSystem::get();
+    for (auto& job : retiredMeshLoads) {
+        try {
+            jobs.wait(job->done);
+        } catch (...) {
+        }
     }
+    retiredMeshLoads.clear();
+}
+
+void Renderer::commitMeshPackage(MeshPackage& package) {
+    TRACE_ZONE("Renderer::commitMeshPackage");
+    {
+        TRACE_ZONE("commitMeshPackage: release previous");
+        vkDeviceWaitIdle(device);
 
-    // Save vertex split mapping before building half-edge (for GRWM curvature remapping)
-    cpuOriginalVertexIndices = ngon.originalVertexIndices;
-    cpuOriginalVertexCount = ngon.originalVertexCount;
+        // Cleanup previous mesh resources
+        cleanupSecondaryMesh();
+        cleanupMeshTextures();
+        cleanupMeshSkeleton();
+        cleanupGrwmPreprocess();
+    }
 
-    HalfEdgeMesh heMesh = HalfEdgeBuilder::build(ngon);
-    computeFace2Coloring(heMesh);
-    uploadHalfEdgeMesh(heMesh);
+    loadedMeshPath = package.path;
+    cpuOriginalVertexIndices = std::move(package.originalVertexIndices);
+    cpuOriginalVertexCount = package.originalVertexCount;
+    uploadHalfEdgeMesh(package.mesh, std::move(package.copies));
 
-    // Load GRWM preprocessed data if available
-    loadGrwmPreprocess(path);
+    // GRWM preprocessed data if it was found, else built-in slots
+    uploadGrwmPreprocess(package.preprocess);
+    if (!preprocessLoaded) uploadGeneratedSlots(package.generatedSlots, package.generatedSlotsPerFace);
     writeGrwmDescriptors(heDescriptorSet);
 
     // Create proxy face data buffer (per-face flags written by task shader, cleared via vkCmdFillBuffer)
     {
+        TRACE_ZONE("commitMeshPackage: proxy buffer");
         heProxyBuffer.destroy();
         size_t proxySize = heNbFaces * 4 * sizeof(float);  // ProxyFaceData = 16 bytes
 
@@ -1716,104 +1798,29 @@ void Renderer::loadMesh(const std::string& path) {
         vkUpdateDescriptorSets(device, 1, &w, 0, nullptr);
     }
 
-    // Auto-detect textures in the same directory as the mesh
-    std::string dir = path.substr(0, path.find_last_of("/\\") + 1);
-
-    // Determine AO texture name based on mesh filename
-    std::string filename = path.substr(path.find_last_of("/\\") + 1);
-    if (filename.find("dragon_coat") != std::string::npos) {
-        loadAndUploadTexture(dir + "dragon_coat_ao.png", aoTexture,
-                             VK_FORMAT_R8G8B8A8_SRGB, aoTextureLoaded);
-    } else if (filename.find("dragon") != std::string::npos) {
-        // Note: the AO file is named "dargon_ao.png" (typo in asset)
-        loadAndUploadTexture(dir + "dargon_ao.png", aoTexture,
-                             VK_FORMAT_R8G8B8A8_SRGB, aoTextureLoaded);
-    }
-
-    // Element type map (shared across dragon meshes)
-    loadAndUploadTexture(dir + "dragon_element_type_map_2k.png", elementTypeTexture,
-                         VK_FORMAT_R8G8B8A8_UNORM, elementTypeTextureLoaded);
-
-    // Mask texture (per-face generation mask)
-    loadAndUploadTexture(dir + "mask.png", maskTexture,
-                         VK_FORMAT_R8G8B8A8_UNORM, maskTextureLoaded);
+    // Textures found next to the mesh
+    const auto& textures = package.textures;
+    uploadTexture(textures[MeshPackage::Ao], aoTexture,
+                  VK_FORMAT_R8G8B8A8_SRGB, aoTextureLoaded);
+    uploadTexture(textures[MeshPackage::ElementType], elementTypeTexture,
+                  VK_FORMAT_R8G8B8A8_UNORM, elementTypeTextureLoaded);
+    uploadTexture(textures[MeshPackage::Mask], maskTexture,
+                  VK_FORMAT_R8G8B8A8_UNORM, maskTextureLoaded);
     if (maskTextureLoaded) {
         useMaskTexture = true;  // auto-enable
-        // Keep CPU copy of mask R channel for stats
-        ImageData maskImg = ImageLoader::load(dir + "mask.png");
-        cpuMaskWidth = maskImg.width;
-        cpuMaskHeight = maskImg.height;
-        cpuMaskPixels.resize(maskImg.width * maskImg.height);
-        for (uint32_t i = 0; i < maskImg.width * maskImg.height; i++)
-            cpuMaskPixels[i] = maskImg.pixels[i * 4];  // R channel only
-    }
-
-    // Skin diffuse texture
-    loadAndUploadTexture(dir + "skin.png", skinTexture,
-                         VK_FORMAT_R8G8B8A8_SRGB, skinTextureLoaded);
-
-    // Diffuse texture (auto-detect common names)
-    {
-        std::string stem = std::filesystem::path(path).stem().string();
-        std::vector<std::string> candidates = {
-            dir + "diffuse.png", dir + "color.png", dir + "albedo.png",
-            dir + stem + "_diffuse.png", dir + stem + "_color.png", dir + stem + "_albedo.png",
-            dir + "diffuse.jpg", dir + "color.jpg", dir + "albedo.jpg",
-            dir + stem + "_diffuse.jpg", dir + stem + "_color.jpg", dir + stem + "_albedo.jpg",
-        };
-        for (const auto& candidate : candidates) {
-            if (std::filesystem::exists(candidate)) {
-                loadAndUploadTexture(candidate, diffuseTexture,
-                                     VK_FORMAT_R8G8B8A8_SRGB, diffuseTextureLoaded);
-                if (diffuseTextureLoaded) {
-                    std::cout << "  Loaded diffuse texture: " << candidate << std::endl;
-                    break;
-                }
-            }
-        }
-    }
-
-    // Normal map (auto-detect common names)
-    {
-        std::string stem = std::filesystem::path(path).stem().string();
-        std::vector<std::string> candidates = {
-            dir + "normal.png", dir + "normals.png",
-            dir + stem + "_normal.png", dir + stem + "_normals.png",
-            dir + "normal.jpg", dir + "normals.jpg",
-            dir + stem + "_normal.jpg", dir + stem + "_normals.jpg",
-        };
-        for (const auto& candidate : candidates) {
-            if (std::filesystem::exists(candidate)) {
-                loadAndUploadTexture(candidate, normalTexture,
-                                     VK_FORMAT_R8G8B8A8_UNORM, normalTextureLoaded);
-                if (normalTextureLoaded) {
-                    std::cout << "  Loaded normal texture: " << candidate << std::endl;
-                    break;
-                }
-            }
-        }
-    }
-
-    // ORM texture (Occlusion/Roughness/Metallic packed in R/G/B)
-    {
-        std::string stem = std::filesystem::path(path).stem().string();
-        std::vector<std::string> candidates = {
-            dir + "orm.png", dir + "ORM.png",
-            dir + stem + "_orm.png", dir + stem + "_ORM.png",
-            dir + "orm.jpg", dir + "ORM.jpg",
-            dir + stem + "_orm.jpg", dir + stem + "_ORM.jpg",
-        };
-        for (const auto& candidate : candidates) {
-            if (std::filesystem::exists(candidate)) {
-                loadAndUploadTexture(candidate, ormTexture,
-                                     VK_FORMAT_R8G8B8A8_UNORM, ormTextureLoaded);
-                if (ormTextureLoaded) {
-                    std::cout << "  Loaded ORM texture: " << candidate << std::endl;
-                    break;
-                }
-            }
-        }
-    }
+        cpuMaskPixels = std::move(package.maskPixels);
+        cpuMaskWidth = package.maskWidth;
+        cpuMaskHeight = package.maskHeight;
+    }
+    uploadTexture(textures[MeshPackage::Skin], skinTexture,
+                  VK_FORMAT_R8G8B8A8_SRGB, skinTextureLoaded);
+    uploadTexture(textures[MeshPackage::Diffuse], diffuseTexture,
+                  VK_FORMAT_R8G8B8A8_SRGB, diffuseTextureLoaded);
+    uploadTexture(textures[MeshPackage::Normal], normalTexture,
+                  VK_FORMAT_R8G8B8A8_UNORM, normalTextureLoaded);
+    // Occlusion/Roughness/Metallic packed in R/G/B
+    uploadTexture(textures[MeshPackage::Orm], ormTexture,
+                  VK_FORMAT_R8G8B8A8_UNORM, ormTextureLoaded);
 
     // Write sampler and texture descriptors if any textures were loaded
     if (aoTextureLoaded || elementTypeTextureLoaded || maskTextureLoaded || skinTextureLoaded
@@ -1821,106 +1828,47 @@ void Renderer::loadMesh(const std::string& path) {
         writeTextureDescriptors();
     }
 
-    // Auto-detect glTF skeleton (same name as OBJ, or any .gltf in same directory)
-    std::string baseName = path.substr(0, path.find_last_of('.'));
-    std::string gltfPath = baseName + ".gltf";
-    if (!std::filesystem::exists(gltfPath)) {
-        // Fallback: search directory for any .gltf file
-        std::string gltfDir = path.substr(0, path.find_last_of("/\\") + 1);
-        if (!gltfDir.empty()) {
-            for (const auto& entry : std::filesystem::directory_iterator(gltfDir)) {
-                if (entry.path().extension() == ".gltf") {
-                    gltfPath = entry.path().string();
-                    break;
-                }
-            }
-        }
-    }
-    std::cout << "  glTF path check: " << gltfPath
-              << " exists=" << std::filesystem::exists(gltfPath) << std::endl;
-    if (std::filesystem::exists(gltfPath) && subdivideLevel > 0) {
-        std::cout << "  Skipping glTF skeleton (subdivided mesh)" << std::endl;
-    }
-    if (std::filesystem::exists(gltfPath) && subdivideLevel == 0) {
-        std::cout << "  Loading glTF skeleton: " << gltfPath << std::endl;
-        try {
-            tinygltf::Model gltfModel = GltfLoader::loadModel(gltfPath);
-            std::cout << "  glTF model loaded OK" << std::endl;
-            GltfLoader::extractSkeleton(gltfModel, skeleton);
-            std::cout << "  Skeleton extracted: " << skeleton.bones.size() << " bones" << std::endl;
-            GltfLoader::extractAnimations(gltfModel, skeleton, animations);
-            std::cout << "  Animations extracted: " << animations.size() << std::endl;
-            GltfLoader::matchBoneDataToObjMesh(gltfModel, ngon.positions,
-                                                skeleton, jointIndicesData, jointWeightsData);
-            std::cout << "  Bone matching done" << std::endl;
-
-            // Extract UVs from glTF and re-upload to GPU (OBJ has no UVs)
-            std::vector<glm::vec2> gltfUVs;
-            GltfLoader::matchUVsToObjMesh(gltfModel, ngon.positions, skeleton, gltfUVs);
-            bool hasUVs = false;
-            for (const auto& uv : gltfUVs) {
-                if (uv.x != 0.0f || uv.y != 0.0f) { hasUVs = true; break; }
-            }
-            if (hasUVs) {
-                heVec2Buffers[0].destroy();
-                heVec2Buffers[0].create(device, physicalDevice,
-                    gltfUVs.size() * sizeof(glm::vec2), gltfUVs.data());
-                writeHEDescriptorSet(heDescriptorSet, heVec4Buffers, heVec2Buffers, heIntBuffers, heFloatBuffers);
-                std::cout << "  UV buffer re-uploaded from glTF data" << std::endl;
-
-                // Sync CPU UV arrays to match GPU (glTF UVs) so CPU pre-cull uses the same data
-                for (uint32_t j = 0; j < static_cast<uint32_t>(gltfUVs.size()) && j < static_cast<uint32_t>(cpuVertexUVs.size()); j++)
-                    cpuVertexUVs[j] = gltfUVs[j];
-                for (uint32_t j = 0; j < heNbFaces; j++) {
-                    int edge = heMesh.faceEdges[j];
-                    uint32_t firstVert = static_cast<uint32_t>(heMesh.heVertex[edge]);
-                    if (firstVert < gltfUVs.size())
-                        cpuFaceUVs[j] = gltfUVs[firstVert];
-                }
-            }
-
-            boneCount = static_cast<uint32_t>(skeleton.bones.size());
-            std::cout << "  boneCount=" << boneCount
-                      << " jointIndicesData.size()=" << jointIndicesData.size() << std::endl;
-            if (boneCount > 0 && !jointIndicesData.empty()) {
-                // Upload joint indices (device-local, static)
-                jointIndicesBuffer.create(device, physicalDevice,
-                    jointIndicesData.size() * sizeof(glm::vec4),
-                    jointIndicesData.data());
-
-                // Upload joint weights (device-local, static)
-                jointWeightsBuffer.create(device, physicalDevice,
-                    jointWeightsData.size() * sizeof(glm::vec4),
-                    jointWeightsData.data());
-
-                // Bone matrices buffer (already host-visible via StorageBuffer::create)
-                std::vector<glm::mat4> boneMatrices;
-                GltfLoader::computeBoneMatrices(skeleton, boneMatrices);
-                boneMatricesBuffer.create(device, physicalDevice,
-                    boneMatrices.size() * sizeof(glm::mat4),
-                    boneMatrices.data());
-
-                skeletonLoaded = true;
-                writeSkeletonDescriptors();
-
-                std::cout << "  Skeleton uploaded: " << boneCount << " bones, "
-                          << jointIndicesData.size() << " skinned vertices" << std::endl;
-            }
-        } catch (const std::exception& e) {
-            std::cerr << "  glTF loading error: " << e.what() << std::endl;
-        } catch (...) {
-            std::cerr << "  glTF loading: unknown exception" << std::endl;
+    jointIndicesData = std::move(package.jointIndices);
+    jointWeightsData = std::move(package.jointWeights);
+    if (package.hasSkeleton) {
+        TRACE_ZONE("commitMeshPackage: skeleton");
+        skeleton = std::move(package.skeleton);
+        animations = std::move(package.animations);
+        bakedAnimations = std::move(package.bakedAnimations);
+        skeletonCharge.reset(package.skinningBytes);
+        setupAnimationBlending();
+
+        boneCount = static_cast<uint32_t>(skeleton.bones.size());
+        std::cout << "  boneCount=" << boneCount
+                  << " jointIndicesData.size()=" << jointIndicesData.size() << std::endl;
+        if (boneCount > 0 && !jointIndicesData.empty()) {
+            // Upload joint indices (device-local, static)
+            jointIndicesBuffer.create(device, physicalDevice,
+                jointIndicesData.size() * sizeof(glm::vec4),
+                jointIndicesData.data());
+
+            // Upload joint weights (device-local, static)
+            jointWeightsBuffer.create(device, physicalDevice,
+                jointWeightsData.size() * sizeof(glm::vec4),
+                jointWeightsData.data());
+
+            // Bone matrices buffer (already host-visible via StorageBuffer::create)
+            std::vector<glm::mat4> boneMatrices;
+            GltfLoader::computeBoneMatrices(skeleton, boneMatrices);
+            boneMatricesBuffer.create(device, physicalDevice,
+                boneMatrices.size() * sizeof(glm::mat4),
+                boneMatrices.data());
+
+            skeletonLoaded = true;
+            writeSkeletonDescriptors();
+
+            std::cout << "  Skeleton uploaded: " << boneCount << " bones, "
+                      << jointIndicesData.size() << " skinned vertices" << std::endl;
         }
-    } else {
-        std::cout << "  No glTF file found for skeleton" << std::endl;
     }
 
-    // Check if a coat mesh exists alongside (e.g. dragon_coat.obj next to dragon.obj)
-    {
-        std::string coatPath = dir + "dragon_coat.obj";
-        if (std::filesystem::exists(coatPath)) {
-            dragonCoatAvailable = true;
-            dragonCoatPath = coatPath;
-        }
+    if (!package.coatPath.empty()) {
+        dragonCoatAvailable = true;
+        dragonCoatPath = package.coatPath;
     }
 }
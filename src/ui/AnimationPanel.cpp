@@ -13,14 +13,90 @@ void AnimationPanel::render(Renderer& r) {
             ImGui::SliderFloat("Speed", &r.animationSpeed, 0.0f, 5.0f, "%.2f");
         }
 
-        float duration = r.animations.empty() ? 0.0f : r.animations[0].duration;
+        int activeClip = (r.useAnimationBlending && r.animBlender.current.clip >= 0)
+            ? r.animBlender.current.clip : 0;
+        float duration = r.animations.empty() ? 0.0f : r.animations[activeClip].duration;
         ImGui::SliderFloat("Time", &r.animationTime, 0.0f, duration, "%.3f s");
         ImGui::SameLine();
         if (ImGui::Button("Reset##anim")) r.animationTime = 0.0f;
 
         ImGui::Text("Bones: %u", r.boneCount);
         if (!r.animations.empty()) {
-            ImGui::Text("Animation: \"%s\" (%.2fs)", r.animations[0].name.c_str(), duration);
+            ImGui::Text("Animation: \"%s\" (%.2fs)", r.animations[activeClip].name.c_str(), duration);
+        }
+
+        ImGui::Separator();
+        ImGui::Checkbox("Blending", &r.useAnimationBlending);
+        if (r.useAnimationBlending && r.animBlender.isInitialized() && !r.animations.empty()) {
+            ImGui::Indent();
+            auto clipName = [&](int i) {
+                return (i >= 0 && i < static_cast<int>(r.animations.size()))
+                    ? r.animations[i].name.c_str() : "None";
+            };
+            auto clipCombo = [&](const char* label, int& clip) {
+                bool changed = false;
+                if (ImGui::BeginCombo(label, clipName(clip))) {
+                    for (int i = 0; i < static_cast<int>(r.animations.size()); i++) {
+                        if (ImGui::Selectable(clipName(i), clip == i)) { clip = i; changed = true; }
+                    }
+                    ImGui::EndCombo();
+                }
+                return changed;
+            };
+
+            ImGui::SliderFloat("Crossfade", &r.animCrossfadeTime, 0.0f, 1.0f, "%.2f s");
+            if (r.thirdPersonMode) {
+                clipCombo("Idle Clip", r.animStateClips[0]);
+                clipCombo("Walk Clip", r.animStateClips[1]);
+                clipCombo("Run Clip", r.animStateClips[2]);
+            } else {
+                int clip = r.animBlender.current.clip;
+                if (clipCombo("Clip", clip) && r.animBlender.crossfadeTo(clip, r.animCrossfadeTime)) {
+                    r.animationTime = 0.0f;
+                }
+            }
+            if (r.animBlender.previous.clip >= 0) {
+                ImGui::TextDisabled("Fading from \"%s\" (%.0f%%)",
+                    clipName(r.animBlender.previous.clip), r.animBlender.fadeProgress() * 100.0f);
+            }
+
+            // Additive layers
+            auto& layers = r.animBlender.additiveLayers;
+            for (size_t i = 0; i < layers.size(); i++) {
+                ImGui::PushID(static_cast<int>(i));
+                clipCombo("Additive", layers[i].clip);
+                ImGui::SliderFloat("Weight", &layers[i].weight, 0.0f, 1.0f, "%.2f");
+                ImGui::SameLine();
+                bool remove = ImGui::SmallButton("X");
+                ImGui::PopID();
+                if (remove) { layers.erase(layers.begin() + i); break; }
+            }
+            if (ImGui::Button("Add Additive Layer", ImVec2(-1, 0))) {
+                r.animBlender.addAdditiveLayer(0, 0.5f);
+            }
+            ImGui::Unindent();
+        }
+
+        ImGui::Separator();
+        ImGui::Checkbox("Use Pose Bake", &r.useAnimationBake);
+        if (r.useAnimationBake) {
+            ImGui::Indent();
+            ImGui::Checkbox("Blend Frames", &r.animationBakeInterpolate);
+            ImGui::SliderFloat("Bake Rate", &r.animationBakeRate, 10.0f, 120.0f, "%.0f fps");
+            ImGui::SliderInt("Bake Budget", &r.animationBakeBudgetMB, 1, 256, "%d MB");
+            if (ImGui::Button("Rebake", ImVec2(-1, 0))) r.bakeAnimations();
+
+            size_t bakedBytes = 0;
+            for (const auto& b : r.bakedAnimations) bakedBytes += b.sizeBytes();
+            ImGui::Text("Bake Memory: %.2f MB", bakedBytes / (1024.0 * 1024.0));
+            for (size_t i = 0; i < r.bakedAnimations.size() && i < r.animations.size(); i++) {
+                const auto& b = r.bakedAnimations[i];
+                if (b.valid())
+                    ImGui::TextDisabled("  %s: %u frames", r.animations[i].name.c_str(), b.frameCount);
+                else
+                    ImGui::TextDisabled("  %s: live (over budget)", r.animations[i].name.c_str());
+            }
+            ImGui::Unindent();
         }
     }
 }
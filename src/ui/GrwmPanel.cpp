@@ -1,27 +1,91 @@
 #include "ui/GrwmPanel.h"
 #include "renderer/renderer.h"
 #include "imgui.h"
+#include <algorithm>
+
+// Progress, latest output and cancel button for a running GRWM job
+static void renderJobStatus(Renderer& r) {
+    float progress = r.grwmJobs.getProgress();
+    std::string status = r.grwmJobs.getStatus();
+    ImGui::ProgressBar(progress >= 0.0f ? progress : 0.0f, ImVec2(-1, 0),
+                       progress >= 0.0f ? nullptr : "...");
+    ImGui::TextWrapped("%s", status.c_str());
+    if (ImGui::Button("Cancel", ImVec2(-1, 0))) {
+        r.grwmJobs.cancel();
+    }
+}
+
+static void renderJobLog(Renderer& r) {
+    if (!ImGui::TreeNode("Job Output")) return;
+    std::vector<std::string> lines = r.grwmJobs.getLog();
+    ImGui::BeginChild("##grwmlog", ImVec2(0, 120), true);
+    for (const auto& line : lines) ImGui::TextUnformatted(line.c_str());
+    if (r.grwmJobs.isRunning()) ImGui::SetScrollHereY(1.0f);
+    ImGui::EndChild();
+    ImGui::TreePop();
+}
+
+// Slot placement controls, shared by GRWM and built-in generated slots
+static void renderSlotPlacement(Renderer& r) {
+    ImGui::Checkbox("Slot Placement", &r.enableSlotPlacement);
+    if (r.enableSlotPlacement) {
+        int maxSlots = std::max(1, static_cast<int>(r.slotsPerFace));
+        ImGui::Indent();
+        ImGui::SliderInt("Active Slots", &r.activeSlotCount, 1, maxSlots);
+        ImGui::Checkbox("Uniform Size", &r.slotUniformSize);
+        ImGui::TextDisabled("1 = center only  |  %d = max density", maxSlots);
+        ImGui::Unindent();
+    }
+}
+
+// Built-in blue-noise slots, used when the mesh has no GRWM data
+static void renderSlotGenerator(Renderer& r) {
+    if (!ImGui::CollapsingHeader("Built-in Slots")) return;
+    if (ImGui::Checkbox("Generate When No GRWM Data", &r.enableSlotGenerator))
+        r.slotGenPending = true;
+    if (!r.enableSlotGenerator) return;
+
+    ImGui::SliderInt("Slots/Face##gen", &r.slotGenCount, 4, 128);
+    ImGui::SliderFloat("Curvature Bias", &r.slotGenCurvatureBias, 0.0f, 4.0f, "%.2f");
+    if (ImGui::Button("Regenerate", ImVec2(-1, 0))) r.slotGenPending = true;
+    if (r.slotsGenerated) {
+        renderSlotPlacement(r);
+    }
+}
 
 void GrwmPanel::render(Renderer& r) {
     // Pipeline execution section — always visible
     if (!r.preprocessLoaded) {
         if (r.loadedMeshPath.empty()) {
             ImGui::TextDisabled("No mesh loaded");
-        } else if (r.grwmRunning) {
-            ImGui::TextDisabled("Running GRWM pipeline...");
+        } else if (r.grwmJobs.isRunning()) {
+            renderJobStatus(r);
         } else {
             // Pipeline settings
             ImGui::SliderInt("Slots/Face", &r.grwmSlotsPerFace, 16, 128);
             ImGui::SliderFloat("Feature Threshold", &r.grwmFeatureThreshold, 5.0f, 90.0f, "%.0f deg");
+            ImGui::Checkbox("CPU Preprocessor", &r.grwmUseNative);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Run in-process instead of cuda_preprocess\n(used automatically when the binary is missing)");
+            ImGui::Checkbox("Use Cache", &r.grwmUseCache);
 
             if (ImGui::Button("Run Pipeline", ImVec2(-1, 0))) {
                 r.runGrwmPreprocess();
             }
+            if (r.grwmJobs.getState() != GrwmJobManager::State::Idle) {
+                ImGui::TextWrapped("%s", r.grwmJobs.getStatus().c_str());
+            }
         }
 
         if (!r.grwmStatus.empty()) {
             ImGui::TextWrapped("%s", r.grwmStatus.c_str());
         }
+        renderJobLog(r);
+
+        if (!r.loadedMeshPath.empty()) {
+            ImGui::Separator();
+            renderSlotGenerator(r);
+        }
         return;
     }
 
@@ -29,13 +93,27 @@ void GrwmPanel::render(Renderer& r) {
     ImGui::Checkbox("Enable", &r.enablePreprocess);
 
     ImGui::SameLine();
-    if (ImGui::SmallButton("Rerun")) {
+    if (r.grwmJobs.isRunning()) {
+        if (ImGui::SmallButton("Cancel")) r.grwmJobs.cancel();
+    } else if (ImGui::SmallButton("Rerun")) {
         r.runGrwmPreprocess();
     }
+    if (r.preprocessVersion == 1) {
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Convert to v2")) {
+            r.convertGrwmPreprocessToV2();
+        }
+    }
 
+    if (r.grwmJobs.isRunning()) {
+        float progress = r.grwmJobs.getProgress();
+        ImGui::ProgressBar(progress >= 0.0f ? progress : 0.0f, ImVec2(-1, 0),
+                           r.grwmJobs.getStatus().c_str());
+    }
     if (!r.grwmStatus.empty()) {
         ImGui::TextDisabled("%s", r.grwmStatus.c_str());
     }
+    renderJobLog(r);
 
     if (!r.enablePreprocess) return;
 
@@ -66,12 +144,5 @@ void GrwmPanel::render(Renderer& r) {
     ImGui::Separator();
 
     // Slot placement
-    ImGui::Checkbox("Slot Placement", &r.enableSlotPlacement);
-    if (r.enableSlotPlacement) {
-        ImGui::Indent();
-        ImGui::SliderInt("Active Slots", &r.activeSlotCount, 1, 64);
-        ImGui::Checkbox("Uniform Size", &r.slotUniformSize);
-        ImGui::TextDisabled("1 = center only  |  64 = max density");
-        ImGui::Unindent();
-    }
+    renderSlotPlacement(r);
 }
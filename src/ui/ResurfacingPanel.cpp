@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <filesystem>
 
 void ResurfacingPanel::render(Renderer& r) {
@@ -251,19 +252,78 @@ void ResurfacingPanel::render(Renderer& r) {
         }
     }
 
-    if (r.heMeshUploaded && (r.renderResurfacing || r.renderPebbles) &&
+    const bool pathwayExportable = r.renderPathway && r.hasGroundMesh();
+    if (((r.heMeshUploaded && (r.renderResurfacing || r.renderPebbles)) || pathwayExportable) &&
         ImGui::CollapsingHeader("Export", ImGuiTreeNodeFlags_DefaultOpen)) {
         static char exportPath[256] = "exports/export.obj";
         ImGui::InputText("File Path", exportPath, sizeof(exportPath));
 
+        const char* formats[] = {"OBJ (text)", "GLB (binary glTF)", "PLY (binary)", "Meshlets (GMLT)"};
+        if (ImGui::Combo("Format", &r.exportFormat, formats, 4)) {
+            std::filesystem::path path(exportPath);
+            path.replace_extension(MeshStreamWriter::extension(static_cast<MeshFileFormat>(r.exportFormat)));
+            std::snprintf(exportPath, sizeof(exportPath), "%s", path.string().c_str());
+        }
+
         // Estimated size
-        if (r.renderResurfacing && !r.renderPebbles) {
+        const bool parametricExportable = r.heMeshUploaded && r.renderResurfacing && !r.renderPebbles;
+        if (parametricExportable) {
             uint32_t M = r.resolutionM, N = r.resolutionN;
             uint32_t numElements = r.heNbFaces + r.heNbVertices;
-            uint32_t estVerts = numElements * (M + 1) * (N + 1);
-            uint32_t estTris = numElements * M * N * 2;
-            float estMB = (estVerts * (sizeof(float) * 10) + estTris * 3 * sizeof(float) * 4) / 1e6f;
-            ImGui::Text("Est: %u verts, %u tris (~%.1f MB file)", estVerts, estTris, estMB);
+            uint64_t estVerts = uint64_t(numElements) * (M + 1) * (N + 1);
+            uint64_t estTris = uint64_t(numElements) * M * N * 2;
+            if (r.exportWeld) {
+                GridWeld weld;
+                weld.build(M, N, GridWeld::topologyFor(r.elementType), r.exportWeldSeams);
+                estVerts = uint64_t(numElements) * weld.vertexCount();
+                estTris = uint64_t(numElements) * weld.triangleCount();
+            }
+            // Meshlets: 24-byte vertices, 3 local index bytes per triangle,
+            // and about one shared vertex id per triangle plus the record
+            float estMB = (r.exportFormat == 0)
+                ? (estVerts * (sizeof(float) * 10) + estTris * 3 * sizeof(float) * 4) / 1e6f
+                : (r.exportFormat == 3)
+                ? (estVerts * 24 + estTris * (3 + sizeof(uint32_t) + 1)) / 1e6f
+                : (estVerts * sizeof(float) * 8 + estTris * (3 * sizeof(uint32_t) + 1)) / 1e6f;
+            ImGui::Text(r.exportLod ? "Full res: %llu verts, %llu tris (~%.1f MB file)"
+                                    : "Est: %llu verts, %llu tris (~%.1f MB file)",
+                        static_cast<unsigned long long>(estVerts),
+                        static_cast<unsigned long long>(estTris), estMB);
+            const char* backends[] = {"GPU (compute)", "CPU"};
+            ImGui::Combo("Backend", &r.exportBackend, backends, 2);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("CPU evaluates the elements without the export compute\n"
+                                  "shader, from the same parameters and element frames.");
+            ImGui::Checkbox("LOD from Current View", &r.exportLod);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Give each element the resolution adaptive LOD draws it at\n"
+                                  "from the current camera (LOD Factor applies).");
+            if (r.exportLod) {
+                ImGui::Indent();
+                ImGui::InputInt("Target Height (px)", &r.exportLodTargetHeight, 100, 1000);
+                r.exportLodTargetHeight = std::max(0, r.exportLodTargetHeight);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Screen height the export should hold up at; 0 = window height.");
+                ImGui::InputFloat("Triangle Budget (M)", &r.exportTriangleBudgetM, 0.5f, 5.0f, "%.1f");
+                r.exportTriangleBudgetM = std::max(0.0f, r.exportTriangleBudgetM);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Coarsen the LOD uniformly to fit; 0 = no budget.");
+                ImGui::Unindent();
+            }
+            ImGui::SliderInt("Batch Memory (MB)", &r.exportBatchMB, 16, 1024);
+            ImGui::Checkbox("Weld Poles", &r.exportWeld);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Merge duplicated pole vertices and drop collapsed triangles.\n"
+                                  "Seam vertices stay split so their texture coordinates are kept.");
+            if (r.exportWeld) {
+                ImGui::Indent();
+                ImGui::Checkbox("Weld UV Seams", &r.exportWeldSeams);
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Also merge the u/v seams into a closed surface. Welded seams\n"
+                                      "keep the u=0 texture coordinates, so the last column's texture\n"
+                                      "stretches across its quads.");
+                ImGui::Unindent();
+            }
 
             if (ImGui::Button("Export Parametric Mesh")) {
                 r.exportFilePath = exportPath;
@@ -272,8 +332,26 @@ void ResurfacingPanel::render(Renderer& r) {
             }
         }
 
-        if (r.renderPebbles) {
-            ImGui::Text("Pebble export: coming soon");
+        if ((r.heMeshUploaded && r.renderPebbles) || pathwayExportable) {
+            // Pebbles are generated on the CPU from the pebble UBO parameters
+            if (!parametricExportable)
+                ImGui::SliderInt("Batch Memory (MB)", &r.exportBatchMB, 16, 1024);
+            if (r.heMeshUploaded && r.renderPebbles && ImGui::Button("Export Pebble Mesh")) {
+                r.exportFilePath = exportPath;
+                r.exportMode = 1;
+                r.pendingExport = true;
+            }
+            if (pathwayExportable) {
+                if (r.heMeshUploaded && r.renderPebbles) ImGui::SameLine();
+                if (ImGui::Button("Export Pathway Pebbles")) {
+                    r.exportFilePath = exportPath;
+                    r.exportMode = 2;
+                    r.pendingExport = true;
+                }
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Ground pebbles at rest pose, faded around the\n"
+                                      "player's current position when fog of war is on.");
+            }
         }
 
         if (!r.lastExportStatus.empty()) {